@@ -162,6 +162,7 @@ def envoy_dependencies(skip_targets = []):
     _net_zlib()
     _com_github_zlib_ng_zlib_ng()
     _org_brotli()
+    _com_github_facebook_zstd()
     _upb()
     _proxy_wasm_cpp_sdk()
     _proxy_wasm_cpp_host()
@@ -374,6 +375,16 @@ def _org_brotli():
         actual = "@org_brotli//:brotlidec",
     )
 
+def _com_github_facebook_zstd():
+    external_http_archive(
+        name = "com_github_facebook_zstd",
+        build_file_content = BUILD_ALL_CONTENT,
+    )
+    native.bind(
+        name = "zstd",
+        actual = "@envoy//bazel/foreign_cc:zstd",
+    )
+
 def _com_google_cel_cpp():
     external_http_archive("com_google_cel_cpp")
     external_http_archive("rules_antlr")
@@ -424,6 +424,22 @@ REPOSITORY_LOCATIONS_SPEC = dict(
         release_date = "2020-09-08",
         cpe = "cpe:2.3:a:google:brotli:*",
     ),
+    com_github_facebook_zstd = dict(
+        project_name = "zstd",
+        project_desc = "zstd compression library",
+        project_url = "https://facebook.github.io/zstd",
+        version = "1.5.0",
+        sha256 = "5194fbfa781fcf45b98c5e849651aa7b3b0a008c6b72d4a0db760f3002291e94",
+        strip_prefix = "zstd-{version}",
+        urls = ["https://github.com/facebook/zstd/releases/download/v{version}/zstd-{version}.tar.gz"],
+        use_category = ["dataplane_ext"],
+        extensions = [
+            "envoy.compression.zstd.compressor",
+            "envoy.compression.zstd.decompressor",
+        ],
+        release_date = "2021-05-14",
+        cpe = "N/A",
+    ),
     com_github_zlib_ng_zlib_ng = dict(
         project_name = "zlib-ng",
         project_desc = "zlib fork (higher performance)",
@@ -132,6 +132,22 @@ public:
    */
   virtual std::string fileReadToEnd(const std::string& path) PURE;
 
+  /**
+   * Renames a file, replacing the file at the new path if there is one.
+   * @param old_path the path of the file to rename.
+   * @param new_path the path to rename the file to.
+   * @return Api::IoCallBoolResult whether the file was renamed, with the error if not.
+   */
+  virtual Api::IoCallBoolResult renameFile(const std::string& old_path,
+                                           const std::string& new_path) PURE;
+
+  /**
+   * Removes a file.
+   * @param path the path of the file to remove.
+   * @return Api::IoCallBoolResult whether the file was removed, with the error if not.
+   */
+  virtual Api::IoCallBoolResult removeFile(const std::string& path) PURE;
+
   /**
    * @path file path to split
    * @return PathSplitResult containing the parent directory of the input path and the file name
@@ -118,6 +118,21 @@ public:
                                           int flags, const Address::Ip* self_ip,
                                           const Address::Instance& peer_address) PURE;
 
+  /**
+   * If the platform supports, send multiple messages to the address in a single call. The kernel
+   * selects the source address.
+   * @param messages points to the messages to be sent, each slice being sent as one message.
+   * @param num_messages indicates number of messages |messages| contains.
+   * @param flags supplies the flags passed to the underlying send call.
+   * @param peer_address is the destination address.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages sent for success, which may be fewer than
+   * |num_messages|.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* messages,
+                                           uint64_t num_messages, int flags,
+                                           const Address::Instance& peer_address) PURE;
+
   struct RecvMsgPerPacketInfo {
     // The destination address from transport header.
     Address::InstanceConstSharedPtr local_address_;
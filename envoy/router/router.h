@@ -480,7 +480,8 @@ using ShadowPolicyPtr = std::unique_ptr<ShadowPolicy>;
  * Struct definition for all virtual cluster stats. @see stats_macro.h
  */
 MAKE_STAT_NAMES_STRUCT(VirtualClusterStatNames, ALL_VIRTUAL_CLUSTER_STATS);
-MAKE_STATS_STRUCT(VirtualClusterStats, VirtualClusterStatNames, ALL_VIRTUAL_CLUSTER_STATS);
+MAKE_DEFERRABLE_STATS_STRUCT(VirtualClusterStats, VirtualClusterStatNames,
+                             ALL_VIRTUAL_CLUSTER_STATS);
 
 /**
  * Virtual cluster definition (allows splitting a virtual host into virtual clusters orthogonal to
@@ -501,8 +502,9 @@ public:
   virtual VirtualClusterStats& stats() const PURE;
 
   static VirtualClusterStats generateStats(Stats::Scope& scope,
-                                           const VirtualClusterStatNames& stat_names) {
-    return VirtualClusterStats(stat_names, scope);
+                                           const VirtualClusterStatNames& stat_names,
+                                           bool defer_creation = false) {
+    return VirtualClusterStats(stat_names, scope, defer_creation);
   }
 };
 
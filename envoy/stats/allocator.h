@@ -55,6 +55,20 @@ public:
    */
   virtual TextReadoutSharedPtr makeTextReadout(StatName name, StatName tag_extracted_name,
                                                const StatNameTagVector& stat_name_tags) PURE;
+  /**
+   * @param name the full name of the stat.
+   * @return CounterSharedPtr the counter of that name if one is allocated, or nullptr. Unlike
+   *         makeCounter(), this never creates the counter.
+   */
+  virtual CounterSharedPtr findCounter(StatName name) const PURE;
+
+  /**
+   * @param name the full name of the stat.
+   * @return GaugeSharedPtr the gauge of that name if one is allocated, or nullptr. Unlike
+   *         makeGauge(), this never creates the gauge.
+   */
+  virtual GaugeSharedPtr findGauge(StatName name) const PURE;
+
   virtual const SymbolTable& constSymbolTable() const PURE;
   virtual SymbolTable& symbolTable() PURE;
 
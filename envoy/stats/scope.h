@@ -203,6 +203,12 @@ public:
    */
   virtual TextReadoutOptConstRef findTextReadout(StatName name) const PURE;
 
+  /**
+   * @return the prefix joined to the names of the stats created in the scope, so that the full
+   * name of a stat can be formed for the find methods above. Empty for the root scope.
+   */
+  virtual StatName prefix() const PURE;
+
   /**
    * @return a reference to the symbol table.
    */
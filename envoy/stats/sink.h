@@ -48,6 +48,19 @@ public:
   virtual SystemTime snapshotTime() const PURE;
 };
 
+/**
+ * Controls which metrics a sink is handed on each flush, and how.
+ */
+struct SinkFlushOptions {
+  // If true, the snapshot only holds the counters with a non-zero delta, the gauges whose value
+  // changed and the histograms which recorded values since the previous flush. Text readouts are
+  // always included.
+  bool changed_metrics_only_{false};
+  // If non-zero, the snapshot is handed to Sink::flush() in consecutive chunks of at most this
+  // many metrics, rather than all at once.
+  uint32_t max_metrics_per_flush_{0};
+};
+
 /**
  * A sink for stats. Each sink is responsible for writing stats to a backing store.
  */
@@ -61,6 +74,12 @@ public:
    */
   virtual void flush(MetricSnapshot& snapshot) PURE;
 
+  /**
+   * @return SinkFlushOptions the options controlling the snapshots passed to flush(). When flushes
+   *         are chunked, flush() is called several times per flush interval.
+   */
+  virtual SinkFlushOptions flushOptions() const { return {}; }
+
   /**
    * Flush a single histogram sample. Note: this call is called synchronously as a part of recording
    * the metric, so implementations must be thread-safe.
@@ -5,6 +5,7 @@
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
 
+#include "source/common/stats/deferred_stat.h"
 #include "source/common/stats/symbol_table_impl.h"
 #include "source/common/stats/utility.h"
 
@@ -66,6 +67,17 @@ namespace Envoy {
  * For example:
  *
  *    : my_cool_stats_(context.my_cool_stat_names_, scope, opt_prefix)
+ *
+ * Structures which are instantiated in very large numbers, most of which are never
+ * touched (e.g. one per cluster), can instead be declared with
+ *
+ *    MAKE_DEFERRABLE_STATS_STRUCT(MyStats, MyStatNames, MY_COOL_STATS);
+ *
+ * The counters, gauges and histograms in such a structure are Stats::DeferredStat
+ * handles. They are constructed with the stat_names struct, a scope, and a flag
+ * which, when true, defers instantiating each stat until it is first touched:
+ *
+ *    : my_cool_stats_(context.my_cool_stat_names_, scope, defer_creation)
  */
 
 // Fully-qualified for use in external callsites.
@@ -164,4 +176,39 @@ static inline std::string statPrefixJoin(absl::string_view prefix, absl::string_
               GENERATE_TEXT_READOUT_STRUCT, GENERATE_STATNAME_STRUCT)                              \
   }
 
+#define GENERATE_DEFERRED_COUNTER_STRUCT(NAME) Envoy::Stats::DeferredCounter NAME##_;
+#define GENERATE_DEFERRED_GAUGE_STRUCT(NAME, MODE) Envoy::Stats::DeferredGauge NAME##_;
+#define GENERATE_DEFERRED_HISTOGRAM_STRUCT(NAME, UNIT) Envoy::Stats::DeferredHistogram NAME##_;
+
+#define MAKE_DEFERRABLE_STATS_STRUCT_COUNTER_HELPER_(NAME)                                         \
+  , NAME##_(scope, stat_names.NAME##_, deferred)
+#define MAKE_DEFERRABLE_STATS_STRUCT_GAUGE_HELPER_(NAME, MODE)                                     \
+  , NAME##_(scope, stat_names.NAME##_, Envoy::Stats::Gauge::ImportMode::MODE, deferred)
+#define MAKE_DEFERRABLE_STATS_STRUCT_HISTOGRAM_HELPER_(NAME, UNIT)                                 \
+  , NAME##_(scope, stat_names.NAME##_, Envoy::Stats::Histogram::Unit::UNIT, deferred)
+#define MAKE_DEFERRABLE_STATS_STRUCT_TEXT_READOUT_HELPER_(NAME)                                    \
+  , NAME##_(scope.textReadoutFromStatName(stat_names.NAME##_))
+
+/**
+ * Like MAKE_STATS_STRUCT, but the counters, gauges and histograms of the structure
+ * may be instantiated lazily, on first touch, when the structure is constructed with
+ * deferred set to true. Text readouts are always instantiated eagerly. Prefixes are not
+ * supported; the scope passed in determines the full name of each stat.
+ */
+#define MAKE_DEFERRABLE_STATS_STRUCT(StatsStruct, StatNamesStruct, ALL_STATS)                      \
+  struct StatsStruct {                                                                             \
+    StatsStruct(const StatNamesStruct& stat_names, Envoy::Stats::Scope& scope,                     \
+                bool deferred = false)                                                             \
+        : stat_names_(stat_names)                                                                  \
+              ALL_STATS(MAKE_DEFERRABLE_STATS_STRUCT_COUNTER_HELPER_,                              \
+                        MAKE_DEFERRABLE_STATS_STRUCT_GAUGE_HELPER_,                                \
+                        MAKE_DEFERRABLE_STATS_STRUCT_HISTOGRAM_HELPER_,                            \
+                        MAKE_DEFERRABLE_STATS_STRUCT_TEXT_READOUT_HELPER_,                         \
+                        MAKE_STATS_STRUCT_STATNAME_HELPER_) {}                                     \
+    const StatNamesStruct& stat_names_;                                                            \
+    ALL_STATS(GENERATE_DEFERRED_COUNTER_STRUCT, GENERATE_DEFERRED_GAUGE_STRUCT,                    \
+              GENERATE_DEFERRED_HISTOGRAM_STRUCT, GENERATE_TEXT_READOUT_STRUCT,                    \
+              GENERATE_STATNAME_STRUCT)                                                            \
+  }
+
 } // namespace Envoy
@@ -310,6 +310,12 @@ public:
   virtual const ClusterRequestResponseSizeStatNames&
   clusterRequestResponseSizeStatNames() const PURE;
   virtual const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const PURE;
+
+  /**
+   * @return bool whether per-cluster and per-virtual-cluster stats should only be instantiated
+   *         when first touched. @see envoy.config.metrics.v3.StatsConfig.
+   */
+  virtual bool deferStatCreation() const PURE;
 };
 
 using ClusterManagerPtr = std::unique_ptr<ClusterManager>;
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/non_copyable.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+
+/**
+ * A bump allocator for objects that share a lifetime, such as the per stream state of the HTTP
+ * connection manager. Memory is carved out of blocks which are all released together when the
+ * arena is destroyed: allocating is a pointer bump, and deallocating does nothing. Objects
+ * allocated in the arena must be destroyed before it.
+ */
+class Arena : NonCopyable {
+public:
+  static constexpr uint64_t DefaultBlockSize = 4096;
+
+  explicit Arena(uint64_t block_size = DefaultBlockSize) : block_size_(block_size) {}
+
+  /**
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the alignment of the allocation, a power of two which is at most
+   *        alignof(std::max_align_t).
+   * @return the allocated memory, which is valid until the arena is destroyed.
+   */
+  void* allocate(uint64_t size, uint64_t alignment = alignof(std::max_align_t)) {
+    ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    ASSERT(alignment <= alignof(std::max_align_t));
+    uint64_t padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+    if (current_ == nullptr || padding + size > remaining_) {
+      // Blocks are allocated with operator new[], so they start at the maximal alignment.
+      // Allocations that are larger than a block get a block of their own.
+      const uint64_t block_size = std::max(size, block_size_);
+      blocks_.emplace_back(new uint8_t[block_size]);
+      current_ = blocks_.back().get();
+      remaining_ = block_size;
+      padding = 0;
+    }
+    void* allocation = current_ + padding;
+    current_ += padding + size;
+    remaining_ -= padding + size;
+    return allocation;
+  }
+
+  /**
+   * @return the number of blocks allocated by the arena so far.
+   */
+  uint64_t blocks() const { return blocks_.size(); }
+
+private:
+  const uint64_t block_size_;
+  absl::InlinedVector<std::unique_ptr<uint8_t[]>, 2> blocks_;
+  uint8_t* current_{};
+  uint64_t remaining_{};
+};
+
+/**
+ * An allocator for standard containers which allocates from an Arena, so that the memory of the
+ * container is released along with the arena.
+ */
+template <class T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  template <class U> bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena_;
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena_;
+  }
+
+private:
+  template <class U> friend class ArenaAllocator;
+
+  Arena* arena_;
+};
+
+/**
+ * Mixin for classes whose instances are allocated in an Arena with new (arena) T(...). They are
+ * destroyed with delete as usual, e.g. through a std::unique_ptr, which runs their destructor and
+ * leaves their memory to the arena.
+ */
+class ArenaObject {
+public:
+  static void* operator new(size_t size, Arena& arena) { return arena.allocate(size); }
+  static void operator delete(void*) {}
+  // Called if the constructor of an object allocated in an arena throws.
+  static void operator delete(void*, Arena&) {}
+};
+
+} // namespace Envoy
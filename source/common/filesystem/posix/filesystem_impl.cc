@@ -126,6 +126,17 @@ std::string InstanceImplPosix::fileReadToEnd(const std::string& path) {
   return file_string.str();
 }
 
+Api::IoCallBoolResult InstanceImplPosix::renameFile(const std::string& old_path,
+                                                    const std::string& new_path) {
+  const int rc = ::rename(old_path.c_str(), new_path.c_str());
+  return rc != -1 ? resultSuccess(true) : resultFailure(false, errno);
+}
+
+Api::IoCallBoolResult InstanceImplPosix::removeFile(const std::string& path) {
+  const int rc = ::unlink(path.c_str());
+  return rc != -1 ? resultSuccess(true) : resultFailure(false, errno);
+}
+
 PathSplitResult InstanceImplPosix::splitPathFromFilename(absl::string_view path) {
   size_t last_slash = path.rfind('/');
   if (last_slash == std::string::npos) {
@@ -166,6 +166,22 @@ std::string InstanceImplWin32::fileReadToEnd(const std::string& path) {
   return std::string(complete_buffer.begin(), complete_buffer.end());
 }
 
+Api::IoCallBoolResult InstanceImplWin32::renameFile(const std::string& old_path,
+                                                    const std::string& new_path) {
+  // Unlike rename(), MoveFileEx() can replace an existing file.
+  if (!::MoveFileExA(old_path.c_str(), new_path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+    return resultFailure(false, ::GetLastError());
+  }
+  return resultSuccess(true);
+}
+
+Api::IoCallBoolResult InstanceImplWin32::removeFile(const std::string& path) {
+  if (!::DeleteFileA(path.c_str())) {
+    return resultFailure(false, ::GetLastError());
+  }
+  return resultSuccess(true);
+}
+
 PathSplitResult InstanceImplWin32::splitPathFromFilename(absl::string_view path) {
   size_t last_slash = path.find_last_of(":/\\");
   if (last_slash == std::string::npos) {
@@ -81,6 +81,9 @@ public:
   bool directoryExists(const std::string& path) override;
   ssize_t fileSize(const std::string& path) override;
   std::string fileReadToEnd(const std::string& path) override;
+  Api::IoCallBoolResult renameFile(const std::string& old_path,
+                                   const std::string& new_path) override;
+  Api::IoCallBoolResult removeFile(const std::string& path) override;
   PathSplitResult splitPathFromFilename(absl::string_view path) override;
   bool illegalPath(const std::string& path) override;
 };
@@ -627,14 +627,14 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.isRoutable() &&
       connection_manager.config_.routeConfigProvider() != nullptr) {
-    route_config_update_requester_ =
-        std::make_unique<ConnectionManagerImpl::RdsRouteConfigUpdateRequester>(
-            connection_manager.config_.routeConfigProvider(), *this);
+    route_config_update_requester_.reset(
+        new (filter_manager_.arena()) ConnectionManagerImpl::RdsRouteConfigUpdateRequester(
+            connection_manager.config_.routeConfigProvider(), *this));
   } else if (connection_manager_.config_.isRoutable() &&
              connection_manager.config_.scopedRouteConfigProvider() != nullptr) {
-    route_config_update_requester_ =
-        std::make_unique<ConnectionManagerImpl::RdsRouteConfigUpdateRequester>(
-            connection_manager.config_.scopedRouteConfigProvider(), *this);
+    route_config_update_requester_.reset(
+        new (filter_manager_.arena()) ConnectionManagerImpl::RdsRouteConfigUpdateRequester(
+            connection_manager.config_.scopedRouteConfigProvider(), *this));
   }
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
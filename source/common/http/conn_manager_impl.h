@@ -36,6 +36,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "source/common/buffer/watermark_buffer.h"
+#include "source/common/common/arena.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/grpc/common.h"
@@ -115,7 +116,8 @@ public:
 private:
   struct ActiveStream;
 
-  class RdsRouteConfigUpdateRequester {
+  // Allocated in the arena of its stream.
+  class RdsRouteConfigUpdateRequester : public ArenaObject {
   public:
     RdsRouteConfigUpdateRequester(Router::RouteConfigProvider* route_config_provider,
                                   ActiveStream& parent)
@@ -16,6 +16,7 @@
 #include "envoy/type/matcher/v3/http_inputs.pb.validate.h"
 
 #include "source/common/buffer/watermark_buffer.h"
+#include "source/common/common/arena.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
@@ -26,6 +27,7 @@
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/matcher/matcher.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/stream_info/stream_info_impl.h"
 
 namespace Envoy {
@@ -89,6 +91,7 @@ public:
  * memory overhead of unused fields) should apply.
  */
 struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
+                                public ArenaObject,
                                 Logger::Loggable<Logger::Id::http> {
   ActiveStreamFilterBase(FilterManager& parent, bool dual_filter,
                          FilterMatchStateSharedPtr match_state)
@@ -214,9 +217,11 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
 /**
  * Wrapper for a stream decoder filter.
  */
-struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                   public StreamDecoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamDecoderFilter> {
+struct ActiveStreamDecoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamDecoderFilterCallbacks,
+      LinkedObject<ActiveStreamDecoderFilter,
+                   ArenaAllocator<std::unique_ptr<ActiveStreamDecoderFilter>>> {
   ActiveStreamDecoderFilter(FilterManager& parent, StreamDecoderFilterSharedPtr filter,
                             FilterMatchStateSharedPtr match_state, bool dual_filter)
       : ActiveStreamFilterBase(parent, dual_filter, std::move(match_state)), handle_(filter) {}
@@ -303,13 +308,16 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
 };
 
 using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+using ActiveStreamDecoderFilterList = ActiveStreamDecoderFilter::ListType;
 
 /**
  * Wrapper for a stream encoder filter.
  */
-struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                   public StreamEncoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamEncoderFilter> {
+struct ActiveStreamEncoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamEncoderFilterCallbacks,
+      LinkedObject<ActiveStreamEncoderFilter,
+                   ArenaAllocator<std::unique_ptr<ActiveStreamEncoderFilter>>> {
   ActiveStreamEncoderFilter(FilterManager& parent, StreamEncoderFilterSharedPtr filter,
                             FilterMatchStateSharedPtr match_state, bool dual_filter)
       : ActiveStreamFilterBase(parent, dual_filter, std::move(match_state)), handle_(filter) {}
@@ -360,6 +368,7 @@ struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
 };
 
 using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+using ActiveStreamEncoderFilterList = ActiveStreamEncoderFilter::ListType;
 
 /**
  * Callbacks invoked by the FilterManager to pass filter data/events back to the caller.
@@ -660,7 +669,11 @@ public:
         proxy_100_continue_(proxy_100_continue), buffer_limit_(buffer_limit),
         filter_chain_factory_(filter_chain_factory), local_reply_(local_reply),
         stream_info_(protocol, time_source, connection.addressProviderSharedPtr(),
-                     parent_filter_state, filter_state_life_span) {}
+                     parent_filter_state, filter_state_life_span,
+                     Runtime::runtimeFeatureEnabled(
+                         "envoy.reloadable_features.allocate_filter_state_in_stream_arena")
+                         ? &arena_
+                         : nullptr) {}
   ~FilterManager() override {
     ASSERT(state_.destroyed_);
     ASSERT(state_.filter_call_state_ == 0);
@@ -909,6 +922,12 @@ public:
     state_.created_filter_chain_ = true;
   }
 
+  /**
+   * @return the arena of the stream, which short lived per stream objects may be allocated in.
+   * It is destroyed along with the filter manager.
+   */
+  Arena& arena() { return arena_; }
+
   // TODO(snowp): This should probably return a StreamInfo instead of the impl.
   StreamInfo::StreamInfoImpl& streamInfo() { return stream_info_; }
   const StreamInfo::StreamInfoImpl& streamInfo() const { return stream_info_; }
@@ -938,11 +957,11 @@ private:
   enum class FilterIterationStartState { AlwaysStartFromNext, CanStartFromCurrent };
 
   // Returns the encoder filter to start iteration with.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator
+  ActiveStreamEncoderFilterList::iterator
   commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
                      FilterIterationStartState filter_iteration_start_state);
   // Returns the decoder filter to start iteration with.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator
+  ActiveStreamDecoderFilterList::iterator
   commonDecodePrefix(ActiveStreamDecoderFilter* filter,
                      FilterIterationStartState filter_iteration_start_state);
   void addDecodedData(ActiveStreamDecoderFilter& filter, Buffer::Instance& data, bool streaming);
@@ -951,7 +970,7 @@ private:
   // Helper function for the case where we have a header only request, but a filter adds a body
   // to it.
   void maybeContinueDecoding(
-      const std::list<ActiveStreamDecoderFilterPtr>::iterator& maybe_continue_data_entry);
+      const ActiveStreamDecoderFilterList::iterator& maybe_continue_data_entry);
   void decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHeaderMap& headers, bool end_stream);
   // Sends data through decoding filter chains. filter_iteration_start_state indicates which
   // filter to start the iteration with.
@@ -966,7 +985,7 @@ private:
   // filters before calling encodeHeadersInternal which does final header munging and passes the
   // headers to the encoder.
   void maybeContinueEncoding(
-      const std::list<ActiveStreamEncoderFilterPtr>::iterator& maybe_continue_data_entry);
+      const ActiveStreamEncoderFilterList::iterator& maybe_continue_data_entry);
   void encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHeaderMap& headers,
                      bool end_stream);
   // Sends data through encoding filter chains. filter_iteration_start_state indicates which
@@ -1000,10 +1019,18 @@ private:
   Buffer::BufferMemoryAccountSharedPtr account_;
   const bool proxy_100_continue_;
 
-  std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-  std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
-  std::list<StreamFilterBase*> filters_;
-  std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+  // The filter wrappers of the stream, the nodes of the lists below and the filter state of the
+  // stream are allocated in the arena, which releases them all at once when the stream is
+  // destroyed. It must be declared before them.
+  Arena arena_;
+  ActiveStreamDecoderFilterList decoder_filters_{
+      ArenaAllocator<ActiveStreamDecoderFilterPtr>(arena_)};
+  ActiveStreamEncoderFilterList encoder_filters_{
+      ArenaAllocator<ActiveStreamEncoderFilterPtr>(arena_)};
+  std::list<StreamFilterBase*, ArenaAllocator<StreamFilterBase*>> filters_{
+      ArenaAllocator<StreamFilterBase*>(arena_)};
+  std::list<AccessLog::InstanceSharedPtr, ArenaAllocator<AccessLog::InstanceSharedPtr>>
+      access_log_handlers_{ArenaAllocator<AccessLog::InstanceSharedPtr>(arena_)};
 
   // Stores metadata added in the decoding filter that is being processed. Will be cleared before
   // processing the next filter. The storage is created on demand. We need to store metadata
@@ -310,6 +310,44 @@ absl::optional<uint32_t> maybeGetPacketsDroppedFromHeader([[maybe_unused]] const
   return absl::nullopt;
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const Buffer::RawSlice* messages,
+                                                     uint64_t num_messages, int flags,
+                                                     const Address::Instance& peer_address) {
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
+  if (sock_addr == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+  if (num_messages == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  absl::FixedArray<mmsghdr> mmsg_hdr(num_messages);
+  absl::FixedArray<iovec> iovs(num_messages);
+  for (uint64_t i = 0; i < num_messages; ++i) {
+    iovs[i].iov_base = messages[i].mem_;
+    iovs[i].iov_len = messages[i].len_;
+    mmsg_hdr[i] = {};
+    msghdr& hdr = mmsg_hdr[i].msg_hdr;
+    hdr.msg_name = reinterpret_cast<void*>(sock_addr);
+    hdr.msg_namelen = address_base->sockAddrLen();
+    hdr.msg_iov = &iovs[i];
+    hdr.msg_iovlen = 1;
+  }
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().sendmmsg(fd_, mmsg_hdr.data(), num_messages, flags);
+  auto io_result = sysCallResultToIoCallResult(result);
+  // Emulated edge events need to registered if the socket operation did not complete
+  // because the socket would block.
+  if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
+    if (io_result.wouldBlock() && file_event_) {
+      file_event_->registerEventIfEmulatedEdge(Event::FileReadyType::Write);
+    }
+  }
+  return io_result;
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
                                                     const uint64_t num_slice, uint32_t self_port,
                                                     RecvMsgOutput& output) {
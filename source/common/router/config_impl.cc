@@ -59,6 +59,21 @@ void mergeTransforms(Http::HeaderTransforms& dest, const Http::HeaderTransforms&
                                 src.headers_to_remove.end());
 }
 
+// The header parsers of a route, its virtual host and its route configuration, in the order they
+// are evaluated.
+std::vector<const HeaderParser*>
+headerParsersInEvaluationOrder(const HeaderParser& route, const HeaderParser& vhost,
+                               const HeaderParser& global,
+                               bool most_specific_header_mutations_wins) {
+  if (!most_specific_header_mutations_wins) {
+    // Append user-specified headers from most to least specific: route-level headers, virtual
+    // host level headers and finally global connection manager level headers.
+    return {&route, &vhost, &global};
+  }
+  // Most specific mutations take precedence.
+  return {&global, &vhost, &route};
+}
+
 } // namespace
 
 const std::string& OriginalConnectPort::key() {
@@ -354,6 +369,14 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
                                                       route.request_headers_to_remove())),
       response_headers_parser_(HeaderParser::configure(route.response_headers_to_add(),
                                                        route.response_headers_to_remove())),
+      request_headers_plan_(headerParsersInEvaluationOrder(
+          *request_headers_parser_, vhost.requestHeaderParser(),
+          vhost.globalRouteConfig().requestHeaderParser(),
+          vhost.globalRouteConfig().mostSpecificHeaderMutationsWins())),
+      response_headers_plan_(headerParsersInEvaluationOrder(
+          *response_headers_parser_, vhost.responseHeaderParser(),
+          vhost.globalRouteConfig().responseHeaderParser(),
+          vhost.globalRouteConfig().mostSpecificHeaderMutationsWins())),
       retry_shadow_buffer_limit_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           route, per_request_buffer_limit_bytes, vhost.retryShadowBufferLimit())),
       metadata_(route.metadata()), typed_metadata_(route.metadata()),
@@ -548,18 +571,8 @@ const std::string& RouteEntryImplBase::clusterName() const { return cluster_name
 void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
                                                 const StreamInfo::StreamInfo& stream_info,
                                                 bool insert_envoy_original_path) const {
-  if (!vhost_.globalRouteConfig().mostSpecificHeaderMutationsWins()) {
-    // Append user-specified request headers from most to least specific: route-level headers,
-    // virtual host level headers and finally global connection manager level headers.
-    request_headers_parser_->evaluateHeaders(headers, stream_info);
-    vhost_.requestHeaderParser().evaluateHeaders(headers, stream_info);
-    vhost_.globalRouteConfig().requestHeaderParser().evaluateHeaders(headers, stream_info);
-  } else {
-    // Most specific mutations take precedence.
-    vhost_.globalRouteConfig().requestHeaderParser().evaluateHeaders(headers, stream_info);
-    vhost_.requestHeaderParser().evaluateHeaders(headers, stream_info);
-    request_headers_parser_->evaluateHeaders(headers, stream_info);
-  }
+  // User-specified request headers of the route, virtual host and route configuration levels.
+  request_headers_plan_.evaluateHeaders(headers, stream_info);
 
   // Restore the port if this was a CONNECT request.
   // Note this will restore the port for HTTP/2 CONNECT-upgrades as well as as HTTP/1.1 style
@@ -599,18 +612,8 @@ void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
 
 void RouteEntryImplBase::finalizeResponseHeaders(Http::ResponseHeaderMap& headers,
                                                  const StreamInfo::StreamInfo& stream_info) const {
-  if (!vhost_.globalRouteConfig().mostSpecificHeaderMutationsWins()) {
-    // Append user-specified request headers from most to least specific: route-level headers,
-    // virtual host level headers and finally global connection manager level headers.
-    response_headers_parser_->evaluateHeaders(headers, stream_info);
-    vhost_.responseHeaderParser().evaluateHeaders(headers, stream_info);
-    vhost_.globalRouteConfig().responseHeaderParser().evaluateHeaders(headers, stream_info);
-  } else {
-    // Most specific mutations take precedence.
-    vhost_.globalRouteConfig().responseHeaderParser().evaluateHeaders(headers, stream_info);
-    vhost_.responseHeaderParser().evaluateHeaders(headers, stream_info);
-    response_headers_parser_->evaluateHeaders(headers, stream_info);
-  }
+  // User-specified response headers of the route, virtual host and route configuration levels.
+  response_headers_plan_.evaluateHeaders(headers, stream_info);
 }
 
 Http::HeaderTransforms
@@ -1203,7 +1206,8 @@ VirtualHostImpl::VirtualHostImpl(
       include_attempt_count_in_request_(virtual_host.include_request_attempt_count()),
       include_attempt_count_in_response_(virtual_host.include_attempt_count_in_response()),
       virtual_cluster_catch_all_(*vcluster_scope_,
-                                 factory_context.routerContext().virtualClusterStatNames()) {
+                                 factory_context.routerContext().virtualClusterStatNames(),
+                                 factory_context.clusterManager().deferStatCreation()) {
 
   switch (virtual_host.require_tls()) {
   case envoy::config::route::v3::VirtualHost::NONE:
@@ -1269,7 +1273,8 @@ VirtualHostImpl::VirtualHostImpl(
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(
         VirtualClusterEntry(virtual_cluster, *vcluster_scope_,
-                            factory_context.routerContext().virtualClusterStatNames()));
+                            factory_context.routerContext().virtualClusterStatNames(),
+                            factory_context.clusterManager().deferStatCreation()));
   }
 
   if (virtual_host.has_cors()) {
@@ -1279,10 +1284,11 @@ VirtualHostImpl::VirtualHostImpl(
 
 VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
     const envoy::config::route::v3::VirtualCluster& virtual_cluster, Stats::Scope& scope,
-    const VirtualClusterStatNames& stat_names)
+    const VirtualClusterStatNames& stat_names, bool defer_stat_creation)
     : StatNameProvider(virtual_cluster.name(), scope.symbolTable()),
       VirtualClusterBase(stat_name_storage_.statName(),
-                         scope.scopeFromStatName(stat_name_storage_.statName()), stat_names) {
+                         scope.scopeFromStatName(stat_name_storage_.statName()), stat_names,
+                         defer_stat_creation) {
   if (virtual_cluster.headers().empty()) {
     throw EnvoyException("virtual clusters must define 'headers'");
   }
@@ -1497,6 +1503,13 @@ ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& confi
       max_direct_response_body_size_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_direct_response_body_size_bytes,
                                           DEFAULT_MAX_DIRECT_RESPONSE_BODY_SIZE_BYTES)) {
+  // The header parsers are merged into the header mutation plans of the routes, so they are
+  // configured first.
+  request_headers_parser_ =
+      HeaderParser::configure(config.request_headers_to_add(), config.request_headers_to_remove());
+  response_headers_parser_ = HeaderParser::configure(config.response_headers_to_add(),
+                                                     config.response_headers_to_remove());
+
   route_matcher_ = std::make_unique<RouteMatcher>(
       config, optional_http_filters, *this, factory_context, validator,
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
@@ -1504,11 +1517,6 @@ ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& confi
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
-
-  request_headers_parser_ =
-      HeaderParser::configure(config.request_headers_to_add(), config.request_headers_to_remove());
-  response_headers_parser_ = HeaderParser::configure(config.response_headers_to_add(),
-                                                     config.response_headers_to_remove());
 }
 
 RouteConstSharedPtr ConfigImpl::route(const RouteCallback& cb,
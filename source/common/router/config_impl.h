@@ -230,9 +230,9 @@ private:
   struct VirtualClusterBase : public VirtualCluster {
   public:
     VirtualClusterBase(Stats::StatName stat_name, Stats::ScopePtr&& scope,
-                       const VirtualClusterStatNames& stat_names)
+                       const VirtualClusterStatNames& stat_names, bool defer_stat_creation)
         : stat_name_(stat_name), scope_(std::move(scope)),
-          stats_(generateStats(*scope_, stat_names)) {}
+          stats_(generateStats(*scope_, stat_names, defer_stat_creation)) {}
 
     // Router::VirtualCluster
     Stats::StatName statName() const override { return stat_name_; }
@@ -246,14 +246,16 @@ private:
 
   struct VirtualClusterEntry : public StatNameProvider, public VirtualClusterBase {
     VirtualClusterEntry(const envoy::config::route::v3::VirtualCluster& virtual_cluster,
-                        Stats::Scope& scope, const VirtualClusterStatNames& stat_names);
+                        Stats::Scope& scope, const VirtualClusterStatNames& stat_names,
+                        bool defer_stat_creation);
     std::vector<Http::HeaderUtility::HeaderDataPtr> headers_;
   };
 
   struct CatchAllVirtualCluster : public VirtualClusterBase {
-    CatchAllVirtualCluster(Stats::Scope& scope, const VirtualClusterStatNames& stat_names)
+    CatchAllVirtualCluster(Stats::Scope& scope, const VirtualClusterStatNames& stat_names,
+                           bool defer_stat_creation)
         : VirtualClusterBase(stat_names.other_, scope.scopeFromStatName(stat_names.other_),
-                             stat_names) {}
+                             stat_names, defer_stat_creation) {}
   };
 
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
@@ -874,6 +876,8 @@ private:
   TlsContextMatchCriteriaConstPtr tls_context_match_criteria_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
+  const HeaderMutationPlan request_headers_plan_;
+  const HeaderMutationPlan response_headers_plan_;
   uint32_t retry_shadow_buffer_limit_{std::numeric_limits<uint32_t>::max()};
   envoy::config::core::v3::Metadata metadata_;
   Envoy::Config::TypedMetadataImpl<HttpRouteTypedMetadataFactory> typed_metadata_;
@@ -70,6 +70,8 @@ public:
   };
   bool append() const override { return append_; }
 
+  const std::string& staticValue() const { return static_value_; }
+
 private:
   const std::string static_value_;
   const bool append_;
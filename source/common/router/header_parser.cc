@@ -296,6 +296,49 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers,
   }
 }
 
+HeaderMutationPlan::HeaderMutationPlan(const std::vector<const HeaderParser*>& parsers) {
+  for (const HeaderParser* parser : parsers) {
+    for (const auto& header : parser->headers_to_remove_) {
+      mutations_.push_back({&header, nullptr, absl::nullopt});
+    }
+    for (const auto& [key, entry] : parser->headers_to_add_) {
+      const auto* plain_formatter =
+          dynamic_cast<const PlainHeaderFormatter*>(entry.formatter_.get());
+      if (plain_formatter == nullptr) {
+        mutations_.push_back({&key, entry.formatter_.get(), absl::nullopt});
+      } else if (!plain_formatter->staticValue().empty()) {
+        mutations_.push_back({&key, plain_formatter, plain_formatter->staticValue()});
+      }
+    }
+  }
+}
+
+void HeaderMutationPlan::evaluateHeaders(Http::HeaderMap& headers,
+                                         const StreamInfo::StreamInfo& stream_info) const {
+  for (const Mutation& mutation : mutations_) {
+    if (mutation.formatter_ == nullptr) {
+      headers.remove(*mutation.key_);
+      continue;
+    }
+    if (mutation.constant_value_.has_value()) {
+      if (mutation.formatter_->append()) {
+        headers.addReferenceKey(*mutation.key_, mutation.constant_value_.value());
+      } else {
+        headers.setReferenceKey(*mutation.key_, mutation.constant_value_.value());
+      }
+      continue;
+    }
+    const std::string value = mutation.formatter_->format(stream_info);
+    if (!value.empty()) {
+      if (mutation.formatter_->append()) {
+        headers.addReferenceKey(*mutation.key_, value);
+      } else {
+        headers.setReferenceKey(*mutation.key_, value);
+      }
+    }
+  }
+}
+
 Http::HeaderTransforms HeaderParser::getHeaderTransforms(const StreamInfo::StreamInfo& stream_info,
                                                          bool do_formatting) const {
   Http::HeaderTransforms transforms;
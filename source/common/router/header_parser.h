@@ -10,6 +10,8 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/router/header_formatter.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Router {
 
@@ -65,6 +67,8 @@ protected:
   HeaderParser() = default;
 
 private:
+  friend class HeaderMutationPlan;
+
   struct HeadersToAddEntry {
     HeaderFormatterPtr formatter_;
     const std::string original_value_;
@@ -74,5 +78,32 @@ private:
   std::vector<Http::LowerCaseString> headers_to_remove_;
 };
 
+/**
+ * The header mutations of several HeaderParsers, e.g. those of a route, its virtual host and its
+ * route configuration, merged at config load into a single list that is applied in one pass.
+ * Applying it has the same effect as evaluating the parsers one after another, but constant
+ * values are not formatted again for every request. The parsers must outlive the plan.
+ */
+class HeaderMutationPlan {
+public:
+  /*
+   * @param parsers the header parsers to merge, in the order they are evaluated.
+   */
+  explicit HeaderMutationPlan(const std::vector<const HeaderParser*>& parsers);
+
+  void evaluateHeaders(Http::HeaderMap& headers, const StreamInfo::StreamInfo& stream_info) const;
+
+private:
+  struct Mutation {
+    const Http::LowerCaseString* key_;
+    // Null when the header is removed.
+    const HeaderFormatter* formatter_;
+    // The value of a constant formatter_, which is never empty.
+    absl::optional<std::string> constant_value_;
+  };
+
+  std::vector<Mutation> mutations_;
+};
+
 } // namespace Router
 } // namespace Envoy
@@ -67,6 +67,7 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.grpc_bridge_stats_disabled",
     "envoy.reloadable_features.grpc_web_fix_non_proto_encoded_response_handling",
     "envoy.reloadable_features.grpc_json_transcoder_adhere_to_buffer_limits",
+    "envoy.reloadable_features.grpc_json_transcoder_stream_http_body_requests",
     "envoy.reloadable_features.hash_multiple_header_values",
     "envoy.reloadable_features.health_check.graceful_goaway_handling",
     "envoy.reloadable_features.health_check.immediate_failure_exclude_from_cluster",
@@ -119,6 +120,9 @@ constexpr const char* disabled_runtime_features[] = {
     "envoy.test_only.per_stream_buffer_accounting",
     // Allows the use of ExtensionWithMatcher to wrap a HTTP filter with a match tree.
     "envoy.reloadable_features.experimental_matching_api",
+    // A filter state object kept past the end of its stream by an extension would be released with
+    // the arena of the stream, so this is off until the extensions are audited.
+    "envoy.reloadable_features.allocate_filter_state_in_stream_arena",
 };
 
 RuntimeFeatures::RuntimeFeatures() {
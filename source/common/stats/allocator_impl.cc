@@ -173,18 +173,21 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     child_value_ += amount;
-    flags_ |= Flags::Used;
+    flags_ |= amount != 0 ? (Flags::Used | Flags::Changed) : Flags::Used;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
-    child_value_ = value;
-    flags_ |= Flags::Used;
+    const uint64_t previous = child_value_.exchange(value);
+    flags_ |= previous != value ? (Flags::Used | Flags::Changed) : Flags::Used;
   }
   void sub(uint64_t amount) override {
     ASSERT(child_value_ >= amount);
     ASSERT(used() || amount == 0);
     child_value_ -= amount;
+    if (amount != 0) {
+      flags_ |= Flags::Changed;
+    }
   }
   uint64_t value() const override { return child_value_ + parent_value_; }
 
@@ -224,7 +227,14 @@ public:
     }
   }
 
-  void setParentValue(uint64_t value) override { parent_value_ = value; }
+  void setParentValue(uint64_t value) override {
+    if (parent_value_.exchange(value) != value) {
+      flags_ |= Flags::Changed;
+    }
+  }
+  bool latchChanged() override {
+    return (flags_.fetch_and(static_cast<uint16_t>(~Flags::Changed)) & Flags::Changed) != 0;
+  }
 
 private:
   std::atomic<uint64_t> parent_value_{0};
@@ -303,6 +313,26 @@ TextReadoutSharedPtr AllocatorImpl::makeTextReadout(StatName name, StatName tag_
   return text_readout;
 }
 
+CounterSharedPtr AllocatorImpl::findCounter(StatName name) const {
+  // The reference is taken under the lock, so it cannot race with the last reference being
+  // dropped in decRefCount().
+  Thread::LockGuard lock(mutex_);
+  auto iter = counters_.find(name);
+  if (iter == counters_.end()) {
+    return nullptr;
+  }
+  return CounterSharedPtr(*iter);
+}
+
+GaugeSharedPtr AllocatorImpl::findGauge(StatName name) const {
+  Thread::LockGuard lock(mutex_);
+  auto iter = gauges_.find(name);
+  if (iter == gauges_.end()) {
+    return nullptr;
+  }
+  return GaugeSharedPtr(*iter);
+}
+
 bool AllocatorImpl::isMutexLockedForTest() {
   bool locked = mutex_.tryLock();
   if (locked) {
@@ -30,6 +30,8 @@ public:
                            Gauge::ImportMode import_mode) override;
   TextReadoutSharedPtr makeTextReadout(StatName name, StatName tag_extracted_name,
                                        const StatNameTagVector& stat_name_tags) override;
+  CounterSharedPtr findCounter(StatName name) const override;
+  GaugeSharedPtr findGauge(StatName name) const override;
   SymbolTable& symbolTable() override { return symbol_table_; }
   const SymbolTable& constSymbolTable() const override { return symbol_table_; }
 
@@ -72,7 +74,7 @@ private:
   // alloc() and free() operations. Although alloc() operations are called under existing locking,
   // free() operations are made from the destructors of the individual stat objects, which are not
   // protected by locks.
-  Thread::MutexBasicLockable mutex_;
+  mutable Thread::MutexBasicLockable mutex_;
 
   Thread::ThreadSynchronizer sync_;
 };
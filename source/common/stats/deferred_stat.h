@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A handle to a stat which is only instantiated in its scope the first time it is touched.
+ * Until then the handle costs a scope reference, a StatName and a pointer, and the stat does not
+ * exist in the store, so it is neither visible from the admin endpoints nor flushed to sinks.
+ *
+ * Instantiation is thread-safe: two threads racing on the first touch of the same handle both
+ * obtain the same stat object, as scopes de-duplicate stats by name, so publishing the pointer
+ * does not need to be exclusive.
+ *
+ * Reading the value of a handle does not instantiate the stat, so that sinks and other readers
+ * which poll every cluster do not defeat the deferral. Instead an uninstantiated handle finds the
+ * stat by its full name, and reads as zero if it does not exist. A handle created for a new
+ * generation of a cluster thus reads, and once touched resolves to, the stat created by the
+ * previous generation, so the value stays continuous across config updates.
+ */
+template <class StatType, class Derived> class DeferredStat {
+public:
+  /**
+   * @return StatType& the underlying stat, instantiating it if this is the first touch.
+   */
+  StatType& get() const {
+    StatType* stat = stat_.load(std::memory_order_acquire);
+    if (stat == nullptr) {
+      stat = &static_cast<const Derived*>(this)->instantiate();
+      stat_.store(stat, std::memory_order_release);
+    }
+    return *stat;
+  }
+
+  /**
+   * Allows the handle to be passed where a plain reference to the stat is expected.
+   */
+  operator StatType&() const { return get(); } // NOLINT(google-explicit-constructor)
+
+  /**
+   * @return bool whether the underlying stat has been instantiated.
+   */
+  bool instantiated() const { return stat_.load(std::memory_order_acquire) != nullptr; }
+
+protected:
+  DeferredStat(Scope& scope, StatName name) : scope_(scope), name_(name) {}
+  DeferredStat(const DeferredStat& that)
+      : scope_(that.scope_), name_(that.name_), stat_(that.stat_.load()) {}
+  DeferredStat& operator=(const DeferredStat&) = delete;
+
+  // Joins the scope's prefix to the name, to look the stat up without instantiating it.
+  SymbolTable::StoragePtr fullName() const {
+    return scope_.symbolTable().join({scope_.prefix(), name_});
+  }
+
+  Scope& scope_;
+  const StatName name_;
+
+private:
+  mutable std::atomic<StatType*> stat_{nullptr};
+};
+
+class DeferredCounter : public DeferredStat<Counter, DeferredCounter> {
+public:
+  DeferredCounter(Scope& scope, StatName name, bool deferred) : DeferredStat(scope, name) {
+    if (!deferred) {
+      get();
+    }
+  }
+
+  void add(uint64_t amount) const {
+    // Adding zero is not a touch; the counter would stay unused anyway.
+    if (amount != 0 || instantiated()) {
+      get().add(amount);
+    }
+  }
+  void inc() const { get().inc(); }
+  bool used() const {
+    if (instantiated()) {
+      return get().used();
+    }
+    const SymbolTable::StoragePtr full_name = fullName();
+    const CounterOptConstRef counter = scope_.findCounter(StatName(full_name.get()));
+    return counter.has_value() && counter->get().used();
+  }
+  uint64_t value() const {
+    if (instantiated()) {
+      return get().value();
+    }
+    const SymbolTable::StoragePtr full_name = fullName();
+    const CounterOptConstRef counter = scope_.findCounter(StatName(full_name.get()));
+    return counter.has_value() ? counter->get().value() : 0;
+  }
+
+  // Creates, or finds, the stat in the scope. Called by DeferredStat on first touch.
+  Counter& instantiate() const { return scope_.counterFromStatName(name_); }
+};
+
+class DeferredGauge : public DeferredStat<Gauge, DeferredGauge> {
+public:
+  DeferredGauge(Scope& scope, StatName name, Gauge::ImportMode import_mode, bool deferred)
+      : DeferredStat(scope, name), import_mode_(import_mode) {
+    if (!deferred) {
+      get();
+    }
+  }
+
+  void add(uint64_t amount) const { get().add(amount); }
+  void dec() const { get().dec(); }
+  void inc() const { get().inc(); }
+  void set(uint64_t value) const { get().set(value); }
+  void sub(uint64_t amount) const { get().sub(amount); }
+  uint64_t value() const {
+    if (instantiated()) {
+      return get().value();
+    }
+    const SymbolTable::StoragePtr full_name = fullName();
+    const GaugeOptConstRef gauge = scope_.findGauge(StatName(full_name.get()));
+    return gauge.has_value() ? gauge->get().value() : 0;
+  }
+
+  // Creates, or finds, the stat in the scope. Called by DeferredStat on first touch.
+  Gauge& instantiate() const { return scope_.gaugeFromStatName(name_, import_mode_); }
+
+private:
+  const Gauge::ImportMode import_mode_;
+};
+
+class DeferredHistogram : public DeferredStat<Histogram, DeferredHistogram> {
+public:
+  DeferredHistogram(Scope& scope, StatName name, Histogram::Unit unit, bool deferred)
+      : DeferredStat(scope, name), unit_(unit) {
+    if (!deferred) {
+      get();
+    }
+  }
+
+  void recordValue(uint64_t value) const { get().recordValue(value); }
+  Histogram::Unit unit() const { return unit_; }
+
+  // Creates, or finds, the stat in the scope. Called by DeferredStat on first touch.
+  Histogram& instantiate() const { return scope_.histogramFromStatName(name_, unit_); }
+
+private:
+  const Histogram::Unit unit_;
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -49,6 +49,7 @@ public:
   GaugeOptConstRef findGauge(StatName name) const override;
   HistogramOptConstRef findHistogram(StatName name) const override;
   TextReadoutOptConstRef findTextReadout(StatName name) const override;
+  StatName prefix() const override { return prefix_.statName(); }
 
   const SymbolTable& constSymbolTable() const final { return scope_.constSymbolTable(); }
   SymbolTable& symbolTable() final { return scope_.symbolTable(); }
@@ -17,6 +17,7 @@ public:
 
   SymbolTable& symbolTable() override { return symbol_table_; }
   const SymbolTable& constSymbolTable() const override { return symbol_table_; }
+  StatName prefix() const override { return StatName(); }
 
 private:
   SymbolTable& symbol_table_;
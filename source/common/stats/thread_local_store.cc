@@ -750,11 +750,33 @@ TextReadout& ThreadLocalStoreImpl::ScopeImpl::textReadoutFromStatNameWithTags(
 }
 
 CounterOptConstRef ThreadLocalStoreImpl::ScopeImpl::findCounter(StatName name) const {
-  return findStatLockHeld<Counter>(name, central_cache_->counters_);
+  Thread::LockGuard lock(parent_.lock_);
+  CounterOptConstRef counter = findStatLockHeld<Counter>(name, central_cache_->counters_);
+  if (counter.has_value()) {
+    return counter;
+  }
+  // The counter may still be referenced by another scope of the same prefix, e.g. the one of the
+  // previous generation of a cluster, which the allocator shares by name with this scope. The
+  // reference stays valid as long as that scope does.
+  CounterSharedPtr allocated = parent_.alloc_.findCounter(name);
+  if (allocated == nullptr) {
+    return absl::nullopt;
+  }
+  return std::cref(*allocated);
 }
 
 GaugeOptConstRef ThreadLocalStoreImpl::ScopeImpl::findGauge(StatName name) const {
-  return findStatLockHeld<Gauge>(name, central_cache_->gauges_);
+  Thread::LockGuard lock(parent_.lock_);
+  GaugeOptConstRef gauge = findStatLockHeld<Gauge>(name, central_cache_->gauges_);
+  if (gauge.has_value()) {
+    return gauge;
+  }
+  // See findCounter().
+  GaugeSharedPtr allocated = parent_.alloc_.findGauge(name);
+  if (allocated == nullptr) {
+    return absl::nullopt;
+  }
+  return std::cref(*allocated);
 }
 
 HistogramOptConstRef ThreadLocalStoreImpl::ScopeImpl::findHistogram(StatName name) const {
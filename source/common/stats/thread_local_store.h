@@ -192,7 +192,7 @@ public:
     CounterOptConstRef found_counter;
     Thread::LockGuard lock(lock_);
     for (ScopeImpl* scope : scopes_) {
-      found_counter = scope->findCounter(name);
+      found_counter = scope->findStatLockHeld<Counter>(name, scope->central_cache_->counters_);
       if (found_counter.has_value()) {
         return found_counter;
       }
@@ -203,7 +203,7 @@ public:
     GaugeOptConstRef found_gauge;
     Thread::LockGuard lock(lock_);
     for (ScopeImpl* scope : scopes_) {
-      found_gauge = scope->findGauge(name);
+      found_gauge = scope->findStatLockHeld<Gauge>(name, scope->central_cache_->gauges_);
       if (found_gauge.has_value()) {
         return found_gauge;
       }
@@ -232,6 +232,7 @@ public:
     }
     return absl::nullopt;
   }
+  StatName prefix() const override { return default_scope_->prefix(); }
 
   bool iterate(const IterateFn<Counter>& fn) const override { return iterHelper(fn); }
   bool iterate(const IterateFn<Gauge>& fn) const override { return iterHelper(fn); }
@@ -394,6 +395,7 @@ private:
     GaugeOptConstRef findGauge(StatName name) const override;
     HistogramOptConstRef findHistogram(StatName name) const override;
     TextReadoutOptConstRef findTextReadout(StatName name) const override;
+    StatName prefix() const override { return prefix_.statName(); }
 
     template <class StatType>
     using MakeStatFn = std::function<RefcountPtr<StatType>(
@@ -11,6 +11,7 @@
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/tracing/trace_reason.h"
 
+#include "source/common/common/arena.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/macros.h"
@@ -46,14 +47,17 @@ struct StreamInfoImpl : public StreamInfo {
       : StreamInfoImpl(protocol, time_source, downstream_address_provider,
                        std::make_shared<FilterStateImpl>(FilterState::LifeSpan::FilterChain)) {}
 
+  // If an arena is supplied, the filter state of the stream is allocated in it. The arena must
+  // then outlive all the references to the filter state.
   StreamInfoImpl(Http::Protocol protocol, TimeSource& time_source,
                  const Network::SocketAddressProviderSharedPtr& downstream_address_provider,
-                 FilterStateSharedPtr parent_filter_state, FilterState::LifeSpan life_span)
+                 FilterStateSharedPtr parent_filter_state, FilterState::LifeSpan life_span,
+                 Arena* arena = nullptr)
       : StreamInfoImpl(
             protocol, time_source, downstream_address_provider,
-            std::make_shared<FilterStateImpl>(
+            createFilterState(
                 FilterStateImpl::LazyCreateAncestor(std::move(parent_filter_state), life_span),
-                FilterState::LifeSpan::FilterChain)) {}
+                arena)) {}
 
   SystemTime startTime() const override { return start_time_; }
 
@@ -303,6 +307,17 @@ struct StreamInfoImpl : public StreamInfo {
   std::string route_name_;
 
 private:
+  static FilterStateSharedPtr
+  createFilterState(FilterStateImpl::LazyCreateAncestor lazy_create_ancestor, Arena* arena) {
+    if (arena != nullptr) {
+      return std::allocate_shared<FilterStateImpl>(ArenaAllocator<FilterStateImpl>(*arena),
+                                                   std::move(lazy_create_ancestor),
+                                                   FilterState::LifeSpan::FilterChain);
+    }
+    return std::make_shared<FilterStateImpl>(std::move(lazy_create_ancestor),
+                                             FilterState::LifeSpan::FilterChain);
+  }
+
   static Network::SocketAddressProviderSharedPtr emptyDownstreamAddressProvider() {
     MUTABLE_CONSTRUCT_ON_FIRST_USE(
         Network::SocketAddressProviderSharedPtr,
@@ -0,0 +1,184 @@
+#include "source/common/tracing/tail_sampling_impl.h"
+
+#include <algorithm>
+
+#include "source/common/common/empty_string.h"
+#include "source/common/tracing/common_values.h"
+#include "source/common/tracing/null_span_impl.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Tracing {
+
+TailSampler::TailSampler(const TailSamplingConfig& config, const std::string& stat_prefix,
+                         Stats::Scope& scope, TimeSource& time_source)
+    : config_(config), stats_{ALL_TAIL_SAMPLING_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix),
+                                                      POOL_GAUGE_PREFIX(scope, stat_prefix))},
+      time_source_(time_source) {}
+
+bool TailSampler::shouldKeep(std::chrono::milliseconds duration, uint64_t max_status_code,
+                             bool error) const {
+  return (config_.min_duration_.has_value() && duration >= config_.min_duration_.value()) ||
+         (config_.min_status_code_.has_value() &&
+          max_status_code >= config_.min_status_code_.value()) ||
+         (config_.keep_errors_ && error);
+}
+
+bool TailSampler::tryBufferSpan() {
+  // Workers may race past the limit by a span each, which is fine for a memory cap.
+  if (stats_.spans_buffered_.value() >= config_.max_buffered_spans_) {
+    stats_.spans_overflowed_.inc();
+    return false;
+  }
+  stats_.spans_buffered_.inc();
+  return true;
+}
+
+TailSampledTrace::TailSampledTrace(TailSamplerSharedPtr sampler, MonotonicTime start_time)
+    : sampler_(std::move(sampler)), start_time_(start_time) {}
+
+TailSampledTrace::~TailSampledTrace() {
+  // The request's own span was never finished, so there is no complete trace to keep.
+  if (decision_ == Decision::Pending) {
+    decide(Decision::Discard);
+  }
+}
+
+void TailSampledTrace::onTag(absl::string_view name, absl::string_view value) {
+  if (name == Tags::get().HttpStatusCode) {
+    uint64_t status_code;
+    if (absl::SimpleAtoi(value, &status_code)) {
+      max_status_code_ = std::max(max_status_code_, status_code);
+    }
+  } else if (name == Tags::get().Error && value == Tags::get().True) {
+    error_ = true;
+  }
+}
+
+void TailSampledTrace::onSpanFinished(SpanPtr&& span, bool root) {
+  if (decision_ != Decision::Pending) {
+    // E.g. a shadowed request which completed after the request it was shadowing.
+    finish(*span, decision_);
+    return;
+  }
+
+  if (!root) {
+    if (sampler_->tryBufferSpan()) {
+      buffered_spans_.push_back(std::move(span));
+    } else {
+      finish(*span, Decision::Discard);
+    }
+    return;
+  }
+
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      sampler_->timeSource().monotonicTime() - start_time_);
+  const Decision decision = sampler_->shouldKeep(duration, max_status_code_, error_)
+                                ? Decision::Keep
+                                : Decision::Discard;
+  decide(decision);
+  finish(*span, decision);
+}
+
+void TailSampledTrace::decide(Decision decision) {
+  decision_ = decision;
+  if (decision == Decision::Keep) {
+    sampler_->stats().traces_kept_.inc();
+  } else {
+    sampler_->stats().traces_discarded_.inc();
+  }
+
+  for (SpanPtr& span : buffered_spans_) {
+    finish(*span, decision);
+  }
+  sampler_->releaseBufferedSpans(buffered_spans_.size());
+  buffered_spans_.clear();
+}
+
+void TailSampledTrace::finish(Span& span, Decision decision) {
+  // Drivers report their spans when finished, or even when destroyed, unless they are unsampled.
+  if (decision == Decision::Discard) {
+    span.setSampled(false);
+  }
+  span.finishSpan();
+}
+
+void TailSampledSpan::setOperation(absl::string_view operation) {
+  if (span_ != nullptr) {
+    span_->setOperation(operation);
+  }
+}
+
+void TailSampledSpan::setTag(absl::string_view name, absl::string_view value) {
+  if (span_ != nullptr) {
+    trace_->onTag(name, value);
+    span_->setTag(name, value);
+  }
+}
+
+void TailSampledSpan::log(SystemTime timestamp, const std::string& event) {
+  if (span_ != nullptr) {
+    span_->log(timestamp, event);
+  }
+}
+
+void TailSampledSpan::finishSpan() {
+  if (span_ != nullptr) {
+    // The trace takes ownership of the driver's span, to buffer it or finish it.
+    SpanPtr span = std::move(span_);
+    trace_->onSpanFinished(std::move(span), root_);
+  }
+}
+
+void TailSampledSpan::injectContext(TraceContext& trace_context) {
+  if (span_ != nullptr) {
+    span_->injectContext(trace_context);
+  }
+}
+
+SpanPtr TailSampledSpan::spawnChild(const Config& config, const std::string& name,
+                                    SystemTime start_time) {
+  if (span_ == nullptr) {
+    return std::make_unique<NullSpan>();
+  }
+  return std::make_unique<TailSampledSpan>(span_->spawnChild(config, name, start_time), trace_,
+                                           false);
+}
+
+void TailSampledSpan::setSampled(bool sampled) {
+  if (span_ != nullptr) {
+    span_->setSampled(sampled);
+  }
+}
+
+std::string TailSampledSpan::getBaggage(absl::string_view key) {
+  return span_ != nullptr ? span_->getBaggage(key) : EMPTY_STRING;
+}
+
+void TailSampledSpan::setBaggage(absl::string_view key, absl::string_view value) {
+  if (span_ != nullptr) {
+    span_->setBaggage(key, value);
+  }
+}
+
+std::string TailSampledSpan::getTraceIdAsHex() const {
+  return span_ != nullptr ? span_->getTraceIdAsHex() : EMPTY_STRING;
+}
+
+SpanPtr TailSamplingHttpTracer::startSpan(const Config& config,
+                                          Http::RequestHeaderMap& request_headers,
+                                          const StreamInfo::StreamInfo& stream_info,
+                                          const Tracing::Decision tracing_decision) {
+  SpanPtr span = parent_->startSpan(config, request_headers, stream_info, tracing_decision);
+  if (!tracing_decision.traced) {
+    // The driver will not report the spans of this request anyway.
+    return span;
+  }
+  return std::make_unique<TailSampledSpan>(
+      std::move(span),
+      std::make_shared<TailSampledTrace>(sampler_, stream_info.startTimeMonotonic()), true);
+}
+
+} // namespace Tracing
+} // namespace Envoy
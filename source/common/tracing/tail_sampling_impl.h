@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/tracing/http_tracer.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Tracing {
+
+/**
+ * All tail sampling stats. @see stats_macros.h
+ */
+#define ALL_TAIL_SAMPLING_STATS(COUNTER, GAUGE)                                                    \
+  COUNTER(spans_overflowed)                                                                        \
+  COUNTER(traces_discarded)                                                                        \
+  COUNTER(traces_kept)                                                                             \
+  GAUGE(spans_buffered, Accumulate)
+
+/**
+ * Struct definition for all tail sampling stats. @see stats_macros.h
+ */
+struct TailSamplingStats {
+  ALL_TAIL_SAMPLING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Predicates and limits of a tail sampler. A trace is kept if it matches any of the predicates.
+ */
+struct TailSamplingConfig {
+  // Keep the traces of requests which lasted at least this long.
+  absl::optional<std::chrono::milliseconds> min_duration_;
+  // Keep the traces with a span whose response status code is at least this value.
+  absl::optional<uint64_t> min_status_code_;
+  // Keep the traces with a span tagged as an error.
+  bool keep_errors_{};
+  // The maximum number of finished spans buffered while waiting for the decision on their trace.
+  uint32_t max_buffered_spans_{10000};
+};
+
+/**
+ * The state shared by all the traces sampled by a TailSamplingHttpTracer. It outlives the tracer
+ * as long as spans of its traces are alive.
+ */
+class TailSampler {
+public:
+  TailSampler(const TailSamplingConfig& config, const std::string& stat_prefix,
+              Stats::Scope& scope, TimeSource& time_source);
+
+  /**
+   * @return bool whether a trace with the given properties should be kept.
+   */
+  bool shouldKeep(std::chrono::milliseconds duration, uint64_t max_status_code, bool error) const;
+
+  /**
+   * Accounts for a span about to be buffered.
+   * @return bool false if the buffer is full, in which case the span must be discarded.
+   */
+  bool tryBufferSpan();
+
+  /**
+   * Accounts for spans which are no longer buffered.
+   */
+  void releaseBufferedSpans(uint64_t count) { stats_.spans_buffered_.sub(count); }
+
+  TailSamplingStats& stats() { return stats_; }
+  TimeSource& timeSource() { return time_source_; }
+
+private:
+  const TailSamplingConfig config_;
+  TailSamplingStats stats_;
+  TimeSource& time_source_;
+};
+
+using TailSamplerSharedPtr = std::shared_ptr<TailSampler>;
+
+/**
+ * The spans of a single traced request, which all share the decision taken when the request's own
+ * span finishes. Spans finished before the decision are buffered; spans finished after it are
+ * reported or discarded straight away.
+ */
+class TailSampledTrace {
+public:
+  TailSampledTrace(TailSamplerSharedPtr sampler, MonotonicTime start_time);
+  ~TailSampledTrace();
+
+  /**
+   * Records the predicates a tag may match.
+   */
+  void onTag(absl::string_view name, absl::string_view value);
+
+  /**
+   * Takes the decision on the trace when the request's own span finishes, or buffers a child span
+   * until then.
+   */
+  void onSpanFinished(SpanPtr&& span, bool root);
+
+private:
+  enum class Decision { Pending, Keep, Discard };
+
+  void decide(Decision decision);
+  static void finish(Span& span, Decision decision);
+
+  TailSamplerSharedPtr sampler_;
+  const MonotonicTime start_time_;
+  std::vector<SpanPtr> buffered_spans_;
+  uint64_t max_status_code_{0};
+  bool error_{false};
+  Decision decision_{Decision::Pending};
+};
+
+using TailSampledTraceSharedPtr = std::shared_ptr<TailSampledTrace>;
+
+/**
+ * A span of the configured driver, whose finishing is deferred until the decision on its trace.
+ * Once finished, the driver's span belongs to the trace, which may already have destroyed it, so
+ * the span behaves as a NullSpan.
+ */
+class TailSampledSpan : public Span {
+public:
+  TailSampledSpan(SpanPtr&& span, TailSampledTraceSharedPtr trace, bool root)
+      : span_(std::move(span)), trace_(std::move(trace)), root_(root) {}
+
+  // Tracing::Span
+  void setOperation(absl::string_view operation) override;
+  void setTag(absl::string_view name, absl::string_view value) override;
+  void log(SystemTime timestamp, const std::string& event) override;
+  void finishSpan() override;
+  void injectContext(TraceContext& trace_context) override;
+  SpanPtr spawnChild(const Config& config, const std::string& name,
+                     SystemTime start_time) override;
+  void setSampled(bool sampled) override;
+  std::string getBaggage(absl::string_view key) override;
+  void setBaggage(absl::string_view key, absl::string_view value) override;
+  std::string getTraceIdAsHex() const override;
+
+private:
+  // The driver's span, until it is handed off to the trace by finishSpan().
+  SpanPtr span_;
+  TailSampledTraceSharedPtr trace_;
+  const bool root_;
+};
+
+/**
+ * An HttpTracer which tail samples the spans of another one: the spans of each traced request are
+ * only reported to the driver if the trace matches one of the configured predicates once the
+ * request completes.
+ */
+class TailSamplingHttpTracer : public HttpTracer {
+public:
+  TailSamplingHttpTracer(HttpTracerSharedPtr parent, TailSamplerSharedPtr sampler)
+      : parent_(std::move(parent)), sampler_(std::move(sampler)) {}
+
+  // Tracing::HttpTracer
+  SpanPtr startSpan(const Config& config, Http::RequestHeaderMap& request_headers,
+                    const StreamInfo::StreamInfo& stream_info,
+                    const Tracing::Decision tracing_decision) override;
+
+private:
+  const HttpTracerSharedPtr parent_;
+  const TailSamplerSharedPtr sampler_;
+};
+
+} // namespace Tracing
+} // namespace Envoy
@@ -314,6 +314,7 @@ public:
   const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const override {
     return cluster_timeout_budget_stat_names_;
   }
+  bool deferStatCreation() const override { return defer_stat_creation_; }
 
 protected:
   virtual void postThreadLocalDrainConnections(const Cluster& cluster,
@@ -618,6 +619,7 @@ private:
   ClusterCircuitBreakersStatNames cluster_circuit_breakers_stat_names_;
   ClusterRequestResponseSizeStatNames cluster_request_response_size_stat_names_;
   ClusterTimeoutBudgetStatNames cluster_timeout_budget_stat_names_;
+  const bool defer_stat_creation_;
 
   Config::SubscriptionFactoryImpl subscription_factory_;
   ClusterSet primary_clusters_;
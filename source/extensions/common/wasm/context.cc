@@ -884,9 +884,8 @@ BufferInterface* Context::getBuffer(WasmBufferType type) {
   case WasmBufferType::HttpCallResponseBody:
     response = rootContext()->http_call_response_;
     if (response) {
-      auto& body = (*response)->body();
-      return buffer_.set(
-          std::string_view(static_cast<const char*>(body.linearize(body.length())), body.length()));
+      // Copied out slice by slice into VM memory, without linearizing the body first.
+      return buffer_.set(static_cast<const ::Envoy::Buffer::Instance*>(&(*response)->body()));
     }
     return nullptr;
   case WasmBufferType::GrpcReceiveBuffer:
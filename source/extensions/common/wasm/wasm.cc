@@ -5,10 +5,14 @@
 
 #include "envoy/event/deferred_deletable.h"
 
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/hex.h"
 #include "source/common/common/logger.h"
+#include "source/common/crypto/utility.h"
 #include "source/extensions/common/wasm/plugin.h"
 #include "source/extensions/common/wasm/wasm_extension.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 
 #define WASM_CONTEXT(_c)                                                                           \
@@ -36,6 +40,105 @@ struct CodeCacheEntry {
   MonotonicTime fetch_time;
 };
 
+// Returns the path of the file persisting the remote code in the code cache directory, or an empty
+// string if the sha256 of the remote data source is not a SHA-256 digest, as it would otherwise
+// name a file anywhere in the file system.
+std::string codeCacheFilePath(const envoy::extensions::wasm::v3::VmConfig& vm_config) {
+  const std::string& sha256 = vm_config.code().remote().sha256();
+  if (sha256.size() != 64 || !std::all_of(sha256.begin(), sha256.end(), absl::ascii_isxdigit)) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Not using the Wasm code cache directory: invalid sha256 {}", sha256);
+    return EMPTY_STRING;
+  }
+  return absl::StrCat(vm_config.code_cache_directory(), "/", sha256, ".wasm");
+}
+
+// Returns the remote code persisted in the code cache directory, or an empty string if there is
+// none or it does not match the sha256 of the remote data source.
+std::string readCodeCacheFile(const envoy::extensions::wasm::v3::VmConfig& vm_config,
+                              Api::Api& api) {
+  const std::string path = codeCacheFilePath(vm_config);
+  if (path.empty() || !api.fileSystem().fileExists(path)) {
+    return EMPTY_STRING;
+  }
+  std::string code;
+  try {
+    code = api.fileSystem().fileReadToEnd(path);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Unable to read Wasm code cache file {}: {}", path, e.what());
+    return EMPTY_STRING;
+  }
+  Buffer::OwnedImpl buffer(code);
+  if (Hex::encode(Envoy::Common::Crypto::UtilitySingleton::get().getSha256Digest(buffer)) !=
+      vm_config.code().remote().sha256()) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Ignoring Wasm code cache file {}: sha256 mismatch", path);
+    return EMPTY_STRING;
+  }
+  return code;
+}
+
+// Persists fetched remote code, which matches the sha256, in the code cache directory. The code is
+// written to a temporary file which then replaces the file of the code, so that the file is never
+// seen partially written, and a corrupt file is replaced.
+void writeCodeCacheFile(const envoy::extensions::wasm::v3::VmConfig& vm_config, Api::Api& api,
+                        absl::string_view code) {
+  const std::string path = codeCacheFilePath(vm_config);
+  if (path.empty()) {
+    return;
+  }
+  const std::string temporary_path = absl::StrCat(path, ".", api.randomGenerator().uuid(), ".tmp");
+  Filesystem::FilePtr file = api.fileSystem().createFile(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, temporary_path});
+  const Api::IoCallBoolResult open_result = file->open(
+      Filesystem::FlagSet{1 << Filesystem::File::Operation::Write |
+                          1 << Filesystem::File::Operation::Create});
+  if (!open_result.rc_) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Unable to create Wasm code cache file {}: {}", temporary_path,
+                        open_result.err_->getErrorDetails());
+    return;
+  }
+  bool written = true;
+  while (!code.empty()) {
+    const Api::IoCallSizeResult write_result = file->write(code);
+    if (write_result.rc_ <= 0) {
+      ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                          "Unable to write Wasm code cache file {}: {}", temporary_path,
+                          write_result.err_ != nullptr ? write_result.err_->getErrorDetails()
+                                                       : "no data written");
+      written = false;
+      break;
+    }
+    code.remove_prefix(write_result.rc_);
+  }
+  const Api::IoCallBoolResult close_result = file->close();
+  if (written && !close_result.rc_) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Unable to close Wasm code cache file {}: {}", temporary_path,
+                        close_result.err_->getErrorDetails());
+    written = false;
+  }
+  if (written) {
+    const Api::IoCallBoolResult rename_result = api.fileSystem().renameFile(temporary_path, path);
+    if (!rename_result.rc_) {
+      ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                          "Unable to rename Wasm code cache file {} to {}: {}", temporary_path,
+                          path, rename_result.err_->getErrorDetails());
+      written = false;
+    }
+  }
+  if (!written) {
+    const Api::IoCallBoolResult remove_result = api.fileSystem().removeFile(temporary_path);
+    if (!remove_result.rc_) {
+      ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                          "Unable to remove Wasm code cache file {}: {}", temporary_path,
+                          remove_result.err_->getErrorDetails());
+    }
+  }
+}
+
 class RemoteDataFetcherAdapter : public Config::DataFetcher::RemoteDataFetcherCallback,
                                  public Event::DeferredDeletable {
 public:
@@ -362,12 +465,21 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
         wasm_extension->onEvent(WasmExtension::WasmEvent::RemoteLoadCacheHit, plugin);
       }
     } else {
-      fetch = true; // Not in cache, fetch.
+      if (!vm_config.code_cache_directory().empty()) {
+        code = readCodeCacheFile(vm_config, api);
+      }
       auto& e = (*code_cache)[vm_config.code().remote().sha256()];
-      e.in_progress = true;
       e.use_time = e.fetch_time = now;
+      if (!code.empty()) {
+        e.code = code;
+        e.in_progress = false;
+        wasm_extension->onEvent(WasmExtension::WasmEvent::RemoteLoadDiskCacheHit, plugin);
+      } else {
+        fetch = true; // Not in cache, fetch.
+        e.in_progress = true;
+        wasm_extension->onEvent(WasmExtension::WasmEvent::RemoteLoadCacheMiss, plugin);
+      }
       wasm_extension->onRemoteCacheEntriesChanged(code_cache->size());
-      wasm_extension->onEvent(WasmExtension::WasmEvent::RemoteLoadCacheMiss, plugin);
     }
   } else if (vm_config.code().has_local()) {
     code = Config::DataSource::read(vm_config.code().local(), true, api);
@@ -411,8 +523,8 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
 
   if (fetch) {
     auto holder = std::make_shared<std::unique_ptr<Event::DeferredDeletable>>();
-    auto fetch_callback = [vm_config, complete_cb, source, &dispatcher, scope, holder, plugin,
-                           wasm_extension](const std::string& code) {
+    auto fetch_callback = [vm_config, complete_cb, source, &dispatcher, &api, scope, holder,
+                           plugin, wasm_extension](const std::string& code) {
       {
         std::lock_guard<std::mutex> guard(code_cache_mutex);
         auto& e = (*code_cache)[vm_config.code().remote().sha256()];
@@ -427,6 +539,9 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
         }
         wasm_extension->onRemoteCacheEntriesChanged(code_cache->size());
       }
+      if (!code.empty() && !vm_config.code_cache_directory().empty()) {
+        writeCodeCacheFile(vm_config, api, code);
+      }
       // NB: xDS currently does not support failing asynchronously, so we fail immediately
       // if remote Wasm code is not cached and do a background fill.
       if (!vm_config.nack_on_code_cache_miss()) {
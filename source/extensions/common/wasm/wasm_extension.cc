@@ -84,6 +84,9 @@ void EnvoyWasm::onEvent(WasmEvent event, const PluginSharedPtr&) {
   case WasmEvent::RemoteLoadCacheFetchFailure:
     create_wasm_stats_->remote_load_fetch_failures_.inc();
     break;
+  case WasmEvent::RemoteLoadDiskCacheHit:
+    create_wasm_stats_->remote_load_disk_cache_hits_.inc();
+    break;
   default:
     break;
   }
@@ -20,6 +20,7 @@ namespace Wasm {
 #define CREATE_WASM_STATS(COUNTER, GAUGE)                                                          \
   COUNTER(remote_load_cache_hits)                                                                  \
   COUNTER(remote_load_cache_negative_hits)                                                         \
+  COUNTER(remote_load_disk_cache_hits)                                                             \
   COUNTER(remote_load_cache_misses)                                                                \
   COUNTER(remote_load_fetch_successes)                                                             \
   COUNTER(remote_load_fetch_failures)                                                              \
@@ -63,6 +64,7 @@ public:
     RemoteLoadCacheMiss,
     RemoteLoadCacheFetchSuccess,
     RemoteLoadCacheFetchFailure,
+    RemoteLoadDiskCacheHit,
     UnableToCreateVM,
     UnableToCloneVM,
     MissingFunction,
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+
+// The advanced parameters, e.g. the ones of digested dictionaries, are only exposed to the
+// applications linking zstd statically, which Envoy does.
+#define ZSTD_STATIC_LINKING_ONLY
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Common {
+
+// Keeps a `Zstd` compression stream's state.
+struct ZstdContext {
+  ZstdContext(const uint32_t chunk_size);
+
+  void setInput(const Buffer::RawSlice& input_slice);
+  void updateOutput(Buffer::Instance& output_buffer);
+  void finalizeOutput(Buffer::Instance& output_buffer);
+
+  const uint32_t chunk_size_;
+  std::unique_ptr<uint8_t[]> chunk_ptr_;
+  ZSTD_inBuffer input_;
+  ZSTD_outBuffer output_;
+  // Whether the last call to updateOutput() found the output chunk full and flushed it.
+  bool output_flushed_;
+
+private:
+  void resetOut();
+};
+
+} // namespace Common
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,56 @@
+#include "source/extensions/compression/zstd/compressor/config.h"
+
+#include "source/common/config/datasource.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+namespace {
+// Default compression level.
+const uint32_t DefaultCompressionLevel = 3;
+
+// Default zstd chunk size.
+const uint32_t DefaultChunkSize = 4096;
+} // namespace
+
+// The values of the Strategy enum match the ones of ZSTD_strategy, DEFAULT being 0.
+ZstdCompressorFactory::ZstdCompressorFactory(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd& zstd, Api::Api& api)
+    : chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)),
+      compression_level_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, compression_level, DefaultCompressionLevel)),
+      enable_checksum_(zstd.enable_checksum()), strategy_(zstd.strategy()),
+      window_log_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, window_log, 0)) {
+  if (zstd.has_dictionary()) {
+    cdict_ = ZstdCompressorImpl::createDictionary(
+        Config::DataSource::read(zstd.dictionary(), false, api), compression_level_, strategy_,
+        window_log_);
+  }
+}
+
+Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompressor() {
+  return std::make_unique<ZstdCompressorImpl>(compression_level_, enable_checksum_, strategy_,
+                                              window_log_, cdict_, chunk_size_);
+}
+
+Envoy::Compression::Compressor::CompressorFactoryPtr
+ZstdCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<ZstdCompressorFactory>(proto_config, context.api());
+}
+
+/**
+ * Static registration for the zstd compressor library. @see NamedCompressorLibraryConfigFactory.
+ */
+REGISTER_FACTORY(ZstdCompressorLibraryFactory,
+                 Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory);
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,117 @@
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+
+#include "envoy/common/exception.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+ZstdCompressorImpl::ZstdCompressorImpl(const uint32_t compression_level,
+                                       const bool enable_checksum, const uint32_t strategy,
+                                       const uint32_t window_log, ZstdCDictSharedPtr cdict,
+                                       const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, cdict_(std::move(cdict)), cctx_(ZSTD_createCCtx(), &ZSTD_freeCCtx) {
+  RELEASE_ASSERT(cctx_ != nullptr, "unable to create zstd compression context");
+
+  RELEASE_ASSERT(compression_level <= static_cast<uint32_t>(ZSTD_maxCLevel()), "");
+  size_t result =
+      ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_compressionLevel, compression_level);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_checksumFlag, enable_checksum ? 1 : 0);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  RELEASE_ASSERT(strategy <= ZSTD_STRATEGY_MAX, "");
+  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_strategy, strategy);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  RELEASE_ASSERT(window_log == 0 ||
+                     (window_log >= ZSTD_WINDOWLOG_MIN && window_log <= ZSTD_WINDOWLOG_MAX),
+                 "");
+  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_windowLog, window_log);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  if (cdict_ != nullptr) {
+    result = ZSTD_CCtx_refCDict(cctx_.get(), cdict_.get());
+    RELEASE_ASSERT(!ZSTD_isError(result), "");
+  }
+}
+
+ZstdCDictSharedPtr ZstdCompressorImpl::createDictionary(absl::string_view dictionary,
+                                                        const uint32_t compression_level,
+                                                        const uint32_t strategy,
+                                                        const uint32_t window_log) {
+  // The frames compressed with a dictionary reference it by its ID, which raw content lacks.
+  if (ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size()) == 0) {
+    throw EnvoyException("zstd compressor: the dictionary is not a valid zstd dictionary");
+  }
+
+  // The parameters of a digested dictionary supersede the ones of the compression context using
+  // it, thus apply the configured ones to the dictionary.
+  ZSTD_compressionParameters params =
+      ZSTD_getCParams(compression_level, ZSTD_CONTENTSIZE_UNKNOWN, dictionary.size());
+  if (strategy != 0) {
+    params.strategy = static_cast<ZSTD_strategy>(strategy);
+  }
+  if (window_log != 0) {
+    params.windowLog = window_log;
+  }
+
+  ZSTD_CDict* cdict =
+      ZSTD_createCDict_advanced(dictionary.data(), dictionary.size(), ZSTD_dlm_byCopy,
+                                ZSTD_dct_fullDict, params, ZSTD_defaultCMem);
+  if (cdict == nullptr) {
+    throw EnvoyException("zstd compressor: unable to load the dictionary");
+  }
+  return ZstdCDictSharedPtr(cdict, &ZSTD_freeCDict);
+}
+
+void ZstdCompressorImpl::compress(Buffer::Instance& buffer,
+                                  Envoy::Compression::Compressor::State state) {
+  Common::ZstdContext ctx(chunk_size_);
+
+  Buffer::OwnedImpl accumulation_buffer;
+  for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
+    ctx.setInput(input_slice);
+
+    while (ctx.input_.pos < ctx.input_.size) {
+      process(ctx, accumulation_buffer, ZSTD_e_continue);
+    }
+
+    buffer.drain(input_slice.len_);
+  }
+
+  ASSERT(buffer.length() == 0);
+  buffer.move(accumulation_buffer);
+
+  // The compressor's internal buffers can still hold data not flushed to the output chunk, and in
+  // case of the `Finish` operation the compressor adds the frame epilogue to the output. Thus keep
+  // processing until the compressor reports that nothing is left to flush.
+  size_t remaining;
+  do {
+    remaining = process(ctx, buffer,
+                        state == Envoy::Compression::Compressor::State::Finish ? ZSTD_e_end
+                                                                               : ZSTD_e_flush);
+  } while (remaining != 0);
+
+  ctx.finalizeOutput(buffer);
+}
+
+size_t ZstdCompressorImpl::process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer,
+                                   const ZSTD_EndDirective mode) {
+  const size_t result = ZSTD_compressStream2(cctx_.get(), &ctx.output_, &ctx.input_, mode);
+  RELEASE_ASSERT(!ZSTD_isError(result), "unable to compress");
+  ctx.updateOutput(output_buffer);
+  return result;
+}
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
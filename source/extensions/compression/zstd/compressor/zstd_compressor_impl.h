@@ -0,0 +1,69 @@
+#pragma once
+
+#include "envoy/compression/compressor/compressor.h"
+
+#include "source/extensions/compression/zstd/common/base.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+/**
+ * A dictionary digested for compression. It is shared by all the compressors created by a
+ * compressor factory.
+ */
+using ZstdCDictSharedPtr = std::shared_ptr<ZSTD_CDict>;
+
+/**
+ * Implementation of compressor's interface.
+ */
+class ZstdCompressorImpl : public Envoy::Compression::Compressor::Compressor, NonCopyable {
+public:
+  /**
+   * Constructor.
+   * @param compression_level sets compression level. The higher the level, the slower the
+   * compression. @see ZSTD_c_compressionLevel (zstd manual).
+   * @param enable_checksum if true, a checksum of the content is written at the end of each frame.
+   * @param strategy sets the strategy used to search for matches, 0 meaning the default strategy
+   * of the compression level. @see ZSTD_strategy (zstd manual).
+   * @param window_log sets the base two logarithm of the window size, 0 meaning the default
+   * window size of the compression level.
+   * @param cdict a dictionary digested by createDictionary(), or nullptr. A dictionary supersedes
+   * compression_level, strategy and window_log with the parameters it was digested with.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  ZstdCompressorImpl(const uint32_t compression_level, const bool enable_checksum,
+                     const uint32_t strategy, const uint32_t window_log,
+                     ZstdCDictSharedPtr cdict, const uint32_t chunk_size);
+
+  /**
+   * Digests a dictionary once, so that the compressors using it do not have to.
+   * @param dictionary the content of a dictionary, e.g. trained with `zstd --train`.
+   * @return the digested dictionary.
+   * @throw EnvoyException if the dictionary is not a valid zstd dictionary.
+   */
+  static ZstdCDictSharedPtr createDictionary(absl::string_view dictionary,
+                                             const uint32_t compression_level,
+                                             const uint32_t strategy, const uint32_t window_log);
+
+  // Compression::Compressor::Compressor
+  void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
+
+private:
+  size_t process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer,
+                 const ZSTD_EndDirective mode);
+
+  const uint32_t chunk_size_;
+  const ZstdCDictSharedPtr cdict_;
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+};
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,67 @@
+#include "source/extensions/compression/zstd/decompressor/config.h"
+
+#include "source/common/config/datasource.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+namespace {
+
+const uint32_t DefaultChunkSize = 4096;
+
+// The largest window accepted by default. Frames requiring a larger one must be explicitly
+// allowed, as decompressing them requires more memory.
+const uint32_t DefaultWindowLogMax = ZSTD_WINDOWLOG_LIMIT_DEFAULT;
+
+} // namespace
+
+ZstdDecompressorFactory::ZstdDecompressorFactory(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& zstd, Stats::Scope& scope,
+    Api::Api& api)
+    : scope_(scope),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)),
+      window_log_max_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, window_log_max, DefaultWindowLogMax)),
+      ddicts_(createDictionaries(zstd.dictionaries(), api)) {}
+
+Envoy::Compression::Decompressor::DecompressorPtr
+ZstdDecompressorFactory::createDecompressor(const std::string& stats_prefix) {
+  return std::make_unique<ZstdDecompressorImpl>(scope_, stats_prefix, ddicts_, window_log_max_,
+                                                chunk_size_);
+}
+
+ZstdDDictsSharedPtr ZstdDecompressorFactory::createDictionaries(
+    const Protobuf::RepeatedPtrField<envoy::config::core::v3::DataSource>& dictionaries,
+    Api::Api& api) {
+  if (dictionaries.empty()) {
+    return nullptr;
+  }
+
+  auto ddicts = std::make_shared<std::vector<ZstdDDictPtr>>();
+  ddicts->reserve(dictionaries.size());
+  for (const auto& dictionary : dictionaries) {
+    ddicts->push_back(
+        ZstdDecompressorImpl::createDictionary(Config::DataSource::read(dictionary, false, api)));
+  }
+  return ddicts;
+}
+
+Envoy::Compression::Decompressor::DecompressorFactoryPtr
+ZstdDecompressorLibraryFactory::createDecompressorFactoryFromProtoTyped(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<ZstdDecompressorFactory>(proto_config, context.scope(), context.api());
+}
+
+/**
+ * Static registration for the zstd decompressor. @see NamedDecompressorLibraryConfigFactory.
+ */
+REGISTER_FACTORY(ZstdDecompressorLibraryFactory,
+                 Envoy::Compression::Decompressor::NamedDecompressorLibraryConfigFactory);
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,117 @@
+#include "source/extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+
+#include "zstd_errors.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+ZstdDecompressorImpl::ZstdDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
+                                           ZstdDDictsSharedPtr ddicts,
+                                           const uint32_t window_log_max,
+                                           const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, ddicts_(std::move(ddicts)),
+      dctx_(ZSTD_createDCtx(), &ZSTD_freeDCtx), stats_(generateStats(stats_prefix, scope)) {
+  RELEASE_ASSERT(dctx_ != nullptr, "unable to create zstd decompression context");
+
+  RELEASE_ASSERT(window_log_max >= ZSTD_WINDOWLOG_MIN && window_log_max <= ZSTD_WINDOWLOG_MAX, "");
+  size_t result = ZSTD_DCtx_setParameter(dctx_.get(), ZSTD_d_windowLogMax, window_log_max);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  if (ddicts_ == nullptr || ddicts_->empty()) {
+    return;
+  }
+  if (ddicts_->size() > 1) {
+    // Lets the context pick the dictionary of each frame by the dictionary ID written in it.
+    result = ZSTD_DCtx_setParameter(dctx_.get(), ZSTD_d_refMultipleDDicts,
+                                    ZSTD_rmd_refMultipleDDicts);
+    RELEASE_ASSERT(!ZSTD_isError(result), "");
+  }
+  for (const ZstdDDictPtr& ddict : *ddicts_) {
+    result = ZSTD_DCtx_refDDict(dctx_.get(), ddict.get());
+    RELEASE_ASSERT(!ZSTD_isError(result), "");
+  }
+}
+
+ZstdDDictPtr ZstdDecompressorImpl::createDictionary(absl::string_view dictionary) {
+  // Frames reference the dictionary they were compressed with by its ID, which raw content lacks.
+  if (ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size()) == 0) {
+    throw EnvoyException("zstd decompressor: the dictionary is not a valid zstd dictionary");
+  }
+
+  ZstdDDictPtr ddict(ZSTD_createDDict(dictionary.data(), dictionary.size()), &ZSTD_freeDDict);
+  if (ddict == nullptr) {
+    throw EnvoyException("zstd decompressor: unable to load the dictionary");
+  }
+  return ddict;
+}
+
+void ZstdDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+                                      Buffer::Instance& output_buffer) {
+  Common::ZstdContext ctx(chunk_size_);
+
+  for (const Buffer::RawSlice& input_slice : input_buffer.getRawSlices()) {
+    ctx.setInput(input_slice);
+
+    while (ctx.input_.pos < ctx.input_.size) {
+      if (!process(ctx, output_buffer)) {
+        ctx.finalizeOutput(output_buffer);
+        return;
+      }
+    }
+  }
+
+  // Even though the input has been fully consumed by the decompressor it still can hold output
+  // which did not fit the output chunk. Thus keep processing as long as the decompressor fills
+  // whole output chunks.
+  while (ctx.output_flushed_ && process(ctx, output_buffer)) {
+  }
+
+  ctx.finalizeOutput(output_buffer);
+}
+
+bool ZstdDecompressorImpl::process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer) {
+  const size_t result = ZSTD_decompressStream(dctx_.get(), &ctx.output_, &ctx.input_);
+  if (ZSTD_isError(result)) {
+    ENVOY_LOG(trace, "zstd decompression error: {}", ZSTD_getErrorName(result));
+    chargeErrorStats(result);
+    return false;
+  }
+
+  ctx.updateOutput(output_buffer);
+
+  return true;
+}
+
+void ZstdDecompressorImpl::chargeErrorStats(const size_t result) {
+  switch (ZSTD_getErrorCode(result)) {
+  case ZSTD_error_dictionary_corrupted:
+  case ZSTD_error_dictionary_wrong:
+    stats_.zstd_dictionary_error_.inc();
+    break;
+  case ZSTD_error_checksum_wrong:
+    stats_.zstd_checksum_wrong_error_.inc();
+    break;
+  case ZSTD_error_memory_allocation:
+    stats_.zstd_memory_error_.inc();
+    break;
+  case ZSTD_error_frameParameter_windowTooLarge:
+    stats_.zstd_window_too_large_error_.inc();
+    break;
+  default:
+    stats_.zstd_generic_error_.inc();
+    break;
+  }
+}
+
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
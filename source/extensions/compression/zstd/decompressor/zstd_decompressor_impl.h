@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+
+#include "envoy/compression/decompressor/decompressor.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/compression/zstd/common/base.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+/**
+ * All zstd decompressor stats. @see stats_macros.h
+ */
+#define ALL_ZSTD_DECOMPRESSOR_STATS(COUNTER)                                                       \
+  COUNTER(zstd_generic_error)                                                                      \
+  COUNTER(zstd_dictionary_error)                                                                   \
+  COUNTER(zstd_checksum_wrong_error)                                                               \
+  COUNTER(zstd_memory_error)                                                                       \
+  COUNTER(zstd_window_too_large_error)
+
+/**
+ * Struct definition for zstd decompressor stats. @see stats_macros.h
+ */
+struct ZstdDecompressorStats {
+  ALL_ZSTD_DECOMPRESSOR_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A dictionary digested for decompression.
+ */
+using ZstdDDictPtr = std::unique_ptr<ZSTD_DDict, decltype(&ZSTD_freeDDict)>;
+
+/**
+ * The dictionaries of a decompressor factory, shared by all the decompressors it creates.
+ */
+using ZstdDDictsSharedPtr = std::shared_ptr<const std::vector<ZstdDDictPtr>>;
+
+/**
+ * Implementation of decompressor's interface.
+ */
+class ZstdDecompressorImpl : public Envoy::Compression::Decompressor::Decompressor,
+                             public Logger::Loggable<Logger::Id::decompression>,
+                             NonCopyable {
+public:
+  /**
+   * Constructor.
+   * @param ddicts the dictionaries the compressed frames may reference by their ID, or nullptr.
+   * @param window_log_max the base two logarithm of the largest window size accepted. Frames
+   * requiring a larger window are rejected.
+   * @param chunk_size amount of memory reserved for the decompressor output.
+   */
+  ZstdDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
+                       ZstdDDictsSharedPtr ddicts, const uint32_t window_log_max,
+                       const uint32_t chunk_size);
+
+  /**
+   * Digests a dictionary once, so that the decompressors using it do not have to.
+   * @param dictionary the content of a dictionary, e.g. trained with `zstd --train`.
+   * @return the digested dictionary.
+   * @throw EnvoyException if the dictionary is not a valid zstd dictionary.
+   */
+  static ZstdDDictPtr createDictionary(absl::string_view dictionary);
+
+  // Compression::Decompressor::Decompressor
+  void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
+
+private:
+  friend class ZstdDecompressorStatsTest;
+  static ZstdDecompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+    return ZstdDecompressorStats{ALL_ZSTD_DECOMPRESSOR_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+  }
+
+  bool process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer);
+  void chargeErrorStats(const size_t result);
+
+  const uint32_t chunk_size_;
+  const ZstdDDictsSharedPtr ddicts_;
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx_;
+  const ZstdDecompressorStats stats_;
+};
+
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
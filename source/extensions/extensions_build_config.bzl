@@ -27,6 +27,8 @@ EXTENSIONS = {
     "envoy.compression.gzip.decompressor":              "//source/extensions/compression/gzip/decompressor:config",
     "envoy.compression.brotli.compressor":              "//source/extensions/compression/brotli/compressor:config",
     "envoy.compression.brotli.decompressor":            "//source/extensions/compression/brotli/decompressor:config",
+    "envoy.compression.zstd.compressor":                "//source/extensions/compression/zstd/compressor:config",
+    "envoy.compression.zstd.decompressor":              "//source/extensions/compression/zstd/decompressor:config",
 
     #
     # gRPC Credentials Plugins
@@ -219,6 +221,8 @@ EXTENSIONS = {
     #
     # CacheFilter plugins
     #
+    "envoy.cache.disk_http_cache":                      "//source/extensions/filters/http/cache/disk_http_cache:config",
+    "envoy.cache.lru_http_cache":                       "//source/extensions/filters/http/cache/lru_http_cache:config",
     "envoy.cache.simple_http_cache":                    "//source/extensions/filters/http/cache/simple_http_cache:config",
 
     #
@@ -1,5 +1,7 @@
 #include "source/extensions/filters/common/expr/evaluator.h"
 
+#include <cstddef>
+
 #include "envoy/common/exception.h"
 
 #include "eval/public/builtin_func_registrar.h"
@@ -10,6 +12,77 @@ namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace Expr {
+namespace {
+
+// The size of the initial arena block of an evaluation by matches(), which holds the wrappers and
+// the intermediate results of most expressions without a heap allocation.
+constexpr size_t InitialArenaBlockSize = 1024;
+
+constexpr absl::string_view ActivationAttributes[] = {
+    Request, Response, Connection, Upstream, Source, Destination, Metadata, FilterState};
+
+template <class T, class... Args> CelValue produce(Protobuf::Arena& arena, Args&&... args) {
+  return Protobuf::Arena::Create<T>(&arena, std::forward<Args>(args)...)->Produce(&arena);
+}
+
+/**
+ * Binds the common context attributes of an evaluation to the activation of the thread, which is
+ * reused by all the evaluations of the thread instead of building an activation with new value
+ * producers every time. The wrappers of the attributes are allocated on the evaluation arena, and
+ * the attributes are removed from the activation when the evaluation is done. A fresh activation
+ * is used if the thread activation is already bound.
+ */
+class ScopedActivation {
+public:
+  ScopedActivation(Protobuf::Arena& arena, const StreamInfo::StreamInfo& info,
+                   const Http::RequestHeaderMap* request_headers,
+                   const Http::ResponseHeaderMap* response_headers,
+                   const Http::ResponseTrailerMap* response_trailers) {
+    if (thread_activation_bound_) {
+      owned_activation_ = std::make_unique<Activation>();
+      activation_ = owned_activation_.get();
+    } else {
+      thread_activation_bound_ = true;
+      activation_ = &threadActivation();
+    }
+
+    activation_->InsertValue(Request, produce<RequestWrapper>(arena, arena, request_headers, info));
+    activation_->InsertValue(Response, produce<ResponseWrapper>(arena, arena, response_headers,
+                                                                response_trailers, info));
+    activation_->InsertValue(Connection, produce<ConnectionWrapper>(arena, info));
+    activation_->InsertValue(Upstream, produce<UpstreamWrapper>(arena, info));
+    activation_->InsertValue(Source, produce<PeerWrapper>(arena, info, false));
+    activation_->InsertValue(Destination, produce<PeerWrapper>(arena, info, true));
+    activation_->InsertValue(Metadata, produce<MetadataProducer>(arena, info.dynamicMetadata()));
+    activation_->InsertValue(FilterState, produce<FilterStateWrapper>(arena, info.filterState()));
+  }
+
+  ~ScopedActivation() {
+    if (owned_activation_ == nullptr) {
+      for (const absl::string_view attribute : ActivationAttributes) {
+        activation_->RemoveValueEntry(attribute);
+      }
+      thread_activation_bound_ = false;
+    }
+  }
+
+  const Activation& activation() const { return *activation_; }
+
+private:
+  static Activation& threadActivation() {
+    static thread_local Activation activation;
+    return activation;
+  }
+
+  static thread_local bool thread_activation_bound_;
+
+  Activation* activation_;
+  ActivationPtr owned_activation_;
+};
+
+thread_local bool ScopedActivation::thread_activation_bound_ = false;
+
+} // namespace
 
 ActivationPtr createActivation(Protobuf::Arena& arena, const StreamInfo::StreamInfo& info,
                                const Http::RequestHeaderMap* request_headers,
@@ -73,9 +146,8 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
                                   const Http::RequestHeaderMap* request_headers,
                                   const Http::ResponseHeaderMap* response_headers,
                                   const Http::ResponseTrailerMap* response_trailers) {
-  auto activation =
-      createActivation(arena, info, request_headers, response_headers, response_trailers);
-  auto eval_status = expr.Evaluate(*activation, &arena);
+  ScopedActivation activation(arena, info, request_headers, response_headers, response_trailers);
+  auto eval_status = expr.Evaluate(activation.activation(), &arena);
   if (!eval_status.ok()) {
     return {};
   }
@@ -85,7 +157,12 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::RequestHeaderMap& headers) {
-  Protobuf::Arena arena;
+  // The arena requires its initial block to be aligned as any of the objects it allocates.
+  alignas(std::max_align_t) char initial_block[InitialArenaBlockSize];
+  Protobuf::ArenaOptions options;
+  options.initial_block = initial_block;
+  options.initial_block_size = sizeof(initial_block);
+  Protobuf::Arena arena(options);
   auto eval_status = Expr::evaluate(expr, arena, info, &headers, nullptr, nullptr);
   if (!eval_status.has_value()) {
     return false;
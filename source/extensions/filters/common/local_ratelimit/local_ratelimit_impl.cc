@@ -12,7 +12,8 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
     const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
     const Protobuf::RepeatedPtrField<
-        envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors)
+        envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
+    const uint32_t max_dynamic_descriptors)
     : fill_timer_(fill_interval > std::chrono::milliseconds(0)
                       ? dispatcher.createTimer([this] { onFillTimer(); })
                       : nullptr),
@@ -31,10 +32,17 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
   }
 
   for (const auto& descriptor : descriptors) {
+    if (descriptor.entries().empty() == descriptor.dynamic_entries().empty()) {
+      throw EnvoyException(
+          "local rate descriptor must have exactly one of entries and dynamic_entries");
+    }
     LocalDescriptorImpl new_descriptor;
     for (const auto& entry : descriptor.entries()) {
       new_descriptor.entries_.push_back({entry.key(), entry.value()});
     }
+    for (const auto& entry : descriptor.dynamic_entries()) {
+      new_descriptor.entries_.push_back({entry.key(), entry.value()});
+    }
     RateLimit::TokenBucket token_bucket;
     token_bucket.fill_interval_ =
         absl::Milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(descriptor.token_bucket(), fill_interval, 0));
@@ -47,6 +55,27 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(descriptor.token_bucket(), tokens_per_fill, 1);
     new_descriptor.token_bucket_ = token_bucket;
 
+    const bool dynamic =
+        std::any_of(new_descriptor.entries_.begin(), new_descriptor.entries_.end(),
+                    [](const RateLimit::DescriptorEntry& entry) { return entry.value_.empty(); });
+    if (dynamic) {
+      if (token_bucket.max_tokens_ > TokenBucketTable::MaxTokens) {
+        throw EnvoyException(
+            absl::StrCat("local rate descriptor with dynamic values supports at most ",
+                         TokenBucketTable::MaxTokens, " tokens: ", new_descriptor.toString()));
+      }
+      DynamicDescriptor dynamic_descriptor;
+      dynamic_descriptor.entries_ = std::move(new_descriptor.entries_);
+      dynamic_descriptor.ticks_per_fill_ =
+          token_bucket_.fill_interval_ > absl::ZeroDuration()
+              ? static_cast<uint32_t>(token_bucket.fill_interval_ / token_bucket_.fill_interval_)
+              : 1;
+      dynamic_descriptor.buckets_ = std::make_unique<TokenBucketTable>(
+          max_dynamic_descriptors, token_bucket.max_tokens_, token_bucket.tokens_per_fill_);
+      dynamic_descriptors_.push_back(std::move(dynamic_descriptor));
+      continue;
+    }
+
     auto token_state = std::make_unique<TokenState>();
     token_state->tokens_ = token_bucket.max_tokens_;
     token_state->fill_time_ = time_source_.monotonicTime();
@@ -69,6 +98,8 @@ LocalRateLimiterImpl::~LocalRateLimiterImpl() {
 void LocalRateLimiterImpl::onFillTimer() {
   onFillTimerHelper(tokens_, token_bucket_);
   onFillTimerDescriptorHelper();
+  // The buckets of dynamic descriptors are refilled lazily, when they are checked.
+  fill_ticks_.fetch_add(1, std::memory_order_relaxed);
   fill_timer_->enableTimer(absl::ToChronoMilliseconds(token_bucket_.fill_interval_));
 }
 
@@ -123,14 +154,43 @@ bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const
   return true;
 }
 
+bool LocalRateLimiterImpl::DynamicDescriptor::matches(
+    const RateLimit::LocalDescriptor& request_descriptor) const {
+  if (request_descriptor.entries_.size() != entries_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const RateLimit::DescriptorEntry& entry = entries_[i];
+    const RateLimit::DescriptorEntry& request_entry = request_descriptor.entries_[i];
+    if (entry.key_ != request_entry.key_ ||
+        (!entry.value_.empty() && entry.value_ != request_entry.value_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LocalRateLimiterImpl::dynamicRequestAllowed(
+    const DynamicDescriptor& descriptor,
+    const RateLimit::LocalDescriptor& request_descriptor) const {
+  const uint32_t fill_count =
+      fill_ticks_.load(std::memory_order_relaxed) / descriptor.ticks_per_fill_;
+  return descriptor.buckets_->consume(LocalDescriptorHash()(request_descriptor), fill_count);
+}
+
 bool LocalRateLimiterImpl::requestAllowed(
     absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const {
-  if (!descriptors_.empty() && !request_descriptors.empty()) {
+  if ((!descriptors_.empty() || !dynamic_descriptors_.empty()) && !request_descriptors.empty()) {
     for (const auto& request_descriptor : request_descriptors) {
       auto it = descriptors_.find(request_descriptor);
       if (it != descriptors_.end()) {
         return requestAllowedHelper(*it->token_state_);
       }
+      for (const DynamicDescriptor& descriptor : dynamic_descriptors_) {
+        if (descriptor.matches(request_descriptor)) {
+          return dynamicRequestAllowed(descriptor, request_descriptor);
+        }
+      }
     }
   }
   return requestAllowedHelper(tokens_);
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -9,6 +11,7 @@
 
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/extensions/filters/common/local_ratelimit/token_bucket_table.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -18,11 +21,20 @@ namespace LocalRateLimit {
 
 class LocalRateLimiterImpl {
 public:
+  // The number of token buckets of each descriptor with dynamic values, if not configured.
+  static constexpr uint32_t DefaultMaxDynamicDescriptors = 16384;
+
+  /**
+   * The descriptors having dynamic entries with an empty value are dynamic: such an entry matches
+   * any value, and each distinct value gets its own token bucket, up to max_dynamic_descriptors
+   * buckets per descriptor. The least recently used buckets are recycled past that.
+   */
   LocalRateLimiterImpl(
       const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
       const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
       const Protobuf::RepeatedPtrField<
-          envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors);
+          envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
+      const uint32_t max_dynamic_descriptors = DefaultMaxDynamicDescriptors);
   ~LocalRateLimiterImpl();
 
   bool requestAllowed(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
@@ -44,6 +56,15 @@ private:
       return absl::StrJoin(entries, ", ");
     }
   };
+  struct DynamicDescriptor {
+    bool matches(const RateLimit::LocalDescriptor& request_descriptor) const;
+
+    // The entries with an empty value match any value.
+    std::vector<RateLimit::DescriptorEntry> entries_;
+    // The descriptor's fill interval in fill timer ticks.
+    uint32_t ticks_per_fill_;
+    TokenBucketTablePtr buckets_;
+  };
   struct LocalDescriptorHash {
     using is_transparent = void; // NOLINT(readability-identifier-naming)
     size_t operator()(const RateLimit::LocalDescriptor& d) const {
@@ -62,12 +83,17 @@ private:
   void onFillTimerHelper(const TokenState& state, const RateLimit::TokenBucket& bucket);
   void onFillTimerDescriptorHelper();
   bool requestAllowedHelper(const TokenState& tokens) const;
+  bool dynamicRequestAllowed(const DynamicDescriptor& descriptor,
+                             const RateLimit::LocalDescriptor& request_descriptor) const;
 
   RateLimit::TokenBucket token_bucket_;
   const Event::TimerPtr fill_timer_;
   TimeSource& time_source_;
   TokenState tokens_;
   absl::flat_hash_set<LocalDescriptorImpl, LocalDescriptorHash, LocalDescriptorEqual> descriptors_;
+  std::vector<DynamicDescriptor> dynamic_descriptors_;
+  // The number of times the fill timer fired, which refills the buckets of dynamic descriptors.
+  std::atomic<uint32_t> fill_ticks_{0};
   mutable Thread::ThreadSynchronizer synchronizer_; // Used for testing only.
 
   friend class LocalRateLimiterImplTest;
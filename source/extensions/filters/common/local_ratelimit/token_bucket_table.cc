@@ -0,0 +1,126 @@
+#include "source/extensions/filters/common/local_ratelimit/token_bucket_table.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+namespace {
+
+// The number of fill intervals elapsed from one fill count to a later one. The fill counts wrap
+// around, and a worker may pass a fill count slightly older than the one a bucket was updated at
+// by another worker, which counts as no time elapsed.
+uint32_t elapsedFills(uint32_t from, uint32_t to) {
+  const int32_t elapsed = static_cast<int32_t>(to - from);
+  return elapsed > 0 ? elapsed : 0;
+}
+
+uint64_t setCount(uint64_t capacity, uint32_t ways) {
+  const uint64_t needed = (capacity + ways - 1) / ways;
+  uint64_t count = 1;
+  while (count < needed) {
+    count <<= 1;
+  }
+  return count;
+}
+
+} // namespace
+
+TokenBucketTable::TokenBucketTable(uint64_t capacity, uint32_t max_tokens,
+                                   uint32_t tokens_per_fill)
+    : max_tokens_(max_tokens), tokens_per_fill_(tokens_per_fill),
+      set_mask_(setCount(capacity, Ways) - 1), sets_(std::make_unique<Set[]>(set_mask_ + 1)) {
+  ASSERT(max_tokens_ <= MaxTokens);
+}
+
+bool TokenBucketTable::consume(uint64_t key, uint32_t fill_count) {
+  // 0 marks the empty slots.
+  key = key == 0 ? 1 : key;
+  Set& set = sets_[key & set_mask_];
+
+  while (true) {
+    Slot* victim = nullptr;
+    uint64_t victim_state = 0;
+    uint64_t victim_age = 0;
+    bool retry = false;
+
+    for (Slot& slot : set.slots_) {
+      // The state is loaded before the key: if the slot gets recycled for another key in between,
+      // the CAS of the state fails as the generation changed.
+      const uint64_t state = slot.state_.load(std::memory_order_acquire);
+      if (locked(state)) {
+        retry = true;
+        continue;
+      }
+      const uint64_t slot_key = slot.key_.load(std::memory_order_acquire);
+      if (slot_key == key) {
+        const Result result = consumeFromSlot(slot, state, fill_count);
+        if (result == Result::Recycled) {
+          retry = true;
+          break;
+        }
+        return result == Result::Allowed;
+      }
+
+      // Empty slots are recycled first, then the least recently used ones.
+      const uint64_t age = slot_key == 0 ? std::numeric_limits<uint64_t>::max()
+                                         : elapsedFills(fillCount(state), fill_count);
+      if (victim == nullptr || age > victim_age) {
+        victim = &slot;
+        victim_state = state;
+        victim_age = age;
+      }
+    }
+    if (retry) {
+      continue;
+    }
+
+    // The key is not in the table: recycle the victim for a full bucket, less the token taken
+    // now. Another thread may race to recycle it, in which case the lookup starts over.
+    ASSERT(victim != nullptr);
+    if (!victim->state_.compare_exchange_strong(victim_state, victim_state | LockedBit,
+                                                std::memory_order_acq_rel)) {
+      continue;
+    }
+    victim->key_.store(key, std::memory_order_release);
+    victim->state_.store(packState(max_tokens_ > 0 ? max_tokens_ - 1 : 0,
+                                   generation(victim_state) + 1, fill_count),
+                         std::memory_order_release);
+    return max_tokens_ > 0;
+  }
+}
+
+TokenBucketTable::Result TokenBucketTable::consumeFromSlot(Slot& slot, uint64_t state,
+                                                           uint32_t fill_count) const {
+  const uint64_t slot_generation = generation(state);
+  uint64_t new_state;
+  do {
+    if (locked(state) || generation(state) != slot_generation) {
+      return Result::Recycled;
+    }
+    const uint64_t elapsed = elapsedFills(fillCount(state), fill_count);
+    const uint32_t available = static_cast<uint32_t>(std::min<uint64_t>(
+        max_tokens_, tokens(state) + elapsed * tokens_per_fill_));
+    if (available == 0) {
+      // Nothing was refilled, so the state is current already.
+      return Result::Limited;
+    }
+    new_state = packState(available - 1, slot_generation,
+                          elapsed > 0 ? fill_count : fillCount(state));
+    // Loop while the weak CAS fails trying to update the state, which reloads it.
+  } while (!slot.state_.compare_exchange_weak(state, new_state, std::memory_order_acq_rel));
+
+  return Result::Allowed;
+}
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
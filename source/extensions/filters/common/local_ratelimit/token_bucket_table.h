@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+/**
+ * A fixed size table of token buckets keyed by the hash of a descriptor, shared by all the
+ * workers. It backs the descriptors with dynamic values, e.g. one bucket per client address, and
+ * bounds the memory they use whatever the number of distinct values.
+ *
+ * The table is set associative: a key may only live in one of the slots of the set selected by
+ * its hash, which are packed in a single cache line. When the set is full, the slot least recently
+ * refilled or consumed from is recycled. Buckets are refilled lazily when consumed from, so that
+ * the cost of a check does not depend on the number of buckets, and a check never takes a lock.
+ *
+ * Different keys sharing a hash share a bucket, which makes the limit stricter for them, and
+ * racing insertions of a new key may briefly give it two buckets.
+ */
+class TokenBucketTable {
+public:
+  // The largest max_tokens supported, as the tokens share a word with the bucket's bookkeeping.
+  static constexpr uint32_t MaxTokens = (1 << 24) - 1;
+
+  /**
+   * @param capacity the number of buckets, rounded up to a power of two.
+   * @param max_tokens the number of tokens of a full bucket, at most MaxTokens.
+   * @param tokens_per_fill the number of tokens added to a bucket every fill interval.
+   */
+  TokenBucketTable(uint64_t capacity, uint32_t max_tokens, uint32_t tokens_per_fill);
+
+  /**
+   * Takes a token from the bucket of a key, which starts full.
+   * @param key the hash of the descriptor.
+   * @param fill_count the number of fill intervals elapsed since the table was created.
+   * @return whether a token was available.
+   */
+  bool consume(uint64_t key, uint32_t fill_count);
+
+  uint64_t capacity() const { return (set_mask_ + 1) * Ways; }
+
+private:
+  static constexpr uint32_t Ways = 4;
+
+  // The state of a bucket is packed in a single word, so that it is updated with a single CAS:
+  // the number of tokens, a lock bit set while the slot is recycled for another key, the
+  // generation of the slot bumped each time it is recycled, and the fill count it was last
+  // refilled at.
+  static constexpr uint64_t TokensShift = 40;
+  static constexpr uint64_t LockedBit = 1ULL << 39;
+  static constexpr uint64_t GenerationShift = 32;
+  static constexpr uint64_t GenerationMask = 0x7f;
+
+  static uint64_t packState(uint32_t tokens, uint64_t generation, uint32_t fill_count) {
+    return (static_cast<uint64_t>(tokens) << TokensShift) |
+           ((generation & GenerationMask) << GenerationShift) | fill_count;
+  }
+  static uint32_t tokens(uint64_t state) { return state >> TokensShift; }
+  static uint64_t generation(uint64_t state) {
+    return (state >> GenerationShift) & GenerationMask;
+  }
+  static uint32_t fillCount(uint64_t state) { return static_cast<uint32_t>(state); }
+  static bool locked(uint64_t state) { return (state & LockedBit) != 0; }
+
+  struct Slot {
+    // 0 for an empty slot.
+    std::atomic<uint64_t> key_{0};
+    std::atomic<uint64_t> state_{0};
+  };
+  struct alignas(64) Set {
+    Slot slots_[Ways];
+  };
+
+  enum class Result { Allowed, Limited, Recycled };
+  Result consumeFromSlot(Slot& slot, uint64_t state, uint32_t fill_count) const;
+
+  const uint32_t max_tokens_;
+  const uint32_t tokens_per_fill_;
+  const uint64_t set_mask_;
+  std::unique_ptr<Set[]> sets_;
+};
+
+using TokenBucketTablePtr = std::unique_ptr<TokenBucketTable>;
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
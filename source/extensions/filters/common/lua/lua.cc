@@ -13,9 +13,23 @@ namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace Lua {
+namespace {
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+// Bounds the threads kept per state, which would otherwise stay at the peak of concurrent
+// requests.
+constexpr uint64_t MaxIdleCoroutines = 256;
+
+} // namespace
+
+Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+                     CoroutinePool* pool)
+    : coroutine_state_(new_thread_state, false), pool_(pool) {}
+
+Coroutine::~Coroutine() {
+  if (pool_ != nullptr && returned_) {
+    pool_->release(*this);
+  }
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -36,6 +50,7 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
 
   if (0 == rc) {
     state_ = State::Finished;
+    returned_ = true;
     ENVOY_LOG(debug, "coroutine finished");
   } else if (LUA_YIELD == rc) {
     state_ = State::Yielded;
@@ -89,13 +104,50 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global,
   return current_global_slot_++;
 }
 
+CoroutinePtr CoroutinePool::createCoroutine() {
+  if (idle_refs_.empty()) {
+    return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state_), state_), this);
+  }
+
+  // A thread whose function returned can be resumed again with a new function. The coroutine
+  // takes its own reference to the thread from the top of the stack.
+  const int ref = idle_refs_.back();
+  idle_refs_.pop_back();
+  lua_rawgeti(state_, LUA_REGISTRYINDEX, ref);
+  auto coroutine =
+      std::make_unique<Coroutine>(std::make_pair(lua_tothread(state_, -1), state_), this);
+  luaL_unref(state_, LUA_REGISTRYINDEX, ref);
+  return coroutine;
+}
+
+void CoroutinePool::release(Coroutine& coroutine) {
+  if (idle_refs_.size() >= MaxIdleCoroutines) {
+    return;
+  }
+
+  // Drop the return values so that nothing they reference is kept alive by the idle thread.
+  lua_settop(coroutine.luaState(), 0);
+  coroutine.coroutine_state_.pushStack();
+  idle_refs_.push_back(luaL_ref(state_, LUA_REGISTRYINDEX));
+}
+
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tlsState().get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  return (*tls_slot_)->coroutine_pool_.createCoroutine();
+}
+
+void ThreadLocalState::tuneRuntimeGC(uint32_t pause, uint32_t step_multiplier) {
+  tls_slot_->runOnAllThreads([pause, step_multiplier](OptRef<LuaThreadLocal> tls) {
+    if (pause > 0) {
+      lua_gc(tls->state_.get(), LUA_GCSETPAUSE, pause);
+    }
+    if (step_multiplier > 0) {
+      lua_gc(tls->state_.get(), LUA_GCSETSTEPMUL, step_multiplier);
+    }
+  });
 }
 
 ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
-    : state_(luaL_newstate()) {
+    : state_(luaL_newstate()), coroutine_pool_(state_.get()) {
 
   RELEASE_ASSERT(state_.get() != nullptr, "unable to create new Lua state object");
   luaL_openlibs(state_.get());
@@ -328,11 +328,22 @@ public:
  * This is a wrapper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
  */
+class CoroutinePool;
+
 class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  /**
+   * @param new_thread_state supplies the Lua thread of the coroutine, which must be at the top of
+   *        the stack of the main state.
+   * @param pool supplies the pool the thread is returned to if the coroutine returns without an
+   *        error, or nullptr if the thread should not be reused.
+   */
+  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+            CoroutinePool* pool = nullptr);
+  ~Coroutine();
+
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
@@ -355,11 +366,47 @@ public:
   void resume(int num_args, const std::function<void()>& yield_callback);
 
 private:
+  friend class CoroutinePool;
+
   LuaRef<lua_State> coroutine_state_;
   State state_{State::NotStarted};
+  // Set when the coroutine function returned without an error. Only such a thread can be resumed
+  // again with a new function.
+  bool returned_{};
+  CoroutinePool* pool_;
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
+
+/**
+ * The Lua threads of the coroutines of a state that returned without an error. New coroutines
+ * reuse them before creating new threads, which saves a thread allocation and its GC per request.
+ * Threads of coroutines that yielded or failed are never reused since their stack is still in
+ * use or dead.
+ */
+class CoroutinePool {
+public:
+  CoroutinePool(lua_State* state) : state_(state) {}
+
+  /**
+   * @return CoroutinePtr a new coroutine, running on an idle thread if there is one.
+   */
+  CoroutinePtr createCoroutine();
+
+  /**
+   * @return the number of idle threads.
+   */
+  uint64_t size() const { return idle_refs_.size(); }
+
+private:
+  friend class Coroutine;
+
+  void release(Coroutine& coroutine);
+
+  lua_State* state_;
+  // Registry references to the idle threads.
+  std::vector<int> idle_refs_;
+};
 using Initializer = std::function<void(lua_State*)>;
 using InitializerList = std::vector<Initializer>;
 
@@ -415,12 +462,27 @@ public:
    */
   void runtimeGC() { lua_gc(tlsState().get(), LUA_GCCOLLECT, 0); }
 
+  /**
+   * Tune the incremental GC of the runtime on all threaded workers.
+   * @param pause supplies how long the collector waits before starting a new cycle, as a
+   *        percentage of the memory in use after the previous one. 0 keeps the runtime default.
+   * @param step_multiplier supplies the speed of the collector relative to memory allocation, as
+   *        a percentage. 0 keeps the runtime default.
+   */
+  void tuneRuntimeGC(uint32_t pause, uint32_t step_multiplier);
+
+  /**
+   * Return the number of idle coroutine threads of the runtime.
+   */
+  uint64_t idleCoroutines() { return (*tls_slot_)->coroutine_pool_.size(); }
+
 private:
   struct LuaThreadLocal : public ThreadLocal::ThreadLocalObject {
     LuaThreadLocal(const std::string& code);
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    CoroutinePool coroutine_pool_;
   };
 
   CSmartPtr<lua_State, lua_close>& tlsState() { return (*tls_slot_)->state_; }
@@ -0,0 +1,221 @@
+#include "source/extensions/filters/common/ratelimit/quota_lease_impl.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/empty_string.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+QuotaLeaseCache::QuotaLeaseCache(TimeSource& time_source, Stats::Scope& scope,
+                                 uint32_t hits_per_lease, std::chrono::milliseconds lease_duration,
+                                 uint32_t max_leases)
+    : time_source_(time_source),
+      stats_({ALL_QUOTA_LEASE_STATS(POOL_COUNTER_PREFIX(scope, "ratelimit.quota_lease."))}),
+      hits_per_lease_(hits_per_lease), lease_duration_(lease_duration), max_leases_(max_leases),
+      next_sweep_(time_source.monotonicTime()) {}
+
+std::string QuotaLeaseCache::key(const std::string& domain,
+                                 const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  // The strings are prefixed by their length, so that the keys of different descriptors differ.
+  std::string key = absl::StrCat(domain.size(), ":", domain);
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    absl::StrAppend(&key, "|", descriptor.entries_.size());
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      absl::StrAppend(&key, ";", entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                      entry.value_);
+    }
+    if (descriptor.limit_) {
+      absl::StrAppend(&key, "/", descriptor.limit_->requests_per_unit_, "/",
+                      static_cast<int>(descriptor.limit_->unit_));
+    }
+  }
+  return key;
+}
+
+QuotaLeaseCache::Decision QuotaLeaseCache::consume(const std::string& key, uint32_t& lease_hits) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  absl::MutexLock lock(&mutex_);
+  auto it = leases_.find(key);
+  if (it == leases_.end()) {
+    if (leases_.size() >= max_leases_) {
+      sweepExpired(now);
+      if (leases_.size() >= max_leases_) {
+        return Decision::RequestHit;
+      }
+    }
+    leases_.emplace(key, Lease{State::Pending, 0, now + lease_duration_, hits_per_lease_});
+    lease_hits = hits_per_lease_;
+    return Decision::RequestLease;
+  }
+
+  Lease& lease = it->second;
+  switch (lease.state_) {
+  case State::Pending:
+    return Decision::RequestHit;
+  case State::Denied:
+    if (now < lease.expiry_) {
+      return Decision::RequestHit;
+    }
+    break;
+  case State::Granted:
+    if (lease.remaining_hits_ > 0 && now < lease.expiry_) {
+      --lease.remaining_hits_;
+      stats_.local_hit_.inc();
+      return Decision::Allowed;
+    }
+    break;
+  }
+  // The lease is exhausted or expired, so a new one is requested.
+  lease = Lease{State::Pending, 0, now + lease_duration_, lease.lease_hits_};
+  lease_hits = lease.lease_hits_;
+  return Decision::RequestLease;
+}
+
+void QuotaLeaseCache::grant(const std::string& key, const DescriptorStatusList* statuses) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  MonotonicTime expiry = now + lease_duration_;
+  if (statuses != nullptr) {
+    // The hits of the lease are only valid until the limits of the descriptors reset.
+    for (const auto& status : *statuses) {
+      if (status.has_duration_until_reset()) {
+        const auto until_reset =
+            std::chrono::seconds(status.duration_until_reset().seconds()) +
+            std::chrono::nanoseconds(status.duration_until_reset().nanos());
+        expiry = std::min(expiry, now + std::chrono::duration_cast<MonotonicTime::duration>(
+                                            std::max(until_reset, std::chrono::nanoseconds(0))));
+      }
+    }
+  }
+
+  absl::MutexLock lock(&mutex_);
+  auto it = leases_.find(key);
+  if (it != leases_.end()) {
+    const uint32_t lease_hits = it->second.lease_hits_;
+    it->second = Lease{State::Granted, lease_hits - 1, expiry,
+                       lease_hits > hits_per_lease_ / 2 ? hits_per_lease_ : lease_hits * 2};
+  }
+}
+
+void QuotaLeaseCache::deny(const std::string& key) {
+  const MonotonicTime expiry = time_source_.monotonicTime() + lease_duration_;
+  absl::MutexLock lock(&mutex_);
+  auto it = leases_.find(key);
+  if (it != leases_.end()) {
+    it->second = Lease{State::Denied, 0, expiry, std::max(it->second.lease_hits_ / 2, 1u)};
+  }
+}
+
+void QuotaLeaseCache::abandon(const std::string& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = leases_.find(key);
+  if (it != leases_.end() && it->second.state_ == State::Pending) {
+    leases_.erase(it);
+  }
+}
+
+void QuotaLeaseCache::sweepExpired(MonotonicTime now) {
+  if (now < next_sweep_) {
+    return;
+  }
+  next_sweep_ = now + lease_duration_;
+  // Pending leases expire too, in case their request never completes.
+  for (auto it = leases_.begin(); it != leases_.end();) {
+    if (it->second.expiry_ <= now) {
+      leases_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+QuotaLeaseClient::QuotaLeaseClient(std::unique_ptr<GrpcClientImpl>&& client,
+                                   QuotaLeaseCacheSharedPtr cache)
+    : client_(std::move(client)), cache_(std::move(cache)) {}
+
+void QuotaLeaseClient::cancel() {
+  ASSERT(callbacks_ != nullptr);
+  client_->cancel();
+  if (leasing_) {
+    cache_->abandon(key_);
+  }
+  callbacks_ = nullptr;
+}
+
+void QuotaLeaseClient::limit(RequestCallbacks& callbacks, const std::string& domain,
+                             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                             Tracing::Span& parent_span,
+                             const StreamInfo::StreamInfo& stream_info) {
+  ASSERT(callbacks_ == nullptr);
+  key_ = QuotaLeaseCache::key(domain, descriptors);
+  switch (cache_->consume(key_, lease_hits_)) {
+  case QuotaLeaseCache::Decision::Allowed:
+    callbacks.complete(LimitStatus::OK, nullptr, nullptr, nullptr, EMPTY_STRING, nullptr);
+    return;
+  case QuotaLeaseCache::Decision::RequestLease:
+    leasing_ = true;
+    // A denied lease of several hits is followed by a request for a single hit.
+    domain_ = domain;
+    descriptors_ = descriptors;
+    parent_span_ = &parent_span;
+    stream_info_ = &stream_info;
+    cache_->stats().lease_requested_.inc();
+    break;
+  case QuotaLeaseCache::Decision::RequestHit:
+    leasing_ = false;
+    break;
+  }
+
+  callbacks_ = &callbacks;
+  client_->limit(*this, domain, descriptors, parent_span, stream_info,
+                 leasing_ ? lease_hits_ : 0);
+}
+
+void QuotaLeaseClient::complete(LimitStatus status, DescriptorStatusListPtr&& descriptor_statuses,
+                                Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                                Http::RequestHeaderMapPtr&& request_headers_to_add,
+                                const std::string& response_body,
+                                DynamicMetadataPtr&& dynamic_metadata) {
+  ASSERT(callbacks_ != nullptr);
+  if (leasing_) {
+    leasing_ = false;
+    switch (status) {
+    case LimitStatus::OK:
+      cache_->stats().lease_granted_.inc();
+      cache_->grant(key_, descriptor_statuses.get());
+      break;
+    case LimitStatus::OverLimit:
+      cache_->stats().lease_denied_.inc();
+      cache_->deny(key_);
+      if (lease_hits_ > 1) {
+        // Fewer hits than a lease may remain, so the request is checked by itself.
+        ENVOY_LOG(debug, "quota lease denied, checking the request by itself");
+        client_->limit(*this, domain_, descriptors_, *parent_span_, *stream_info_, 0);
+        return;
+      }
+      // The lease was of a single hit, so it was the check of the request by itself.
+      break;
+    case LimitStatus::Error:
+      cache_->abandon(key_);
+      break;
+    }
+  }
+
+  RequestCallbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  callbacks->complete(status, std::move(descriptor_statuses), std::move(response_headers_to_add),
+                      std::move(request_headers_to_add), response_body,
+                      std::move(dynamic_metadata));
+}
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
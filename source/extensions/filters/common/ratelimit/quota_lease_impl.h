@@ -0,0 +1,157 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/common/ratelimit/ratelimit.h"
+#include "source/extensions/filters/common/ratelimit/ratelimit_impl.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+/**
+ * All quota lease stats. @see stats_macros.h
+ */
+#define ALL_QUOTA_LEASE_STATS(COUNTER)                                                             \
+  COUNTER(lease_requested)                                                                         \
+  COUNTER(lease_granted)                                                                           \
+  COUNTER(lease_denied)                                                                            \
+  COUNTER(local_hit)
+
+/**
+ * Struct definition for all quota lease stats. @see stats_macros.h
+ */
+struct QuotaLeaseStats {
+  ALL_QUOTA_LEASE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * The blocks of hits leased from the rate limit service, keyed by the domain and descriptors of
+ * the requests. It is shared by the clients of all the workers using a filter config.
+ */
+class QuotaLeaseCache {
+public:
+  QuotaLeaseCache(TimeSource& time_source, Stats::Scope& scope, uint32_t hits_per_lease,
+                  std::chrono::milliseconds lease_duration, uint32_t max_leases);
+
+  enum class Decision {
+    // A hit of a lease was taken, the request is not over limit.
+    Allowed,
+    // There is no lease, and the caller is to request one.
+    RequestLease,
+    // The request is to be checked with the rate limit service by itself, as a lease was denied,
+    // another one is being requested, or there are too many leases.
+    RequestHit,
+  };
+
+  static std::string key(const std::string& domain,
+                         const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  /**
+   * Takes a hit from the lease of a key. If RequestLease is returned, the caller must then call
+   * either grant(), deny() or abandon() for the key.
+   * @param lease_hits receives the number of hits of the lease to request, if RequestLease is
+   *        returned.
+   */
+  Decision consume(const std::string& key, uint32_t& lease_hits);
+
+  /**
+   * Records the lease granted for a key, of which the request which obtained it used one hit.
+   * @param statuses the descriptor statuses returned with the lease, which may shorten it.
+   */
+  void grant(const std::string& key, const DescriptorStatusList* statuses);
+
+  /**
+   * Records that the rate limit service denied a lease for a key. As the service may have counted
+   * the hits of the denied lease, the next lease of the key asks for half as many hits.
+   */
+  void deny(const std::string& key);
+
+  // Forgets about the lease requested for a key, as the request failed or was cancelled.
+  void abandon(const std::string& key);
+
+  QuotaLeaseStats& stats() { return stats_; }
+
+private:
+  enum class State { Pending, Granted, Denied };
+  struct Lease {
+    State state_;
+    uint32_t remaining_hits_;
+    MonotonicTime expiry_;
+    // The hits of the lease being requested or of the next one, which are halved when a lease is
+    // denied and doubled back up to hits_per_lease_ when one is granted.
+    uint32_t lease_hits_;
+  };
+
+  void sweepExpired(MonotonicTime now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  TimeSource& time_source_;
+  QuotaLeaseStats stats_;
+  const uint32_t hits_per_lease_;
+  const std::chrono::milliseconds lease_duration_;
+  const uint32_t max_leases_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Lease> leases_ ABSL_GUARDED_BY(mutex_);
+  // The expired leases are swept at most once per lease duration, when the cache is full.
+  MonotonicTime next_sweep_ ABSL_GUARDED_BY(mutex_);
+};
+
+using QuotaLeaseCacheSharedPtr = std::shared_ptr<QuotaLeaseCache>;
+
+/**
+ * A client serving the decisions it can from the quota lease cache, and calling the rate limit
+ * service for the others.
+ */
+class QuotaLeaseClient : public Client,
+                         public RequestCallbacks,
+                         public Logger::Loggable<Logger::Id::filter> {
+public:
+  QuotaLeaseClient(std::unique_ptr<GrpcClientImpl>&& client, QuotaLeaseCacheSharedPtr cache);
+
+  // Filters::Common::RateLimit::Client
+  void cancel() override;
+  void limit(RequestCallbacks& callbacks, const std::string& domain,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+             Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info) override;
+
+  // Filters::Common::RateLimit::RequestCallbacks
+  void complete(LimitStatus status, DescriptorStatusListPtr&& descriptor_statuses,
+                Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                Http::RequestHeaderMapPtr&& request_headers_to_add,
+                const std::string& response_body, DynamicMetadataPtr&& dynamic_metadata) override;
+
+private:
+  std::unique_ptr<GrpcClientImpl> client_;
+  QuotaLeaseCacheSharedPtr cache_;
+  RequestCallbacks* callbacks_{};
+  // The state of the request being checked by the rate limit service.
+  std::string key_;
+  bool leasing_{};
+  uint32_t lease_hits_{};
+  std::string domain_;
+  std::vector<Envoy::RateLimit::Descriptor> descriptors_;
+  Tracing::Span* parent_span_{};
+  const StreamInfo::StreamInfo* stream_info_{};
+};
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
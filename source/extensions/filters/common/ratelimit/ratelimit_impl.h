@@ -51,13 +51,24 @@ public:
 
   static void createRequest(envoy::service::ratelimit::v3::RateLimitRequest& request,
                             const std::string& domain,
-                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                            uint32_t hits_addend = 0);
+
+  /**
+   * Same as limit() but with the number of hits to add to the limits, where 0 means 1.
+   */
+  void limit(RequestCallbacks& callbacks, const std::string& domain,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+             Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info,
+             uint32_t hits_addend);
 
   // Filters::Common::RateLimit::Client
   void cancel() override;
   void limit(RequestCallbacks& callbacks, const std::string& domain,
              const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
-             Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info) override;
+             Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info) override {
+    limit(callbacks, domain, descriptors, parent_span, stream_info, 0);
+  }
 
   // Grpc::AsyncRequestCallbacks
   void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
@@ -77,13 +88,18 @@ private:
   const envoy::config::core::v3::ApiVersion transport_api_version_;
 };
 
+class QuotaLeaseCache;
+
 /**
  * Builds the rate limit client.
+ * @param quota_lease_cache if not null, the client serves the decisions it can from the leases
+ *        of the cache.
  */
 ClientPtr rateLimitClient(Server::Configuration::FactoryContext& context,
                           const envoy::config::core::v3::GrpcService& grpc_service,
                           const std::chrono::milliseconds timeout,
-                          envoy::config::core::v3::ApiVersion transport_api_version);
+                          envoy::config::core::v3::ApiVersion transport_api_version,
+                          std::shared_ptr<QuotaLeaseCache> quota_lease_cache = nullptr);
 
 } // namespace RateLimit
 } // namespace Common
@@ -3,12 +3,63 @@
 #include "envoy/config/rbac/v3/rbac.pb.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/http/path_utility.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace RBAC {
+namespace {
+
+// The minimum number of rules of an OrMatcher compiled into one set matcher.
+constexpr size_t MinRulesToCompile = 2;
+// The LC-Trie holds up to MaxLcTrieNodes / 4 ranges with its default fill factor.
+constexpr size_t MaxIPSetRanges = Network::LcTrie::MaxLcTrieNodes / 4;
+
+const envoy::config::core::v3::CidrRange*
+ipRange(const envoy::config::rbac::v3::Permission& permission, IPMatcher::Type& type) {
+  if (permission.rule_case() == envoy::config::rbac::v3::Permission::RuleCase::kDestinationIp) {
+    type = IPMatcher::Type::DownstreamLocal;
+    return &permission.destination_ip();
+  }
+  return nullptr;
+}
+
+const envoy::config::core::v3::CidrRange*
+ipRange(const envoy::config::rbac::v3::Principal& principal, IPMatcher::Type& type) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+    type = IPMatcher::Type::ConnectionRemote;
+    return &principal.source_ip();
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+    type = IPMatcher::Type::DownstreamDirectRemote;
+    return &principal.direct_remote_ip();
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kRemoteIp:
+    type = IPMatcher::Type::DownstreamRemote;
+    return &principal.remote_ip();
+  default:
+    return nullptr;
+  }
+}
+
+// An empty exact match matches any value, so it is not compiled into a set.
+template <class Rule> bool isExactHeaderRule(const Rule& rule) {
+  return rule.has_header() &&
+         rule.header().header_match_specifier_case() ==
+             envoy::config::route::v3::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch &&
+         !rule.header().exact_match().empty() && !rule.header().invert_match();
+}
+
+template <class Rule> bool isExactPathRule(const Rule& rule) {
+  return rule.has_url_path() &&
+         rule.url_path().rule_case() == envoy::type::matcher::v3::PathMatcher::RuleCase::kPath &&
+         rule.url_path().path().match_pattern_case() ==
+             envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact &&
+         !rule.url_path().path().ignore_case();
+}
+
+} // namespace
 
 MatcherConstSharedPtr Matcher::create(const envoy::config::rbac::v3::Permission& permission) {
   switch (permission.rule_case()) {
@@ -95,14 +146,73 @@ bool AndMatcher::matches(const Network::Connection& connection,
 }
 
 OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Permission>& rules) {
-  for (const auto& rule : rules) {
-    matchers_.push_back(Matcher::create(rule));
-  }
+  compile(rules);
 }
 
 OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Principal>& ids) {
-  for (const auto& id : ids) {
-    matchers_.push_back(Matcher::create(id));
+  compile(ids);
+}
+
+template <class Rule> void OrMatcher::compile(const Protobuf::RepeatedPtrField<Rule>& rules) {
+  std::map<IPMatcher::Type, std::vector<const Rule*>> ip_rules;
+  std::map<std::string, std::vector<const Rule*>> header_rules;
+  std::vector<const Rule*> path_rules;
+  std::vector<const Rule*> other_rules;
+  for (const auto& rule : rules) {
+    IPMatcher::Type type;
+    if (ipRange(rule, type) != nullptr) {
+      ip_rules[type].push_back(&rule);
+    } else if (isExactHeaderRule(rule)) {
+      header_rules[Envoy::Http::LowerCaseString(rule.header().name()).get()].push_back(&rule);
+    } else if (isExactPathRule(rule)) {
+      path_rules.push_back(&rule);
+    } else {
+      other_rules.push_back(&rule);
+    }
+  }
+
+  // The order of the sub-matchers does not change the result, so the set matchers go first.
+  for (const auto& [type, group] : ip_rules) {
+    if (group.size() < MinRulesToCompile || group.size() > MaxIPSetRanges) {
+      other_rules.insert(other_rules.end(), group.begin(), group.end());
+      continue;
+    }
+    std::vector<Network::Address::CidrRange> ranges;
+    for (const Rule* rule : group) {
+      IPMatcher::Type rule_type;
+      auto range = Network::Address::CidrRange::create(*ipRange(*rule, rule_type));
+      // An invalid range never matches.
+      if (range.isValid()) {
+        ranges.push_back(std::move(range));
+      }
+    }
+    matchers_.push_back(std::make_shared<const IPSetMatcher>(ranges, type));
+  }
+
+  for (const auto& [name, group] : header_rules) {
+    if (group.size() < MinRulesToCompile) {
+      other_rules.insert(other_rules.end(), group.begin(), group.end());
+      continue;
+    }
+    absl::flat_hash_set<std::string> values;
+    for (const Rule* rule : group) {
+      values.insert(rule->header().exact_match());
+    }
+    matchers_.push_back(std::make_shared<const HeaderValueSetMatcher>(name, std::move(values)));
+  }
+
+  if (path_rules.size() < MinRulesToCompile) {
+    other_rules.insert(other_rules.end(), path_rules.begin(), path_rules.end());
+  } else {
+    absl::flat_hash_set<std::string> paths;
+    for (const Rule* rule : path_rules) {
+      paths.insert(rule->url_path().path().exact());
+    }
+    matchers_.push_back(std::make_shared<const PathSetMatcher>(std::move(paths)));
+  }
+
+  for (const Rule* rule : other_rules) {
+    matchers_.push_back(Matcher::create(*rule));
   }
 }
 
@@ -130,26 +240,43 @@ bool HeaderMatcher::matches(const Network::Connection&,
   return Envoy::Http::HeaderUtility::matchHeaders(headers, header_);
 }
 
-bool IPMatcher::matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap&,
-                        const StreamInfo::StreamInfo& info) const {
-  Envoy::Network::Address::InstanceConstSharedPtr ip;
-  switch (type_) {
+const Network::Address::InstanceConstSharedPtr&
+IPMatcher::address(Type type, const Network::Connection& connection,
+                   const StreamInfo::StreamInfo& info) {
+  switch (type) {
   case ConnectionRemote:
-    ip = connection.addressProvider().remoteAddress();
-    break;
+    return connection.addressProvider().remoteAddress();
   case DownstreamLocal:
-    ip = info.downstreamAddressProvider().localAddress();
-    break;
+    return info.downstreamAddressProvider().localAddress();
   case DownstreamDirectRemote:
-    ip = info.downstreamAddressProvider().directRemoteAddress();
-    break;
+    return info.downstreamAddressProvider().directRemoteAddress();
   case DownstreamRemote:
-    ip = info.downstreamAddressProvider().remoteAddress();
-    break;
+    return info.downstreamAddressProvider().remoteAddress();
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
-  return range_.isInRange(*ip.get());
+}
+
+bool IPMatcher::matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap&,
+                        const StreamInfo::StreamInfo& info) const {
+  return range_.isInRange(*address(type_, connection, info));
+}
+
+bool IPSetMatcher::matches(const Network::Connection& connection,
+                           const Envoy::Http::RequestHeaderMap&,
+                           const StreamInfo::StreamInfo& info) const {
+  const auto& address = IPMatcher::address(type_, connection, info);
+  if (address->ip() == nullptr) {
+    return false;
+  }
+  return !trie_.getData(address).empty();
+}
+
+bool HeaderValueSetMatcher::matches(const Network::Connection&,
+                                    const Envoy::Http::RequestHeaderMap& headers,
+                                    const StreamInfo::StreamInfo&) const {
+  const auto header_value = Envoy::Http::HeaderUtility::getAllOfHeaderAsString(headers, name_);
+  return header_value.result().has_value() && values_.contains(header_value.result().value());
 }
 
 bool PortMatcher::matches(const Network::Connection&, const Envoy::Http::RequestHeaderMap&,
@@ -215,6 +342,15 @@ bool PathMatcher::matches(const Network::Connection&, const Envoy::Http::Request
   return path_matcher_.match(headers.getPathValue());
 }
 
+bool PathSetMatcher::matches(const Network::Connection&,
+                             const Envoy::Http::RequestHeaderMap& headers,
+                             const StreamInfo::StreamInfo&) const {
+  if (headers.Path() == nullptr) {
+    return false;
+  }
+  return paths_.contains(Envoy::Http::PathUtil::removeQueryAndFragment(headers.getPathValue()));
+}
+
 } // namespace RBAC
 } // namespace Common
 } // namespace Filters
@@ -13,8 +13,11 @@
 #include "source/common/common/matchers.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/network/cidr_range.h"
+#include "source/common/network/lc_trie.h"
 #include "source/extensions/filters/common/expr/evaluator.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -85,7 +88,9 @@ private:
 
 /**
  * A composite matcher where only one sub-matcher must match for this to return true. Evaluation
- * short-circuits on the first match.
+ * short-circuits on the first match. The IP ranges, exact header values and exact paths of the
+ * sub-matchers are compiled into set matchers, so that each of these groups is checked with a
+ * single lookup instead of one sub-matcher per rule.
  */
 class OrMatcher : public Matcher {
 public:
@@ -98,6 +103,8 @@ public:
                const StreamInfo::StreamInfo&) const override;
 
 private:
+  template <class Rule> void compile(const Protobuf::RepeatedPtrField<Rule>& rules);
+
   std::vector<MatcherConstSharedPtr> matchers_;
 };
 
@@ -144,11 +151,51 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo& info) const override;
 
+  /**
+   * @return the address of the given type of the connection.
+   */
+  static const Network::Address::InstanceConstSharedPtr&
+  address(Type type, const Network::Connection& connection, const StreamInfo::StreamInfo& info);
+
 private:
   const Network::Address::CidrRange range_;
   const Type type_;
 };
 
+/**
+ * Perform a match against a set of IP CIDR ranges of the same type, with a single lookup in an
+ * LC-Trie.
+ */
+class IPSetMatcher : public Matcher {
+public:
+  IPSetMatcher(const std::vector<Network::Address::CidrRange>& ranges, IPMatcher::Type type)
+      : trie_({{true, ranges}}), type_(type) {}
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo& info) const override;
+
+private:
+  const Network::LcTrie::LcTrie<bool> trie_;
+  const IPMatcher::Type type_;
+};
+
+/**
+ * Matches when the value of an HTTP header, with all its values joined by commas, is exactly one
+ * of a set of values.
+ */
+class HeaderValueSetMatcher : public Matcher {
+public:
+  HeaderValueSetMatcher(const std::string& name, absl::flat_hash_set<std::string>&& values)
+      : name_(name), values_(std::move(values)) {}
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo&) const override;
+
+private:
+  const Envoy::Http::LowerCaseString name_;
+  const absl::flat_hash_set<std::string> values_;
+};
+
 /**
  * Matches the port number of the destination (local) address.
  */
@@ -247,6 +294,21 @@ private:
   const Matchers::PathMatcher path_matcher_;
 };
 
+/**
+ * Matches when the path header on the HTTP request, without its query and fragment string, is
+ * exactly one of a set of paths.
+ */
+class PathSetMatcher : public Matcher {
+public:
+  PathSetMatcher(absl::flat_hash_set<std::string>&& paths) : paths_(std::move(paths)) {}
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo&) const override;
+
+private:
+  const absl::flat_hash_set<std::string> paths_;
+};
+
 } // namespace RBAC
 } // namespace Common
 } // namespace Filters
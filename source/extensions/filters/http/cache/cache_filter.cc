@@ -31,12 +31,16 @@ using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(
     const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config, const std::string&,
-    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache)
-    : time_source_(time_source), cache_(http_cache),
+    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache,
+    RequestCoalescerSharedPtr coalescer)
+    : time_source_(time_source), cache_(http_cache), coalescer_(std::move(coalescer)),
       vary_allow_list_(config.allowed_vary_headers()) {}
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  coalescing_timer_.reset();
+  // Let the requests waiting for this one look up the cache again, or be sent upstream.
+  fetch_.reset();
   if (lookup_) {
     lookup_->onDestroy();
   }
@@ -65,6 +69,13 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  // Only the requests whose responses may fill the cache are coalesced.
+  coalesce_ = coalescer_ != nullptr && request_allows_inserts_ && !is_head_request_ &&
+              headers.get(Http::Headers::get().Range).empty();
+  if (coalesce_) {
+    key_ = lookup_request.key();
+  }
+  request_headers_ = &headers;
   lookup_ = cache_.makeLookupContext(std::move(lookup_request));
 
   ASSERT(lookup_);
@@ -83,6 +94,12 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (filter_state_ == FilterState::WaitingForCoalescedRequest) {
+    // A local reply is sent while the request waits for another one.
+    coalescing_timer_.reset();
+    filter_state_ = FilterState::Initial;
+  }
+
   // If lookup_ is null, the request wasn't cacheable, so the response isn't either.
   if (!lookup_) {
     return Http::FilterHeadersStatus::Continue;
@@ -109,6 +126,10 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     const ResponseMetadata metadata = {time_source_.systemTime()};
     insert_->insertHeaders(headers, metadata, end_stream);
   }
+  if (insert_ == nullptr || end_stream) {
+    // Nothing more will be cached for this request: the requests waiting for it can proceed.
+    fetch_.reset();
+  }
   return Http::FilterHeadersStatus::Continue;
 }
 
@@ -127,6 +148,9 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     // TODO(toddmgreer): Wait for the cache if necessary.
     insert_->insertBody(
         data, [](bool) {}, end_stream);
+    if (end_stream) {
+      fetch_.reset();
+    }
   }
   return Http::FilterDataStatus::Continue;
 }
@@ -158,12 +182,14 @@ void CacheFilter::getHeaders(Http::RequestHeaderMap& request_headers) {
                      headers_raw_ptr = result.headers_.release(),
                      response_ranges = std::move(result.response_ranges_),
                      content_length = result.content_length_,
-                     has_trailers = result.has_trailers_]() mutable {
+                     has_trailers = result.has_trailers_,
+                     stale_while_revalidate = result.stale_while_revalidate_]() mutable {
       // Wrap the raw pointer in a unique_ptr before checking to avoid memory leaks.
       Http::ResponseHeaderMapPtr headers = absl::WrapUnique(headers_raw_ptr);
       if (CacheFilterSharedPtr cache_filter = self.lock()) {
         cache_filter->onHeaders(
-            LookupResult{status, std::move(headers), content_length, response_ranges, has_trailers},
+            LookupResult{status, std::move(headers), content_length, response_ranges, has_trailers,
+                         stale_while_revalidate},
             request_headers);
       }
     });
@@ -239,6 +265,19 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
   case CacheEntryStatus::FoundNotModified:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // We don't yet return or support these codes.
   case CacheEntryStatus::RequiresValidation:
+    if (coalesce_ && result.stale_while_revalidate_) {
+      fetch_ = coalescer_->tryFetch(key_);
+      if (fetch_ == nullptr) {
+        // Another request is validating the cached response, which may be served stale meanwhile.
+        coalescer_->stats().stale_responses_served_while_revalidating_.inc();
+        lookup_result_ = std::make_unique<LookupResult>(std::move(result));
+        filter_state_ = FilterState::DecodeServingFromCache;
+        encodeCachedResponse();
+        return;
+      }
+    } else if (waitForCoalescedRequest()) {
+      return;
+    }
     // If a cache entry requires validation, inject validation headers in the request and let it
     // pass through as if no cache entry was found.
     // If the cache entry was valid, the response status should be 304 (unmodified) and the cache
@@ -248,6 +287,9 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     injectValidationHeaders(request_headers);
     break;
   case CacheEntryStatus::Unusable:
+    if (waitForCoalescedRequest()) {
+      return;
+    }
     break;
   case CacheEntryStatus::NotSatisfiableRange:
     lookup_result_ = std::make_unique<LookupResult>(std::move(result));
@@ -294,6 +336,58 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
   decoder_callbacks_->continueDecoding();
 }
 
+bool CacheFilter::waitForCoalescedRequest() {
+  if (!coalesce_) {
+    return false;
+  }
+  // The request may complete on another worker, so the callback is posted to this one, and only
+  // runs if the filter is still alive.
+  CacheFilterWeakPtr self = weak_from_this();
+  fetch_ = coalescer_->fetchOrWait(key_, [self, &dispatcher = decoder_callbacks_->dispatcher()]() {
+    dispatcher.post([self]() {
+      if (CacheFilterSharedPtr cache_filter = self.lock()) {
+        cache_filter->onCoalescedRequestDone();
+      }
+    });
+  });
+  if (fetch_ != nullptr) {
+    return false;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for a concurrent request for the same key",
+                   *decoder_callbacks_);
+  filter_state_ = FilterState::WaitingForCoalescedRequest;
+  coalescing_timer_ =
+      decoder_callbacks_->dispatcher().createTimer([this]() { onCoalescedRequestTimeout(); });
+  coalescing_timer_->enableTimer(coalescer_->timeout());
+  return true;
+}
+
+void CacheFilter::onCoalescedRequestDone() {
+  if (filter_state_ != FilterState::WaitingForCoalescedRequest) {
+    // The wait timed out, or the filter is being destroyed.
+    return;
+  }
+  coalescing_timer_.reset();
+  filter_state_ = FilterState::Initial;
+  // Look up the response again. If it is still missing or stale, for instance because it wasn't
+  // cacheable or because the cache inserts it asynchronously, the request is sent upstream.
+  coalesce_ = false;
+  lookup_->onDestroy();
+  lookup_ = cache_.makeLookupContext(
+      LookupRequest(*request_headers_, time_source_.systemTime(), vary_allow_list_));
+  getHeaders(*request_headers_);
+}
+
+void CacheFilter::onCoalescedRequestTimeout() {
+  ASSERT(filter_state_ == FilterState::WaitingForCoalescedRequest);
+  ENVOY_STREAM_LOG(debug, "CacheFilter timed out waiting for a concurrent request",
+                   *decoder_callbacks_);
+  coalescer_->stats().coalesced_request_timeouts_.inc();
+  filter_state_ = FilterState::Initial;
+  // decodeHeaders returned StopIteration waiting for the lookup -- continue decoding
+  decoder_callbacks_->continueDecoding();
+}
+
 // TODO(toddmgreer): Handle downstream backpressure.
 void CacheFilter::onBody(Buffer::InstancePtr&& body) {
   // Can be called during decoding if a valid cache hit is found,
@@ -390,6 +484,8 @@ void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_
     const ResponseMetadata metadata = {time_source_.systemTime()};
     cache_.updateHeaders(*lookup_, response_headers, metadata);
   }
+  // The requests waiting for this validation can look up the cache again.
+  fetch_.reset();
 
   // A cache entry was successfully validated -> encode cached body and trailers.
   encodeCachedResponse();
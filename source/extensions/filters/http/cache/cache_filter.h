@@ -5,11 +5,13 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
 
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -26,7 +28,7 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              HttpCache& http_cache);
+              HttpCache& http_cache, RequestCoalescerSharedPtr coalescer);
   // Http::StreamFilterBase
   void onDestroy() override;
   // Http::StreamDecoderFilter
@@ -48,6 +50,15 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Returns true if the request waits for the response to another request for the same key, which
+  // is being sent upstream. Otherwise, this request is the one sent upstream for the key, and its
+  // response completes the wait of the requests coalesced with it.
+  bool waitForCoalescedRequest();
+
+  // Called once the response to the request this one waits for is cached, or won't be.
+  void onCoalescedRequestDone();
+  void onCoalescedRequestTimeout();
+
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
   //               filter_state_ is ValidatingCachedResponse.
   // Serves a validated cached response after updating it with a 304 response.
@@ -76,6 +87,13 @@ private:
 
   TimeSource& time_source_;
   HttpCache& cache_;
+  // Null if request coalescing is disabled.
+  const RequestCoalescerSharedPtr coalescer_;
+  // Held while this request is the one sent upstream for its key.
+  RequestCoalescer::FetchPtr fetch_;
+  Event::TimerPtr coalescing_timer_;
+  Http::RequestHeaderMap* request_headers_{};
+  Key key_;
   LookupContextPtr lookup_;
   InsertContextPtr insert_;
   LookupResultPtr lookup_result_;
@@ -99,9 +117,17 @@ private:
   // https://httpwg.org/specs/rfc7234.html#response.cacheability
   bool request_allows_inserts_ = false;
 
+  // True if the request may be coalesced with the concurrent requests for the same key. Cleared
+  // once it has waited for another request, so that it is sent upstream if it still misses.
+  bool coalesce_ = false;
+
   enum class FilterState {
     Initial,
 
+    // Cache lookup missed, or found a cached response that requires validation, and the request
+    // waits for the response to a concurrent request for the same key to be cached.
+    WaitingForCoalescedRequest,
+
     // Cache lookup found a cached response that requires validation
     ValidatingCachedResponse,
 
@@ -88,6 +88,11 @@ struct ResponseCacheControl {
   // max_age is set if to 's-maxage' if present, if not it is set to 'max-age' if present.
   // Indicates the maximum time after which this response will be considered stale
   OptionalDuration max_age_;
+
+  // Set to 'stale-while-revalidate' if present, as defined by:
+  // https://tools.ietf.org/html/rfc5861#section-3
+  // This response may be served stale for up to this long while it is being validated
+  OptionalDuration stale_while_revalidate_;
 };
 
 bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs);
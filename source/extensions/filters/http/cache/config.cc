@@ -1,6 +1,8 @@
 #include "source/extensions/filters/http/cache/config.h"
 
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/cache_filter.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -18,11 +20,17 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
         fmt::format("Didn't find a registered implementation for type: '{}'", type));
   }
 
-  return [config, stats_prefix, &context,
-          http_cache_factory](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(),
-                                                            http_cache_factory->getCache(config)));
+  std::shared_ptr<HttpCache> cache = http_cache_factory->getCache(config, context);
+  RequestCoalescerSharedPtr coalescer;
+  if (config.has_request_coalescing_timeout()) {
+    coalescer = std::make_shared<RequestCoalescer>(
+        std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(config, request_coalescing_timeout)),
+        stats_prefix, context.scope());
+  }
+  return [config, stats_prefix, &context, cache,
+          coalescer](Http::FilterChainFactoryCallbacks& callbacks) {
+    callbacks.addStreamFilter(std::make_shared<CacheFilter>(
+        config, stats_prefix, context.scope(), context.timeSource(), *cache, coalescer));
   };
 }
 
@@ -0,0 +1,486 @@
+#include "source/extensions/filters/http/cache/disk_http_cache/disk_http_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "envoy/common/exception.h"
+#include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/utility.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr uint64_t DefaultSegmentSizeBytes = 64 * 1024 * 1024;
+constexpr uint64_t DefaultMaxCacheSizeBytes = 1024 * 1024 * 1024;
+constexpr uint64_t DefaultMaxPendingInsertBytes = 16 * 1024 * 1024;
+
+// References a body in a segment, which it keeps mapped until the buffer is done with it.
+class SegmentFragment : public Buffer::BufferFragment {
+public:
+  SegmentFragment(SegmentSharedPtr segment, absl::string_view data)
+      : segment_(std::move(segment)), data_(data) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_.data(); }
+  size_t size() const override { return data_.size(); }
+  void done() override { delete this; }
+
+private:
+  const SegmentSharedPtr segment_;
+  const absl::string_view data_;
+};
+
+class DiskLookupContext : public LookupContext {
+public:
+  DiskLookupContext(DiskHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    entry_ = cache_.lookup(request_, entry_key_);
+    if (!entry_.response_headers_) {
+      cb(LookupResult{});
+      return;
+    }
+    cb(request_.makeLookupResult(
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry_.response_headers_),
+        ResponseMetadata(entry_.metadata_), entry_.body_size_));
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(range.end() <= entry_.body_size_, "Attempt to read past end of body.");
+    // The range maps directly onto the segment file.
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    buffer->addBufferFragment(*new SegmentFragment(
+        entry_.segment_, entry_.segment_->read(entry_.offset_ + range.begin(), range.length())));
+    cb(std::move(buffer));
+  }
+
+  void getTrailers(LookupTrailersCallback&&) override {
+    // Trailers are not cached.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  void onDestroy() override {}
+
+  const LookupRequest& request() const { return request_; }
+  // The key of the entry found by getHeaders(), if any.
+  absl::string_view entryKey() const { return entry_key_; }
+
+private:
+  DiskHttpCache& cache_;
+  const LookupRequest request_;
+  std::string entry_key_;
+  DiskHttpCache::Entry entry_;
+};
+
+class DiskInsertContext : public InsertContext {
+public:
+  DiskInsertContext(LookupContext& lookup_context, DiskHttpCache& cache)
+      : key_(dynamic_cast<DiskLookupContext&>(lookup_context).request().key()),
+        request_vary_headers_(
+            dynamic_cast<DiskLookupContext&>(lookup_context).request().getVaryHeaders()),
+        cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    body_->add(chunk);
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // Trailers are not cached.
+  }
+
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.insert(key_, std::move(response_headers_), std::move(metadata_), std::move(body_),
+                  request_vary_headers_);
+  }
+
+  const Key key_;
+  const Http::RequestHeaderMap& request_vary_headers_;
+  DiskHttpCache& cache_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  Buffer::InstancePtr body_{std::make_unique<Buffer::OwnedImpl>()};
+  bool committed_{false};
+};
+
+std::string variedKey(const Key& key, const Http::HeaderMap::GetResult& vary_header,
+                      const Http::RequestHeaderMap& request_vary_headers) {
+  Key varied_key = key;
+  varied_key.add_custom_fields(VaryHeader::createVaryKey(vary_header, request_vary_headers));
+  return varied_key.SerializeAsString();
+}
+
+} // namespace
+
+StatusOr<SegmentSharedPtr> Segment::create(const std::string& directory, uint64_t size) {
+  std::string path = absl::StrCat(directory, "/envoy_http_cache_XXXXXX");
+  const int fd = ::mkstemp(path.data());
+  if (fd == -1) {
+    return absl::InternalError(
+        fmt::format("unable to create a cache segment in {}: {}", directory, errorDetails(errno)));
+  }
+  ::unlink(path.c_str());
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+#ifdef __linux__
+  // Allocates the blocks of the file up front, so that writing to the mapping can't fail with
+  // SIGBUS if the file system fills up.
+  const int allocate_error = ::posix_fallocate(fd, 0, size);
+#else
+  const Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(fd, size);
+  const int allocate_error = truncate_result.rc_ == -1 ? truncate_result.errno_ : 0;
+#endif
+  if (allocate_error != 0) {
+    os_sys_calls.close(fd);
+    return absl::InternalError(
+        fmt::format("unable to allocate a cache segment of {} bytes in {}: {}", size, directory,
+                    errorDetails(allocate_error)));
+  }
+
+  const Api::SysCallPtrResult result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open.
+  os_sys_calls.close(fd);
+  if (result.rc_ == MAP_FAILED) {
+    return absl::InternalError(fmt::format("unable to map a cache segment of {} bytes in {}: {}",
+                                           size, directory, errorDetails(result.errno_)));
+  }
+  return std::make_shared<Segment>(static_cast<char*>(result.rc_), size);
+}
+
+Segment::~Segment() { ::munmap(base_, size_); }
+
+absl::optional<uint64_t> Segment::append(const Buffer::Instance& data) {
+  if (data.length() > size_ - write_offset_) {
+    return absl::nullopt;
+  }
+  const uint64_t offset = write_offset_;
+  data.copyOut(0, data.length(), base_ + offset);
+  write_offset_ += data.length();
+  return offset;
+}
+
+DiskHttpCache::DiskHttpCache(
+    const envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig& config,
+    Thread::ThreadFactory& thread_factory, Stats::Scope& scope)
+    : cache_path_(config.cache_path()),
+      segment_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, segment_size_bytes, DefaultSegmentSizeBytes)),
+      max_segments_(std::max<uint64_t>(
+          1, PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_cache_size_bytes,
+                                             DefaultMaxCacheSizeBytes) /
+                 segment_size_)),
+      max_pending_insert_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_insert_bytes,
+                                                                DefaultMaxPendingInsertBytes)),
+      stats_{ALL_DISK_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "http_cache.disk."),
+                                       POOL_GAUGE_PREFIX(scope, "http_cache.disk."))} {
+  // Creating the first segment here reports an unusable cache_path as a config error.
+  const absl::Status status = addSegment();
+  if (!status.ok()) {
+    throw EnvoyException(std::string(status.message()));
+  }
+  writer_thread_ = thread_factory.createThread([this]() -> void { writerThreadRoutine(); },
+                                               Thread::Options{"cache_writer"});
+}
+
+DiskHttpCache::~DiskHttpCache() {
+  {
+    Thread::LockGuard lock(queue_mutex_);
+    shutdown_ = true;
+    queue_event_.notifyOne();
+  }
+  writer_thread_->join();
+
+  // The inserts still queued are dropped.
+  Thread::LockGuard lock(queue_mutex_);
+  stats_.pending_insert_bytes_.sub(pending_insert_bytes_);
+  stats_.segments_.sub(segments_.size());
+}
+
+LookupContextPtr DiskHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<DiskLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr DiskHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<DiskInsertContext>(*lookup_context, *this);
+}
+
+void DiskHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                  const Http::ResponseHeaderMap& response_headers,
+                                  const ResponseMetadata& metadata) {
+  const absl::string_view key = dynamic_cast<const DiskLookupContext&>(lookup_context).entryKey();
+  std::shared_ptr<const Http::ResponseHeaderMap> headers =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+
+  absl::WriterMutexLock lock(&index_mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    // The entry was evicted since it was looked up.
+    return;
+  }
+  it->second.response_headers_ = std::move(headers);
+  it->second.metadata_ = metadata;
+}
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.disk";
+
+CacheInfo DiskHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  cache_info.supports_range_requests_ = true;
+  return cache_info;
+}
+
+DiskHttpCache::Entry DiskHttpCache::lookup(const LookupRequest& request, std::string& entry_key) {
+  entry_key = request.key().SerializeAsString();
+  Entry entry;
+  {
+    absl::ReaderMutexLock lock(&index_mutex_);
+    auto it = index_.find(entry_key);
+    if (it != index_.end() && it->second.segment_ == nullptr) {
+      // The entry only flags that the responses to this request vary.
+      entry_key = variedKey(request.key(),
+                            it->second.response_headers_->get(Http::CustomHeaders::get().Vary),
+                            request.getVaryHeaders());
+      it = index_.find(entry_key);
+    }
+    if (it != index_.end()) {
+      entry = it->second;
+    }
+  }
+  if (entry.response_headers_) {
+    stats_.hits_.inc();
+  } else {
+    stats_.misses_.inc();
+  }
+  return entry;
+}
+
+void DiskHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+                           ResponseMetadata&& metadata, Buffer::InstancePtr&& body,
+                           const Http::RequestHeaderMap& request_vary_headers) {
+  const uint64_t body_size = body->length();
+  if (body_size > segment_size_) {
+    stats_.rejected_inserts_.inc();
+    return;
+  }
+
+  std::vector<PendingInsert> inserts;
+  const auto vary_header = response_headers->get(Http::CustomHeaders::get().Vary);
+  std::string entry_key;
+  if (vary_header.empty()) {
+    entry_key = key.SerializeAsString();
+  } else {
+    // Add a special entry to flag that this request generates varied responses. It is written
+    // first, so that the response is found as soon as it is in the index.
+    Http::ResponseHeaderMapPtr vary_only_map =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+    // Only the first vary header is kept.
+    vary_only_map->setCopy(Http::CustomHeaders::get().Vary,
+                           vary_header[0]->value().getStringView());
+    inserts.push_back({key.SerializeAsString(), {std::move(vary_only_map), {}, nullptr}, nullptr});
+    entry_key = variedKey(key, vary_header, request_vary_headers);
+  }
+  inserts.push_back({std::move(entry_key),
+                     {std::move(response_headers), std::move(metadata), nullptr, 0, body_size},
+                     std::move(body)});
+
+  Thread::LockGuard lock(queue_mutex_);
+  if (pending_insert_bytes_ + body_size > max_pending_insert_bytes_) {
+    stats_.rejected_inserts_.inc();
+    return;
+  }
+  pending_insert_bytes_ += body_size;
+  stats_.pending_insert_bytes_.add(body_size);
+  for (PendingInsert& insert : inserts) {
+    queue_.push_back(std::move(insert));
+  }
+  queue_event_.notifyOne();
+}
+
+void DiskHttpCache::writerThreadRoutine() {
+  while (true) {
+    PendingInsert insert;
+    {
+      Thread::LockGuard lock(queue_mutex_);
+      while (queue_.empty() && !shutdown_) {
+        queue_event_.wait(queue_mutex_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      insert = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    const uint64_t body_size = insert.entry_.body_size_;
+    write(std::move(insert));
+
+    Thread::LockGuard lock(queue_mutex_);
+    pending_insert_bytes_ -= body_size;
+    stats_.pending_insert_bytes_.sub(body_size);
+  }
+}
+
+void DiskHttpCache::write(PendingInsert&& insert) {
+  if (insert.body_ != nullptr) {
+    absl::optional<uint64_t> offset = segments_.back().segment_->append(*insert.body_);
+    if (!offset.has_value()) {
+      const absl::Status status = addSegment();
+      if (!status.ok()) {
+        ENVOY_LOG(warn, "not caching a response: {}", status.message());
+        stats_.rejected_inserts_.inc();
+        stats_.segment_creation_failures_.inc();
+        return;
+      }
+      offset = segments_.back().segment_->append(*insert.body_);
+      ASSERT(offset.has_value());
+    }
+    insert.entry_.segment_ = segments_.back().segment_;
+    insert.entry_.offset_ = offset.value();
+  }
+
+  const bool has_body = insert.body_ != nullptr;
+  insert.entry_.segment_id_ = segments_.back().id_;
+  segments_.back().keys_.push_back(insert.key_);
+  {
+    absl::WriterMutexLock lock(&index_mutex_);
+    index_.insert_or_assign(std::move(insert.key_), std::move(insert.entry_));
+  }
+  if (has_body) {
+    stats_.inserts_.inc();
+  }
+}
+
+absl::Status DiskHttpCache::addSegment() {
+  StatusOr<SegmentSharedPtr> segment = Segment::create(cache_path_, segment_size_);
+  if (!segment.ok()) {
+    return segment.status();
+  }
+  stats_.segments_created_.inc();
+  stats_.segments_.inc();
+
+  if (segments_.size() == max_segments_) {
+    // Drops the oldest segment, and the entries which are still in it. Responses being served from
+    // it keep it mapped until they are done.
+    SegmentKeys oldest = std::move(segments_.front());
+    segments_.pop_front();
+    stats_.segments_.dec();
+
+    absl::WriterMutexLock lock(&index_mutex_);
+    for (const std::string& key : oldest.keys_) {
+      auto it = index_.find(key);
+      // Skip the keys which have been recorded again in a newer segment since.
+      if (it != index_.end() && it->second.segment_id_ == oldest.id_) {
+        if (it->second.segment_ != nullptr) {
+          stats_.evictions_.inc();
+        }
+        index_.erase(it);
+      }
+    }
+  }
+  segments_.push_back({std::move(segment.value()), next_segment_id_++, {}});
+  return absl::OkStatus();
+}
+
+namespace {
+
+// The disk caches of a server, one for each distinct config.
+class DiskHttpCacheSingleton : public Singleton::Instance {
+public:
+  DiskHttpCacheSingleton(Thread::ThreadFactory& thread_factory, Stats::Scope& scope)
+      : thread_factory_(thread_factory), scope_(scope) {}
+
+  DiskHttpCache&
+  get(const envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig& config) {
+    std::unique_ptr<DiskHttpCache>& cache = caches_[MessageUtil::hash(config)];
+    if (cache == nullptr) {
+      cache = std::make_unique<DiskHttpCache>(config, thread_factory_, scope_);
+    }
+    return *cache;
+  }
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  Stats::Scope& scope_;
+  absl::flat_hash_map<size_t, std::unique_ptr<DiskHttpCache>> caches_;
+};
+
+} // namespace
+
+SINGLETON_MANAGER_REGISTRATION(disk_http_cache_singleton);
+
+class DiskHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  std::shared_ptr<HttpCache>
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig disk_config;
+    MessageUtil::anyConvertAndValidate(config.typed_config(), disk_config,
+                                       context.messageValidationVisitor());
+    std::shared_ptr<DiskHttpCacheSingleton> singleton =
+        context.singletonManager().getTyped<DiskHttpCacheSingleton>(
+            SINGLETON_MANAGER_REGISTERED_NAME(disk_http_cache_singleton), [&context] {
+              return std::make_shared<DiskHttpCacheSingleton>(
+                  context.api().threadFactory(), context.getServerFactoryContext().scope());
+            });
+    // The returned pointer owns the singleton, so that the caches live as long as any filter
+    // config using them.
+    return std::shared_ptr<HttpCache>(singleton, &singleton->get(disk_config));
+  }
+};
+
+static Registry::RegisterFactory<DiskHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
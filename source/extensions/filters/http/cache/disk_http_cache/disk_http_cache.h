@@ -0,0 +1,166 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/extensions/cache/disk_http_cache/v3alpha/config.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/common/statusor.h"
+#include "source/common/common/thread.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All disk HTTP cache stats. @see stats_macros.h
+ */
+#define ALL_DISK_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                  \
+  COUNTER(evictions)                                                                               \
+  COUNTER(hits)                                                                                    \
+  COUNTER(inserts)                                                                                 \
+  COUNTER(misses)                                                                                  \
+  COUNTER(rejected_inserts)                                                                        \
+  COUNTER(segment_creation_failures)                                                               \
+  COUNTER(segments_created)                                                                        \
+  GAUGE(pending_insert_bytes, NeverImport)                                                         \
+  GAUGE(segments, NeverImport)
+
+/**
+ * Struct definition for all disk HTTP cache stats. @see stats_macros.h
+ */
+struct DiskHttpCacheStats {
+  ALL_DISK_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class Segment;
+using SegmentSharedPtr = std::shared_ptr<Segment>;
+
+// A file of cached bodies, mapped in memory. Bodies are appended by the writer thread of the cache,
+// and read straight from the mapping by any thread. The mapping lives as long as the last response
+// served from it.
+class Segment {
+public:
+  // Creates a file of the given size in the directory, and maps it. The file is unlinked right away
+  // so that it is removed once unmapped.
+  static StatusOr<SegmentSharedPtr> create(const std::string& directory, uint64_t size);
+
+  // Takes ownership of a mapping of the given size.
+  Segment(char* base, uint64_t size) : size_(size), base_(base) {}
+  ~Segment();
+
+  // Appends data to the segment. Returns the offset it was written at, or nothing if the segment
+  // doesn't have room for it.
+  absl::optional<uint64_t> append(const Buffer::Instance& data);
+
+  absl::string_view read(uint64_t offset, uint64_t length) const {
+    ASSERT(offset + length <= size_);
+    return {base_ + offset, length};
+  }
+
+private:
+  const uint64_t size_;
+  char* const base_;
+  // Only accessed by the writer thread.
+  uint64_t write_offset_{0};
+};
+
+// Cache backend which keeps the bodies of responses in memory mapped segment files, and everything
+// else in an in-memory index. Insertions are queued to a writer thread, so that workers never
+// block on the file system.
+class DiskHttpCache : public HttpCache, Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  struct Entry {
+    std::shared_ptr<const Http::ResponseHeaderMap> response_headers_;
+    ResponseMetadata metadata_;
+    // Null for the entries which only flag that the responses to a request vary.
+    SegmentSharedPtr segment_;
+    uint64_t offset_{};
+    uint64_t body_size_{};
+    // The id of the segment the key of the entry was recorded in, with or without a body. The entry
+    // is evicted with that segment.
+    uint64_t segment_id_{};
+  };
+
+  DiskHttpCache(
+      const envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig& config,
+      Thread::ThreadFactory& thread_factory, Stats::Scope& scope);
+  ~DiskHttpCache() override;
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+  CacheInfo cacheInfo() const override;
+
+  // Looks up the response to the request, following its vary headers if it has any. Sets entry_key
+  // to the key of the returned entry. Returns an entry without headers on a miss.
+  Entry lookup(const LookupRequest& request, std::string& entry_key);
+
+  // Queues a response to be written by the writer thread. If the response varies on some headers,
+  // it is cached under a key which includes their values in request_vary_headers.
+  void insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, Buffer::InstancePtr&& body,
+              const Http::RequestHeaderMap& request_vary_headers);
+
+private:
+  struct PendingInsert {
+    std::string key_;
+    Entry entry_;
+    Buffer::InstancePtr body_;
+  };
+
+  struct SegmentKeys {
+    SegmentSharedPtr segment_;
+    uint64_t id_;
+    // The keys of the entries recorded in the segment.
+    std::vector<std::string> keys_;
+  };
+
+  void writerThreadRoutine();
+  void write(PendingInsert&& insert);
+  // Creates a new segment to append to, dropping the oldest one if there are already max_segments_.
+  absl::Status addSegment();
+
+  const std::string cache_path_;
+  const uint64_t segment_size_;
+  const uint64_t max_segments_;
+  const uint64_t max_pending_insert_bytes_;
+  DiskHttpCacheStats stats_;
+
+  absl::Mutex index_mutex_;
+  absl::flat_hash_map<std::string, Entry> index_ ABSL_GUARDED_BY(index_mutex_);
+
+  Thread::MutexBasicLockable queue_mutex_;
+  Thread::CondVar queue_event_;
+  std::deque<PendingInsert> queue_ ABSL_GUARDED_BY(queue_mutex_);
+  uint64_t pending_insert_bytes_ ABSL_GUARDED_BY(queue_mutex_){0};
+  bool shutdown_ ABSL_GUARDED_BY(queue_mutex_){false};
+
+  // Only accessed by the writer thread once it is started: the segments from the oldest to the
+  // newest.
+  std::deque<SegmentKeys> segments_;
+  uint64_t next_segment_id_{0};
+  Thread::ThreadPtr writer_thread_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -78,7 +78,9 @@ void LookupRequest::initializeRequestCacheControl(const Http::RequestHeaderMap&
 }
 
 bool LookupRequest::requiresValidation(const Http::ResponseHeaderMap& response_headers,
-                                       SystemTime::duration response_age) const {
+                                       SystemTime::duration response_age,
+                                       bool& stale_while_revalidate) const {
+  stale_while_revalidate = false;
   // TODO(yosrym93): Store parsed response cache-control in cache instead of parsing it on every
   // lookup.
   const absl::string_view cache_control =
@@ -113,10 +115,18 @@ bool LookupRequest::requiresValidation(const Http::ResponseHeaderMap& response_h
     // Response is stale, requires validation if
     // the response does not allow being served stale,
     // or the request max-stale directive does not allow it.
-    const bool allowed_by_max_stale =
-        request_cache_control_.max_stale_.has_value() &&
-        request_cache_control_.max_stale_.value() > response_age - freshness_lifetime;
-    return response_cache_control.no_stale_ || !allowed_by_max_stale;
+    const SystemTime::duration staleness = response_age - freshness_lifetime;
+    const bool allowed_by_max_stale = request_cache_control_.max_stale_.has_value() &&
+                                      request_cache_control_.max_stale_.value() > staleness;
+    if (response_cache_control.no_stale_ || !allowed_by_max_stale) {
+      // The response may still be served while it is being validated, if its
+      // stale-while-revalidate directive allows it.
+      stale_while_revalidate = !response_cache_control.no_stale_ &&
+                               response_cache_control.stale_while_revalidate_.has_value() &&
+                               response_cache_control.stale_while_revalidate_.value() > staleness;
+      return true;
+    }
+    return false;
   } else {
     // Response is fresh, requires validation only if there is an unsatisfied min-fresh requirement.
     const bool min_fresh_unsatisfied =
@@ -138,9 +148,10 @@ LookupResult LookupRequest::makeLookupResult(Http::ResponseHeaderMapPtr&& respon
       CacheHeadersUtils::calculateAge(*response_headers, metadata.response_time_, timestamp_);
   response_headers->setInline(CacheCustomHeaders::age(), std::to_string(age.count()));
 
-  result.cache_entry_status_ = requiresValidation(*response_headers, age)
-                                   ? CacheEntryStatus::RequiresValidation
-                                   : CacheEntryStatus::Ok;
+  result.cache_entry_status_ =
+      requiresValidation(*response_headers, age, result.stale_while_revalidate_)
+          ? CacheEntryStatus::RequiresValidation
+          : CacheEntryStatus::Ok;
   result.headers_ = std::move(response_headers);
   result.content_length_ = content_length;
   if (!adjustByteRangeSet(result.response_ranges_, request_range_spec_, content_length)) {
@@ -9,6 +9,7 @@
 #include "envoy/config/typed_config.h"
 #include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
 #include "envoy/http/header_map.h"
+#include "envoy/server/factory_context.h"
 
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
@@ -145,6 +146,10 @@ struct LookupResult {
   // True if the cached response has trailers.
   bool has_trailers_ = false;
 
+  // True if cache_entry_status_ == RequiresValidation, but the cached response may be served
+  // while it is being validated, as allowed by its stale-while-revalidate directive.
+  bool stale_while_revalidate_ = false;
+
   // Update the content length of the object and its response headers.
   void setContentLength(uint64_t new_length) {
     content_length_ = new_length;
@@ -211,8 +216,10 @@ public:
 
 private:
   void initializeRequestCacheControl(const Http::RequestHeaderMap& request_headers);
+  // Sets stale_while_revalidate if the response requires validation, but may be served while it
+  // is being validated.
   bool requiresValidation(const Http::ResponseHeaderMap& response_headers,
-                          SystemTime::duration age) const;
+                          SystemTime::duration age, bool& stale_while_revalidate) const;
 
   Key key_;
   std::vector<RawByteRange> request_range_spec_;
@@ -371,10 +378,11 @@ public:
   // From UntypedFactory
   std::string category() const override { return "envoy.http.cache"; }
 
-  // Returns an HttpCache that will remain valid indefinitely (at least as long
-  // as the calling CacheFilter).
-  virtual HttpCache&
-  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config) PURE;
+  // Returns an HttpCache for the given config, shared by all the CacheFilters
+  // created from the same filter config. Called on the main thread.
+  virtual std::shared_ptr<HttpCache>
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) PURE;
   ~HttpCacheFactory() override = default;
 
 private:
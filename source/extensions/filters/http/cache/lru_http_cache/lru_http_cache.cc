@@ -0,0 +1,399 @@
+#include "source/extensions/filters/http/cache/lru_http_cache/lru_http_cache.h"
+
+#include <algorithm>
+
+#include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/hash.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr uint64_t DefaultMaxCacheSizeBytes = 256 * 1024 * 1024;
+constexpr uint32_t DefaultShards = 16;
+
+// References a part of a cached body, which it keeps alive until the buffer is done with it.
+class BodyFragment : public Buffer::BufferFragment {
+public:
+  BodyFragment(LruHttpCache::BodySharedPtr body, absl::string_view data)
+      : body_(std::move(body)), data_(data) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_.data(); }
+  size_t size() const override { return data_.size(); }
+  void done() override { delete this; }
+
+private:
+  const LruHttpCache::BodySharedPtr body_;
+  const absl::string_view data_;
+};
+
+class LruLookupContext : public LookupContext {
+public:
+  LruLookupContext(LruHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    LruHttpCache::Entry entry = cache_.lookup(request_, entry_key_);
+    if (!entry.response_headers_) {
+      cb(LookupResult{});
+      return;
+    }
+    body_ = std::move(entry.body_);
+    cb(request_.makeLookupResult(
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+        std::move(entry.metadata_), entry.body_size_));
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(body_ != nullptr);
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    uint64_t chunk_begin = 0;
+    for (const std::string& chunk : *body_) {
+      const uint64_t chunk_end = chunk_begin + chunk.size();
+      if (chunk_end > range.begin() && chunk_begin < range.end()) {
+        const uint64_t begin = std::max(chunk_begin, range.begin());
+        const uint64_t end = std::min(chunk_end, range.end());
+        buffer->addBufferFragment(*new BodyFragment(
+            body_, absl::string_view(chunk).substr(begin - chunk_begin, end - begin)));
+      }
+      if (chunk_end >= range.end()) {
+        break;
+      }
+      chunk_begin = chunk_end;
+    }
+    ASSERT(buffer->length() == range.length(), "Attempt to read past end of body.");
+    cb(std::move(buffer));
+  }
+
+  void getTrailers(LookupTrailersCallback&&) override {
+    // Trailers are not cached.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  void onDestroy() override {}
+
+  const LookupRequest& request() const { return request_; }
+  // The key of the entry found by getHeaders(), if any.
+  absl::string_view entryKey() const { return entry_key_; }
+
+private:
+  LruHttpCache& cache_;
+  const LookupRequest request_;
+  std::string entry_key_;
+  LruHttpCache::BodySharedPtr body_;
+};
+
+class LruInsertContext : public InsertContext {
+public:
+  LruInsertContext(LookupContext& lookup_context, LruHttpCache& cache)
+      : key_(dynamic_cast<LruLookupContext&>(lookup_context).request().key()),
+        request_vary_headers_(
+            dynamic_cast<LruLookupContext&>(lookup_context).request().getVaryHeaders()),
+        cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    // Each chunk is copied once, and never concatenated with the others.
+    if (chunk.length() > 0) {
+      body_.push_back(chunk.toString());
+      body_size_ += chunk.length();
+    }
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // Trailers are not cached.
+  }
+
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.insert(key_, std::move(response_headers_), std::move(metadata_), std::move(body_),
+                  body_size_, request_vary_headers_);
+  }
+
+  const Key key_;
+  const Http::RequestHeaderMap& request_vary_headers_;
+  LruHttpCache& cache_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  LruHttpCache::Body body_;
+  uint64_t body_size_{0};
+  bool committed_{false};
+};
+
+std::string variedKey(const Key& key, const Http::HeaderMap::GetResult& vary_header,
+                      const Http::RequestHeaderMap& request_vary_headers) {
+  Key varied_key = key;
+  varied_key.add_custom_fields(VaryHeader::createVaryKey(vary_header, request_vary_headers));
+  return varied_key.SerializeAsString();
+}
+
+} // namespace
+
+LruHttpCache::LruHttpCache(
+    const envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig& config,
+    Stats::Scope& scope)
+    : stats_{ALL_LRU_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "http_cache.lru."),
+                                      POOL_GAUGE_PREFIX(scope, "http_cache.lru."))},
+      max_bytes_per_shard_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_cache_size_bytes, DefaultMaxCacheSizeBytes) /
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shards, DefaultShards)) {
+  const uint32_t shards = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shards, DefaultShards);
+  shards_.reserve(shards);
+  for (uint32_t i = 0; i < shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(max_bytes_per_shard_, stats_));
+  }
+}
+
+LookupContextPtr LruHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<LruLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr LruHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<LruInsertContext>(*lookup_context, *this);
+}
+
+void LruHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const ResponseMetadata& metadata) {
+  const absl::string_view key = dynamic_cast<const LruLookupContext&>(lookup_context).entryKey();
+  shard(key).updateHeaders(key, response_headers, metadata);
+}
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.lru";
+
+CacheInfo LruHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  cache_info.supports_range_requests_ = true;
+  return cache_info;
+}
+
+LruHttpCache::Entry LruHttpCache::lookup(const LookupRequest& request, std::string& entry_key) {
+  entry_key = request.key().SerializeAsString();
+  Entry entry = shard(entry_key).find(entry_key);
+  if (entry.response_headers_ && VaryHeader::hasVary(*entry.response_headers_)) {
+    // The entry only flags that the responses to this request vary.
+    entry_key =
+        variedKey(request.key(), entry.response_headers_->get(Http::CustomHeaders::get().Vary),
+                  request.getVaryHeaders());
+    entry = shard(entry_key).find(entry_key);
+  }
+  if (entry.response_headers_) {
+    stats_.hits_.inc();
+  } else {
+    stats_.misses_.inc();
+  }
+  return entry;
+}
+
+void LruHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+                          ResponseMetadata&& metadata, Body&& body, uint64_t body_size,
+                          const Http::RequestHeaderMap& request_vary_headers) {
+  const auto vary_header = response_headers->get(Http::CustomHeaders::get().Vary);
+  if (vary_header.empty()) {
+    insertEntry(key.SerializeAsString(), Entry{std::move(response_headers), std::move(metadata),
+                                               std::make_shared<const Body>(std::move(body)),
+                                               body_size});
+    return;
+  }
+
+  // Add a special entry to flag that this request generates varied responses.
+  Http::ResponseHeaderMapPtr vary_only_map = Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  // Only the first vary header is kept.
+  vary_only_map->setCopy(Http::CustomHeaders::get().Vary, vary_header[0]->value().getStringView());
+  std::string varied_key = variedKey(key, vary_header, request_vary_headers);
+  insertEntry(std::move(varied_key),
+              Entry{std::move(response_headers), std::move(metadata),
+                    std::make_shared<const Body>(std::move(body)), body_size});
+  insertEntry(key.SerializeAsString(),
+              Entry{std::move(vary_only_map), {}, std::make_shared<const Body>(), 0});
+}
+
+LruHttpCache::Shard& LruHttpCache::shard(absl::string_view key) {
+  return *shards_[HashUtil::xxHash64(key) % shards_.size()];
+}
+
+void LruHttpCache::insertEntry(std::string&& key, Entry&& entry) {
+  shard(key).insert(std::move(key), std::move(entry));
+}
+
+LruHttpCache::Shard::~Shard() {
+  absl::MutexLock lock(&mutex_);
+  while (!lru_.empty()) {
+    removeLocked(lru_.begin());
+  }
+}
+
+LruHttpCache::Entry LruHttpCache::Shard::find(absl::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return Entry{};
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->entry_;
+}
+
+void LruHttpCache::Shard::insert(std::string&& key, Entry&& entry) {
+  Node node{std::move(key), std::move(entry), 0};
+  node.size_ = nodeSize(node);
+  if (node.size_ > max_bytes_) {
+    stats_.rejected_inserts_.inc();
+    return;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(node.key_);
+  if (it != index_.end()) {
+    removeLocked(it->second);
+  }
+  while (bytes_ + node.size_ > max_bytes_) {
+    removeLocked(std::prev(lru_.end()));
+    stats_.evictions_.inc();
+  }
+
+  bytes_ += node.size_;
+  stats_.cached_bytes_.add(node.size_);
+  stats_.entries_.inc();
+  stats_.inserts_.inc();
+  lru_.push_front(std::move(node));
+  index_.emplace(lru_.front().key_, lru_.begin());
+}
+
+void LruHttpCache::Shard::updateHeaders(absl::string_view key,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const ResponseMetadata& metadata) {
+  std::shared_ptr<const Http::ResponseHeaderMap> headers =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    // The entry was evicted since it was looked up.
+    return;
+  }
+  // The entry was just validated, so it is the most recently used.
+  lru_.splice(lru_.begin(), lru_, it->second);
+  Node& node = lru_.front();
+  node.entry_.response_headers_ = std::move(headers);
+  node.entry_.metadata_ = metadata;
+  const uint64_t size = nodeSize(node);
+  if (size >= node.size_) {
+    stats_.cached_bytes_.add(size - node.size_);
+  } else {
+    stats_.cached_bytes_.sub(node.size_ - size);
+  }
+  bytes_ = bytes_ - node.size_ + size;
+  node.size_ = size;
+  while (bytes_ > max_bytes_ && lru_.size() > 1) {
+    removeLocked(std::prev(lru_.end()));
+    stats_.evictions_.inc();
+  }
+}
+
+uint64_t LruHttpCache::Shard::nodeSize(const Node& node) {
+  return sizeof(Node) + node.key_.size() + node.entry_.response_headers_->byteSize() +
+         node.entry_.body_size_;
+}
+
+void LruHttpCache::Shard::removeLocked(NodeList::iterator node) {
+  bytes_ -= node->size_;
+  stats_.cached_bytes_.sub(node->size_);
+  stats_.entries_.dec();
+  index_.erase(node->key_);
+  lru_.erase(node);
+}
+
+namespace {
+
+// The LRU caches of a server, one for each distinct config.
+class LruHttpCacheSingleton : public Singleton::Instance {
+public:
+  explicit LruHttpCacheSingleton(Stats::Scope& scope) : scope_(scope) {}
+
+  // Returns the cache of the config, shared by the filter configs which use it. Caches are only
+  // held weakly, so that the cache of a config is released with the last filter config using it.
+  std::shared_ptr<LruHttpCache>
+  get(const envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig& config) {
+    absl::erase_if(caches_, [](const auto& entry) { return entry.second.expired(); });
+    std::weak_ptr<LruHttpCache>& weak_cache = caches_[MessageUtil::hash(config)];
+    std::shared_ptr<LruHttpCache> cache = weak_cache.lock();
+    if (cache == nullptr) {
+      cache = std::make_shared<LruHttpCache>(config, scope_);
+      weak_cache = cache;
+    }
+    return cache;
+  }
+
+private:
+  // The server scope, which outlives the listeners whose filter configs use the caches.
+  Stats::Scope& scope_;
+  absl::flat_hash_map<size_t, std::weak_ptr<LruHttpCache>> caches_;
+};
+
+} // namespace
+
+SINGLETON_MANAGER_REGISTRATION(lru_http_cache_singleton);
+
+class LruHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  std::shared_ptr<HttpCache>
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig lru_config;
+    MessageUtil::anyConvertAndValidate(config.typed_config(), lru_config,
+                                       context.messageValidationVisitor());
+    std::shared_ptr<LruHttpCacheSingleton> singleton =
+        context.singletonManager().getTyped<LruHttpCacheSingleton>(
+            SINGLETON_MANAGER_REGISTERED_NAME(lru_http_cache_singleton), [&context] {
+              return std::make_shared<LruHttpCacheSingleton>(
+                  context.getServerFactoryContext().scope());
+            });
+    return singleton->get(lru_config);
+  }
+};
+
+static Registry::RegisterFactory<LruHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/cache/lru_http_cache/v3alpha/config.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All LRU HTTP cache stats. @see stats_macros.h
+ */
+#define ALL_LRU_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                   \
+  COUNTER(evictions)                                                                               \
+  COUNTER(hits)                                                                                    \
+  COUNTER(inserts)                                                                                 \
+  COUNTER(misses)                                                                                  \
+  COUNTER(rejected_inserts)                                                                        \
+  GAUGE(cached_bytes, NeverImport)                                                                 \
+  GAUGE(entries, NeverImport)
+
+/**
+ * Struct definition for all LRU HTTP cache stats. @see stats_macros.h
+ */
+struct LruHttpCacheStats {
+  ALL_LRU_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// In-memory cache backend with a byte budget. Responses are spread over independently locked
+// shards by the hash of their key, and each shard evicts its least recently used responses once it
+// holds more than its share of the budget. Cached bodies are immutable and served without copies.
+class LruHttpCache : public HttpCache {
+public:
+  // The body of a cached response, in the chunks it was inserted in. Shared by the cache and the
+  // buffers of the responses served from it, so that evicting it doesn't invalidate them.
+  using Body = std::vector<std::string>;
+  using BodySharedPtr = std::shared_ptr<const Body>;
+
+  struct Entry {
+    std::shared_ptr<const Http::ResponseHeaderMap> response_headers_;
+    ResponseMetadata metadata_;
+    BodySharedPtr body_;
+    uint64_t body_size_{};
+  };
+
+  LruHttpCache(const envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig& config,
+               Stats::Scope& scope);
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+  CacheInfo cacheInfo() const override;
+
+  // Looks up the response to the request, following its vary headers if it has any. Sets entry_key
+  // to the key of the returned entry. Returns an entry without headers on a miss.
+  Entry lookup(const LookupRequest& request, std::string& entry_key);
+
+  // Inserts a response, or replaces the cached one. If the response varies on some headers, it is
+  // cached under a key which includes their values in request_vary_headers.
+  void insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, Body&& body, uint64_t body_size,
+              const Http::RequestHeaderMap& request_vary_headers);
+
+  const LruHttpCacheStats& stats() const { return stats_; }
+
+private:
+  class Shard {
+  public:
+    Shard(uint64_t max_bytes, LruHttpCacheStats& stats) : max_bytes_(max_bytes), stats_(stats) {}
+    ~Shard();
+
+    // Returns the entry for the key and marks it as the most recently used, or an entry without
+    // headers if there is none.
+    Entry find(absl::string_view key);
+    void insert(std::string&& key, Entry&& entry);
+    void updateHeaders(absl::string_view key, const Http::ResponseHeaderMap& response_headers,
+                       const ResponseMetadata& metadata);
+
+  private:
+    struct Node {
+      std::string key_;
+      Entry entry_;
+      uint64_t size_;
+    };
+    using NodeList = std::list<Node>;
+
+    static uint64_t nodeSize(const Node& node);
+    void removeLocked(NodeList::iterator node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    const uint64_t max_bytes_;
+    LruHttpCacheStats& stats_;
+    absl::Mutex mutex_;
+    // The entries from the most to the least recently used.
+    NodeList lru_ ABSL_GUARDED_BY(mutex_);
+    // Keys are views of the keys in lru_.
+    absl::flat_hash_map<absl::string_view, NodeList::iterator> index_ ABSL_GUARDED_BY(mutex_);
+    uint64_t bytes_ ABSL_GUARDED_BY(mutex_){0};
+  };
+
+  Shard& shard(absl::string_view key);
+  void insertEntry(std::string&& key, Entry&& entry);
+
+  LruHttpCacheStats stats_;
+  const uint64_t max_bytes_per_shard_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,60 @@
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+RequestCoalescer::RequestCoalescer(std::chrono::milliseconds timeout,
+                                   const std::string& stats_prefix, Stats::Scope& scope)
+    : timeout_(timeout), stats_{ALL_CACHE_COALESCING_STATS(
+                             POOL_COUNTER_PREFIX(scope, absl::StrCat(stats_prefix, "cache.")))} {}
+
+RequestCoalescer::FetchPtr RequestCoalescer::fetchOrWait(const Key& key,
+                                                         FetchDoneCallback&& done_cb) {
+  const size_t key_hash = stableHashKey(key);
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = in_flight_.find(key_hash);
+    if (it != in_flight_.end()) {
+      it->second.push_back(std::move(done_cb));
+      stats_.coalesced_requests_.inc();
+      return nullptr;
+    }
+    in_flight_.emplace(key_hash, std::vector<FetchDoneCallback>());
+  }
+  return std::make_unique<Fetch>(shared_from_this(), key_hash);
+}
+
+RequestCoalescer::FetchPtr RequestCoalescer::tryFetch(const Key& key) {
+  const size_t key_hash = stableHashKey(key);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!in_flight_.emplace(key_hash, std::vector<FetchDoneCallback>()).second) {
+      return nullptr;
+    }
+  }
+  return std::make_unique<Fetch>(shared_from_this(), key_hash);
+}
+
+void RequestCoalescer::complete(size_t key_hash) {
+  std::vector<FetchDoneCallback> callbacks;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = in_flight_.find(key_hash);
+    ASSERT(it != in_flight_.end());
+    callbacks = std::move(it->second);
+    in_flight_.erase(it);
+  }
+  // The callbacks are called without the lock, as they may start new fetches.
+  for (FetchDoneCallback& callback : callbacks) {
+    callback();
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
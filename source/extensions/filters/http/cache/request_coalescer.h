@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All cache filter request coalescing stats. @see stats_macros.h
+ */
+#define ALL_CACHE_COALESCING_STATS(COUNTER)                                                        \
+  COUNTER(coalesced_requests)                                                                      \
+  COUNTER(coalesced_request_timeouts)                                                              \
+  COUNTER(stale_responses_served_while_revalidating)
+
+/**
+ * Struct definition for all cache filter request coalescing stats. @see stats_macros.h
+ */
+struct CacheCoalescingStats {
+  ALL_CACHE_COALESCING_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+// Tracks the keys which a request is being sent upstream for, so that the concurrent requests for
+// the same key can wait for its response to be cached instead of being sent upstream as well. It is
+// shared by the filters of all the workers using a filter config.
+class RequestCoalescer : public std::enable_shared_from_this<RequestCoalescer> {
+public:
+  // Called once the response to the request sent upstream has been cached, or won't be. It may be
+  // called on any thread.
+  using FetchDoneCallback = std::function<void()>;
+
+  // Held by the stream whose request is sent upstream for a key. Destroying it completes the fetch,
+  // and calls the callbacks of the streams waiting for it.
+  class Fetch {
+  public:
+    Fetch(std::shared_ptr<RequestCoalescer> coalescer, size_t key_hash)
+        : coalescer_(std::move(coalescer)), key_hash_(key_hash) {}
+    ~Fetch() { coalescer_->complete(key_hash_); }
+
+  private:
+    const std::shared_ptr<RequestCoalescer> coalescer_;
+    const size_t key_hash_;
+  };
+  using FetchPtr = std::unique_ptr<Fetch>;
+
+  RequestCoalescer(std::chrono::milliseconds timeout, const std::string& stats_prefix,
+                   Stats::Scope& scope);
+
+  // Returns a Fetch if no request is being sent upstream for key, in which case the caller sends
+  // its own. Otherwise returns nullptr and calls done_cb once the request in flight is done.
+  FetchPtr fetchOrWait(const Key& key, FetchDoneCallback&& done_cb);
+
+  // Returns a Fetch if no request is being sent upstream for key, or nullptr otherwise.
+  FetchPtr tryFetch(const Key& key);
+
+  // How long a request waits for the response to another one before being sent upstream itself.
+  std::chrono::milliseconds timeout() const { return timeout_; }
+  CacheCoalescingStats& stats() { return stats_; }
+
+private:
+  void complete(size_t key_hash);
+
+  const std::chrono::milliseconds timeout_;
+  CacheCoalescingStats stats_;
+  absl::Mutex mutex_;
+  // The callbacks of the requests waiting for each key with a request in flight. Keys are hashed:
+  // a collision only makes a request wait for an unrelated one, and then miss the cache.
+  absl::flat_hash_map<size_t, std::vector<FetchDoneCallback>> in_flight_ ABSL_GUARDED_BY(mutex_);
+};
+
+using RequestCoalescerSharedPtr = std::shared_ptr<RequestCoalescer>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
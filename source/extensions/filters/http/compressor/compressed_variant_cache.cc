@@ -0,0 +1,42 @@
+#include "source/extensions/filters/http/compressor/compressed_variant_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+CompressedVariantSharedPtr CompressedVariantCache::lookup(absl::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+bool CompressedVariantCache::insert(absl::string_view key, CompressedVariantSharedPtr body) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = std::move(body);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return false;
+  }
+
+  bool evicted = false;
+  if (lru_.size() >= max_entries_) {
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+    evicted = true;
+  }
+  lru_.emplace_front(std::string(key), std::move(body));
+  // The index references the key owned by the list entry.
+  index_.emplace(lru_.front().first, lru_.begin());
+  return evicted;
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+using CompressedVariantSharedPtr = std::shared_ptr<const std::string>;
+
+// A least recently used cache of compressed response bodies, shared by the filters of all the
+// workers using a filter config. As a filter config has a single compressor library, the
+// entries are keyed by the identity of the uncompressed body only.
+class CompressedVariantCache {
+public:
+  explicit CompressedVariantCache(uint32_t max_entries) : max_entries_(max_entries) {}
+
+  // Returns the compressed body cached for key, or nullptr.
+  CompressedVariantSharedPtr lookup(absl::string_view key);
+
+  // Caches the compressed body for key, replacing any body cached for it before. Returns true if
+  // the least recently used entry was evicted to make room for it.
+  bool insert(absl::string_view key, CompressedVariantSharedPtr body);
+
+private:
+  using Entry = std::pair<std::string, CompressedVariantSharedPtr>;
+
+  const uint32_t max_entries_;
+  absl::Mutex mutex_;
+  // The most recently used entries are at the front.
+  std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> index_ ABSL_GUARDED_BY(mutex_);
+};
+
+using CompressedVariantCachePtr = std::unique_ptr<CompressedVariantCache>;
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
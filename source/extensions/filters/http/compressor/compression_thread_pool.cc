@@ -0,0 +1,61 @@
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
+
+#include "source/common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+CompressionThreadPool::CompressionThreadPool(Thread::ThreadFactory& thread_factory,
+                                             uint32_t thread_count)
+    : thread_factory_(thread_factory) {
+  reserveThreads(thread_count);
+}
+
+CompressionThreadPool::~CompressionThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    shutdown_ = true;
+    queue_event_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void CompressionThreadPool::reserveThreads(uint32_t thread_count) {
+  while (threads_.size() < thread_count) {
+    threads_.push_back(thread_factory_.createThread([this]() -> void { threadRoutine(); },
+                                                    Thread::Options{"compressor"}));
+  }
+}
+
+void CompressionThreadPool::post(Job job) {
+  Thread::LockGuard lock(mutex_);
+  queue_.push_back(std::move(job));
+  queue_event_.notifyOne();
+}
+
+void CompressionThreadPool::threadRoutine() {
+  while (true) {
+    Job job;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (queue_.empty() && !shutdown_) {
+        queue_event_.wait(mutex_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    job();
+  }
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
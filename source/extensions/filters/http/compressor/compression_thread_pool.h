@@ -0,0 +1,53 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/singleton/instance.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/thread.h"
+
+#include "absl/base/thread_annotations.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+// A pool of threads dedicated to compressing response bodies, so that slow compression does not
+// block the workers. A single pool is shared by all the compressor filter configs of a server.
+class CompressionThreadPool : public Singleton::Instance {
+public:
+  using Job = std::function<void()>;
+
+  CompressionThreadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count);
+  // Joins the threads, so it must only be destroyed on the main thread. The jobs which are still
+  // queued are dropped without being run.
+  ~CompressionThreadPool() override;
+
+  // Starts more threads if the pool has fewer than thread_count. Only called on the main thread.
+  void reserveThreads(uint32_t thread_count);
+
+  // Queues a job to be run by one of the threads.
+  void post(Job job);
+
+private:
+  void threadRoutine();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar queue_event_;
+  std::deque<Job> queue_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using CompressionThreadPoolSharedPtr = std::shared_ptr<CompressionThreadPool>;
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
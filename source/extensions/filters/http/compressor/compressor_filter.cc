@@ -1,8 +1,14 @@
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/enum_to_int.h"
+#include "source/common/common/hex.h"
+#include "source/common/crypto/utility.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -28,6 +34,14 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Respons
 // Default minimum length of an upstream response that allows compression.
 const uint64_t DefaultMinimumContentLength = 30;
 
+// Defaults of the cache of compressed response bodies.
+const uint32_t DefaultMaxCompressedVariants = 1000;
+const uint64_t DefaultMaxVariantContentLength = 1024 * 1024;
+const uint64_t DefaultMaxHashedContentLength = 64 * 1024;
+
+// Defaults of the offloading of response compression.
+const uint64_t DefaultMinOffloadContentLength = 64 * 1024;
+
 // Default content types will be used if any is provided by the user.
 const std::vector<std::string>& defaultContentEncoding() {
   CONSTRUCT_ON_FIRST_USE(
@@ -55,6 +69,19 @@ void compressAndUpdateStats(const Compression::Compressor::CompressorPtr& compre
   stats.total_compressed_bytes_.add(data.length());
 }
 
+absl::optional<uint64_t> contentLength(const Http::RequestOrResponseHeaderMap& headers) {
+  uint64_t length;
+  if (headers.ContentLength() == nullptr ||
+      !absl::SimpleAtoi(headers.getContentLengthValue(), &length)) {
+    return absl::nullopt;
+  }
+  return length;
+}
+
+bool isStrongEtag(absl::string_view value) {
+  return value.length() > 2 && !((value[0] == 'w' || value[0] == 'W') && value[1] == '/');
+}
+
 } // namespace
 
 CompressorFilterConfig::DirectionConfig::DirectionConfig(
@@ -70,12 +97,14 @@ CompressorFilterConfig::DirectionConfig::DirectionConfig(
 CompressorFilterConfig::CompressorFilterConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-    Compression::Compressor::CompressorFactoryPtr compressor_factory)
+    Compression::Compressor::CompressorFactoryPtr compressor_factory,
+    CompressionThreadPoolSharedPtr offload_thread_pool)
     : common_stats_prefix_(fmt::format("{}compressor.{}.{}", stats_prefix,
                                        proto_config.compressor_library().name(),
                                        compressor_factory->statsPrefix())),
       request_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
-      response_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
+      response_direction_config_(proto_config, common_stats_prefix_, scope, runtime,
+                                 std::move(offload_thread_pool)),
       content_encoding_(compressor_factory->contentEncoding()),
       compressor_factory_(std::move(compressor_factory)) {}
 
@@ -100,7 +129,8 @@ CompressorFilterConfig::RequestDirectionConfig::RequestDirectionConfig(
 
 CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
-    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    CompressionThreadPoolSharedPtr offload_thread_pool)
     : DirectionConfig(commonConfig(proto_config),
                       proto_config.has_response_direction_config() ? stats_prefix + "response."
                                                                    : stats_prefix,
@@ -113,7 +143,30 @@ CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
           proto_config.has_response_direction_config()
               ? proto_config.response_direction_config().remove_accept_encoding_header()
               : proto_config.remove_accept_encoding_header()),
-      response_stats_{generateResponseStats(stats_prefix, scope)} {}
+      response_stats_{generateResponseStats(stats_prefix, scope)},
+      variant_cache_(makeVariantCache(proto_config)),
+      max_variant_content_length_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compressed_variant_cache(), max_content_length,
+          DefaultMaxVariantContentLength)),
+      max_hashed_content_length_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compressed_variant_cache(),
+          max_hashed_content_length, DefaultMaxHashedContentLength)),
+      offload_thread_pool_(proto_config.response_direction_config().has_compression_offload()
+                               ? std::move(offload_thread_pool)
+                               : nullptr),
+      min_offload_content_length_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compression_offload(), min_content_length,
+          DefaultMinOffloadContentLength)) {}
+
+CompressedVariantCachePtr CompressorFilterConfig::ResponseDirectionConfig::makeVariantCache(
+    const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config) {
+  if (!proto_config.response_direction_config().has_compressed_variant_cache()) {
+    return nullptr;
+  }
+  return std::make_unique<CompressedVariantCache>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      proto_config.response_direction_config().compressed_variant_cache(), max_entries,
+      DefaultMaxCompressedVariants));
+}
 
 const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
 CompressorFilterConfig::ResponseDirectionConfig::commonConfig(
@@ -149,6 +202,15 @@ Envoy::Compression::Compressor::CompressorPtr CompressorFilterConfig::makeCompre
 CompressorFilter::CompressorFilter(const CompressorFilterConfigSharedPtr config)
     : config_(std::move(config)) {}
 
+void CompressorFilter::onDestroy() {
+  if (offloaded_compression_ != nullptr) {
+    // The results of the jobs still in flight are dropped.
+    offloaded_compression_->filter_ = nullptr;
+    absl::MutexLock lock(&offloaded_compression_->mutex_);
+    offloaded_compression_->dispatcher_ = nullptr;
+  }
+}
+
 Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap& headers,
                                                           bool end_stream) {
   const Http::HeaderEntry* accept_encoding = headers.getInline(accept_encoding_handle.handle());
@@ -162,6 +224,9 @@ Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap
   if (response_config.compressionEnabled() && response_config.removeAcceptEncodingHeader()) {
     headers.removeInline(accept_encoding_handle.handle());
   }
+  if (response_config.variantCache() != nullptr) {
+    request_host_and_path_ = absl::StrCat(headers.getHostValue(), headers.getPathValue());
+  }
 
   const auto& request_config = config_->requestDirectionConfig();
   const bool is_not_upgrade =
@@ -245,12 +310,19 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
                               !headers.getInline(response_content_encoding_handle.handle());
   if (!end_stream && isEnabledAndContentLengthBigEnough && isAcceptEncodingAllowed(headers) &&
       isCompressible && isTransferEncodingAllowed(headers)) {
+    const absl::optional<uint64_t> content_length = contentLength(headers);
+    offload_response_ = config.offloadThreadPool() != nullptr && content_length.has_value() &&
+                        content_length.value() >= config.minOffloadContentLength();
+    // The entity tag keys the cache of compressed bodies, so it is looked up before being removed.
+    lookupCompressedVariant(headers, content_length);
     sanitizeEtagHeader(headers);
     headers.removeContentLength();
     headers.setInline(response_content_encoding_handle.handle(), config_->contentEncoding());
     config.stats().compressed_.inc();
-    // Finally instantiate the compressor.
-    response_compressor_ = config_->makeCompressor();
+    if (cached_variant_ == nullptr && !hash_response_body_) {
+      // Finally instantiate the compressor.
+      startResponseCompression();
+    }
   } else {
     config.stats().not_compressed_.inc();
   }
@@ -266,26 +338,225 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
-  if (response_compressor_ != nullptr) {
-    compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
-                           end_stream);
-  }
-  return Http::FilterDataStatus::Continue;
+  return encodeResponseData(data, end_stream);
 }
 
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
-  if (response_compressor_ != nullptr) {
+  if (compressingResponse()) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
     // is never called with end_stream=true, thus let the compression library know
     // that the stream is ended.
-    compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(),
-                           empty_buffer, true);
+    if (encodeResponseData(empty_buffer, true) == Http::FilterDataStatus::StopIterationNoBuffer) {
+      // The trailers are continued once the thread pool has compressed the rest of the body.
+      response_trailers_pending_ = true;
+      return Http::FilterTrailersStatus::StopIteration;
+    }
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
   return Http::FilterTrailersStatus::Continue;
 }
 
+bool CompressorFilter::compressingResponse() const {
+  return response_compressor_ != nullptr || offloaded_compression_ != nullptr ||
+         cached_variant_ != nullptr || hash_response_body_;
+}
+
+void CompressorFilter::startResponseCompression() {
+  if (offload_response_) {
+    config_->responseDirectionConfig().responseStats().offloaded_.inc();
+    offloaded_compression_ = std::make_shared<OffloadedCompression>(
+        config_->makeCompressor(), encoder_callbacks_->dispatcher(), *this);
+  } else {
+    response_compressor_ = config_->makeCompressor();
+  }
+}
+
+Http::FilterDataStatus CompressorFilter::encodeResponseData(Buffer::Instance& data,
+                                                            bool end_stream) {
+  if (cached_variant_ != nullptr) {
+    // The response was compressed before, so its own body is discarded.
+    data.drain(data.length());
+    if (end_stream) {
+      data.add(*cached_variant_);
+    }
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (hash_response_body_) {
+    response_body_.move(data);
+    // The body is only buffered up to the limit, whatever its Content-Length header says. A larger
+    // body is compressed as it streams, and not cached.
+    const bool within_limit =
+        response_body_.length() <= config_->responseDirectionConfig().maxHashedContentLength();
+    if (!end_stream && within_limit) {
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
+    hash_response_body_ = false;
+    if (within_limit && lookupCompressedVariantByBodyDigest()) {
+      data.add(*cached_variant_);
+      return Http::FilterDataStatus::Continue;
+    }
+    data.move(response_body_);
+    startResponseCompression();
+  }
+
+  if (offloaded_compression_ != nullptr) {
+    return offloadCompression(data, end_stream);
+  }
+  if (response_compressor_ != nullptr) {
+    compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
+                           end_stream);
+    captureCompressedVariant(data, end_stream);
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+void CompressorFilter::lookupCompressedVariant(const Http::ResponseHeaderMap& headers,
+                                               absl::optional<uint64_t> content_length) {
+  const auto& config = config_->responseDirectionConfig();
+  if (config.variantCache() == nullptr || !content_length.has_value() ||
+      content_length.value() > config.maxVariantContentLength()) {
+    return;
+  }
+  // The keys identify the body of a full representation: a partial response, e.g. a 206 sharing
+  // the entity tag of the full one, must neither be served from the cache nor populate it.
+  if (Http::Utility::getResponseStatusNoThrow(headers) != enumToInt(Http::Code::OK)) {
+    return;
+  }
+
+  const Http::HeaderEntry* etag = headers.getInline(etag_handle.handle());
+  if (etag == nullptr || !isStrongEtag(etag->value().getStringView())) {
+    // Without a strong entity tag, the identity of the body is only known once it is complete, so
+    // only the small ones are buffered to be looked up.
+    hash_response_body_ = content_length.value() <= config.maxHashedContentLength();
+    return;
+  }
+
+  variant_key_ =
+      absl::StrCat("etag:", request_host_and_path_, " ", etag->value().getStringView());
+  cached_variant_ = config.variantCache()->lookup(variant_key_);
+  if (cached_variant_ != nullptr) {
+    config.responseStats().variant_cache_hits_.inc();
+  } else {
+    config.responseStats().variant_cache_misses_.inc();
+    compressed_variant_ = std::make_unique<std::string>();
+  }
+}
+
+bool CompressorFilter::lookupCompressedVariantByBodyDigest() {
+  const auto& config = config_->responseDirectionConfig();
+  // The key holds the SHA-256 digest of the body, so a hit is only served for an identical body of
+  // the same resource.
+  variant_key_ = absl::StrCat(
+      "body:", request_host_and_path_, " ",
+      Hex::encode(Common::Crypto::UtilitySingleton::get().getSha256Digest(response_body_)));
+  cached_variant_ = config.variantCache()->lookup(variant_key_);
+  if (cached_variant_ != nullptr) {
+    config.responseStats().variant_cache_hits_.inc();
+    response_body_.drain(response_body_.length());
+    return true;
+  }
+  config.responseStats().variant_cache_misses_.inc();
+  compressed_variant_ = std::make_unique<std::string>();
+  return false;
+}
+
+void CompressorFilter::captureCompressedVariant(const Buffer::Instance& data, bool end_stream) {
+  if (compressed_variant_ == nullptr) {
+    return;
+  }
+  compressed_variant_->append(data.toString());
+  if (end_stream) {
+    const auto& config = config_->responseDirectionConfig();
+    if (config.variantCache()->insert(
+            variant_key_, std::make_shared<const std::string>(std::move(*compressed_variant_)))) {
+      config.responseStats().variant_cache_evictions_.inc();
+    }
+    config.responseStats().variant_cache_inserts_.inc();
+    compressed_variant_ = nullptr;
+  }
+}
+
+Http::FilterDataStatus CompressorFilter::offloadCompression(Buffer::Instance& data,
+                                                            bool end_stream) {
+  offload_pending_.move(data);
+  offload_end_stream_ = end_stream;
+  maybeStartOffloadedCompression();
+  updateOffloadWatermark();
+  // The compressed data is injected into the filter chain once the thread pool is done with it.
+  return Http::FilterDataStatus::StopIterationNoBuffer;
+}
+
+void CompressorFilter::maybeStartOffloadedCompression() {
+  if (offload_in_flight_ || offload_finished_ ||
+      (offload_pending_.length() == 0 && !offload_end_stream_)) {
+    return;
+  }
+
+  // The thread pool compresses a copy of the data, so that the slices of the stream are only ever
+  // released by the worker thread.
+  auto data = std::make_shared<Buffer::OwnedImpl>();
+  data->add(offload_pending_);
+  offload_pending_.drain(offload_pending_.length());
+  const bool end_stream = offload_end_stream_;
+  offload_in_flight_ = true;
+  offload_in_flight_bytes_ = data->length();
+  offload_finished_ = end_stream;
+  config_->responseDirectionConfig().stats().total_uncompressed_bytes_.add(data->length());
+
+  config_->responseDirectionConfig().offloadThreadPool()->post(
+      [compression = offloaded_compression_, data, end_stream]() -> void {
+        compression->compressor_->compress(*data,
+                                           end_stream
+                                               ? Envoy::Compression::Compressor::State::Finish
+                                               : Envoy::Compression::Compressor::State::Flush);
+        absl::MutexLock lock(&compression->mutex_);
+        if (compression->dispatcher_ == nullptr) {
+          return;
+        }
+        compression->dispatcher_->post([compression, data, end_stream]() -> void {
+          if (compression->filter_ != nullptr) {
+            compression->filter_->onOffloadedCompression(*data, end_stream);
+          }
+        });
+      });
+}
+
+void CompressorFilter::onOffloadedCompression(Buffer::Instance& data, bool end_stream) {
+  offload_in_flight_ = false;
+  offload_in_flight_bytes_ = 0;
+  config_->responseDirectionConfig().stats().total_compressed_bytes_.add(data.length());
+  captureCompressedVariant(data, end_stream);
+  updateOffloadWatermark();
+
+  if (end_stream && response_trailers_pending_) {
+    if (data.length() > 0) {
+      encoder_callbacks_->injectEncodedDataToFilterChain(data, false);
+    }
+    encoder_callbacks_->continueEncoding();
+    return;
+  }
+  if (data.length() > 0 || end_stream) {
+    encoder_callbacks_->injectEncodedDataToFilterChain(data, end_stream);
+  }
+  maybeStartOffloadedCompression();
+}
+
+void CompressorFilter::updateOffloadWatermark() {
+  // The data waiting for the thread pool counts against the buffer limit of the stream, as if it
+  // was buffered by the filter manager.
+  const uint64_t buffered = offload_pending_.length() + offload_in_flight_bytes_;
+  const uint32_t limit = encoder_callbacks_->encoderBufferLimit();
+  if (!above_offload_watermark_ && limit > 0 && buffered > limit) {
+    above_offload_watermark_ = true;
+    encoder_callbacks_->onEncoderFilterAboveWriteBufferHighWatermark();
+  } else if (above_offload_watermark_ && buffered <= limit / 2) {
+    above_offload_watermark_ = false;
+    encoder_callbacks_->onEncoderFilterBelowWriteBufferLowWatermark();
+  }
+}
+
 bool CompressorFilter::hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const {
   const Http::HeaderEntry* cache_control = headers.getInline(cache_control_handle.handle());
   if (cache_control) {
@@ -578,11 +849,8 @@ void CompressorFilter::insertVaryHeader(Http::ResponseHeaderMap& headers) {
 // the strong ones when disable_on_etag_header is false. Envoy does NOT re-write entity tags.
 void CompressorFilter::sanitizeEtagHeader(Http::ResponseHeaderMap& headers) {
   const Http::HeaderEntry* etag = headers.getInline(etag_handle.handle());
-  if (etag != nullptr) {
-    absl::string_view value(etag->value().getStringView());
-    if (value.length() > 2 && !((value[0] == 'w' || value[0] == 'W') && value[1] == '/')) {
-      headers.removeInline(etag_handle.handle());
-    }
+  if (etag != nullptr && isStrongEtag(etag->value().getStringView())) {
+    headers.removeInline(etag_handle.handle());
   }
 }
 
@@ -1,12 +1,20 @@
 #pragma once
 
 #include "envoy/compression/compressor/factory.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 #include "envoy/stats/stats_macros.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/filters/http/compressor/compressed_variant_cache.h"
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -37,6 +45,11 @@ namespace Compressor {
  *
  * "header_gzip" is specific to the gzip filter and is deprecated since it duplicates
  * "header_compressor_used".
+ *
+ * "offloaded" is a number of responses whose body was compressed by the offload thread pool.
+ *
+ * "variant_cache_hits" and "variant_cache_misses" count the responses looked up in the cache of
+ * compressed bodies. A hit is served the cached body instead of being compressed.
  */
 #define RESPONSE_COMPRESSOR_STATS(COUNTER)                                                         \
   COUNTER(no_accept_header)                                                                        \
@@ -45,7 +58,12 @@ namespace Compressor {
   COUNTER(header_compressor_overshadowed)                                                          \
   COUNTER(header_wildcard)                                                                         \
   COUNTER(header_not_valid)                                                                        \
-  COUNTER(not_compressed_etag)
+  COUNTER(not_compressed_etag)                                                                     \
+  COUNTER(offloaded)                                                                               \
+  COUNTER(variant_cache_evictions)                                                                 \
+  COUNTER(variant_cache_hits)                                                                      \
+  COUNTER(variant_cache_inserts)                                                                   \
+  COUNTER(variant_cache_misses)
 
 /**
  * Struct definitions for compressor stats. @see stats_macros.h
@@ -113,12 +131,20 @@ public:
   public:
     ResponseDirectionConfig(
         const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
-        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime);
+        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+        CompressionThreadPoolSharedPtr offload_thread_pool);
 
     bool compressionEnabled() const override { return compression_enabled_.enabled(); }
     const ResponseCompressorStats& responseStats() const { return response_stats_; }
     bool disableOnEtagHeader() const { return disable_on_etag_header_; }
     bool removeAcceptEncodingHeader() const { return remove_accept_encoding_header_; }
+    // Returns nullptr if the compressed bodies are not cached.
+    CompressedVariantCache* variantCache() const { return variant_cache_.get(); }
+    uint64_t maxVariantContentLength() const { return max_variant_content_length_; }
+    uint64_t maxHashedContentLength() const { return max_hashed_content_length_; }
+    // Returns nullptr if the compression is never offloaded.
+    CompressionThreadPool* offloadThreadPool() const { return offload_thread_pool_.get(); }
+    uint64_t minOffloadContentLength() const { return min_offload_content_length_; }
 
   private:
     static ResponseCompressorStats generateResponseStats(const std::string& prefix,
@@ -131,16 +157,25 @@ public:
     static const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
     commonConfig(const envoy::extensions::filters::http::compressor::v3::Compressor&);
 
+    static CompressedVariantCachePtr makeVariantCache(
+        const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config);
+
     const bool disable_on_etag_header_;
     const bool remove_accept_encoding_header_;
     const ResponseCompressorStats response_stats_;
+    const CompressedVariantCachePtr variant_cache_;
+    const uint64_t max_variant_content_length_;
+    const uint64_t max_hashed_content_length_;
+    const CompressionThreadPoolSharedPtr offload_thread_pool_;
+    const uint64_t min_offload_content_length_;
   };
 
   CompressorFilterConfig() = delete;
   CompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory);
+      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory,
+      CompressionThreadPoolSharedPtr offload_thread_pool);
 
   Envoy::Compression::Compressor::CompressorPtr makeCompressor();
 
@@ -165,6 +200,9 @@ class CompressorFilter : public Http::PassThroughFilter {
 public:
   explicit CompressorFilter(const CompressorFilterConfigSharedPtr config);
 
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers,
                                           bool end_stream) override;
@@ -187,6 +225,37 @@ private:
   void sanitizeEtagHeader(Http::ResponseHeaderMap& headers);
   void insertVaryHeader(Http::ResponseHeaderMap& headers);
 
+  bool compressingResponse() const;
+  void startResponseCompression();
+  Http::FilterDataStatus encodeResponseData(Buffer::Instance& data, bool end_stream);
+
+  void lookupCompressedVariant(const Http::ResponseHeaderMap& headers,
+                               absl::optional<uint64_t> content_length);
+  bool lookupCompressedVariantByBodyDigest();
+  void captureCompressedVariant(const Buffer::Instance& data, bool end_stream);
+
+  Http::FilterDataStatus offloadCompression(Buffer::Instance& data, bool end_stream);
+  void maybeStartOffloadedCompression();
+  void onOffloadedCompression(Buffer::Instance& data, bool end_stream);
+  void updateOffloadWatermark();
+
+  // A response body compressed by the offload thread pool. It is shared with the compression jobs,
+  // which may outlive the filter.
+  struct OffloadedCompression {
+    OffloadedCompression(Envoy::Compression::Compressor::CompressorPtr&& compressor,
+                         Event::Dispatcher& dispatcher, CompressorFilter& filter)
+        : compressor_(std::move(compressor)), filter_(&filter), dispatcher_(&dispatcher) {}
+
+    // Only used by the job in flight.
+    const Envoy::Compression::Compressor::CompressorPtr compressor_;
+    // Only accessed by the worker thread. Reset once the filter is destroyed.
+    CompressorFilter* filter_;
+    absl::Mutex mutex_;
+    // Reset once the filter is destroyed, so that the jobs stop posting their results.
+    Event::Dispatcher* dispatcher_ ABSL_GUARDED_BY(mutex_);
+  };
+  using OffloadedCompressionSharedPtr = std::shared_ptr<OffloadedCompression>;
+
   class EncodingDecision : public StreamInfo::FilterState::Object {
   public:
     enum class HeaderStat { NotValid, Identity, Wildcard, ValidCompressor };
@@ -207,6 +276,29 @@ private:
   Envoy::Compression::Compressor::CompressorPtr request_compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+
+  // The host and path of the request, which key the responses with a strong entity tag in the cache
+  // of compressed bodies.
+  std::string request_host_and_path_;
+  std::string variant_key_;
+  // Set while the response body is buffered to be looked up by its digest.
+  bool hash_response_body_{false};
+  Buffer::OwnedImpl response_body_;
+  // The compressed body found in the cache, which is served instead of the response body.
+  CompressedVariantSharedPtr cached_variant_;
+  // The compressed body to be cached once complete.
+  std::unique_ptr<std::string> compressed_variant_;
+
+  bool offload_response_{false};
+  OffloadedCompressionSharedPtr offloaded_compression_;
+  // The response body received while a part of it is being compressed by the thread pool.
+  Buffer::OwnedImpl offload_pending_;
+  uint64_t offload_in_flight_bytes_{0};
+  bool offload_in_flight_{false};
+  bool offload_end_stream_{false};
+  bool offload_finished_{false};
+  bool response_trailers_pending_{false};
+  bool above_offload_watermark_{false};
 };
 
 } // namespace Compressor
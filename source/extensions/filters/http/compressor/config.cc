@@ -1,14 +1,54 @@
 #include "source/extensions/filters/http/compressor/config.h"
 
 #include "envoy/compression/compressor/config.h"
+#include "envoy/singleton/manager.h"
 
+#include "source/common/common/thread.h"
 #include "source/common/config/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace Compressor {
+namespace {
+
+const uint32_t DefaultOffloadThreadCount = 1;
+
+} // namespace
+
+SINGLETON_MANAGER_REGISTRATION(compression_thread_pool);
+
+CompressionThreadPoolSharedPtr CompressorFilterFactory::offloadThreadPool(
+    const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  if (!proto_config.response_direction_config().has_compression_offload()) {
+    return nullptr;
+  }
+  Server::Configuration::ServerFactoryContext& server_context = context.getServerFactoryContext();
+  CompressionThreadPoolSharedPtr thread_pool =
+      server_context.singletonManager().getTyped<CompressionThreadPool>(
+          SINGLETON_MANAGER_REGISTERED_NAME(compression_thread_pool), [&server_context] {
+            Event::Dispatcher& main_dispatcher = server_context.dispatcher();
+            // The last filter config using the pool may be destroyed on a worker, so the threads
+            // are joined on the main thread instead.
+            return std::shared_ptr<CompressionThreadPool>(
+                new CompressionThreadPool(server_context.api().threadFactory(), 0),
+                [&main_dispatcher](CompressionThreadPool* thread_pool) {
+                  if (Thread::MainThread::isMainThread()) {
+                    delete thread_pool;
+                  } else {
+                    main_dispatcher.post([thread_pool]() { delete thread_pool; });
+                  }
+                });
+          });
+  // The pool has as many threads as the filter config asking for the most.
+  thread_pool->reserveThreads(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      proto_config.response_direction_config().compression_offload(), thread_count,
+      DefaultOffloadThreadCount));
+  return thread_pool;
+}
 
 Http::FilterFactoryCb CompressorFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
@@ -27,9 +67,9 @@ Http::FilterFactoryCb CompressorFilterFactory::createFilterFactoryFromProtoTyped
       *config_factory);
   Compression::Compressor::CompressorFactoryPtr compressor_factory =
       config_factory->createCompressorFactoryFromProto(*message, context);
-  CompressorFilterConfigSharedPtr config =
-      std::make_shared<CompressorFilterConfig>(proto_config, stats_prefix, context.scope(),
-                                               context.runtime(), std::move(compressor_factory));
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      proto_config, stats_prefix, context.scope(), context.runtime(),
+      std::move(compressor_factory), offloadThreadPool(proto_config, context));
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CompressorFilter>(config));
   };
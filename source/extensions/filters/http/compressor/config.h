@@ -4,6 +4,7 @@
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.validate.h"
 
 #include "source/extensions/filters/http/common/factory_base.h"
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -19,6 +20,12 @@ public:
   CompressorFilterFactory() : FactoryBase("envoy.filters.http.compressor") {}
 
 private:
+  // Returns the thread pool shared by the filter configs which offload compression, or nullptr if
+  // this one doesn't.
+  static CompressionThreadPoolSharedPtr offloadThreadPool(
+      const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
+      Server::Configuration::FactoryContext& context);
+
   Http::FilterFactoryCb createFilterFactoryFromProtoTyped(
       const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
       const std::string& stats_prefix, Server::Configuration::FactoryContext& context) override;
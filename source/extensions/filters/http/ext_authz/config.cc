@@ -25,7 +25,7 @@ Http::FilterFactoryCb ExtAuthzFilterConfig::createFilterFactoryFromProtoTyped(
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
   const auto filter_config = std::make_shared<FilterConfig>(
       proto_config, context.scope(), context.runtime(), context.httpContext(), stats_prefix,
-      context.getServerFactoryContext().bootstrap());
+      context.getServerFactoryContext().bootstrap(), context.timeSource());
   Http::FilterFactoryCb callback;
 
   if (proto_config.has_http_service()) {
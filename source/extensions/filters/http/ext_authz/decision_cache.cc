@@ -0,0 +1,177 @@
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "source/common/http/path_utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+constexpr uint32_t DefaultMaxEntries = 10000;
+
+std::vector<Http::LowerCaseString>
+toLowerCaseStrings(const Protobuf::RepeatedPtrField<std::string>& names) {
+  std::vector<Http::LowerCaseString> lower_case_names;
+  lower_case_names.reserve(names.size());
+  for (const std::string& name : names) {
+    lower_case_names.emplace_back(name);
+  }
+  return lower_case_names;
+}
+
+// Appends a string prefixed by its length, so that the keys of different attributes differ.
+void appendToKey(std::string& key, absl::string_view value) {
+  absl::StrAppend(&key, value.size(), ":", value);
+}
+
+} // namespace
+
+DecisionCache::DecisionCache(
+    const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+    TimeSource& time_source)
+    : time_source_(time_source), key_headers_(toLowerCaseStrings(config.key_headers())),
+      path_segments_(config.path_segments()),
+      ttl_(PROTOBUF_GET_MS_REQUIRED(config, ttl)),
+      denied_ttl_(config.has_denied_ttl()
+                      ? absl::optional<std::chrono::milliseconds>(
+                            PROTOBUF_GET_MS_REQUIRED(config, denied_ttl))
+                      : absl::nullopt),
+      ttl_metadata_key_(config.ttl_metadata_key()),
+      max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries)),
+      next_sweep_(time_source.monotonicTime()) {}
+
+std::string
+DecisionCache::key(const Http::RequestHeaderMap& headers,
+                   const Protobuf::Map<std::string, std::string>& context_extensions) const {
+  // The authority and the method are always part of the key, as the decisions of most
+  // authorization services depend on them.
+  std::string key;
+  appendToKey(key, headers.getHostValue());
+  appendToKey(key, headers.getMethodValue());
+  for (const Http::LowerCaseString& name : key_headers_) {
+    const auto values = headers.get(name);
+    absl::StrAppend(&key, values.size(), "|");
+    for (size_t i = 0; i < values.size(); ++i) {
+      appendToKey(key, values[i]->value().getStringView());
+    }
+  }
+
+  if (path_segments_ > 0) {
+    const absl::string_view path =
+        Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+    // The prefix ends before the slash starting the segment past the last one in the key.
+    size_t end = 0;
+    for (uint32_t segment = 0; segment < path_segments_ && end != absl::string_view::npos;
+         ++segment) {
+      end = path.find('/', end + 1);
+    }
+    appendToKey(key, path.substr(0, end));
+  }
+
+  // The context extensions are sorted, as the order of a protobuf map is unspecified.
+  std::map<std::string, std::string> sorted_context_extensions;
+  for (const auto& context_extension : context_extensions) {
+    sorted_context_extensions.emplace(context_extension.first, context_extension.second);
+  }
+  absl::StrAppend(&key, sorted_context_extensions.size(), "|");
+  for (const auto& context_extension : sorted_context_extensions) {
+    appendToKey(key, context_extension.first);
+    appendToKey(key, context_extension.second);
+  }
+  return key;
+}
+
+Filters::Common::ExtAuthz::ResponsePtr DecisionCache::lookup(const std::string& key) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  std::shared_ptr<const Filters::Common::ExtAuthz::Response> response;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    if (it->second.expiry_ <= now) {
+      entries_.erase(it);
+      return nullptr;
+    }
+    response = it->second.response_;
+  }
+  // The filter consumes the headers of the response, so it is given a copy.
+  return std::make_unique<Filters::Common::ExtAuthz::Response>(*response);
+}
+
+void DecisionCache::insert(const std::string& key,
+                           const Filters::Common::ExtAuthz::Response& response) {
+  const absl::optional<std::chrono::milliseconds> response_ttl = ttl(response);
+  if (!response_ttl.has_value() || response_ttl->count() <= 0) {
+    return;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  auto cached_response = std::make_shared<const Filters::Common::ExtAuthz::Response>(response);
+  absl::MutexLock lock(&mutex_);
+  if (entries_.size() >= max_entries_ && !entries_.contains(key)) {
+    evict(now);
+  }
+  entries_[key] = Entry{std::move(cached_response), now + response_ttl.value()};
+}
+
+uint64_t DecisionCache::size() {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+absl::optional<std::chrono::milliseconds>
+DecisionCache::ttl(const Filters::Common::ExtAuthz::Response& response) const {
+  if (response.status == Filters::Common::ExtAuthz::CheckStatus::Error) {
+    return absl::nullopt;
+  }
+
+  if (!ttl_metadata_key_.empty()) {
+    const auto& fields = response.dynamic_metadata.fields();
+    const auto it = fields.find(ttl_metadata_key_);
+    if (it != fields.end() && it->second.kind_case() == ProtobufWkt::Value::kNumberValue) {
+      const double seconds = it->second.number_value();
+      if (!(seconds > 0)) {
+        return std::chrono::milliseconds(0);
+      }
+      return std::chrono::milliseconds(static_cast<int64_t>(
+          std::min(seconds, static_cast<double>(std::numeric_limits<int32_t>::max())) * 1000));
+    }
+  }
+
+  if (response.status == Filters::Common::ExtAuthz::CheckStatus::OK) {
+    return ttl_;
+  }
+  return denied_ttl_;
+}
+
+void DecisionCache::evict(MonotonicTime now) {
+  if (now >= next_sweep_) {
+    next_sweep_ = now + std::chrono::seconds(1);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->second.expiry_ <= now) {
+        entries_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // Without expired entries, an arbitrary one makes room for the new decision.
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(entries_.begin());
+  }
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
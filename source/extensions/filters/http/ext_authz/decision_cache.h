@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/protobuf/protobuf.h"
+#include "source/extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * The decisions of the authorization service, keyed by the request attributes they depend on. It
+ * is shared by the filters of all the workers using a filter config.
+ */
+class DecisionCache {
+public:
+  DecisionCache(const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+                TimeSource& time_source);
+
+  /**
+   * @return the cache key of a request.
+   * @param headers supplies the request headers.
+   * @param context_extensions supplies the context extensions of the route of the request.
+   */
+  std::string key(const Http::RequestHeaderMap& headers,
+                  const Protobuf::Map<std::string, std::string>& context_extensions) const;
+
+  /**
+   * @return a copy of the unexpired decision cached for a key, or nullptr if there is none.
+   */
+  Filters::Common::ExtAuthz::ResponsePtr lookup(const std::string& key);
+
+  /**
+   * Caches the decision of the authorization service for a key, unless it is an error or its TTL
+   * is 0.
+   */
+  void insert(const std::string& key, const Filters::Common::ExtAuthz::Response& response);
+
+  uint64_t size();
+
+private:
+  struct Entry {
+    std::shared_ptr<const Filters::Common::ExtAuthz::Response> response_;
+    MonotonicTime expiry_;
+  };
+
+  absl::optional<std::chrono::milliseconds>
+  ttl(const Filters::Common::ExtAuthz::Response& response) const;
+  void evict(MonotonicTime now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  TimeSource& time_source_;
+  const std::vector<Http::LowerCaseString> key_headers_;
+  const uint32_t path_segments_;
+  const std::chrono::milliseconds ttl_;
+  const absl::optional<std::chrono::milliseconds> denied_ttl_;
+  const std::string ttl_metadata_key_;
+  const uint32_t max_entries_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // The expired entries are swept at most once per second, when the cache is full.
+  MonotonicTime next_sweep_ ABSL_GUARDED_BY(mutex_);
+};
+
+using DecisionCachePtr = std::unique_ptr<DecisionCache>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -49,6 +49,23 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers,
     context_extensions = maybe_merged_per_route_config.value().takeContextExtensions();
   }
 
+  DecisionCache* decision_cache = config_->decisionCache();
+  if (decision_cache != nullptr) {
+    const std::string key = decision_cache->key(headers, context_extensions);
+    Filters::Common::ExtAuthz::ResponsePtr response = decision_cache->lookup(key);
+    if (response != nullptr) {
+      ENVOY_STREAM_LOG(trace, "ext_authz filter found the decision in the cache",
+                       *decoder_callbacks_);
+      stats_.decision_cache_hit_.inc();
+      startCall();
+      onComplete(std::move(response));
+      initiating_call_ = false;
+      return;
+    }
+    stats_.decision_cache_miss_.inc();
+    decision_cache_key_ = key;
+  }
+
   // If metadata_context_namespaces is specified, pass matching metadata to the ext_authz service.
   envoy::config::core::v3::Metadata metadata_context;
   const auto& request_metadata =
@@ -66,14 +83,18 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers,
       config_->includePeerCertificate(), config_->destinationLabels());
 
   ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *decoder_callbacks_);
+  startCall();
+  client_->check(*this, check_request_, decoder_callbacks_->activeSpan(),
+                 decoder_callbacks_->streamInfo());
+  initiating_call_ = false;
+}
+
+void Filter::startCall() {
   state_ = State::Calling;
   filter_return_ = FilterReturn::StopDecoding; // Don't let the filter chain continue as we are
                                                // going to invoke check call.
   cluster_ = decoder_callbacks_->clusterInfo();
   initiating_call_ = true;
-  client_->check(*this, check_request_, decoder_callbacks_->activeSpan(),
-                 decoder_callbacks_->streamInfo());
-  initiating_call_ = false;
 }
 
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers, bool end_stream) {
@@ -206,6 +227,11 @@ void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
 
+  if (decision_cache_key_.has_value()) {
+    config_->decisionCache()->insert(decision_cache_key_.value(), *response);
+    decision_cache_key_.reset();
+  }
+
   if (!response->dynamic_metadata.fields().empty()) {
     decoder_callbacks_->streamInfo().setDynamicMetadata("envoy.filters.http.ext_authz",
                                                         response->dynamic_metadata);
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/common/exception.h"
 #include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
 #include "envoy/http/filter.h"
 #include "envoy/runtime/runtime.h"
@@ -22,6 +23,7 @@
 #include "source/extensions/filters/common/ext_authz/ext_authz.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz_grpc_impl.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz_http_impl.h"
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -37,7 +39,9 @@ namespace ExtAuthz {
   COUNTER(denied)                                                                                  \
   COUNTER(error)                                                                                   \
   COUNTER(disabled)                                                                                \
-  COUNTER(failure_mode_allowed)
+  COUNTER(failure_mode_allowed)                                                                    \
+  COUNTER(decision_cache_hit)                                                                      \
+  COUNTER(decision_cache_miss)
 
 /**
  * Wrapper struct for ext_authz filter stats. @see stats_macros.h
@@ -55,7 +59,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ext_authz::v3::ExtAuthz& config,
                Stats::Scope& scope, Runtime::Loader& runtime, Http::Context& http_context,
-               const std::string& stats_prefix, envoy::config::bootstrap::v3::Bootstrap& bootstrap)
+               const std::string& stats_prefix, envoy::config::bootstrap::v3::Bootstrap& bootstrap,
+               TimeSource& time_source)
       : allow_partial_message_(config.with_request_body().allow_partial_message()),
         failure_mode_allow_(config.failure_mode_allow()),
         clear_route_cache_(config.clear_route_cache()),
@@ -85,6 +90,14 @@ public:
         ext_authz_error_(pool_.add(createPoolStatName(config.stat_prefix(), "error"))),
         ext_authz_failure_mode_allowed_(
             pool_.add(createPoolStatName(config.stat_prefix(), "failure_mode_allowed"))) {
+    if (config.has_decision_cache()) {
+      // The decisions do not depend on the request body, which is not part of the cache key.
+      if (config.has_with_request_body()) {
+        throw EnvoyException("ext_authz decision_cache is not supported with with_request_body");
+      }
+      decision_cache_ = std::make_unique<DecisionCache>(config.decision_cache(), time_source);
+    }
+
     auto labels_key_it =
         bootstrap.node().metadata().fields().find(config.bootstrap_metadata_labels_key());
     if (labels_key_it != bootstrap.node().metadata().fields().end()) {
@@ -134,6 +147,10 @@ public:
   }
 
   bool includePeerCertificate() const { return include_peer_certificate_; }
+
+  // @return the cache of the decisions of the authorization service, or nullptr if there is none.
+  DecisionCache* decisionCache() const { return decision_cache_.get(); }
+
   const LabelsMap& destinationLabels() const { return destination_labels_; }
 
 private:
@@ -186,6 +203,8 @@ private:
   // The stats for the filter.
   ExtAuthzFilterStats stats_;
 
+  DecisionCachePtr decision_cache_;
+
 public:
   // TODO(nezdolik): deprecate cluster scope stats counters in favor of filter scope stats
   // (ExtAuthzFilterStats stats_).
@@ -272,6 +291,7 @@ private:
   void addResponseHeaders(Http::HeaderMap& header_map, const Http::HeaderVector& headers);
   void initiateCall(const Http::RequestHeaderMap& headers,
                     const Router::RouteConstSharedPtr& route);
+  void startCall();
   void continueDecoding();
   bool isBufferFull() const;
 
@@ -310,6 +330,8 @@ private:
   bool buffer_data_{};
   bool skip_check_{false};
   envoy::service::auth::v3::CheckRequest check_request_{};
+  // The key the decision of the authorization service is cached with, when it is not cached yet.
+  absl::optional<std::string> decision_cache_key_;
 };
 
 } // namespace ExtAuthz
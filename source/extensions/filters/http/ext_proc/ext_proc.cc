@@ -143,6 +143,29 @@ FilterDataStatus Filter::onData(ProcessorState& state, Buffer::Instance& data, b
     }
   }
 
+  if (state.bodyMode() == ProcessingMode::STREAMED || state.hasStreamedData()) {
+    // Stream the data, which also follows any chunks still in flight if the processing
+    // mode was changed since they were sent.
+    switch (openStream()) {
+    case StreamOpenState::Error:
+      return FilterDataStatus::StopIterationNoBuffer;
+    case StreamOpenState::IgnoreError:
+      return FilterDataStatus::Continue;
+    case StreamOpenState::Ok:
+      // Fall through
+      break;
+    }
+
+    // If trailers were just added, then the data is not the end of the stream any more.
+    state.enqueueStreamedData(data, end_stream && !just_added_trailers);
+    sendStreamedData(state);
+    if (just_added_trailers && !state.hasStreamedData()) {
+      sendTrailers(state, *new_trailers);
+    }
+    // The data is injected into the filter chain as the responses for it arrive.
+    return FilterDataStatus::StopIterationNoBuffer;
+  }
+
   FilterDataStatus result;
   switch (state.bodyMode()) {
   case ProcessingMode::BUFFERED:
@@ -160,7 +183,8 @@ FilterDataStatus Filter::onData(ProcessorState& state, Buffer::Instance& data, b
       // The body has been buffered and we need to send the buffer
       ENVOY_LOG(debug, "Sending request body message");
       state.addBufferedData(data);
-      sendBodyChunk(state, *state.bufferedData(), true);
+      sendBodyChunk(state, *state.bufferedData(), true,
+                    ProcessorState::CallbackState::BufferedBodyCallback);
       // Since we just just moved the data into the buffer, return NoBuffer
       // so that we do not buffer this chunk twice.
       result = FilterDataStatus::StopIterationNoBuffer;
@@ -172,7 +196,6 @@ FilterDataStatus Filter::onData(ProcessorState& state, Buffer::Instance& data, b
     break;
 
   case ProcessingMode::BUFFERED_PARTIAL:
-  case ProcessingMode::STREAMED:
     ENVOY_LOG(debug, "Ignoring unimplemented request body processing mode");
     result = FilterDataStatus::Continue;
     break;
@@ -224,6 +247,14 @@ FilterTrailersStatus Filter::onTrailers(ProcessorState& state, Http::HeaderMap&
     return FilterTrailersStatus::StopIteration;
   }
 
+  if (state.hasStreamedData()) {
+    // The body is complete now, so the data held for coalescing is sent too, and the trailers
+    // follow the last chunk.
+    ENVOY_LOG(trace, "Streamed body chunks still in flight -- holding header iteration");
+    sendStreamedData(state);
+    return FilterTrailersStatus::StopIteration;
+  }
+
   if (!body_delivered && state.bodyMode() == ProcessingMode::BUFFERED) {
     // We would like to process the body in a buffered way, but until now the complete
     // body has not arrived. With the arrival of trailers, we now know that the body
@@ -288,9 +319,27 @@ FilterTrailersStatus Filter::encodeTrailers(ResponseTrailerMap& trailers) {
   return status;
 }
 
-void Filter::sendBodyChunk(ProcessorState& state, const Buffer::Instance& data, bool end_stream) {
+void Filter::sendStreamedData(ProcessorState& state) {
+  if (processing_complete_) {
+    return;
+  }
+  if (state.streamedChunksInFlight() >= config_->maxStreamedChunksInFlight()) {
+    // The data is coalesced into the next chunk, which is sent when a response arrives.
+    ENVOY_LOG(trace, "Too many streamed body chunks in flight -- holding body data");
+    return;
+  }
+  const ProcessorState::QueuedChunk* chunk =
+      state.takeStreamedChunk(config_->streamedChunkMinBytes());
+  if (chunk != nullptr) {
+    sendBodyChunk(state, chunk->data_, chunk->end_stream_,
+                  ProcessorState::CallbackState::StreamedBodyCallback);
+  }
+}
+
+void Filter::sendBodyChunk(ProcessorState& state, const Buffer::Instance& data, bool end_stream,
+                           ProcessorState::CallbackState new_state) {
   ENVOY_LOG(debug, "Sending a body chunk of {} bytes", data.length());
-  state.setCallbackState(ProcessorState::CallbackState::BufferedBodyCallback);
+  state.setCallbackState(new_state);
   state.startMessageTimer(std::bind(&Filter::onMessageTimeout, this), config_->messageTimeout());
   ProcessingRequest req;
   auto* body_req = state.mutableBody(req);
@@ -13,6 +13,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 #include "source/extensions/filters/http/ext_proc/client.h"
 #include "source/extensions/filters/http/ext_proc/processor_state.h"
@@ -36,6 +37,9 @@ struct ExtProcFilterStats {
   ALL_EXT_PROC_FILTER_STATS(GENERATE_COUNTER_STRUCT)
 };
 
+// The default maximum number of streamed body chunks in flight for a request or response.
+constexpr uint32_t DefaultMaxStreamedChunksInFlight = 8;
+
 class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ext_proc::v3alpha::ExternalProcessor& config,
@@ -43,7 +47,10 @@ public:
                const std::string& stats_prefix)
       : failure_mode_allow_(config.failure_mode_allow()), message_timeout_(message_timeout),
         stats_(generateStats(stats_prefix, config.stat_prefix(), scope)),
-        processing_mode_(config.processing_mode()) {}
+        processing_mode_(config.processing_mode()),
+        max_streamed_chunks_in_flight_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            config, max_streamed_chunks_in_flight, DefaultMaxStreamedChunksInFlight)),
+        streamed_chunk_min_bytes_(config.streamed_chunk_min_bytes()) {}
 
   bool failureModeAllow() const { return failure_mode_allow_; }
 
@@ -56,6 +63,10 @@ public:
     return processing_mode_;
   }
 
+  uint32_t maxStreamedChunksInFlight() const { return max_streamed_chunks_in_flight_; }
+
+  uint32_t streamedChunkMinBytes() const { return streamed_chunk_min_bytes_; }
+
 private:
   ExtProcFilterStats generateStats(const std::string& prefix,
                                    const std::string& filter_stats_prefix, Stats::Scope& scope) {
@@ -68,6 +79,8 @@ private:
 
   ExtProcFilterStats stats_;
   const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode processing_mode_;
+  const uint32_t max_streamed_chunks_in_flight_;
+  const uint32_t streamed_chunk_min_bytes_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -119,9 +132,12 @@ public:
   void onMessageTimeout();
 
   void sendBufferedData(ProcessorState& state, bool end_stream) {
-    sendBodyChunk(state, *state.bufferedData(), end_stream);
+    sendBodyChunk(state, *state.bufferedData(), end_stream,
+                  ProcessorState::CallbackState::BufferedBodyCallback);
   }
 
+  void sendStreamedData(ProcessorState& state);
+
   void sendTrailers(ProcessorState& state, const Http::HeaderMap& trailers);
 
 private:
@@ -130,7 +146,8 @@ private:
   void cleanUpTimers();
   void clearAsyncState();
   void sendImmediateResponse(const envoy::service::ext_proc::v3alpha::ImmediateResponse& response);
-  void sendBodyChunk(ProcessorState& state, const Buffer::Instance& data, bool end_stream);
+  void sendBodyChunk(ProcessorState& state, const Buffer::Instance& data, bool end_stream,
+                     ProcessorState::CallbackState new_state);
 
   Http::FilterHeadersStatus onHeaders(ProcessorState& state,
                                       Http::RequestOrResponseHeaderMap& headers, bool end_stream);
@@ -1,5 +1,7 @@
 #include "source/extensions/filters/http/ext_proc/processor_state.h"
 
+#include <algorithm>
+
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/ext_proc/ext_proc.h"
@@ -21,6 +23,7 @@ void ProcessorState::startMessageTimer(Event::TimerCb cb, std::chrono::milliseco
   if (!message_timer_) {
     message_timer_ = filter_callbacks_->dispatcher().createTimer(cb);
   }
+  message_timeout_ = timeout;
   message_timer_->enableTimer(timeout);
 }
 
@@ -76,6 +79,24 @@ bool ProcessorState::handleHeadersResponse(const HeadersResponse& response) {
         return true;
       }
 
+      if (body_mode_ == ProcessingMode::STREAMED && bufferedData() != nullptr) {
+        if (complete_body_available_) {
+          // All the body data came in before the header message was complete, so send
+          // it in a single chunk, as in buffered mode.
+          ENVOY_LOG(debug, "Sending buffered body message in streamed mode");
+          filter_.sendBufferedData(*this, true);
+          return true;
+        }
+
+        // Stream the body data received so far ahead of the data that follows it, once
+        // the headers have been continued.
+        modifyBufferedData([this](Buffer::Instance& data) { enqueueStreamedData(data, false); });
+        headers_ = nullptr;
+        continueProcessing();
+        filter_.sendStreamedData(*this);
+        return true;
+      }
+
       if (send_trailers_ && trailers_available_) {
         // Trailers came in while we were waiting for this response, and the server
         // is not interested in the body, so send them now.
@@ -116,6 +137,39 @@ bool ProcessorState::handleBodyResponse(const BodyResponse& response) {
     continueProcessing();
     return true;
   }
+
+  if (callback_state_ == CallbackState::StreamedBodyCallback) {
+    ENVOY_LOG(debug, "Applying body response to streamed chunk");
+    ASSERT(!streamed_chunks_.empty());
+    QueuedChunkPtr chunk = std::move(streamed_chunks_.front());
+    streamed_chunks_.pop_front();
+    // The headers were continued before the body was streamed, so only the chunk is mutated.
+    MutationUtils::applyCommonBodyResponse(response, nullptr, chunk->data_);
+    if (response.response().clear_route_cache()) {
+      filter_callbacks_->clearRouteCache();
+    }
+    injectDataToFilterChain(chunk->data_, chunk->end_stream_);
+    updateStreamedWatermark();
+    filter_.sendStreamedData(*this);
+
+    if (!streamed_chunks_.empty()) {
+      // Wait for the response to the next chunk in flight.
+      message_timer_->enableTimer(message_timeout_);
+      return true;
+    }
+
+    callback_state_ = CallbackState::Idle;
+    message_timer_->disableTimer();
+    if (trailers_available_ && !hasStreamedData()) {
+      // Trailers came in while the last chunks were processed, and were held behind them.
+      if (send_trailers_) {
+        filter_.sendTrailers(*this, *trailers_);
+      } else {
+        continueProcessing();
+      }
+    }
+    return true;
+  }
   return false;
 }
 
@@ -134,8 +188,81 @@ bool ProcessorState::handleTrailersResponse(const TrailersResponse& response) {
   return false;
 }
 
+void ProcessorState::enqueueStreamedData(Buffer::Instance& data, bool end_stream) {
+  pending_data_.move(data);
+  pending_end_stream_ = end_stream;
+  updateStreamedWatermark();
+}
+
+const ProcessorState::QueuedChunk* ProcessorState::takeStreamedChunk(uint32_t min_bytes) {
+  if (pending_data_.length() == 0 && !pending_end_stream_) {
+    return nullptr;
+  }
+  // Once over the buffer limit, the data stops flowing until at most half of the limit is left
+  // buffered, so waiting for more than that would stall the stream.
+  const uint32_t limit = bufferLimit();
+  if (limit != 0) {
+    min_bytes = std::min(min_bytes, limit / 2);
+  }
+  if (pending_data_.length() < min_bytes && !pending_end_stream_ && !trailers_available_) {
+    // Coalesce the data with what follows it until there is enough to send.
+    return nullptr;
+  }
+  auto chunk = std::make_unique<QueuedChunk>();
+  chunk->data_.move(pending_data_);
+  chunk->end_stream_ = pending_end_stream_;
+  pending_end_stream_ = false;
+  streamed_chunks_.push_back(std::move(chunk));
+  return streamed_chunks_.back().get();
+}
+
+uint64_t ProcessorState::streamedBytes() const {
+  uint64_t bytes = pending_data_.length();
+  for (const auto& chunk : streamed_chunks_) {
+    bytes += chunk->data_.length();
+  }
+  return bytes;
+}
+
+void ProcessorState::updateStreamedWatermark() {
+  const uint32_t limit = bufferLimit();
+  if (limit == 0) {
+    return;
+  }
+  const uint64_t bytes = streamedBytes();
+  if (bytes > limit) {
+    requestWatermark();
+  } else if (bytes <= limit / 2) {
+    clearWatermark();
+  }
+}
+
+void ProcessorState::flushStreamedData() {
+  // The data not processed yet is passed on unmodified, in order.
+  while (!streamed_chunks_.empty()) {
+    QueuedChunkPtr chunk = std::move(streamed_chunks_.front());
+    streamed_chunks_.pop_front();
+    injectDataToFilterChain(chunk->data_, chunk->end_stream_);
+  }
+  if (pending_data_.length() > 0 || pending_end_stream_) {
+    const bool end_stream = pending_end_stream_;
+    pending_end_stream_ = false;
+    injectDataToFilterChain(pending_data_, end_stream);
+  }
+  clearWatermark();
+  if (trailers_available_) {
+    // The trailers were held behind the data.
+    continueProcessing();
+  }
+}
+
 void ProcessorState::clearAsyncState() {
   cleanUpTimer();
+  if (hasStreamedData()) {
+    flushStreamedData();
+    callback_state_ = CallbackState::Idle;
+    return;
+  }
   if (callback_state_ != CallbackState::Idle) {
     continueProcessing();
     callback_state_ = CallbackState::Idle;
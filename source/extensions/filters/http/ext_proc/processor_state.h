@@ -1,5 +1,8 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/ext_proc/v3alpha/processing_mode.pb.h"
@@ -7,6 +10,7 @@
 #include "envoy/http/header_map.h"
 #include "envoy/service/ext_proc/v3alpha/external_processor.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 
 namespace Envoy {
@@ -26,10 +30,19 @@ public:
     HeadersCallback,
     // Waiting for a "body" response in buffered mode
     BufferedBodyCallback,
+    // Waiting for one or more "body" responses in streamed mode
+    StreamedBodyCallback,
     // and waiting for a "trailers" response
     TrailersCallback,
   };
 
+  // A body chunk sent to the processor in streamed mode, held until its response arrives.
+  struct QueuedChunk {
+    Buffer::OwnedImpl data_;
+    bool end_stream_ = false;
+  };
+  using QueuedChunkPtr = std::unique_ptr<QueuedChunk>;
+
   explicit ProcessorState(Filter& filter)
       : filter_(filter), watermark_requested_(false), complete_body_available_(false),
         trailers_available_(false), body_replaced_(false) {}
@@ -74,6 +87,19 @@ public:
 
   virtual Http::HeaderMap* addTrailers() PURE;
 
+  // Holds body data received in streamed mode until it is sent to the processor.
+  void enqueueStreamedData(Buffer::Instance& data, bool end_stream);
+  // Moves the held body data into a new chunk in flight and returns it, unless there is less of
+  // it than min_bytes before the end of the body.
+  const QueuedChunk* takeStreamedChunk(uint32_t min_bytes);
+  uint32_t streamedChunksInFlight() const { return streamed_chunks_.size(); }
+  bool hasStreamedData() const {
+    return !streamed_chunks_.empty() || pending_data_.length() > 0 || pending_end_stream_;
+  }
+
+  virtual void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const PURE;
+  virtual uint32_t bufferLimit() const PURE;
+
   virtual void continueProcessing() const PURE;
   void clearAsyncState();
 
@@ -85,6 +111,10 @@ public:
   mutableTrailers(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const PURE;
 
 protected:
+  uint64_t streamedBytes() const;
+  void updateStreamedWatermark();
+  void flushStreamedData();
+
   Filter& filter_;
   Http::StreamFilterCallbacks* filter_callbacks_;
   CallbackState callback_state_ = CallbackState::Idle;
@@ -110,6 +140,12 @@ protected:
   Http::RequestOrResponseHeaderMap* headers_ = nullptr;
   Http::HeaderMap* trailers_ = nullptr;
   Event::TimerPtr message_timer_;
+  std::chrono::milliseconds message_timeout_{};
+
+  // In streamed mode, the chunks sent to the processor in order, and the data not sent yet.
+  std::deque<QueuedChunkPtr> streamed_chunks_;
+  Buffer::OwnedImpl pending_data_;
+  bool pending_end_stream_ = false;
 };
 
 class DecodingProcessorState : public ProcessorState {
@@ -147,6 +183,12 @@ public:
 
   void continueProcessing() const override { decoder_callbacks_->continueDecoding(); }
 
+  void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const override {
+    decoder_callbacks_->injectDecodedDataToFilterChain(data, end_stream);
+  }
+
+  uint32_t bufferLimit() const override { return decoder_callbacks_->decoderBufferLimit(); }
+
   envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const override {
     return request.mutable_request_headers();
@@ -212,6 +254,12 @@ public:
 
   void continueProcessing() const override { encoder_callbacks_->continueEncoding(); }
 
+  void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const override {
+    encoder_callbacks_->injectEncodedDataToFilterChain(data, end_stream);
+  }
+
+  uint32_t bufferLimit() const override { return encoder_callbacks_->encoderBufferLimit(); }
+
   envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const override {
     return request.mutable_response_headers();
@@ -18,6 +18,7 @@
 #include "source/common/runtime/runtime_features.h"
 #include "source/extensions/filters/http/grpc_json_transcoder/http_body_utils.h"
 
+#include "absl/strings/numbers.h"
 #include "google/api/annotations.pb.h"
 #include "google/api/http.pb.h"
 #include "google/api/httpbody.pb.h"
@@ -65,6 +66,9 @@ namespace {
 constexpr absl::string_view buffer_limits_runtime_feature =
     "envoy.reloadable_features.grpc_json_transcoder_adhere_to_buffer_limits";
 
+constexpr absl::string_view stream_http_body_runtime_feature =
+    "envoy.reloadable_features.grpc_json_transcoder_stream_http_body_requests";
+
 const Http::LowerCaseString& trailerHeader() {
   CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "trailer");
 }
@@ -489,6 +493,9 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::RequestHeade
     if (checkIfTranscoderFailed(RcDetails::get().GrpcTranscodeFailed)) {
       return Http::FilterHeadersStatus::StopIteration;
     }
+    if (!end_stream) {
+      maybeStartHttpBodyRequestStreaming(headers);
+    }
   }
 
   headers.removeContentLength();
@@ -531,6 +538,10 @@ Http::FilterDataStatus JsonTranscoderFilter::decodeData(Buffer::Instance& data,
   }
 
   if (method_->request_type_is_http_body_) {
+    if (http_body_bytes_remaining_.has_value()) {
+      return streamHttpBodyRequestData(data, end_stream);
+    }
+
     request_data_.move(data);
     if (decoderBufferLimitReached(request_data_.length())) {
       return Http::FilterDataStatus::StopIterationNoBuffer;
@@ -570,6 +581,13 @@ Http::FilterTrailersStatus JsonTranscoderFilter::decodeTrailers(Http::RequestTra
   }
 
   if (method_->request_type_is_http_body_) {
+    if (http_body_bytes_remaining_.has_value()) {
+      if (http_body_bytes_remaining_.value() > 0) {
+        rejectHttpBodyLengthMismatch();
+        return Http::FilterTrailersStatus::StopIteration;
+      }
+      return Http::FilterTrailersStatus::Continue;
+    }
     maybeSendHttpBodyRequestMessage();
   } else {
     request_in_.finish();
@@ -785,6 +803,54 @@ void JsonTranscoderFilter::maybeSendHttpBodyRequestMessage() {
   first_request_sent_ = true;
 }
 
+void JsonTranscoderFilter::maybeStartHttpBodyRequestStreaming(
+    const Http::RequestHeaderMap& headers) {
+  uint64_t content_length;
+  if (method_->descriptor_->client_streaming() || headers.ContentLength() == nullptr ||
+      !absl::SimpleAtoi(headers.getContentLengthValue(), &content_length) ||
+      content_length == 0 || !Runtime::runtimeFeatureEnabled(stream_http_body_runtime_feature)) {
+    return;
+  }
+
+  // The content length fixes the length of the message, so that the gRPC frame header and the
+  // HttpBody envelope can be built before the body arrives. The body is then passed upstream as
+  // it arrives, without being buffered or copied.
+  HttpBodyUtils::appendHttpBodyEnvelope(initial_request_data_, method_->request_body_field_path,
+                                        std::move(content_type_), content_length);
+  content_type_.clear();
+  std::array<uint8_t, Grpc::GRPC_FRAME_HEADER_SIZE> frame_header;
+  Grpc::Encoder().newFrame(Grpc::GRPC_FH_DEFAULT, initial_request_data_.length() + content_length,
+                           frame_header);
+  initial_request_data_.prepend(
+      absl::string_view(reinterpret_cast<const char*>(frame_header.data()), frame_header.size()));
+  http_body_bytes_remaining_ = content_length;
+}
+
+Http::FilterDataStatus JsonTranscoderFilter::streamHttpBodyRequestData(Buffer::Instance& data,
+                                                                       bool end_stream) {
+  uint64_t& bytes_remaining = http_body_bytes_remaining_.value();
+  if (data.length() > bytes_remaining || (end_stream && data.length() < bytes_remaining)) {
+    rejectHttpBodyLengthMismatch();
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  bytes_remaining -= data.length();
+
+  if (!first_request_sent_) {
+    data.prepend(initial_request_data_);
+    first_request_sent_ = true;
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+void JsonTranscoderFilter::rejectHttpBodyLengthMismatch() {
+  ENVOY_LOG(debug, "Request rejected because its body length does not match its content-length");
+  error_ = true;
+  decoder_callbacks_->sendLocalReply(
+      Http::Code::BadRequest, "Request body length does not match content-length", nullptr,
+      absl::nullopt,
+      absl::StrCat(RcDetails::get().GrpcTranscodeFailed, "{request_body_length_mismatch}"));
+}
+
 bool JsonTranscoderFilter::buildResponseFromHttpBodyOutput(
     Http::ResponseHeaderMap& response_headers, Buffer::Instance& data) {
   std::vector<Grpc::Frame> frames;
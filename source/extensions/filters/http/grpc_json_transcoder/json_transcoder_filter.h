@@ -12,6 +12,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/filters/http/grpc_json_transcoder/transcoder_input_stream_impl.h"
 
+#include "absl/types/optional.h"
 #include "google/api/http.pb.h"
 #include "grpc_transcoding/path_matcher.h"
 #include "grpc_transcoding/request_message_translator.h"
@@ -172,6 +173,13 @@ private:
   bool checkIfTranscoderFailed(const std::string& details);
   bool readToBuffer(Protobuf::io::ZeroCopyInputStream& stream, Buffer::Instance& data);
   void maybeSendHttpBodyRequestMessage();
+  /**
+   * Streams the body of a unary HttpBody request upstream as it arrives, instead of buffering it,
+   * when its content-length is known.
+   */
+  void maybeStartHttpBodyRequestStreaming(const Http::RequestHeaderMap& headers);
+  Http::FilterDataStatus streamHttpBodyRequestData(Buffer::Instance& data, bool end_stream);
+  void rejectHttpBodyLengthMismatch();
   /**
    * Builds response from HttpBody protobuf.
    * Returns true if at least one gRPC frame has processed.
@@ -204,6 +212,8 @@ private:
   Buffer::OwnedImpl request_data_;
   bool first_request_sent_{false};
   std::string content_type_;
+  // The body bytes still expected from a streamed HttpBody request, set when it is streamed.
+  absl::optional<uint64_t> http_body_bytes_remaining_;
 
   bool error_{false};
   bool has_body_{false};
@@ -58,6 +58,13 @@ private:
   // Verify with a specific public key.
   void verifyKey();
 
+  // Forwards the payload of the verified Jwt and completes it.
+  void handleGoodJwt();
+
+  // Looks up the current token in the Jwt cache of the provider. Returns true if it was verified
+  // before with the current unexpired Jwks of the thread, and sets `jwt_` to the cached Jwt.
+  bool lookupVerifiedJwt();
+
   // Calls the callback with status.
   void doneWithStatus(const Status& status);
 
@@ -80,7 +87,9 @@ private:
   std::vector<JwtLocationConstPtr> tokens_;
   JwtLocationConstPtr curr_token_;
   // The JWT object.
-  std::unique_ptr<::google::jwt_verify::Jwt> jwt_;
+  JwtConstSharedPtr jwt_;
+  // Whether `jwt_` was found in the Jwt cache, so its signature is not verified again.
+  bool jwt_verified_{};
   // The JWKS data object
   JwksCache::JwksData* jwks_data_{};
 
@@ -140,12 +149,23 @@ void AuthenticatorImpl::startVerify() {
   curr_token_ = std::move(tokens_.back());
   tokens_.pop_back();
 
-  jwt_ = std::make_unique<::google::jwt_verify::Jwt>();
-  ENVOY_LOG(debug, "{}: Parse Jwt {}", name(), curr_token_->token());
-  Status status = jwt_->parseFromString(curr_token_->token());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  jwt_verified_ = false;
+  jwks_data_ = nullptr;
+  if (provider_) {
+    jwks_data_ = jwks_cache_.findByProvider(provider_.value());
+    jwt_verified_ = lookupVerifiedJwt();
+  }
+
+  Status status = Status::Ok;
+  if (!jwt_verified_) {
+    auto jwt = std::make_shared<::google::jwt_verify::Jwt>();
+    ENVOY_LOG(debug, "{}: Parse Jwt {}", name(), curr_token_->token());
+    status = jwt->parseFromString(curr_token_->token());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    jwt_ = std::move(jwt);
   }
 
   ENVOY_LOG(debug, "{}: Verifying JWT token of issuer {}", name(), jwt_->iss_);
@@ -158,8 +178,10 @@ void AuthenticatorImpl::startVerify() {
   }
 
   // Check the issuer is configured or not.
-  jwks_data_ = provider_ ? jwks_cache_.findByProvider(provider_.value())
-                         : jwks_cache_.findByIssuer(jwt_->iss_);
+  if (!provider_) {
+    jwks_data_ = jwks_cache_.findByIssuer(jwt_->iss_);
+    jwt_verified_ = lookupVerifiedJwt();
+  }
   // When `provider` is valid, findByProvider should never return nullptr.
   // Only when `allow_missing` or `allow_failed` is used, `provider` is invalid,
   // and this authenticator is checking tokens from all providers. In this case,
@@ -191,6 +213,11 @@ void AuthenticatorImpl::startVerify() {
     return;
   }
 
+  if (jwt_verified_) {
+    handleGoodJwt();
+    return;
+  }
+
   auto jwks_obj = jwks_data_->getJwksObj();
   if (jwks_obj != nullptr && !jwks_data_->isExpired()) {
     // TODO(qiwzhang): It would seem there's a window of error whereby if the JWT issuer
@@ -221,6 +248,26 @@ void AuthenticatorImpl::startVerify() {
   doneWithStatus(Status::JwksNoValidKeys);
 }
 
+bool AuthenticatorImpl::lookupVerifiedJwt() {
+  if (jwks_data_ == nullptr || jwks_data_->getJwtCache() == nullptr) {
+    return false;
+  }
+  // An expired Jwks is fetched again before any Jwt is accepted, in case its keys were rotated.
+  JwtConstSharedPtr jwt;
+  if (jwks_data_->getJwksObj() != nullptr && !jwks_data_->isExpired()) {
+    jwt = jwks_data_->getJwtCache()->lookup(curr_token_->token(),
+                                            jwks_data_->getJwksGeneration());
+  }
+  if (jwt == nullptr) {
+    jwks_cache_.stats().jwt_cache_miss_.inc();
+    return false;
+  }
+  jwks_cache_.stats().jwt_cache_hit_.inc();
+  ENVOY_LOG(debug, "{}: Jwt found in the cache", name());
+  jwt_ = std::move(jwt);
+  return true;
+}
+
 void AuthenticatorImpl::onJwksSuccess(google::jwt_verify::JwksPtr&& jwks) {
   jwks_cache_.stats().jwks_fetch_success_.inc();
   const Status status = jwks_data_->setRemoteJwks(std::move(jwks))->getStatus();
@@ -251,6 +298,14 @@ void AuthenticatorImpl::verifyKey() {
     return;
   }
 
+  if (jwks_data_->getJwtCache() != nullptr) {
+    jwks_data_->getJwtCache()->insert(curr_token_->token(), jwt_,
+                                      jwks_data_->getJwksGeneration());
+  }
+  handleGoodJwt();
+}
+
+void AuthenticatorImpl::handleGoodJwt() {
   // Forward the payload
   const auto& provider = jwks_data_->getJwtProvider();
 
@@ -1,5 +1,6 @@
 #include "source/extensions/filters/http/jwt_authn/jwks_cache.h"
 
+#include <atomic>
 #include <chrono>
 
 #include "envoy/common/time.h"
@@ -37,6 +38,10 @@ public:
 
     tls_.set([](Envoy::Event::Dispatcher&) { return std::make_shared<ThreadLocalCache>(); });
 
+    if (jwt_provider_.has_jwt_cache_config()) {
+      jwt_cache_ = std::make_unique<JwtCache>(jwt_provider_.jwt_cache_config(), time_source_);
+    }
+
     const auto inline_jwks =
         Config::DataSource::read(jwt_provider_.local_jwks(), true, context.api());
     if (!inline_jwks.empty()) {
@@ -72,25 +77,45 @@ public:
     // convert unique_ptr to shared_ptr
     JwksConstSharedPtr shared_jwks = std::move(jwks);
     tls_->jwks_ = shared_jwks;
+    tls_->generation_ = ++last_generation_;
+    clearJwtCache();
     tls_->expire_ = time_source_.monotonicTime() +
                     JwksAsyncFetcher::getCacheDuration(jwt_provider_.remote_jwks());
     return shared_jwks.get();
   }
 
+  uint64_t getJwksGeneration() const override { return tls_->generation_; }
+
+  JwtCache* getJwtCache() const override { return jwt_cache_.get(); }
+
 private:
   struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
     // The jwks object.
     JwksConstSharedPtr jwks_;
     // The pubkey expiration time.
     MonotonicTime expire_;
+    // The generation of the jwks object, which the cached Jwts verified with it are tagged with.
+    uint64_t generation_{};
   };
 
+  // The Jwts verified with a replaced Jwks are verified again, in case a key was revoked. As the
+  // other threads may still verify Jwts with the replaced Jwks, they are only used with the
+  // generation of the Jwks which verified them.
+  void clearJwtCache() {
+    if (jwt_cache_) {
+      jwt_cache_->clear();
+    }
+  }
+
   // Set jwks shared_ptr to all threads.
   void setJwksToAllThreads(JwksConstPtr&& jwks) {
+    clearJwtCache();
     JwksConstSharedPtr shared_jwks = std::move(jwks);
-    tls_.runOnAllThreads([shared_jwks](OptRef<ThreadLocalCache> obj) {
+    const uint64_t generation = ++last_generation_;
+    tls_.runOnAllThreads([shared_jwks, generation](OptRef<ThreadLocalCache> obj) {
       obj->jwks_ = shared_jwks;
       obj->expire_ = std::chrono::steady_clock::time_point::max();
+      obj->generation_ = generation;
     });
   }
 
@@ -104,6 +129,10 @@ private:
   ThreadLocal::TypedSlot<ThreadLocalCache> tls_;
   // async fetcher
   JwksAsyncFetcherPtr async_fetcher_;
+  // The cache of the verified Jwts, shared by all threads.
+  JwtCachePtr jwt_cache_;
+  // The generation of the last jwks object set, on any thread.
+  std::atomic<uint64_t> last_generation_{};
 };
 
 using JwksDataImplPtr = std::unique_ptr<JwksDataImpl>;
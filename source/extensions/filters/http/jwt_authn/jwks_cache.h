@@ -8,6 +8,7 @@
 
 #include "source/extensions/filters/http/common/jwks_fetcher.h"
 #include "source/extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
 #include "source/extensions/filters/http/jwt_authn/stats.h"
 
 #include "jwt_verify_lib/jwks.h"
@@ -65,6 +66,12 @@ public:
 
     // Set a remote Jwks.
     virtual const ::google::jwt_verify::Jwks* setRemoteJwks(JwksConstPtr&& jwks) PURE;
+
+    // Get the generation of the Jwks object, which changes whenever it is replaced.
+    virtual uint64_t getJwksGeneration() const PURE;
+
+    // Get the cache of the verified Jwts, or nullptr if it is not enabled.
+    virtual JwtCache* getJwtCache() const PURE;
   };
 
   // Lookup issuer cache map. The cache only stores Jwks specified in the config.
@@ -0,0 +1,87 @@
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
+
+#include "source/common/common/utility.h"
+
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+constexpr uint32_t DefaultJwtCacheSize = 100;
+
+} // namespace
+
+JwtCache::JwtCache(const envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig& config,
+                   TimeSource& time_source)
+    : time_source_(time_source),
+      max_size_(config.jwt_cache_size() > 0 ? config.jwt_cache_size() : DefaultJwtCacheSize) {}
+
+std::string JwtCache::digest(const std::string& token) {
+  std::string digest(SHA256_DIGEST_LENGTH, '\0');
+  SHA256(reinterpret_cast<const uint8_t*>(token.data()), token.size(),
+         reinterpret_cast<uint8_t*>(&digest[0]));
+  return digest;
+}
+
+JwtConstSharedPtr JwtCache::lookup(const std::string& token, uint64_t jwks_generation) {
+  const std::string key = digest(token);
+  const uint64_t now = DateUtil::nowToSeconds(time_source_);
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  if (it->second->jwt_->exp_ <= now) {
+    lru_list_.erase(it->second);
+    entries_.erase(it);
+    return nullptr;
+  }
+  // A Jwt verified with another Jwks is verified again with the Jwks of the caller.
+  if (it->second->jwks_generation_ != jwks_generation) {
+    return nullptr;
+  }
+  lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+  return it->second->jwt_;
+}
+
+void JwtCache::insert(const std::string& token, const JwtConstSharedPtr& jwt,
+                      uint64_t jwks_generation) {
+  if (jwt->exp_ == 0) {
+    return;
+  }
+
+  std::string key = digest(token);
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    it->second->jwt_ = jwt;
+    it->second->jwks_generation_ = jwks_generation;
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    return;
+  }
+  if (entries_.size() >= max_size_) {
+    entries_.erase(lru_list_.back().digest_);
+    lru_list_.pop_back();
+  }
+  lru_list_.push_front(Entry{key, jwt, jwks_generation});
+  entries_.emplace(std::move(key), lru_list_.begin());
+}
+
+void JwtCache::clear() {
+  absl::MutexLock lock(&mutex_);
+  entries_.clear();
+  lru_list_.clear();
+}
+
+uint64_t JwtCache::size() {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "jwt_verify_lib/jwt.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+using JwtConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwt>;
+
+/**
+ * The JWTs verified with the JWKS of a provider, keyed by the SHA-256 digest of their token. It is
+ * shared by the filters of all the workers, and evicts the least recently used JWT when full.
+ */
+class JwtCache {
+public:
+  JwtCache(const envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig& config,
+           TimeSource& time_source);
+
+  /**
+   * @return the unexpired JWT verified from a token with the JWKS of a generation, or nullptr if
+   *         there is none.
+   */
+  JwtConstSharedPtr lookup(const std::string& token, uint64_t jwks_generation);
+
+  /**
+   * Caches the JWT verified from a token with the JWKS of a generation until its exp time. JWTs
+   * without exp are not cached.
+   */
+  void insert(const std::string& token, const JwtConstSharedPtr& jwt, uint64_t jwks_generation);
+
+  /**
+   * Removes all the JWTs, when the JWKS they were verified with is replaced.
+   */
+  void clear();
+
+  uint64_t size();
+
+private:
+  struct Entry {
+    std::string digest_;
+    JwtConstSharedPtr jwt_;
+    uint64_t jwks_generation_;
+  };
+  using EntryList = std::list<Entry>;
+
+  static std::string digest(const std::string& token);
+
+  TimeSource& time_source_;
+  const uint32_t max_size_;
+  absl::Mutex mutex_;
+  // The most recently used JWT is at the front.
+  EntryList lru_list_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, EntryList::iterator> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+using JwtCachePtr = std::unique_ptr<JwtCache>;
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
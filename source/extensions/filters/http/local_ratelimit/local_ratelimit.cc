@@ -30,7 +30,10 @@ FilterConfig::FilterConfig(
       descriptors_(config.descriptors()),
       rate_limit_per_connection_(config.local_rate_limit_per_downstream_connection()),
       rate_limiter_(Filters::Common::LocalRateLimit::LocalRateLimiterImpl(
-          fill_interval_, max_tokens_, tokens_per_fill_, dispatcher, descriptors_)),
+          fill_interval_, max_tokens_, tokens_per_fill_, dispatcher, descriptors_,
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+              config, max_dynamic_descriptors,
+              Filters::Common::LocalRateLimit::LocalRateLimiterImpl::DefaultMaxDynamicDescriptors))),
       local_info_(local_info), runtime_(runtime),
       filter_enabled_(
           config.has_filter_enabled()
@@ -56,6 +59,17 @@ FilterConfig::FilterConfig(
   if (per_route && !config.has_token_bucket()) {
     throw EnvoyException("local rate limit token bucket must be set for per filter configs");
   }
+  // Each connection would get its own token bucket tables, which are sized for many clients.
+  if (rate_limit_per_connection_) {
+    for (const auto& descriptor : descriptors_) {
+      for (const auto& entry : descriptor.dynamic_entries()) {
+        if (entry.value().empty()) {
+          throw EnvoyException("local rate limit descriptors with empty values are not supported "
+                               "with local_rate_limit_per_downstream_connection");
+        }
+      }
+    }
+  }
 }
 
 bool FilterConfig::requestAllowed(
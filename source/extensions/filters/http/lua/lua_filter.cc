@@ -684,6 +684,7 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::lua::v3::Lua&
     : cluster_manager_(cluster_manager) {
   auto global_setup_ptr = std::make_unique<PerLuaCodeSetup>(proto_config.inline_code(), tls);
   if (global_setup_ptr) {
+    global_setup_ptr->tuneRuntimeGC(proto_config.garbage_collection());
     per_lua_code_setups_map_[GLOBAL_SCRIPT_NAME] = std::move(global_setup_ptr);
   }
 
@@ -693,6 +694,7 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::lua::v3::Lua&
     if (!per_lua_code_setup_ptr) {
       continue;
     }
+    per_lua_code_setup_ptr->tuneRuntimeGC(proto_config.garbage_collection());
     per_lua_code_setups_map_[source.first] = std::move(per_lua_code_setup_ptr);
   }
 }
@@ -6,6 +6,7 @@
 
 #include "source/common/crypto/utility.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/common/utility.h"
 #include "source/extensions/filters/common/lua/wrappers.h"
 #include "source/extensions/filters/http/common/factory_base.h"
@@ -31,6 +32,11 @@ public:
 
   uint64_t runtimeBytesUsed() { return lua_state_.runtimeBytesUsed(); }
   void runtimeGC() { return lua_state_.runtimeGC(); }
+  void tuneRuntimeGC(
+      const envoy::extensions::filters::http::lua::v3::Lua::GarbageCollection& gc_config) {
+    lua_state_.tuneRuntimeGC(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gc_config, pause, 0),
+                             PROTOBUF_GET_WRAPPED_OR_DEFAULT(gc_config, step_multiplier, 0));
+  }
 
 private:
   uint64_t request_function_slot_{};
@@ -9,6 +9,7 @@
 
 #include "source/common/config/utility.h"
 #include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/common/ratelimit/quota_lease_impl.h"
 #include "source/extensions/filters/common/ratelimit/ratelimit_impl.h"
 #include "source/extensions/filters/http/ratelimit/ratelimit.h"
 
@@ -26,15 +27,23 @@ Http::FilterFactoryCb RateLimitFilterConfig::createFilterFactoryFromProtoTyped(
                                                        context.httpContext()));
   const std::chrono::milliseconds timeout =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, timeout, 20));
+  Filters::Common::RateLimit::QuotaLeaseCacheSharedPtr quota_lease_cache;
+  if (proto_config.has_quota_lease()) {
+    const auto& quota_lease = proto_config.quota_lease();
+    quota_lease_cache = std::make_shared<Filters::Common::RateLimit::QuotaLeaseCache>(
+        context.timeSource(), context.scope(), quota_lease.hits_per_lease(),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(quota_lease, lease_duration)),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(quota_lease, max_leases, 10000));
+  }
 
   return [proto_config, &context, timeout,
           transport_version =
               Config::Utility::getAndCheckTransportVersion(proto_config.rate_limit_service()),
-          filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+          filter_config, quota_lease_cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<Filter>(
         filter_config, Filters::Common::RateLimit::rateLimitClient(
                            context, proto_config.rate_limit_service().grpc_service(), timeout,
-                           transport_version)));
+                           transport_version, quota_lease_cache)));
   };
 }
 
@@ -35,6 +35,7 @@
 #include "source/common/router/scoped_rds.h"
 #include "source/common/runtime/runtime_impl.h"
 #include "source/common/tracing/http_tracer_manager_impl.h"
+#include "source/common/tracing/tail_sampling_impl.h"
 #include "source/common/tracing/tracer_config_impl.h"
 
 #ifdef ENVOY_ENABLE_QUIC
@@ -514,6 +515,22 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
         std::make_unique<Http::TracingConnectionManagerConfig>(Http::TracingConnectionManagerConfig{
             tracing_operation_name, custom_tags, client_sampling, random_sampling, overall_sampling,
             tracing_config.verbose(), max_path_tag_length});
+
+    if (tracing_config.has_tail_sampling()) {
+      const auto& tail_sampling = tracing_config.tail_sampling();
+      Tracing::TailSamplingConfig tail_sampling_config;
+      tail_sampling_config.min_duration_ = PROTOBUF_GET_OPTIONAL_MS(tail_sampling, min_duration);
+      if (tail_sampling.has_min_status_code()) {
+        tail_sampling_config.min_status_code_ = tail_sampling.min_status_code().value();
+      }
+      tail_sampling_config.keep_errors_ = tail_sampling.keep_errors();
+      tail_sampling_config.max_buffered_spans_ =
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(tail_sampling, max_buffered_spans, 10000);
+      http_tracer_ = std::make_shared<Tracing::TailSamplingHttpTracer>(
+          http_tracer_, std::make_shared<Tracing::TailSampler>(
+                            tail_sampling_config, stats_prefix_ + "tracing.tail_sampling.",
+                            context_.scope(), context_.dispatcher().timeSource()));
+    }
   }
 
   for (const auto& access_log : config.access_log()) {
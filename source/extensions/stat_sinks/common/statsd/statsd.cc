@@ -1,5 +1,7 @@
 #include "source/extensions/stat_sinks/common/statsd/statsd.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -15,12 +17,14 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/utility.h"
 #include "source/common/network/socket_interface.h"
 #include "source/common/network/utility.h"
 #include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -34,6 +38,11 @@ UdpStatsdSink::WriterImpl::WriterImpl(UdpStatsdSink& parent)
                                                            parent_.server_address_)) {}
 
 void UdpStatsdSink::WriterImpl::write(const std::string& message) {
+  if (batching_) {
+    batch_.append(message);
+    batch_ends_.push_back(batch_.size());
+    return;
+  }
   // TODO(mattklein123): We can avoid this const_cast pattern by having a constant variant of
   // RawSlice. This can be fixed elsewhere as well.
   Buffer::RawSlice slice{const_cast<char*>(message.c_str()), message.size()};
@@ -41,9 +50,69 @@ void UdpStatsdSink::WriterImpl::write(const std::string& message) {
 }
 
 void UdpStatsdSink::WriterImpl::writeBuffer(Buffer::Instance& data) {
+  if (batching_) {
+    for (const Buffer::RawSlice& slice : data.getRawSlices()) {
+      batch_.append(static_cast<const char*>(slice.mem_), slice.len_);
+    }
+    batch_ends_.push_back(batch_.size());
+    return;
+  }
   Network::Utility::writeToSocket(*io_handle_, data, nullptr, *parent_.server_address_);
 }
 
+void UdpStatsdSink::WriterImpl::endBatch() {
+  batching_ = false;
+  if (batch_ends_.empty()) {
+    return;
+  }
+
+  if (io_handle_->supportsMmsg()) {
+    sendBatchWithMmsg();
+  } else {
+    sendBatchOneByOne();
+  }
+  batch_.clear();
+  batch_ends_.clear();
+}
+
+void UdpStatsdSink::WriterImpl::sendBatchWithMmsg() {
+  std::array<Buffer::RawSlice, MaxDatagramsPerSyscall> datagrams;
+
+  size_t next = 0;
+  while (next < batch_ends_.size()) {
+    const size_t count = std::min(MaxDatagramsPerSyscall, batch_ends_.size() - next);
+    size_t begin = next == 0 ? 0 : batch_ends_[next - 1];
+    for (size_t i = 0; i < count; ++i) {
+      const size_t end = batch_ends_[next + i];
+      datagrams[i] = {&batch_[begin], end - begin};
+      begin = end;
+    }
+
+    const Api::IoCallUint64Result result =
+        io_handle_->sendmmsg(datagrams.data(), count, 0, *parent_.server_address_);
+    if (!result.ok() || result.rc_ == 0) {
+      // As with single datagrams, delivery is best effort: the rest of the batch is dropped
+      // rather than retried, e.g. if the socket buffer is full.
+      ENVOY_LOG_MISC(debug, "statsd: dropping {} datagrams, sendmmsg failed: {}",
+                     batch_ends_.size() - next,
+                     result.ok() ? "no datagram sent" : result.err_->getErrorDetails());
+      return;
+    }
+    // sendmmsg() may send fewer datagrams than asked, in which case the next call resumes from
+    // the first one which was not sent.
+    next += result.rc_;
+  }
+}
+
+void UdpStatsdSink::WriterImpl::sendBatchOneByOne() {
+  size_t begin = 0;
+  for (const size_t end : batch_ends_) {
+    Buffer::RawSlice slice{&batch_[begin], end - begin};
+    Network::Utility::writeToSocket(*io_handle_, &slice, 1, nullptr, *parent_.server_address_);
+    begin = end;
+  }
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
                              const std::string& prefix, absl::optional<uint64_t> buffer_size,
@@ -59,25 +128,80 @@ UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   Writer& writer = tls_->getTyped<Writer>();
   Buffer::OwnedImpl buffer;
+  // Reused across metrics so that its capacity only grows a handful of times per flush.
+  std::string message;
+  ++flush_generation_;
+  rendered_metrics_flushed_ = 0;
 
+  writer.beginBatch();
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      const std::string counter_str = buildMessage(counter.counter_.get(), counter.delta_, "|c");
-      writeBuffer(buffer, writer, counter_str);
+      buildFlushedMessage(message, counter.counter_.get(), counter.delta_, "|c");
+      writeBuffer(buffer, writer, message);
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      const std::string gauge_str = buildMessage(gauge.get(), gauge.get().value(), "|g");
-      writeBuffer(buffer, writer, gauge_str);
+      buildFlushedMessage(message, gauge.get(), gauge.get().value(), "|g");
+      writeBuffer(buffer, writer, message);
     }
   }
 
   flushBuffer(buffer, writer);
+  writer.endBatch();
+  evictUnflushedMetrics();
   // TODO(efimki): Add support of text readouts stats.
 }
 
+void UdpStatsdSink::buildFlushedMessage(std::string& message, const Stats::Metric& metric,
+                                        uint64_t value, absl::string_view type) {
+  if (metric.use_count() == 0) {
+    // The metric is not owned by a store, so its lifetime cannot be shared by the cache.
+    message = buildMessage(metric, value, std::string(type));
+    return;
+  }
+
+  auto it = rendered_metrics_.find(&metric);
+  if (it == rendered_metrics_.end()) {
+    RenderedMetric rendered;
+    // The cache only shares ownership of the metric, it never modifies it.
+    rendered.metric_ = const_cast<Stats::Metric*>(&metric);
+    const std::string tags = buildTagStr(metric.tags());
+    switch (tag_format_.tag_position) {
+    case Statsd::TagPosition::TagAfterValue:
+      rendered.prefix_ = absl::StrCat(prefix_, ".", getName(metric));
+      rendered.suffix_ = tags;
+      break;
+    case Statsd::TagPosition::TagAfterName:
+      rendered.prefix_ = absl::StrCat(prefix_, ".", getName(metric), tags);
+      break;
+    }
+    it = rendered_metrics_.emplace(&metric, std::move(rendered)).first;
+  }
+  if (it->second.flush_generation_ != flush_generation_) {
+    it->second.flush_generation_ = flush_generation_;
+    ++rendered_metrics_flushed_;
+  }
+
+  message.clear();
+  absl::StrAppend(&message, it->second.prefix_, ":", value, type, it->second.suffix_);
+}
+
+void UdpStatsdSink::evictUnflushedMetrics() {
+  if (rendered_metrics_flushed_ == rendered_metrics_.size()) {
+    return;
+  }
+  // Releases the metrics which were not part of this flush, e.g. as their scope was deleted.
+  for (auto it = rendered_metrics_.begin(); it != rendered_metrics_.end();) {
+    if (it->second.flush_generation_ != flush_generation_) {
+      rendered_metrics_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void UdpStatsdSink::writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer,
                                 const std::string& statsd_metric) const {
   if (statsd_metric.length() >= buffer_size_) {
@@ -327,7 +451,7 @@ void TcpStatsdSink::TlsSink::write(Buffer::Instance& buffer) {
                                      parent_.cluster_info_->stats().upstream_cx_rx_bytes_buffered_,
                                      parent_.cluster_info_->stats().upstream_cx_tx_bytes_total_,
                                      parent_.cluster_info_->stats().upstream_cx_tx_bytes_buffered_,
-                                     &parent_.cluster_info_->stats().bind_errors_, nullptr});
+                                     &parent_.cluster_info_->stats().bind_errors_.get(), nullptr});
     connection_->connect();
   }
 
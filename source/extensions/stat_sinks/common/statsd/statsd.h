@@ -17,6 +17,8 @@
 #include "source/common/network/io_socket_handle_impl.h"
 #include "source/extensions/stat_sinks/common/statsd/tag_formats.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -39,6 +41,17 @@ public:
   public:
     virtual void write(const std::string& message) PURE;
     virtual void writeBuffer(Buffer::Instance& data) PURE;
+
+    /**
+     * Starts queueing the datagrams passed to write() and writeBuffer() rather than sending them
+     * one at a time.
+     */
+    virtual void beginBatch() PURE;
+
+    /**
+     * Sends the datagrams queued since beginBatch(), in as few system calls as possible.
+     */
+    virtual void endBatch() PURE;
   };
 
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
@@ -63,6 +76,7 @@ public:
 
   bool getUseTagForTest() { return use_tag_; }
   uint64_t getBufferSizeForTest() { return buffer_size_; }
+  size_t renderedMetricsForTest() const { return rendered_metrics_.size(); }
   const std::string& getPrefix() { return prefix_; }
 
 private:
@@ -76,15 +90,45 @@ private:
     // Writer
     void write(const std::string& message) override;
     void writeBuffer(Buffer::Instance& data) override;
+    void beginBatch() override { batching_ = true; }
+    void endBatch() override;
 
   private:
+    // The number of datagrams handed to each sendmmsg() call.
+    static constexpr size_t MaxDatagramsPerSyscall = 64;
+
+    void sendBatchWithMmsg();
+    void sendBatchOneByOne();
+
     UdpStatsdSink& parent_;
     const Network::IoHandlePtr io_handle_;
+    bool batching_{false};
+    // The datagrams queued while batching, back to back, and the offset at which each one ends.
+    std::string batch_;
+    std::vector<size_t> batch_ends_;
+  };
+
+  /**
+   * The parts of the message of a metric which do not depend on its value, rendered the first time
+   * the metric is flushed. As the tags of a metric are fixed when it is created, and the entry
+   * keeps the metric alive so that its address cannot be reused by a metric with another name or
+   * other tags, an entry never goes stale. Entries for metrics missing from a flush are dropped.
+   */
+  struct RenderedMetric {
+    Stats::RefcountPtr<Stats::Metric> metric_;
+    // Everything before the ':' separating the value.
+    std::string prefix_;
+    // Everything after the type.
+    std::string suffix_;
+    uint64_t flush_generation_{0};
   };
 
   void flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const;
   void writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer, const std::string& data) const;
 
+  void buildFlushedMessage(std::string& message, const Stats::Metric& metric, uint64_t value,
+                           absl::string_view type);
+  void evictUnflushedMetrics();
   const std::string buildMessage(const Stats::Metric& metric, uint64_t value,
                                  const std::string& type) const;
   const std::string getName(const Stats::Metric& metric) const;
@@ -97,6 +141,10 @@ private:
   const std::string prefix_;
   const uint64_t buffer_size_;
   const Statsd::TagFormat tag_format_;
+  // Only accessed from flush(), which always runs on the main thread.
+  absl::flat_hash_map<const Stats::Metric*, RenderedMetric> rendered_metrics_;
+  uint64_t flush_generation_{0};
+  size_t rendered_metrics_flushed_{0};
 };
 
 /**
@@ -36,11 +36,16 @@ MetricsServiceSinkFactory::createStatsSink(const Protobuf::Message& config,
               grpc_service, server.scope(), false),
           server.localInfo(), transport_api_version);
 
+  Stats::SinkFlushOptions flush_options;
+  flush_options.changed_metrics_only_ = sink_config.report_only_changed_metrics();
+  flush_options.max_metrics_per_flush_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_metrics_per_message, 0);
+
   return std::make_unique<MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
                                              envoy::service::metrics::v3::StreamMetricsResponse>>(
       grpc_metrics_streamer,
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, report_counters_as_deltas, false),
-      sink_config.emit_tags_as_labels());
+      sink_config.emit_tags_as_labels(), flush_options);
 }
 
 ProtobufTypes::MessagePtr MetricsServiceSinkFactory::createEmptyConfigProto() {
@@ -119,23 +119,27 @@ template <class RequestProto, class ResponseProto> class MetricsServiceSink : pu
 public:
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
-      bool report_counters_as_deltas, bool emit_labels)
+      bool report_counters_as_deltas, bool emit_labels,
+      const Stats::SinkFlushOptions& flush_options = {})
       : MetricsServiceSink(grpc_metrics_streamer,
-                           MetricsFlusher(report_counters_as_deltas, emit_labels)) {}
+                           MetricsFlusher(report_counters_as_deltas, emit_labels), flush_options) {}
 
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
-      MetricsFlusher&& flusher)
-      : flusher_(std::move(flusher)), grpc_metrics_streamer_(std::move(grpc_metrics_streamer)) {}
+      MetricsFlusher&& flusher, const Stats::SinkFlushOptions& flush_options = {})
+      : flusher_(std::move(flusher)), flush_options_(flush_options),
+        grpc_metrics_streamer_(std::move(grpc_metrics_streamer)) {}
 
   // MetricsService::Sink
   void flush(Stats::MetricSnapshot& snapshot) override {
     grpc_metrics_streamer_->send(flusher_.flush(snapshot));
   }
+  Stats::SinkFlushOptions flushOptions() const override { return flush_options_; }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
 private:
   const MetricsFlusher flusher_;
+  const Stats::SinkFlushOptions flush_options_;
   GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto> grpc_metrics_streamer_;
 };
 
@@ -1,5 +1,7 @@
 #include "source/extensions/tracers/zipkin/span_buffer.h"
 
+#include <algorithm>
+
 #include "envoy/config/trace/v3/zipkin.pb.h"
 
 #include "source/common/protobuf/utility.h"
@@ -7,13 +9,57 @@
 #include "source/extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "source/extensions/tracers/zipkin/zipkin_json_field_names.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
-#include "absl/strings/str_replace.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
+namespace {
+
+// Appends the given value as a JSON string, escaping it as per RFC 8259.
+void appendJsonString(absl::string_view value, std::string& out) {
+  out.push_back('"');
+  size_t unescaped_begin = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const unsigned char c = value[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(value.data() + unescaped_begin, i - unescaped_begin);
+    unescaped_begin = i + 1;
+    switch (c) {
+    case '"':
+      out.append("\\\"");
+      break;
+    case '\\':
+      out.append("\\\\");
+      break;
+    case '\n':
+      out.append("\\n");
+      break;
+    case '\r':
+      out.append("\\r");
+      break;
+    case '\t':
+      out.append("\\t");
+      break;
+    default:
+      absl::StrAppend(&out, "\\u00", absl::Hex(static_cast<uint32_t>(c), absl::kZeroPad2));
+    }
+  }
+  out.append(value.data() + unescaped_begin, value.size() - unescaped_begin);
+  out.push_back('"');
+}
+
+// Appends the key of a field of a JSON object, preceded by a comma unless it is the first field.
+void appendJsonKey(absl::string_view key, bool& first_field, std::string& out) {
+  absl::StrAppend(&out, first_field ? "\"" : ",\"", key, "\":");
+  first_field = false;
+}
+
+} // namespace
 
 SpanBuffer::SpanBuffer(
     const envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion& version,
@@ -71,223 +117,213 @@ JsonV2Serializer::JsonV2Serializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
 std::string JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans) {
-  Util::Replacements replacements;
-  const std::string serialized_elements = absl::StrJoin(
-      zipkin_spans, ",", [this, &replacements](std::string* out, const Span& zipkin_span) {
-        const auto& replacement_values = replacements;
-        absl::StrAppend(
-            out, absl::StrJoin(
-                     toListOfSpans(zipkin_span, replacements), ",",
-                     [&replacement_values](std::string* element, const ProtobufWkt::Struct& span) {
-                       const std::string json = MessageUtil::getJsonStringFromMessageOrDie(
-                           span, /* pretty_print */ false,
-                           /* always_print_primitive_fields */ true);
-
-                       // The Zipkin API V2 specification mandates to store timestamp value as int64
-                       // https://github.com/openzipkin/zipkin-api/blob/228fabe660f1b5d1e28eac9df41f7d1deed4a1c2/zipkin2-api.yaml#L447-L463
-                       // (often translated as uint64 in some of the official implementations:
-                       // https://github.com/openzipkin/zipkin-go/blob/62dc8b26c05e0e8b88eb7536eff92498e65bbfc3/model/span.go#L114,
-                       // and see the discussion here:
-                       // https://github.com/openzipkin/zipkin-go/pull/161#issuecomment-598558072).
-                       // However, when the timestamp is stored as number value in a protobuf
-                       // struct, it is stored as a double. Because of how protobuf serializes
-                       // doubles, there is a possibility that the value will be rendered as a
-                       // number with scientific notation as reported in:
-                       // https://github.com/envoyproxy/envoy/issues/9341#issuecomment-566912973. To
-                       // deal with that issue, here we do a workaround by storing the timestamp as
-                       // string and keeping track of that with the corresponding integer
-                       // replacements, and do the replacement here so we can meet the Zipkin API V2
-                       // requirements.
-                       //
-                       // TODO(dio): The right fix for this is to introduce additional knob when
-                       // serializing double in protobuf DoubleToBuffer function, and make it
-                       // available to be controlled at caller site.
-                       // https://github.com/envoyproxy/envoy/issues/10411).
-                       absl::StrAppend(element, absl::StrReplaceAll(json, replacement_values));
-                     }));
-      });
-  return absl::StrCat("[", serialized_elements, "]");
+  std::string out = "[";
+  bool first = true;
+  for (const Span& zipkin_span : zipkin_spans) {
+    appendListOfSpans(zipkin_span, first, out);
+  }
+  out.push_back(']');
+  return out;
 }
 
-const std::vector<ProtobufWkt::Struct>
-JsonV2Serializer::toListOfSpans(const Span& zipkin_span, Util::Replacements& replacements) const {
-  std::vector<ProtobufWkt::Struct> spans;
-  spans.reserve(zipkin_span.annotations().size());
+void JsonV2Serializer::appendListOfSpans(const Span& zipkin_span, bool& first,
+                                         std::string& out) const {
+  // The annotation entries from logs and the tags are the same for every span built from the given
+  // one, so they are rendered once.
+  std::string annotation_entries;
+  for (const auto& annotation : zipkin_span.annotations()) {
+    if (annotation.value() == CLIENT_SEND || annotation.value() == SERVER_RECV) {
+      continue;
+    }
+    annotation_entries.append(annotation_entries.empty() ? "[{" : ",{");
+    bool first_field = true;
+    appendJsonKey(ANNOTATION_VALUE, first_field, annotation_entries);
+    appendJsonString(annotation.value(), annotation_entries);
+    appendJsonKey(ANNOTATION_TIMESTAMP, first_field, annotation_entries);
+    absl::StrAppend(&annotation_entries, annotation.timestamp());
+    annotation_entries.push_back('}');
+  }
+  if (!annotation_entries.empty()) {
+    annotation_entries.push_back(']');
+  }
 
-  // This holds the annotation entries from logs.
-  std::vector<ProtobufWkt::Value> annotation_entries;
+  std::string tags;
+  const auto& binary_annotations = zipkin_span.binaryAnnotations();
+  for (auto it = binary_annotations.begin(); it != binary_annotations.end(); ++it) {
+    // Tags are keyed by name, so a later tag replaces an earlier one with the same name.
+    if (std::any_of(it + 1, binary_annotations.end(),
+                    [&it](const BinaryAnnotation& later) { return later.key() == it->key(); })) {
+      continue;
+    }
+    tags.push_back(tags.empty() ? '{' : ',');
+    appendJsonString(it->key(), tags);
+    tags.push_back(':');
+    appendJsonString(it->value(), tags);
+  }
+  if (!tags.empty()) {
+    tags.push_back('}');
+  }
 
+  const std::string trace_id = zipkin_span.traceIdAsHexString();
+  const std::string id = zipkin_span.idAsHexString();
   for (const auto& annotation : zipkin_span.annotations()) {
-    ProtobufWkt::Struct span;
-    auto* fields = span.mutable_fields();
-    if (annotation.value() == CLIENT_SEND) {
-      (*fields)[SPAN_KIND] = ValueUtil::stringValue(KIND_CLIENT);
-    } else if (annotation.value() == SERVER_RECV) {
-      if (shared_span_context_ && zipkin_span.annotations().size() > 1) {
-        (*fields)[SPAN_SHARED] = ValueUtil::boolValue(true);
-      }
-      (*fields)[SPAN_KIND] = ValueUtil::stringValue(KIND_SERVER);
-    } else {
-      ProtobufWkt::Struct annotation_entry;
-      auto* annotation_entry_fields = annotation_entry.mutable_fields();
-      (*annotation_entry_fields)[ANNOTATION_VALUE] = ValueUtil::stringValue(annotation.value());
-      (*annotation_entry_fields)[ANNOTATION_TIMESTAMP] =
-          Util::uint64Value(annotation.timestamp(), ANNOTATION_TIMESTAMP, replacements);
-      annotation_entries.push_back(ValueUtil::structValue(annotation_entry));
+    const bool client = annotation.value() == CLIENT_SEND;
+    if (!client && annotation.value() != SERVER_RECV) {
       continue;
     }
 
-    if (annotation.isSetEndpoint()) {
-      // Usually we store number to a ProtobufWkt::Struct object via ValueUtil::numberValue.
-      // However, due to the possibility of rendering that to a number with scientific notation, we
-      // chose to store it as a string and keeping track the corresponding replacement. For example,
-      // we have 1584324295476870 if we stored it as a double value, MessageToJsonString gives
-      // us 1.58432429547687e+15. Instead we store it as the string of 1584324295476870 (when it is
-      // serialized: "1584324295476870"), and replace it post MessageToJsonString serialization with
-      // integer (1584324295476870 without `"`), see: JsonV2Serializer::serialize.
-      (*fields)[SPAN_TIMESTAMP] =
-          Util::uint64Value(annotation.timestamp(), SPAN_TIMESTAMP, replacements);
-      (*fields)[SPAN_LOCAL_ENDPOINT] =
-          ValueUtil::structValue(toProtoEndpoint(annotation.endpoint()));
-    }
+    out.append(first ? "{" : ",{");
+    first = false;
+    bool first_field = true;
 
-    (*fields)[SPAN_TRACE_ID] = ValueUtil::stringValue(zipkin_span.traceIdAsHexString());
+    appendJsonKey(SPAN_TRACE_ID, first_field, out);
+    appendJsonString(trace_id, out);
     if (zipkin_span.isSetParentId()) {
-      (*fields)[SPAN_PARENT_ID] = ValueUtil::stringValue(zipkin_span.parentIdAsHexString());
+      appendJsonKey(SPAN_PARENT_ID, first_field, out);
+      appendJsonString(zipkin_span.parentIdAsHexString(), out);
     }
-
-    (*fields)[SPAN_ID] = ValueUtil::stringValue(zipkin_span.idAsHexString());
+    appendJsonKey(SPAN_ID, first_field, out);
+    appendJsonString(id, out);
 
     const auto& span_name = zipkin_span.name();
     if (!span_name.empty()) {
-      (*fields)[SPAN_NAME] = ValueUtil::stringValue(span_name);
+      appendJsonKey(SPAN_NAME, first_field, out);
+      appendJsonString(span_name, out);
     }
 
-    if (zipkin_span.isSetDuration()) {
-      // Since SPAN_DURATION has the same data type with SPAN_TIMESTAMP, we use Util::uint64Value to
-      // store it.
-      (*fields)[SPAN_DURATION] =
-          Util::uint64Value(zipkin_span.duration(), SPAN_DURATION, replacements);
+    appendJsonKey(SPAN_KIND, first_field, out);
+    appendJsonString(client ? KIND_CLIENT : KIND_SERVER, out);
+    if (!client && shared_span_context_ && zipkin_span.annotations().size() > 1) {
+      appendJsonKey(SPAN_SHARED, first_field, out);
+      out.append("true");
     }
 
-    const auto& binary_annotations = zipkin_span.binaryAnnotations();
-    if (!binary_annotations.empty()) {
-      ProtobufWkt::Struct tags;
-      auto* tag_fields = tags.mutable_fields();
-      for (const auto& binary_annotation : binary_annotations) {
-        (*tag_fields)[binary_annotation.key()] = ValueUtil::stringValue(binary_annotation.value());
-      }
-      (*fields)[SPAN_TAGS] = ValueUtil::structValue(tags);
+    // The Zipkin API V2 specification mandates to store timestamp and duration values as int64:
+    // https://github.com/openzipkin/zipkin-api/blob/228fabe660f1b5d1e28eac9df41f7d1deed4a1c2/zipkin2-api.yaml#L447-L463.
+    // Writing them directly avoids the scientific notation protobuf uses for large doubles, see:
+    // https://github.com/envoyproxy/envoy/issues/9341#issuecomment-566912973.
+    if (annotation.isSetEndpoint()) {
+      appendJsonKey(SPAN_TIMESTAMP, first_field, out);
+      absl::StrAppend(&out, annotation.timestamp());
+      appendJsonKey(SPAN_LOCAL_ENDPOINT, first_field, out);
+      appendEndpoint(annotation.endpoint(), out);
+    }
+    if (zipkin_span.isSetDuration()) {
+      appendJsonKey(SPAN_DURATION, first_field, out);
+      absl::StrAppend(&out, zipkin_span.duration());
     }
 
-    spans.push_back(std::move(span));
-  }
-
-  // Fill up annotation entries from logs.
-  for (auto& span : spans) {
-    auto* fields = span.mutable_fields();
+    if (!tags.empty()) {
+      appendJsonKey(SPAN_TAGS, first_field, out);
+      out.append(tags);
+    }
     if (!annotation_entries.empty()) {
-      (*fields)[ANNOTATIONS] = ValueUtil::listValue(annotation_entries);
+      appendJsonKey(ANNOTATIONS, first_field, out);
+      out.append(annotation_entries);
     }
-  }
 
-  return spans;
+    out.push_back('}');
+  }
 }
 
-const ProtobufWkt::Struct JsonV2Serializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
-  ProtobufWkt::Struct endpoint;
-  auto* fields = endpoint.mutable_fields();
+void JsonV2Serializer::appendEndpoint(const Endpoint& zipkin_endpoint, std::string& out) const {
+  out.push_back('{');
+  bool first_field = true;
 
   Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
   if (address) {
-    if (address->ip()->version() == Network::Address::IpVersion::v4) {
-      (*fields)[ENDPOINT_IPV4] = ValueUtil::stringValue(address->ip()->addressAsString());
-    } else {
-      (*fields)[ENDPOINT_IPV6] = ValueUtil::stringValue(address->ip()->addressAsString());
-    }
-    (*fields)[ENDPOINT_PORT] = ValueUtil::numberValue(address->ip()->port());
+    appendJsonKey(address->ip()->version() == Network::Address::IpVersion::v4 ? ENDPOINT_IPV4
+                                                                              : ENDPOINT_IPV6,
+                  first_field, out);
+    appendJsonString(address->ip()->addressAsString(), out);
+    appendJsonKey(ENDPOINT_PORT, first_field, out);
+    absl::StrAppend(&out, address->ip()->port());
   }
 
   const std::string& service_name = zipkin_endpoint.serviceName();
   if (!service_name.empty()) {
-    (*fields)[ENDPOINT_SERVICE_NAME] = ValueUtil::stringValue(service_name);
+    appendJsonKey(ENDPOINT_SERVICE_NAME, first_field, out);
+    appendJsonString(service_name, out);
   }
 
-  return endpoint;
+  out.push_back('}');
 }
 
 ProtobufSerializer::ProtobufSerializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
 std::string ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans) {
-  zipkin::proto3::ListOfSpans spans;
+  // The message only lives until it is serialized, so it is built on an arena rather than
+  // allocating each span, endpoint and tag separately.
+  Protobuf::Arena arena;
+  auto* spans = Protobuf::Arena::CreateMessage<zipkin::proto3::ListOfSpans>(&arena);
   for (const Span& zipkin_span : zipkin_spans) {
-    spans.MergeFrom(toListOfSpans(zipkin_span));
+    addListOfSpans(zipkin_span, *spans);
   }
   std::string serialized;
-  spans.SerializeToString(&serialized);
+  spans->SerializeToString(&serialized);
   return serialized;
 }
 
-const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span& zipkin_span) const {
-  zipkin::proto3::ListOfSpans spans;
-
-  // This holds the annotation entries from logs.
-  std::vector<Annotation> annotation_entries;
+void ProtobufSerializer::addListOfSpans(const Span& zipkin_span,
+                                        zipkin::proto3::ListOfSpans& spans) const {
+  const int first_span = spans.spans_size();
+  const std::string trace_id = zipkin_span.traceIdAsByteString();
+  const std::string id = zipkin_span.idAsByteString();
 
   for (const auto& annotation : zipkin_span.annotations()) {
-    zipkin::proto3::Span span;
-    if (annotation.value() == CLIENT_SEND) {
-      span.set_kind(zipkin::proto3::Span::CLIENT);
-    } else if (annotation.value() == SERVER_RECV) {
-      span.set_shared(shared_span_context_ && zipkin_span.annotations().size() > 1);
-      span.set_kind(zipkin::proto3::Span::SERVER);
-    } else {
-      annotation_entries.push_back(annotation);
+    const bool client = annotation.value() == CLIENT_SEND;
+    if (!client && annotation.value() != SERVER_RECV) {
       continue;
     }
 
+    zipkin::proto3::Span* span = spans.add_spans();
+    if (client) {
+      span->set_kind(zipkin::proto3::Span::CLIENT);
+    } else {
+      span->set_shared(shared_span_context_ && zipkin_span.annotations().size() > 1);
+      span->set_kind(zipkin::proto3::Span::SERVER);
+    }
+
     if (annotation.isSetEndpoint()) {
-      span.set_timestamp(annotation.timestamp());
-      span.mutable_local_endpoint()->MergeFrom(toProtoEndpoint(annotation.endpoint()));
+      span->set_timestamp(annotation.timestamp());
+      toProtoEndpoint(annotation.endpoint(), *span->mutable_local_endpoint());
     }
 
-    span.set_trace_id(zipkin_span.traceIdAsByteString());
+    span->set_trace_id(trace_id);
     if (zipkin_span.isSetParentId()) {
-      span.set_parent_id(zipkin_span.parentIdAsByteString());
+      span->set_parent_id(zipkin_span.parentIdAsByteString());
     }
 
-    span.set_id(zipkin_span.idAsByteString());
-    span.set_name(zipkin_span.name());
+    span->set_id(id);
+    span->set_name(zipkin_span.name());
 
     if (zipkin_span.isSetDuration()) {
-      span.set_duration(zipkin_span.duration());
+      span->set_duration(zipkin_span.duration());
     }
 
-    auto& tags = *span.mutable_tags();
+    auto& tags = *span->mutable_tags();
     for (const auto& binary_annotation : zipkin_span.binaryAnnotations()) {
       tags[binary_annotation.key()] = binary_annotation.value();
     }
-
-    auto* mutable_span = spans.add_spans();
-    mutable_span->MergeFrom(span);
   }
 
   // Fill up annotation entries from logs.
-  for (auto& span : *spans.mutable_spans()) {
-    for (const auto& annotation_entry : annotation_entries) {
-      const auto entry = span.mutable_annotations()->Add();
-      entry->set_value(annotation_entry.value());
-      entry->set_timestamp(annotation_entry.timestamp());
+  for (int i = first_span; i < spans.spans_size(); ++i) {
+    zipkin::proto3::Span* span = spans.mutable_spans(i);
+    for (const auto& annotation : zipkin_span.annotations()) {
+      if (annotation.value() == CLIENT_SEND || annotation.value() == SERVER_RECV) {
+        continue;
+      }
+      auto* entry = span->add_annotations();
+      entry->set_value(annotation.value());
+      entry->set_timestamp(annotation.timestamp());
     }
   }
-
-  return spans;
 }
 
-const zipkin::proto3::Endpoint
-ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
-  zipkin::proto3::Endpoint endpoint;
+void ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint,
+                                         zipkin::proto3::Endpoint& endpoint) const {
   Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
   if (address) {
     if (address->ip()->version() == Network::Address::IpVersion::v4) {
@@ -302,8 +338,6 @@ ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
   if (!service_name.empty()) {
     endpoint.set_service_name(service_name);
   }
-
-  return endpoint;
 }
 
 } // namespace Zipkin
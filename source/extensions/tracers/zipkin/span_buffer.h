@@ -109,7 +109,8 @@ public:
 
 /**
  * JsonV2Serializer implements Zipkin::Serializer that serializes list of Zipkin spans into JSON
- * Zipkin v2 array.
+ * Zipkin v2 array. The JSON is written directly to the output string, without building
+ * intermediate protobuf structs.
  */
 class JsonV2Serializer : public Serializer {
 public:
@@ -122,16 +123,16 @@ public:
   std::string serialize(const std::vector<Span>& pending_spans) override;
 
 private:
-  const std::vector<ProtobufWkt::Struct> toListOfSpans(const Span& zipkin_span,
-                                                       Util::Replacements& replacements) const;
-  const ProtobufWkt::Struct toProtoEndpoint(const Endpoint& zipkin_endpoint) const;
+  void appendListOfSpans(const Span& zipkin_span, bool& first, std::string& out) const;
+  void appendEndpoint(const Endpoint& zipkin_endpoint, std::string& out) const;
 
   const bool shared_span_context_;
 };
 
 /**
  * ProtobufSerializer implements Zipkin::Serializer that serializes list of Zipkin spans into
- * stringified (SerializeToString) protobuf message.
+ * stringified (SerializeToString) protobuf message. The message is built on an arena, which
+ * frees it in one go once serialized.
  */
 class ProtobufSerializer : public Serializer {
 public:
@@ -144,8 +145,8 @@ public:
   std::string serialize(const std::vector<Span>& pending_spans) override;
 
 private:
-  const zipkin::proto3::ListOfSpans toListOfSpans(const Span& zipkin_span) const;
-  const zipkin::proto3::Endpoint toProtoEndpoint(const Endpoint& zipkin_endpoint) const;
+  void addListOfSpans(const Span& zipkin_span, zipkin::proto3::ListOfSpans& spans) const;
+  void toProtoEndpoint(const Endpoint& zipkin_endpoint, zipkin::proto3::Endpoint& endpoint) const;
 
   const bool shared_span_context_;
 };
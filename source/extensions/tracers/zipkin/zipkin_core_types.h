@@ -71,6 +71,12 @@ public:
    */
   Endpoint& operator=(const Endpoint&);
 
+  /**
+   * Move constructor and assignment, so that spans can be handed over without copying.
+   */
+  Endpoint(Endpoint&&) noexcept = default;
+  Endpoint& operator=(Endpoint&&) noexcept = default;
+
   /**
    * Default constructor. Creates an empty Endpoint.
    */
@@ -133,6 +139,12 @@ public:
    */
   Annotation& operator=(const Annotation&);
 
+  /**
+   * Move constructor and assignment.
+   */
+  Annotation(Annotation&&) noexcept = default;
+  Annotation& operator=(Annotation&&) noexcept = default;
+
   /**
    * Default constructor. Creates an empty annotation.
    */
@@ -162,7 +174,7 @@ public:
   /**
    * Sets the annotation's endpoint attribute (move semantics).
    */
-  void setEndpoint(const Endpoint&& endpoint) { endpoint_ = endpoint; }
+  void setEndpoint(Endpoint&& endpoint) { endpoint_ = std::move(endpoint); }
 
   /**
    * Replaces the endpoint's service-name attribute value with the given value.
@@ -232,6 +244,12 @@ public:
    */
   BinaryAnnotation& operator=(const BinaryAnnotation&);
 
+  /**
+   * Move constructor and assignment.
+   */
+  BinaryAnnotation(BinaryAnnotation&&) noexcept = default;
+  BinaryAnnotation& operator=(BinaryAnnotation&&) noexcept = default;
+
   /**
    * Default constructor. Creates an empty binary annotation.
    */
@@ -269,7 +287,7 @@ public:
   /**
    * Sets the annotation's endpoint attribute (move semantics).
    */
-  void setEndpoint(const Endpoint&& endpoint) { endpoint_ = endpoint; }
+  void setEndpoint(Endpoint&& endpoint) { endpoint_ = std::move(endpoint); }
 
   /**
    * @return true if the endpoint attribute is set, or false otherwise.
@@ -321,6 +339,11 @@ public:
    */
   Span(const Span&);
 
+  /**
+   * Move constructor. Spans are moved from the tracer to the reporter's buffer when finished.
+   */
+  Span(Span&&) noexcept = default;
+
   /**
    * Default constructor. Creates an empty span.
    */
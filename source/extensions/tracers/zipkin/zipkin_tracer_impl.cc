@@ -19,7 +19,8 @@ namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
-ZipkinSpan::ZipkinSpan(Zipkin::Span& span, Zipkin::Tracer& tracer) : span_(span), tracer_(tracer) {}
+ZipkinSpan::ZipkinSpan(Zipkin::Span&& span, Zipkin::Tracer& tracer)
+    : span_(std::move(span)), tracer_(tracer) {}
 
 void ZipkinSpan::finishSpan() { span_.finish(); }
 
@@ -63,7 +64,7 @@ Tracing::SpanPtr ZipkinSpan::spawnChild(const Tracing::Config& config, const std
                                         SystemTime start_time) {
   SpanContext previous_context(span_);
   return std::make_unique<ZipkinSpan>(
-      *tracer_.startSpan(config, name, start_time, previous_context), tracer_);
+      std::move(*tracer_.startSpan(config, name, start_time, previous_context)), tracer_);
 }
 
 Driver::TlsTracer::TlsTracer(TracerPtr&& tracer, Driver& driver)
@@ -136,7 +137,7 @@ Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config,
   }
 
   // Return the active Zipkin span.
-  return std::make_unique<ZipkinSpan>(*new_zipkin_span, tracer);
+  return std::make_unique<ZipkinSpan>(std::move(*new_zipkin_span), tracer);
 }
 
 ReporterImpl::ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
@@ -44,9 +44,9 @@ public:
   /**
    * Constructor. Wraps a Zipkin::Span object.
    *
-   * @param span to be wrapped.
+   * @param span to be wrapped, which is moved into this object.
    */
-  ZipkinSpan(Zipkin::Span& span, Zipkin::Tracer& tracer);
+  ZipkinSpan(Zipkin::Span&& span, Zipkin::Tracer& tracer);
 
   /**
    * Calls Zipkin::Span::finishSpan() to perform all actions needed to finalize the span.
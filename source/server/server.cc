@@ -1,5 +1,6 @@
 #include "source/server/server.h"
 
+#include <algorithm>
 #include <csignal>
 #include <cstdint>
 #include <ctime>
@@ -172,9 +173,11 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_sou
 
   snapped_gauges_ = store.gauges();
   gauges_.reserve(snapped_gauges_.size());
+  gauges_changed_.reserve(snapped_gauges_.size());
   for (const auto& gauge : snapped_gauges_) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
     gauges_.push_back(*gauge);
+    gauges_changed_.push_back(gauge->latchChanged());
   }
 
   snapped_histograms_ = store.histograms();
@@ -192,15 +195,136 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_sou
   snapshot_time_ = time_source.systemTime();
 }
 
+namespace {
+
+bool histogramChanged(const Stats::ParentHistogram& histogram) {
+  return histogram.intervalStatistics().sampleCount() > 0;
+}
+
+} // namespace
+
+ChangedMetricSnapshotImpl::ChangedMetricSnapshotImpl(Stats::Store& store,
+                                                     TimeSource& time_source) {
+  store.iterate(Stats::IterateFn<Stats::Counter>([this](const Stats::CounterSharedPtr& counter) {
+    const uint64_t delta = counter->latch();
+    if (delta > 0) {
+      snapped_counters_.push_back(counter);
+      counters_.push_back({delta, *counter});
+    }
+    return true;
+  }));
+
+  store.iterate(Stats::IterateFn<Stats::Gauge>([this](const Stats::GaugeSharedPtr& gauge) {
+    if (gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized && gauge->latchChanged()) {
+      snapped_gauges_.push_back(gauge);
+      gauges_.push_back(*gauge);
+    }
+    return true;
+  }));
+
+  for (auto& histogram : store.histograms()) {
+    if (histogramChanged(*histogram)) {
+      histograms_.push_back(*histogram);
+      snapped_histograms_.push_back(std::move(histogram));
+    }
+  }
+
+  snapped_text_readouts_ = store.textReadouts();
+  text_readouts_.reserve(snapped_text_readouts_.size());
+  for (const auto& text_readout : snapped_text_readouts_) {
+    text_readouts_.push_back(*text_readout);
+  }
+
+  snapshot_time_ = time_source.systemTime();
+}
+
+ChangedMetricSnapshotImpl::ChangedMetricSnapshotImpl(const MetricSnapshotImpl& snapshot)
+    : text_readouts_(snapshot.text_readouts_), snapshot_time_(snapshot.snapshot_time_) {
+  for (const auto& counter : snapshot.counters_) {
+    if (counter.delta_ > 0) {
+      counters_.push_back(counter);
+    }
+  }
+  for (size_t i = 0; i < snapshot.gauges_.size(); ++i) {
+    if (snapshot.gauges_changed_[i]) {
+      gauges_.push_back(snapshot.gauges_[i]);
+    }
+  }
+  for (const auto& histogram : snapshot.histograms_) {
+    if (histogramChanged(histogram)) {
+      histograms_.push_back(histogram);
+    }
+  }
+}
+
 void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
                                        TimeSource& time_source) {
   // Create a snapshot and flush to all sinks.
   // NOTE: Even if there are no sinks, creating the snapshot has the important property that it
   //       latches all counters on a periodic basis. The hot restart code assumes this is being
   //       done so this should not be removed.
+  const bool changed_metrics_only =
+      std::all_of(sinks.begin(), sinks.end(), [](const Stats::SinkPtr& sink) {
+        return sink->flushOptions().changed_metrics_only_;
+      });
+  if (changed_metrics_only) {
+    // No sink needs the full snapshot, so the unchanged metrics need not be copied at all.
+    ChangedMetricSnapshotImpl snapshot(store, time_source);
+    for (const auto& sink : sinks) {
+      flushSnapshotToSink(*sink, snapshot, sink->flushOptions().max_metrics_per_flush_);
+    }
+    return;
+  }
+
   MetricSnapshotImpl snapshot(store, time_source);
+  std::unique_ptr<ChangedMetricSnapshotImpl> changed_snapshot;
   for (const auto& sink : sinks) {
-    sink->flush(snapshot);
+    const Stats::SinkFlushOptions options = sink->flushOptions();
+    if (options.changed_metrics_only_) {
+      if (changed_snapshot == nullptr) {
+        changed_snapshot = std::make_unique<ChangedMetricSnapshotImpl>(snapshot);
+      }
+      flushSnapshotToSink(*sink, *changed_snapshot, options.max_metrics_per_flush_);
+    } else {
+      flushSnapshotToSink(*sink, snapshot, options.max_metrics_per_flush_);
+    }
+  }
+}
+
+void InstanceUtil::flushSnapshotToSink(Stats::Sink& sink, Stats::MetricSnapshot& snapshot,
+                                       uint32_t max_metrics_per_flush) {
+  if (max_metrics_per_flush == 0) {
+    sink.flush(snapshot);
+    return;
+  }
+
+  // Walk the snapshot handing the sink one bounded chunk at a time, so that whatever the sink
+  // serializes per flush() call stays bounded regardless of the number of stats.
+  MetricSnapshotChunk chunk(snapshot.snapshotTime());
+  bool flushed = false;
+  const auto add = [&](const auto& metric) {
+    chunk.add(metric);
+    if (chunk.size() == max_metrics_per_flush) {
+      sink.flush(chunk);
+      chunk.clear();
+      flushed = true;
+    }
+  };
+  for (const auto& counter : snapshot.counters()) {
+    add(counter);
+  }
+  for (const auto& gauge : snapshot.gauges()) {
+    add(gauge.get());
+  }
+  for (const auto& histogram : snapshot.histograms()) {
+    add(histogram.get());
+  }
+  for (const auto& text_readout : snapshot.textReadouts()) {
+    add(text_readout.get());
+  }
+  // Always flush at least once per interval, even if the snapshot is empty.
+  if (chunk.size() > 0 || !flushed) {
+    sink.flush(chunk);
   }
 }
 
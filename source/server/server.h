@@ -130,6 +130,16 @@ public:
   static void flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
                                   TimeSource& time_source);
 
+  /**
+   * Helper for flushing a snapshot to a single sink, in chunks if the sink asks for it.
+   * @param sink supplies the sink to flush to.
+   * @param snapshot supplies the snapshot to flush.
+   * @param max_metrics_per_flush supplies the maximum number of metrics handed to each flush()
+   *        call, or 0 to flush the snapshot in a single call.
+   */
+  static void flushSnapshotToSink(Stats::Sink& sink, Stats::MetricSnapshot& snapshot,
+                                  uint32_t max_metrics_per_flush);
+
   /**
    * Load a bootstrap config and perform validation.
    * @param bootstrap supplies the bootstrap to fill.
@@ -422,10 +432,14 @@ public:
   SystemTime snapshotTime() const override { return snapshot_time_; }
 
 private:
+  friend class ChangedMetricSnapshotImpl;
+
   std::vector<Stats::CounterSharedPtr> snapped_counters_;
   std::vector<CounterSnapshot> counters_;
   std::vector<Stats::GaugeSharedPtr> snapped_gauges_;
   std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  // Parallel to gauges_, whether each gauge changed since the previous flush.
+  std::vector<bool> gauges_changed_;
   std::vector<Stats::ParentHistogramSharedPtr> snapped_histograms_;
   std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
   std::vector<Stats::TextReadoutSharedPtr> snapped_text_readouts_;
@@ -433,5 +447,84 @@ private:
   SystemTime snapshot_time_;
 };
 
+// Implementation of Stats::MetricSnapshot holding only the metrics that changed since the previous
+// flush, for sinks which set Stats::SinkFlushOptions::changed_metrics_only_. When no sink needs a
+// full snapshot, this is built by iterating the store directly, latching as it goes, so that the
+// unchanged metrics are never copied and the store does not have to de-duplicate names across
+// scopes: a metric visited twice has nothing left to latch the second time.
+class ChangedMetricSnapshotImpl : public Stats::MetricSnapshot {
+public:
+  ChangedMetricSnapshotImpl(Stats::Store& store, TimeSource& time_source);
+  // Filters an already latched full snapshot, which must outlive this one.
+  explicit ChangedMetricSnapshotImpl(const MetricSnapshotImpl& snapshot);
+
+  // Stats::MetricSnapshot
+  const std::vector<CounterSnapshot>& counters() override { return counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+    return gauges_;
+  };
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
+    return histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
+    return text_readouts_;
+  }
+  SystemTime snapshotTime() const override { return snapshot_time_; }
+
+private:
+  // Only populated when iterating the store directly.
+  std::vector<Stats::CounterSharedPtr> snapped_counters_;
+  std::vector<Stats::GaugeSharedPtr> snapped_gauges_;
+  std::vector<Stats::ParentHistogramSharedPtr> snapped_histograms_;
+  std::vector<Stats::TextReadoutSharedPtr> snapped_text_readouts_;
+
+  std::vector<CounterSnapshot> counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+  SystemTime snapshot_time_;
+};
+
+// A window over a bounded number of metrics of another snapshot, used to hand large snapshots to
+// sinks which set Stats::SinkFlushOptions::max_metrics_per_flush_ in several flush() calls.
+class MetricSnapshotChunk : public Stats::MetricSnapshot {
+public:
+  explicit MetricSnapshotChunk(SystemTime snapshot_time) : snapshot_time_(snapshot_time) {}
+
+  void add(const CounterSnapshot& counter) { counters_.push_back(counter); }
+  void add(const Stats::Gauge& gauge) { gauges_.push_back(gauge); }
+  void add(const Stats::ParentHistogram& histogram) { histograms_.push_back(histogram); }
+  void add(const Stats::TextReadout& text_readout) { text_readouts_.push_back(text_readout); }
+  size_t size() const {
+    return counters_.size() + gauges_.size() + histograms_.size() + text_readouts_.size();
+  }
+  void clear() {
+    counters_.clear();
+    gauges_.clear();
+    histograms_.clear();
+    text_readouts_.clear();
+  }
+
+  // Stats::MetricSnapshot
+  const std::vector<CounterSnapshot>& counters() override { return counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+    return gauges_;
+  };
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
+    return histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
+    return text_readouts_;
+  }
+  SystemTime snapshotTime() const override { return snapshot_time_; }
+
+private:
+  std::vector<CounterSnapshot> counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+  const SystemTime snapshot_time_;
+};
+
 } // namespace Server
 } // namespace Envoy
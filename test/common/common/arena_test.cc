@@ -0,0 +1,69 @@
+#include <list>
+#include <memory>
+#include <string>
+
+#include "source/common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(ArenaTest, AllocatesFromBlocks) {
+  Arena arena(64);
+  EXPECT_EQ(0, arena.blocks());
+
+  auto* first = static_cast<uint8_t*>(arena.allocate(8, 8));
+  auto* second = static_cast<uint8_t*>(arena.allocate(8, 8));
+  EXPECT_EQ(1, arena.blocks());
+  EXPECT_EQ(first + 8, second);
+
+  // The padding of an allocation aligns it.
+  auto* third = static_cast<uint8_t*>(arena.allocate(1, 1));
+  auto* fourth = static_cast<uint8_t*>(arena.allocate(4, 4));
+  EXPECT_EQ(second + 8, third);
+  EXPECT_EQ(third + 4, fourth);
+  EXPECT_EQ(1, arena.blocks());
+
+  // An allocation that does not fit in the rest of the block starts a new one.
+  arena.allocate(48, 8);
+  EXPECT_EQ(2, arena.blocks());
+
+  // An allocation larger than a block gets a block of its own.
+  arena.allocate(256);
+  EXPECT_EQ(3, arena.blocks());
+}
+
+TEST(ArenaTest, ContainerAllocator) {
+  Arena arena;
+  {
+    std::list<std::string, ArenaAllocator<std::string>> list{ArenaAllocator<std::string>(arena)};
+    for (int i = 0; i < 16; ++i) {
+      list.emplace_back(std::to_string(i));
+    }
+    EXPECT_EQ("0", list.front());
+    EXPECT_EQ("15", list.back());
+  }
+  EXPECT_EQ(1, arena.blocks());
+}
+
+class TestObject : public ArenaObject {
+public:
+  explicit TestObject(bool& destroyed) : destroyed_(destroyed) {}
+  ~TestObject() { destroyed_ = true; }
+
+private:
+  bool& destroyed_;
+};
+
+TEST(ArenaTest, ArenaObject) {
+  Arena arena;
+  bool destroyed = false;
+  auto object = std::unique_ptr<TestObject>(new (arena) TestObject(destroyed));
+  EXPECT_EQ(1, arena.blocks());
+  object.reset();
+  EXPECT_TRUE(destroyed);
+}
+
+} // namespace
+} // namespace Envoy
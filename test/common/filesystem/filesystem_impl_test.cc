@@ -105,6 +105,32 @@ TEST_F(FileSystemImplTest, FileReadToEndNotReadable) {
                EnvoyException);
 }
 
+TEST_F(FileSystemImplTest, RenameFile) {
+  const std::string old_path = TestEnvironment::writeStringToFileForTest("test_envoy_old", "old");
+  const std::string new_path = TestEnvironment::writeStringToFileForTest("test_envoy_new", "new");
+
+  // The file at the new path is replaced.
+  const Api::IoCallBoolResult result = file_system_.renameFile(old_path, new_path);
+  EXPECT_TRUE(result.rc_);
+  EXPECT_FALSE(file_system_.fileExists(old_path));
+  EXPECT_EQ("old", file_system_.fileReadToEnd(new_path));
+
+  const Api::IoCallBoolResult failure = file_system_.renameFile(old_path, new_path);
+  EXPECT_FALSE(failure.rc_);
+  EXPECT_EQ(Api::IoError::IoErrorCode::UnknownError, failure.err_->getErrorCode());
+}
+
+TEST_F(FileSystemImplTest, RemoveFile) {
+  const std::string file_path = TestEnvironment::writeStringToFileForTest("test_envoy", "x");
+  const Api::IoCallBoolResult result = file_system_.removeFile(file_path);
+  EXPECT_TRUE(result.rc_);
+  EXPECT_FALSE(file_system_.fileExists(file_path));
+
+  const Api::IoCallBoolResult failure = file_system_.removeFile(file_path);
+  EXPECT_FALSE(failure.rc_);
+  EXPECT_EQ(Api::IoError::IoErrorCode::UnknownError, failure.err_->getErrorCode());
+}
+
 TEST_F(FileSystemImplTest, FileReadToEndDenylisted) {
   EXPECT_THROW(file_system_.fileReadToEnd("/dev/urandom"), EnvoyException);
   EXPECT_THROW(file_system_.fileReadToEnd("/proc/cpuinfo"), EnvoyException);
@@ -0,0 +1,331 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+
+#include "source/common/common/empty_string.h"
+#include "source/common/http/conn_manager_impl.h"
+#include "source/common/http/conn_manager_utility.h"
+#include "source/common/http/context_impl.h"
+#include "source/common/http/date_provider_impl.h"
+#include "source/common/http/http2/codec_impl.h"
+#include "source/common/http/utility.h"
+#include "source/common/memory/stats.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/request_id/uuid/config.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/router/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/overload_manager.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+// The last filter of the chain, which responds to the request from decodeHeaders().
+class ResponderFilter : public PassThroughFilter {
+public:
+  FilterHeadersStatus decodeHeaders(RequestHeaderMap&, bool) override {
+    decoder_callbacks_->encodeHeaders(
+        ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, true, "details");
+    return FilterHeadersStatus::StopIteration;
+  }
+};
+
+// Creates a chain of pass through filters, followed by a filter that responds to the request.
+class FilterChainFactoryImpl : public FilterChainFactory {
+public:
+  explicit FilterChainFactoryImpl(uint32_t filters) : filters_(filters) {}
+
+  // Http::FilterChainFactory
+  void createFilterChain(FilterChainFactoryCallbacks& callbacks) override {
+    for (uint32_t i = 1; i < filters_; ++i) {
+      callbacks.addStreamFilter(std::make_shared<PassThroughFilter>());
+    }
+    callbacks.addStreamFilter(std::make_shared<ResponderFilter>());
+  }
+  bool createUpgradeFilterChain(absl::string_view, const FilterChainFactory::UpgradeMap*,
+                                FilterChainFactoryCallbacks&) override {
+    return false;
+  }
+
+private:
+  const uint32_t filters_;
+};
+
+class TestConfig : public ConnectionManagerConfig {
+public:
+  explicit TestConfig(uint32_t filters)
+      : filter_factory_(filters),
+        stats_({ALL_HTTP_CONN_MAN_STATS(POOL_COUNTER(fake_stats_), POOL_GAUGE(fake_stats_),
+                                        POOL_HISTOGRAM(fake_stats_))},
+               "", fake_stats_),
+        tracing_stats_{CONN_MAN_TRACING_STATS(POOL_COUNTER(fake_stats_))},
+        listener_stats_{CONN_MAN_LISTENER_STATS(POOL_COUNTER(fake_stats_))},
+        local_reply_(LocalReply::Factory::createDefault()) {
+    request_id_extension_ = Extensions::RequestId::UUIDRequestIDExtension::defaultInstance(random_);
+  }
+
+  // Http::ConnectionManagerConfig
+  const RequestIDExtensionSharedPtr& requestIDExtension() override { return request_id_extension_; }
+  const std::list<AccessLog::InstanceSharedPtr>& accessLogs() override { return access_logs_; }
+  ServerConnectionPtr createCodec(Network::Connection& connection, const Buffer::Instance& data,
+                                  ServerConnectionCallbacks& callbacks) override {
+    if (codec_ != nullptr) {
+      return ServerConnectionPtr{codec_};
+    }
+    return ConnectionManagerUtility::autoCreateCodec(
+        connection, data, callbacks, fake_stats_, random_, http1_codec_stats_, http2_codec_stats_,
+        http1_settings_, http2_options_, DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+  }
+  DateProvider& dateProvider() override { return date_provider_; }
+  std::chrono::milliseconds drainTimeout() const override { return std::chrono::milliseconds(100); }
+  FilterChainFactory& filterFactory() override { return filter_factory_; }
+  bool generateRequestId() const override { return false; }
+  bool preserveExternalRequestId() const override { return false; }
+  bool alwaysSetRequestIdInResponse() const override { return false; }
+  uint32_t maxRequestHeadersKb() const override { return DEFAULT_MAX_REQUEST_HEADERS_KB; }
+  uint32_t maxRequestHeadersCount() const override { return DEFAULT_MAX_HEADERS_COUNT; }
+  absl::optional<std::chrono::milliseconds> idleTimeout() const override { return {}; }
+  bool isRoutable() const override { return true; }
+  absl::optional<std::chrono::milliseconds> maxConnectionDuration() const override { return {}; }
+  absl::optional<std::chrono::milliseconds> maxStreamDuration() const override { return {}; }
+  std::chrono::milliseconds streamIdleTimeout() const override { return {}; }
+  std::chrono::milliseconds requestTimeout() const override { return {}; }
+  std::chrono::milliseconds requestHeadersTimeout() const override { return {}; }
+  std::chrono::milliseconds delayedCloseTimeout() const override { return {}; }
+  Router::RouteConfigProvider* routeConfigProvider() override { return &route_config_provider_; }
+  Config::ConfigProvider* scopedRouteConfigProvider() override { return nullptr; }
+  const std::string& serverName() const override { return server_name_; }
+  HttpConnectionManagerProto::ServerHeaderTransformation
+  serverHeaderTransformation() const override {
+    return HttpConnectionManagerProto::OVERWRITE;
+  }
+  const absl::optional<std::string>& schemeToSet() const override { return scheme_; }
+  ConnectionManagerStats& stats() override { return stats_; }
+  ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  bool useRemoteAddress() const override { return true; }
+  const InternalAddressConfig& internalAddressConfig() const override {
+    return internal_address_config_;
+  }
+  uint32_t xffNumTrustedHops() const override { return 0; }
+  bool skipXffAppend() const override { return false; }
+  const std::string& via() const override { return EMPTY_STRING; }
+  ForwardClientCertType forwardClientCert() const override {
+    return ForwardClientCertType::Sanitize;
+  }
+  const std::vector<ClientCertDetailsType>& setCurrentClientCertDetails() const override {
+    return set_current_client_cert_details_;
+  }
+  const Network::Address::Instance& localAddress() override { return local_address_; }
+  const absl::optional<std::string>& userAgent() override { return user_agent_; }
+  Tracing::HttpTracerSharedPtr tracer() override { return http_tracer_; }
+  const TracingConnectionManagerConfig* tracingConfig() override { return nullptr; }
+  ConnectionManagerListenerStats& listenerStats() override { return listener_stats_; }
+  bool proxy100Continue() const override { return false; }
+  bool streamErrorOnInvalidHttpMessaging() const override { return false; }
+  const Http1Settings& http1Settings() const override { return http1_settings_; }
+  bool shouldNormalizePath() const override { return false; }
+  bool shouldMergeSlashes() const override { return false; }
+  bool shouldStripTrailingHostDot() const override { return false; }
+  StripPortType stripPortType() const override { return StripPortType::None; }
+  envoy::config::core::v3::HttpProtocolOptions::HeadersWithUnderscoresAction
+  headersWithUnderscoresAction() const override {
+    return envoy::config::core::v3::HttpProtocolOptions::ALLOW;
+  }
+  const LocalReply::LocalReply& localReply() const override { return *local_reply_; }
+  HttpConnectionManagerProto::PathWithEscapedSlashesAction
+  pathWithEscapedSlashesAction() const override {
+    return HttpConnectionManagerProto::KEEP_UNCHANGED;
+  }
+  const std::vector<OriginalIPDetectionSharedPtr>& originalIpDetectionExtensions() const override {
+    return ip_detection_extensions_;
+  }
+
+  NiceMock<Random::MockRandomGenerator> random_;
+  RequestIDExtensionSharedPtr request_id_extension_;
+  std::list<AccessLog::InstanceSharedPtr> access_logs_;
+  // The codec of the connection, or nullptr to create a real HTTP/1 or HTTP/2 codec.
+  NiceMock<MockServerConnection>* codec_{};
+  FilterChainFactoryImpl filter_factory_;
+  Event::SimulatedTimeSystem time_system_;
+  SlowDateProviderImpl date_provider_{time_system_};
+  NiceMock<Router::MockRouteConfigProvider> route_config_provider_;
+  std::string server_name_;
+  absl::optional<std::string> scheme_;
+  Stats::IsolatedStoreImpl fake_stats_;
+  ConnectionManagerStats stats_;
+  ConnectionManagerTracingStats tracing_stats_;
+  ConnectionManagerListenerStats listener_stats_;
+  std::vector<ClientCertDetailsType> set_current_client_cert_details_;
+  Network::Address::Ipv4Instance local_address_{"127.0.0.1"};
+  absl::optional<std::string> user_agent_;
+  Tracing::HttpTracerSharedPtr http_tracer_{std::make_shared<NiceMock<Tracing::MockHttpTracer>>()};
+  Http1Settings http1_settings_;
+  Http1::CodecStats::AtomicPtr http1_codec_stats_;
+  Http2::CodecStats::AtomicPtr http2_codec_stats_;
+  const envoy::config::core::v3::Http2ProtocolOptions http2_options_{
+      ::Envoy::Http2::Utility::initializeAndValidateOptions(
+          envoy::config::core::v3::Http2ProtocolOptions())};
+  DefaultInternalAddressConfig internal_address_config_;
+  LocalReply::LocalReplyPtr local_reply_;
+  std::vector<OriginalIPDetectionSharedPtr> ip_detection_extensions_;
+};
+
+// A connection manager on a mock connection, whose writes are appended to output_.
+class TestConnectionManager {
+public:
+  explicit TestConnectionManager(uint32_t filters) : config_(filters) {
+    filter_callbacks_.connection_.stream_info_.downstream_address_provider_->setLocalAddress(
+        std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1"));
+    filter_callbacks_.connection_.stream_info_.downstream_address_provider_->setRemoteAddress(
+        std::make_shared<Network::Address::Ipv4Instance>("10.0.0.1"));
+    ON_CALL(filter_callbacks_.connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { output_.move(data); }));
+    conn_manager_.initializeReadFilterCallbacks(filter_callbacks_);
+  }
+
+  // Destroys the streams which the connection manager deleted once they were complete.
+  void clearDeferredDeleteList() { filter_callbacks_.connection_.dispatcher_.to_delete_.clear(); }
+
+  TestConfig config_;
+  NiceMock<Network::MockDrainDecision> drain_close_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  Stats::SymbolTableImpl symbol_table_;
+  ContextImpl http_context_{symbol_table_};
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  NiceMock<Network::MockReadFilterCallbacks> filter_callbacks_;
+  NiceMock<Server::MockOverloadManager> overload_manager_;
+  ConnectionManagerImpl conn_manager_{config_,          drain_close_,      random_,
+                                      http_context_,    runtime_,          local_info_,
+                                      cluster_manager_, overload_manager_, config_.time_system_};
+  Buffer::OwnedImpl output_;
+};
+
+// Sets up and tears down a stream through the connection manager, with a chain of range(0)
+// filters the last of which responds to the request headers. This measures the per stream cost
+// of creating the filter chain, iterating it once in each direction and destroying it.
+void bmStreamSetupAndTeardown(benchmark::State& state) {
+  TestConnectionManager connection_manager(state.range(0));
+  NiceMock<MockResponseEncoder> response_encoder;
+  const TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {":scheme", "http"}};
+  connection_manager.config_.codec_ = new NiceMock<MockServerConnection>();
+  ON_CALL(*connection_manager.config_.codec_, dispatch(_))
+      .WillByDefault(Invoke([&](Buffer::Instance&) {
+        RequestDecoder& decoder = connection_manager.conn_manager_.newStream(response_encoder);
+        decoder.decodeHeaders(std::make_unique<TestRequestHeaderMapImpl>(request_headers), true);
+        return okStatus();
+      }));
+
+  Buffer::OwnedImpl data;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    connection_manager.conn_manager_.onData(data, false);
+    connection_manager.clearDeferredDeleteList();
+  }
+}
+BENCHMARK(bmStreamSetupAndTeardown)->Arg(1)->Arg(5)->Arg(15)->Arg(30);
+
+// Reports the request rate, and the memory held by a request once it is complete, before its
+// stream is destroyed.
+void reportRequestCounters(benchmark::State& state, uint64_t request_bytes) {
+  state.counters["requests_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["bytes_per_request"] =
+      benchmark::Counter(request_bytes, benchmark::Counter::kAvgIterations);
+}
+
+// Enables allocating the filter state of the streams in their arena when range(1) is not 0.
+void setStreamArena(benchmark::State& state) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.allocate_filter_state_in_stream_arena",
+        state.range(1) != 0 ? "true" : "false"}});
+}
+
+// Sends HTTP/1 requests through the codec, the connection manager and a chain of range(0) filters
+// the last of which responds, on a single connection.
+void bmHttp1Requests(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setStreamArena(state);
+  TestConnectionManager connection_manager(state.range(0));
+  const std::string request = "GET / HTTP/1.1\r\nhost: host\r\n\r\n";
+
+  uint64_t request_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Buffer::OwnedImpl data(request);
+    const uint64_t start_bytes = Memory::Stats::totalCurrentlyAllocated();
+    connection_manager.conn_manager_.onData(data, false);
+    request_bytes += Memory::Stats::totalCurrentlyAllocated() - start_bytes;
+    connection_manager.output_.drain(connection_manager.output_.length());
+    connection_manager.clearDeferredDeleteList();
+  }
+  reportRequestCounters(state, request_bytes);
+}
+BENCHMARK(bmHttp1Requests)->Args({1, 1})->Args({15, 0})->Args({15, 1});
+
+// Sends HTTP/2 requests from a client codec through the server codec, the connection manager and
+// a chain of range(0) filters the last of which responds, on a single connection, and passes the
+// responses back to the client codec.
+void bmHttp2Requests(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setStreamArena(state);
+  TestConnectionManager connection_manager(state.range(0));
+  NiceMock<Network::MockConnection> client_connection;
+  Buffer::OwnedImpl client_output;
+  ON_CALL(client_connection, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) { client_output.move(data); }));
+  NiceMock<MockConnectionCallbacks> client_callbacks;
+  Http2::CodecStats::AtomicPtr client_codec_stats;
+  Http2::ClientConnectionImpl client(
+      client_connection, client_callbacks,
+      Http2::CodecStats::atomicGet(client_codec_stats, connection_manager.config_.fake_stats_),
+      connection_manager.random_, connection_manager.config_.http2_options_,
+      DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+      Http2::ProdNghttp2SessionFactory::get());
+  NiceMock<MockResponseDecoder> response_decoder;
+  const TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {":scheme", "http"}};
+
+  uint64_t request_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    RequestEncoder& request_encoder = client.newStream(response_decoder);
+    RELEASE_ASSERT(request_encoder.encodeHeaders(request_headers, true).ok(), "");
+    const uint64_t start_bytes = Memory::Stats::totalCurrentlyAllocated();
+    connection_manager.conn_manager_.onData(client_output, false);
+    request_bytes += Memory::Stats::totalCurrentlyAllocated() - start_bytes;
+    RELEASE_ASSERT(client.dispatch(connection_manager.output_).ok(), "");
+    connection_manager.clearDeferredDeleteList();
+    client_connection.dispatcher_.to_delete_.clear();
+  }
+  reportRequestCounters(state, request_bytes);
+}
+BENCHMARK(bmHttp2Requests)->Args({1, 1})->Args({15, 0})->Args({15, 1});
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
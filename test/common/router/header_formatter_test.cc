@@ -1528,6 +1528,59 @@ response_headers_to_remove: ["x-baz-header"]
   EXPECT_THAT(transforms.headers_to_remove, ElementsAre(Http::LowerCaseString("x-baz-header")));
 }
 
+TEST(HeaderMutationPlanTest, EvaluatesParsersInOrder) {
+  const std::string route_yaml = R"EOF(
+match: { prefix: "/new_endpoint" }
+route:
+  cluster: www2
+request_headers_to_add:
+  - header:
+      key: "x-static"
+      value: "route"
+  - header:
+      key: "x-client-ip"
+      value: "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%"
+    append: false
+  - header:
+      key: "x-empty"
+      value: ""
+request_headers_to_remove: ["x-removed"]
+)EOF";
+  const std::string vhost_yaml = R"EOF(
+match: { prefix: "/new_endpoint" }
+route:
+  cluster: www2
+request_headers_to_add:
+  - header:
+      key: "x-static"
+      value: "vhost"
+    append: false
+  - header:
+      key: "x-removed"
+      value: "vhost"
+request_headers_to_remove: ["x-client-ip"]
+)EOF";
+  const auto route = parseRouteFromV3Yaml(route_yaml);
+  const auto vhost = parseRouteFromV3Yaml(vhost_yaml);
+  HeaderParserPtr route_parser =
+      HeaderParser::configure(route.request_headers_to_add(), route.request_headers_to_remove());
+  HeaderParserPtr vhost_parser =
+      HeaderParser::configure(vhost.request_headers_to_add(), vhost.request_headers_to_remove());
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  for (const auto& parsers : std::vector<std::vector<const HeaderParser*>>{
+           {route_parser.get(), vhost_parser.get()}, {vhost_parser.get(), route_parser.get()}}) {
+    Http::TestRequestHeaderMapImpl expected{
+        {"x-static", "original"}, {"x-removed", "original"}, {"x-client-ip", "0.0.0.0"}};
+    Http::TestRequestHeaderMapImpl actual(expected);
+    for (const HeaderParser* parser : parsers) {
+      parser->evaluateHeaders(expected, stream_info);
+    }
+    HeaderMutationPlan(parsers).evaluateHeaders(actual, stream_info);
+    EXPECT_EQ(expected, actual);
+  }
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
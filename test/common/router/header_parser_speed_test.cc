@@ -0,0 +1,82 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "source/common/router/header_parser.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+// The request headers to add of the route, virtual host and route configuration levels, with
+// range(0) constant headers per level and, when range(1) is set, one formatted header per level.
+std::vector<HeaderParserPtr> headerParsers(const benchmark::State& state) {
+  const std::vector<std::string> levels{"route", "vhost", "global"};
+  std::vector<HeaderParserPtr> parsers;
+  for (const std::string& level : levels) {
+    Protobuf::RepeatedPtrField<envoy::config::core::v3::HeaderValueOption> headers_to_add;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      auto* header = headers_to_add.Add()->mutable_header();
+      header->set_key(absl::StrCat("x-", level, "-static-", i));
+      header->set_value(absl::StrCat(level, "-value-", i));
+    }
+    if (state.range(1) != 0) {
+      auto* header = headers_to_add.Add()->mutable_header();
+      header->set_key(absl::StrCat("x-", level, "-client-ip"));
+      header->set_value("%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%");
+    }
+    Protobuf::RepeatedPtrField<std::string> headers_to_remove;
+    headers_to_remove.Add(absl::StrCat("x-", level, "-removed"));
+    parsers.push_back(HeaderParser::configure(headers_to_add, headers_to_remove));
+  }
+  return parsers;
+}
+
+// Evaluates the header parsers of each level one after another, as routes used to.
+void bmEvaluateHeaderParsers(benchmark::State& state) {
+  const std::vector<HeaderParserPtr> parsers = headerParsers(state);
+  testing::NiceMock<StreamInfo::MockStreamInfo> stream_info;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Http::TestRequestHeaderMapImpl headers{
+        {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {"x-route-removed", "a"}};
+    for (const HeaderParserPtr& parser : parsers) {
+      parser->evaluateHeaders(headers, stream_info);
+    }
+    benchmark::DoNotOptimize(headers.size());
+  }
+}
+BENCHMARK(bmEvaluateHeaderParsers)->Args({1, 0})->Args({4, 0})->Args({4, 1})->Args({16, 1});
+
+// Applies the header mutation plan merged from the header parsers of all the levels.
+void bmEvaluateHeaderMutationPlan(benchmark::State& state) {
+  const std::vector<HeaderParserPtr> parsers = headerParsers(state);
+  std::vector<const HeaderParser*> parser_ptrs;
+  for (const HeaderParserPtr& parser : parsers) {
+    parser_ptrs.push_back(parser.get());
+  }
+  const HeaderMutationPlan plan(parser_ptrs);
+  testing::NiceMock<StreamInfo::MockStreamInfo> stream_info;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Http::TestRequestHeaderMapImpl headers{
+        {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {"x-route-removed", "a"}};
+    plan.evaluateHeaders(headers, stream_info);
+    benchmark::DoNotOptimize(headers.size());
+  }
+}
+BENCHMARK(bmEvaluateHeaderMutationPlan)->Args({1, 0})->Args({4, 0})->Args({4, 1})->Args({16, 1});
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
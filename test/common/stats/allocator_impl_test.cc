@@ -72,6 +72,31 @@ TEST_F(AllocatorImplTest, GaugesWithSameName) {
   EXPECT_EQ(0, g2->value());
 }
 
+TEST_F(AllocatorImplTest, GaugeLatchChanged) {
+  GaugeSharedPtr gauge =
+      alloc_.makeGauge(makeStat("gauge.name"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->set(0);
+  EXPECT_TRUE(gauge->used());
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->set(3);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->add(0);
+  gauge->sub(0);
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->inc();
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->dec();
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->setParentValue(2);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->setParentValue(2);
+  EXPECT_FALSE(gauge->latchChanged());
+  EXPECT_EQ(5, gauge->value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, gauge->importMode());
+}
+
 // Test for a race-condition where we may decrement the ref-count of a stat to
 // zero at the same time as we are allocating another instance of that
 // stat. This test reproduces that race organically by having a 12 threads each
@@ -0,0 +1,134 @@
+#include <string>
+
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/stats/deferred_stat.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+#define TEST_DEFERRED_STATS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT, STATNAME)                     \
+  COUNTER(requests)                                                                                \
+  GAUGE(active, Accumulate)                                                                        \
+  HISTOGRAM(latency, Milliseconds)
+
+MAKE_STAT_NAMES_STRUCT(TestDeferredStatNames, TEST_DEFERRED_STATS);
+MAKE_DEFERRABLE_STATS_STRUCT(TestDeferredStats, TestDeferredStatNames, TEST_DEFERRED_STATS);
+
+class DeferredStatTest : public testing::Test {
+protected:
+  DeferredStatTest()
+      : store_(std::make_unique<IsolatedStoreImpl>(symbol_table_)),
+        scope_(store_->createScope("scope.")), stat_names_(symbol_table_) {}
+  ~DeferredStatTest() override {
+    scope_.reset();
+    store_.reset();
+  }
+
+  bool hasCounter(const std::string& name) { return findByName<Counter>(name); }
+  bool hasGauge(const std::string& name) { return findByName<Gauge>(name); }
+  bool hasHistogram(const std::string& name) { return findByName<Histogram>(name); }
+
+  template <class StatType> bool findByName(const std::string& name) {
+    bool found = false;
+    store_->iterate(IterateFn<StatType>([&found, &name](const RefcountPtr<StatType>& stat) {
+      found |= stat->name() == name;
+      return true;
+    }));
+    return found;
+  }
+
+  SymbolTableImpl symbol_table_;
+  std::unique_ptr<IsolatedStoreImpl> store_;
+  ScopePtr scope_;
+  TestDeferredStatNames stat_names_;
+};
+
+TEST_F(DeferredStatTest, Eager) {
+  TestDeferredStats stats(stat_names_, *scope_);
+  EXPECT_TRUE(stats.requests_.instantiated());
+  EXPECT_TRUE(stats.active_.instantiated());
+  EXPECT_TRUE(stats.latency_.instantiated());
+  EXPECT_TRUE(hasCounter("scope.requests"));
+  EXPECT_TRUE(hasGauge("scope.active"));
+  EXPECT_TRUE(hasHistogram("scope.latency"));
+}
+
+TEST_F(DeferredStatTest, Deferred) {
+  TestDeferredStats stats(stat_names_, *scope_, true);
+  EXPECT_FALSE(stats.requests_.instantiated());
+  EXPECT_FALSE(stats.active_.instantiated());
+  EXPECT_FALSE(stats.latency_.instantiated());
+  EXPECT_FALSE(hasCounter("scope.requests"));
+  EXPECT_FALSE(hasGauge("scope.active"));
+  EXPECT_FALSE(hasHistogram("scope.latency"));
+
+  // Adding zero is not a touch.
+  stats.requests_.add(0);
+  EXPECT_FALSE(stats.requests_.instantiated());
+
+  stats.requests_.inc();
+  EXPECT_TRUE(hasCounter("scope.requests"));
+  EXPECT_EQ(1, stats.requests_.value());
+
+  stats.active_.set(5);
+  stats.active_.dec();
+  EXPECT_TRUE(hasGauge("scope.active"));
+  EXPECT_EQ(4, stats.active_.value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, stats.active_.get().importMode());
+
+  EXPECT_EQ(Histogram::Unit::Milliseconds, stats.latency_.unit());
+  EXPECT_FALSE(stats.latency_.instantiated());
+  stats.latency_.recordValue(10);
+  EXPECT_TRUE(hasHistogram("scope.latency"));
+  EXPECT_EQ(Histogram::Unit::Milliseconds, stats.latency_.get().unit());
+}
+
+// Reading a handle, as sinks do for every cluster on each flush, does not instantiate the stat.
+TEST_F(DeferredStatTest, ReadDoesNotInstantiate) {
+  TestDeferredStats stats(stat_names_, *scope_, true);
+  EXPECT_EQ(0, stats.requests_.value());
+  EXPECT_FALSE(stats.requests_.used());
+  EXPECT_EQ(0, stats.active_.value());
+  EXPECT_FALSE(stats.requests_.instantiated());
+  EXPECT_FALSE(stats.active_.instantiated());
+  EXPECT_FALSE(hasCounter("scope.requests"));
+  EXPECT_FALSE(hasGauge("scope.active"));
+}
+
+// A new generation of the same stats struct, in a new scope of the same prefix, reads the stats
+// touched by the previous one without instantiating them, and resolves to them once touched.
+TEST_F(DeferredStatTest, ValueContinuity) {
+  TestDeferredStats first(stat_names_, *scope_, true);
+  first.requests_.add(3);
+  first.active_.set(2);
+
+  ScopePtr next_scope = store_->createScope("scope.");
+  TestDeferredStats second(stat_names_, *next_scope, true);
+  EXPECT_EQ(3, second.requests_.value());
+  EXPECT_TRUE(second.requests_.used());
+  EXPECT_EQ(2, second.active_.value());
+  EXPECT_FALSE(second.requests_.instantiated());
+  EXPECT_FALSE(second.active_.instantiated());
+
+  EXPECT_EQ(&first.requests_.get(), &second.requests_.get());
+  EXPECT_EQ(&first.active_.get(), &second.active_.get());
+}
+
+TEST_F(DeferredStatTest, ConvertsToReference) {
+  TestDeferredStats stats(stat_names_, *scope_, true);
+  Counter& counter = stats.requests_;
+  counter.add(2);
+  EXPECT_EQ(2, stats.requests_.value());
+
+  // Copies share the instantiated stat.
+  TestDeferredStats copy(stats);
+  EXPECT_TRUE(copy.requests_.instantiated());
+  EXPECT_EQ(&counter, &copy.requests_.get());
+}
+
+} // namespace Stats
+} // namespace Envoy
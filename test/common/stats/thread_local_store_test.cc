@@ -619,6 +619,47 @@ TEST_F(StatsThreadLocalStoreTest, OverlappingScopes) {
   tls_.shutdownThread();
 }
 
+// A scope finds, by full name, the stats created by another scope of the same prefix, without
+// creating them in its own cache.
+TEST_F(StatsThreadLocalStoreTest, OverlappingScopesFind) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr scope1 = store_->createScope("scope1.");
+  ScopePtr scope2 = store_->createScope("scope1.");
+  EXPECT_EQ("scope1", symbol_table_.toString(scope2->prefix()));
+
+  StatNameManagedStorage c_name("scope1.c", symbol_table_);
+  StatNameManagedStorage g_name("scope1.g", symbol_table_);
+  EXPECT_FALSE(scope2->findCounter(c_name.statName()).has_value());
+  EXPECT_FALSE(scope2->findGauge(g_name.statName()).has_value());
+
+  Counter& c1 = scope1->counterFromString("c");
+  c1.add(3);
+  Gauge& g1 = scope1->gaugeFromString("g", Gauge::ImportMode::Accumulate);
+  g1.set(5);
+
+  CounterOptConstRef c2 = scope2->findCounter(c_name.statName());
+  ASSERT_TRUE(c2.has_value());
+  EXPECT_EQ(&c1, &c2->get());
+  EXPECT_EQ(3UL, c2->get().value());
+  GaugeOptConstRef g2 = scope2->findGauge(g_name.statName());
+  ASSERT_TRUE(g2.has_value());
+  EXPECT_EQ(5UL, g2->get().value());
+
+  // Finding did not add the stats to the cache of scope2.
+  uint32_t num_counters = 0;
+  scope2->iterate(IterateFn<Counter>([&num_counters](const CounterSharedPtr&) -> bool {
+    ++num_counters;
+    return true;
+  }));
+  EXPECT_EQ(0, num_counters);
+
+  tls_.shutdownGlobalThreading();
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 TEST_F(StatsThreadLocalStoreTest, TextReadoutAllLengths) {
   store_->initializeThreading(main_thread_dispatcher_, tls_);
 
@@ -5,6 +5,7 @@
 #include "envoy/stream_info/filter_state.h"
 #include "envoy/upstream/host_description.h"
 
+#include "source/common/common/arena.h"
 #include "source/common/common/fmt.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
@@ -224,6 +225,25 @@ TEST_F(StreamInfoImplTest, DynamicMetadataTest) {
   EXPECT_TRUE(json.find("\"another_key\":\"another_value\"") != std::string::npos);
 }
 
+TEST_F(StreamInfoImplTest, FilterStateInArena) {
+  Arena arena;
+  auto parent_filter_state = std::make_shared<FilterStateImpl>(FilterState::LifeSpan::Connection);
+  {
+    StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), nullptr,
+                               parent_filter_state, FilterState::LifeSpan::Connection, &arena);
+    EXPECT_EQ(1, arena.blocks());
+    stream_info.filterState()->setData("test", std::make_unique<TestIntAccessor>(1),
+                                       FilterState::StateType::ReadOnly,
+                                       FilterState::LifeSpan::FilterChain);
+    stream_info.filterState()->setData("connection", std::make_unique<TestIntAccessor>(2),
+                                       FilterState::StateType::ReadOnly,
+                                       FilterState::LifeSpan::Connection);
+    EXPECT_EQ(1, stream_info.filterState()->getDataReadOnly<TestIntAccessor>("test").access());
+  }
+  // The objects of the longer life spans are kept by the ancestors of the filter state.
+  EXPECT_EQ(2, parent_filter_state->getDataReadOnly<TestIntAccessor>("connection").access());
+}
+
 TEST_F(StreamInfoImplTest, DumpStateTest) {
   StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), nullptr);
   std::string prefix = "";
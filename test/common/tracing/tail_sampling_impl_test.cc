@@ -0,0 +1,280 @@
+#include <chrono>
+
+#include "source/common/tracing/common_values.h"
+#include "source/common/tracing/tail_sampling_impl.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Tracing {
+namespace {
+
+class TailSamplingHttpTracerTest : public testing::Test {
+protected:
+  TailSamplingHttpTracerTest() {
+    config_.min_duration_ = std::chrono::milliseconds(100);
+    config_.min_status_code_ = 500;
+    config_.keep_errors_ = true;
+    stream_info_.start_time_monotonic_ = time_system_.monotonicTime();
+  }
+
+  void initialize() {
+    sampler_ = std::make_shared<TailSampler>(config_, "tracing.tail_sampling.", store_,
+                                             time_system_);
+    tracer_ = std::make_unique<TailSamplingHttpTracer>(parent_, sampler_);
+  }
+
+  // Starts a traced request, whose driver span is root_span_.
+  SpanPtr startSpan() {
+    root_span_ = new NiceMock<MockSpan>();
+    EXPECT_CALL(*parent_, startSpan_(_, _, _, _)).WillOnce(Return(root_span_));
+    return tracer_->startSpan(config_mock_, request_headers_, stream_info_,
+                              {Reason::Sampling, true});
+  }
+
+  // Spawns a child of the given span, whose driver span is returned in child_span.
+  SpanPtr spawnChild(Span& span, MockSpan*& child_span) {
+    child_span = new NiceMock<MockSpan>();
+    EXPECT_CALL(*root_span_, spawnChild_(_, _, _)).WillOnce(Return(child_span));
+    return span.spawnChild(config_mock_, "child", time_system_.systemTime());
+  }
+
+  static void expectReported(MockSpan& span) {
+    EXPECT_CALL(span, setSampled(_)).Times(0);
+    EXPECT_CALL(span, finishSpan());
+  }
+
+  static void expectDiscarded(MockSpan& span) {
+    InSequence s;
+    EXPECT_CALL(span, setSampled(false));
+    EXPECT_CALL(span, finishSpan());
+  }
+
+  void finishWithStatus(Span& span, absl::string_view status_code) {
+    span.setTag(Tags::get().HttpStatusCode, status_code);
+    span.finishSpan();
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "tracing.tail_sampling." + name)->value();
+  }
+  uint64_t spansBuffered() {
+    return TestUtility::findGauge(store_, "tracing.tail_sampling.spans_buffered")->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::TestUtil::TestStore store_;
+  TailSamplingConfig config_;
+  std::shared_ptr<MockHttpTracer> parent_{std::make_shared<MockHttpTracer>()};
+  TailSamplerSharedPtr sampler_;
+  std::unique_ptr<TailSamplingHttpTracer> tracer_;
+  NiceMock<MockConfig> config_mock_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  MockSpan* root_span_{};
+};
+
+TEST_F(TailSamplingHttpTracerTest, UntracedRequestIsNotWrapped) {
+  initialize();
+  auto* span = new NiceMock<MockSpan>();
+  EXPECT_CALL(*parent_, startSpan_(_, _, _, _)).WillOnce(Return(span));
+  SpanPtr result = tracer_->startSpan(config_mock_, request_headers_, stream_info_,
+                                      {Reason::NotTraceable, false});
+  EXPECT_EQ(span, result.get());
+}
+
+TEST_F(TailSamplingHttpTracerTest, DiscardsFastSuccessfulTrace) {
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span;
+  SpanPtr child = spawnChild(*root, child_span);
+
+  // The child span is buffered until the request completes.
+  EXPECT_CALL(*child_span, finishSpan()).Times(0);
+  finishWithStatus(*child, "200");
+  EXPECT_EQ(1, spansBuffered());
+  testing::Mock::VerifyAndClearExpectations(child_span);
+
+  expectDiscarded(*child_span);
+  expectDiscarded(*root_span_);
+  time_system_.advanceTimeWait(std::chrono::milliseconds(99));
+  finishWithStatus(*root, "200");
+
+  EXPECT_EQ(0, spansBuffered());
+  EXPECT_EQ(1, counter("traces_discarded"));
+  EXPECT_EQ(0, counter("traces_kept"));
+}
+
+TEST_F(TailSamplingHttpTracerTest, KeepsSlowTrace) {
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span;
+  SpanPtr child = spawnChild(*root, child_span);
+
+  expectReported(*child_span);
+  expectReported(*root_span_);
+  finishWithStatus(*child, "200");
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  finishWithStatus(*root, "200");
+
+  EXPECT_EQ(0, spansBuffered());
+  EXPECT_EQ(1, counter("traces_kept"));
+}
+
+TEST_F(TailSamplingHttpTracerTest, KeepsTraceWithFailedChild) {
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span;
+  SpanPtr child = spawnChild(*root, child_span);
+
+  expectReported(*child_span);
+  expectReported(*root_span_);
+  finishWithStatus(*child, "503");
+  finishWithStatus(*root, "200");
+
+  EXPECT_EQ(1, counter("traces_kept"));
+}
+
+TEST_F(TailSamplingHttpTracerTest, KeepsTraceWithError) {
+  initialize();
+  SpanPtr root = startSpan();
+
+  expectReported(*root_span_);
+  root->setTag(Tags::get().Error, Tags::get().True);
+  finishWithStatus(*root, "0");
+
+  EXPECT_EQ(1, counter("traces_kept"));
+}
+
+TEST_F(TailSamplingHttpTracerTest, IgnoresErrorsIfNotConfigured) {
+  config_.keep_errors_ = false;
+  initialize();
+  SpanPtr root = startSpan();
+
+  expectDiscarded(*root_span_);
+  root->setTag(Tags::get().Error, Tags::get().True);
+  finishWithStatus(*root, "0");
+
+  EXPECT_EQ(1, counter("traces_discarded"));
+}
+
+TEST_F(TailSamplingHttpTracerTest, DiscardsSpansOverTheBufferLimit) {
+  config_.max_buffered_spans_ = 1;
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span1;
+  SpanPtr child1 = spawnChild(*root, child_span1);
+  MockSpan* child_span2;
+  SpanPtr child2 = spawnChild(*root, child_span2);
+
+  // The second span is discarded straight away, even though the trace is kept.
+  expectDiscarded(*child_span2);
+  finishWithStatus(*child1, "200");
+  finishWithStatus(*child2, "200");
+  EXPECT_EQ(1, counter("spans_overflowed"));
+  EXPECT_EQ(1, spansBuffered());
+
+  expectReported(*child_span1);
+  expectReported(*root_span_);
+  finishWithStatus(*root, "500");
+  EXPECT_EQ(0, spansBuffered());
+}
+
+TEST_F(TailSamplingHttpTracerTest, SpanFinishedAfterTheDecision) {
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span;
+  SpanPtr child = spawnChild(*root, child_span);
+
+  expectReported(*root_span_);
+  finishWithStatus(*root, "500");
+
+  // The decision applies to spans finished after it, even once the request's own span is gone.
+  root.reset();
+  expectReported(*child_span);
+  finishWithStatus(*child, "200");
+  EXPECT_EQ(0, spansBuffered());
+}
+
+// Once finished, the spans no longer forward to the driver's spans, which belong to the trace.
+TEST_F(TailSamplingHttpTracerTest, SpanUsedAfterFinish) {
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span;
+  SpanPtr child = spawnChild(*root, child_span);
+
+  // The child's driver span is buffered, but must not be touched anymore.
+  finishWithStatus(*child, "200");
+  EXPECT_CALL(*child_span, setOperation(_)).Times(0);
+  EXPECT_CALL(*child_span, setTag(_, _)).Times(0);
+  EXPECT_CALL(*child_span, log(_, _)).Times(0);
+  EXPECT_CALL(*child_span, injectContext(_)).Times(0);
+  EXPECT_CALL(*child_span, spawnChild_(_, _, _)).Times(0);
+  EXPECT_CALL(*child_span, setBaggage(_, _)).Times(0);
+  EXPECT_CALL(*child_span, getBaggage(_)).Times(0);
+  EXPECT_CALL(*child_span, getTraceIdAsHex()).Times(0);
+  child->setOperation("operation");
+  child->setTag(Tags::get().Error, Tags::get().True);
+  child->log(time_system_.systemTime(), "event");
+  child->injectContext(request_headers_);
+  SpanPtr grandchild = child->spawnChild(config_mock_, "grandchild", time_system_.systemTime());
+  grandchild->finishSpan();
+  child->setBaggage("key", "value");
+  EXPECT_EQ("", child->getBaggage("key"));
+  EXPECT_EQ("", child->getTraceIdAsHex());
+  child->finishSpan();
+  EXPECT_EQ(1, spansBuffered());
+
+  // The error tag set after finishing is ignored, and the root's driver span is destroyed once the
+  // trace is discarded.
+  expectDiscarded(*child_span);
+  expectDiscarded(*root_span_);
+  finishWithStatus(*root, "200");
+  root->setOperation("operation");
+  root->setTag(Tags::get().Error, Tags::get().True);
+  root->log(time_system_.systemTime(), "event");
+  root->injectContext(request_headers_);
+  EXPECT_NE(nullptr, root->spawnChild(config_mock_, "child", time_system_.systemTime()));
+  root->setSampled(true);
+  root->setBaggage("key", "value");
+  EXPECT_EQ("", root->getBaggage("key"));
+  EXPECT_EQ("", root->getTraceIdAsHex());
+  root->finishSpan();
+  EXPECT_EQ(0, spansBuffered());
+  EXPECT_EQ(1, counter("traces_discarded"));
+}
+
+TEST_F(TailSamplingHttpTracerTest, UnfinishedTraceIsDiscarded) {
+  initialize();
+  SpanPtr root = startSpan();
+  MockSpan* child_span;
+  SpanPtr child = spawnChild(*root, child_span);
+
+  finishWithStatus(*child, "500");
+  EXPECT_EQ(1, spansBuffered());
+
+  expectDiscarded(*child_span);
+  EXPECT_CALL(*root_span_, finishSpan()).Times(0);
+  child.reset();
+  root.reset();
+
+  EXPECT_EQ(0, spansBuffered());
+  EXPECT_EQ(1, counter("traces_discarded"));
+}
+
+} // namespace
+} // namespace Tracing
+} // namespace Envoy
@@ -0,0 +1,115 @@
+// Measures the time taken and the memory consumed to apply a large number of clusters through the
+// cluster manager, with and without deferred creation of the cluster stats.
+//
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management. Memory is only reported
+// on platforms with tcmalloc.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/router/context_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/stats/stat_test_utility.h"
+#include "test/common/upstream/test_cluster_manager.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class ClusterStatsSpeedTest {
+public:
+  explicit ClusterStatsSpeedTest(bool defer_stat_creation)
+      : http_context_(factory_.stats_.symbolTable()),
+        grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()) {
+    envoy::config::bootstrap::v3::Bootstrap bootstrap;
+    bootstrap.mutable_stats_config()->set_enable_deferred_creation_stats(defer_stat_creation);
+    cluster_manager_ = std::make_unique<TestClusterManagerImpl>(
+        bootstrap, factory_, factory_.stats_, factory_.tls_, factory_.runtime_,
+        factory_.local_info_, log_manager_, factory_.dispatcher_, admin_, validation_context_,
+        *factory_.api_, http_context_, grpc_context_, router_context_);
+  }
+
+  // Applies num_clusters static clusters with a single endpoint each, and returns the memory
+  // consumed in doing so.
+  uint64_t addClusters(uint32_t num_clusters) {
+    Stats::TestUtil::MemoryTest memory_test;
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      envoy::config::cluster::v3::Cluster cluster;
+      cluster.set_name(absl::StrCat("cluster_", i));
+      cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+      cluster.mutable_connect_timeout()->set_seconds(1);
+      auto* socket_address = cluster.mutable_load_assignment()
+                                 ->add_endpoints()
+                                 ->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address("127.0.0.1");
+      socket_address->set_port_value(10000 + i % 50000);
+      cluster_manager_->addOrUpdateCluster(cluster, "");
+    }
+    return memory_test.consumedBytes();
+  }
+
+  uint64_t numStats() {
+    return factory_.stats_.counters().size() + factory_.stats_.gauges().size() +
+           factory_.stats_.histograms().size();
+  }
+
+  NiceMock<TestClusterManagerFactory> factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+};
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
+
+// Args: defer_stat_creation, num_clusters.
+static void addClusters(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const bool defer_stat_creation = state.range(0);
+  // If we've been instructed to skip tests, only add a few clusters no matter the argument.
+  const uint32_t num_clusters = skipExpensiveBenchmarks() ? 10 : state.range(1);
+
+  uint64_t bytes = 0;
+  uint64_t num_stats = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto speed_test =
+        std::make_unique<Envoy::Upstream::ClusterStatsSpeedTest>(defer_stat_creation);
+    state.ResumeTiming();
+
+    bytes = speed_test->addClusters(num_clusters);
+
+    state.PauseTiming();
+    num_stats = speed_test->numStats();
+    speed_test.reset();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_cluster"] = bytes / num_clusters;
+  state.counters["stats_per_cluster"] = num_stats / num_clusters;
+}
+
+BENCHMARK(addClusters)
+    ->Args({false, 1000})
+    ->Args({true, 1000})
+    ->Args({false, 10000})
+    ->Args({true, 10000})
+    ->Unit(benchmark::kMillisecond);
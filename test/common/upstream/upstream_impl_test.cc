@@ -1407,6 +1407,42 @@ TEST_F(StaticClusterImplTest, InitialHosts) {
   EXPECT_FALSE(cluster.info()->addedViaApi());
 }
 
+TEST_F(StaticClusterImplTest, DeferredStatCreation) {
+  const std::string yaml = R"EOF(
+    name: staticcluster
+    connect_timeout: 0.25s
+    type: STATIC
+    lb_policy: ROUND_ROBIN
+    load_assignment:
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 443
+  )EOF";
+
+  cm_.defer_stat_creation_ = true;
+  envoy::config::cluster::v3::Cluster cluster_config = parseClusterFromV3Yaml(yaml);
+  Envoy::Stats::ScopePtr scope = stats_.createScope("cluster.staticcluster.");
+  Envoy::Server::Configuration::TransportSocketFactoryContextImpl factory_context(
+      admin_, ssl_context_manager_, *scope, cm_, local_info_, dispatcher_, stats_,
+      singleton_manager_, tls_, validation_visitor_, *api_, options_);
+  StaticClusterImpl cluster(cluster_config, runtime_, factory_context, std::move(scope), false);
+  cluster.initialize([] {});
+
+  // Membership gauges are touched when the hosts are loaded, traffic stats are not.
+  EXPECT_TRUE(stats_.findGaugeByString("cluster.staticcluster.membership_total").has_value());
+  EXPECT_FALSE(stats_.findCounterByString("cluster.staticcluster.upstream_rq_total").has_value());
+  EXPECT_FALSE(
+      stats_.findHistogramByString("cluster.staticcluster.upstream_cx_connect_ms").has_value());
+
+  cluster.info()->stats().upstream_rq_total_.inc();
+  EXPECT_EQ(1U, stats_.counter("cluster.staticcluster.upstream_rq_total").value());
+  EXPECT_EQ(1U, cluster.info()->stats().upstream_rq_total_.value());
+}
+
 TEST_F(StaticClusterImplTest, LoadAssignmentEmptyHostname) {
   const std::string yaml = R"EOF(
     name: staticcluster
@@ -1,13 +1,17 @@
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/thread.h"
 #include "source/common/common/thread_synchronizer.h"
 #include "source/extensions/common/wasm/wasm.h"
 
+#include "test/mocks/init/mocks.h"
+#include "test/mocks/local_info/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "benchmark/benchmark.h"
@@ -63,6 +67,162 @@ void bmWasmSpeedTest(benchmark::State& state) {
 
 BENCHMARK(bmWasmSpeedTest);
 
+// Creates Wasm plugins with the Null VM plugin from //test/extensions/common/wasm/test_data, the
+// way the filter configs of listeners do.
+class CreateWasmBenchmark {
+public:
+  CreateWasmBenchmark()
+      : logging_state_(spdlog::level::warn, Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_,
+                       false),
+        api_(Envoy::Api::createApiForTest(stats_store_)),
+        dispatcher_(api_->allocateDispatcher("wasm_test")),
+        scope_(stats_store_.createScope("wasm.")) {
+    Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm).set_level(spdlog::level::off);
+  }
+
+  ~CreateWasmBenchmark() { proxy_wasm::clearWasmCachesForTesting(); }
+
+  Envoy::Extensions::Common::Wasm::PluginSharedPtr createPlugin(absl::string_view name,
+                                                                absl::string_view vm_id) {
+    envoy::extensions::wasm::v3::PluginConfig plugin_config;
+    plugin_config.set_name(std::string(name));
+    auto* vm_config = plugin_config.mutable_vm_config();
+    vm_config->set_vm_id(std::string(vm_id));
+    vm_config->set_runtime("envoy.wasm.runtime.null");
+    vm_config->mutable_code()->mutable_local()->set_inline_string("CommonWasmTestCpp");
+    return std::make_shared<Envoy::Extensions::Common::Wasm::Plugin>(
+        plugin_config, envoy::config::core::v3::TrafficDirection::UNSPECIFIED, local_info_,
+        nullptr);
+  }
+
+  Envoy::Extensions::Common::Wasm::WasmHandleSharedPtr
+  createWasm(const Envoy::Extensions::Common::Wasm::PluginSharedPtr& plugin) {
+    Envoy::Extensions::Common::Wasm::WasmHandleSharedPtr wasm_handle;
+    Envoy::Extensions::Common::Wasm::createWasm(
+        plugin, scope_, cluster_manager_, init_manager_, *dispatcher_, *api_,
+        lifecycle_notifier_, remote_data_provider_,
+        [&wasm_handle](const Envoy::Extensions::Common::Wasm::WasmHandleSharedPtr& w) {
+          wasm_handle = w;
+        });
+    RELEASE_ASSERT(wasm_handle != nullptr, "");
+    return wasm_handle;
+  }
+
+  Envoy::Event::Dispatcher& dispatcher() { return *dispatcher_; }
+
+private:
+  Envoy::Thread::MutexBasicLockable lock_;
+  Envoy::Logger::Context logging_state_;
+  Envoy::Stats::IsolatedStoreImpl stats_store_;
+  Envoy::Api::ApiPtr api_;
+  testing::NiceMock<Envoy::Upstream::MockClusterManager> cluster_manager_;
+  testing::NiceMock<Envoy::Init::MockManager> init_manager_;
+  testing::NiceMock<Envoy::Server::MockServerLifecycleNotifier> lifecycle_notifier_;
+  testing::NiceMock<Envoy::LocalInfo::MockLocalInfo> local_info_;
+  Envoy::Event::DispatcherPtr dispatcher_;
+  Envoy::Stats::ScopeSharedPtr scope_;
+  Envoy::Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider_;
+};
+
+// Cold start of the plugins of range(0) listeners, each in its own VM or, when range(1) is set,
+// all in a VM shared through their vm_id.
+void bmCreateWasmColdStart(benchmark::State& state) {
+  CreateWasmBenchmark wasm_benchmark;
+  const int64_t plugins = state.range(0);
+  const bool shared_vm = state.range(1) != 0;
+  uint64_t vms = 0;
+
+  for (__attribute__((unused)) auto _ : state) {
+    std::vector<Envoy::Extensions::Common::Wasm::WasmHandleSharedPtr> wasm_handles;
+    for (int64_t i = 0; i < plugins; ++i) {
+      auto plugin = wasm_benchmark.createPlugin(absl::StrCat("plugin", i),
+                                                shared_vm ? "shared" : absl::StrCat("vm", i));
+      wasm_handles.push_back(wasm_benchmark.createWasm(plugin));
+    }
+    state.PauseTiming();
+    absl::flat_hash_set<Envoy::Extensions::Common::Wasm::Wasm*> distinct_vms;
+    for (const auto& wasm_handle : wasm_handles) {
+      distinct_vms.insert(wasm_handle->wasm().get());
+    }
+    vms += distinct_vms.size();
+    wasm_handles.clear();
+    proxy_wasm::clearWasmCachesForTesting();
+    state.ResumeTiming();
+  }
+
+  state.counters["vms"] = benchmark::Counter(vms, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(bmCreateWasmColdStart)
+    ->Args({1, 0})
+    ->Args({16, 0})
+    ->Args({16, 1})
+    ->Args({128, 0})
+    ->Args({128, 1});
+
+// Overhead of the stream context created by the Wasm filters for every request, with the plugin
+// already cloned into the worker VM.
+void bmWasmStreamContext(benchmark::State& state) {
+  CreateWasmBenchmark wasm_benchmark;
+  auto plugin = wasm_benchmark.createPlugin("plugin", "");
+  auto wasm_handle = wasm_benchmark.createWasm(plugin);
+  auto plugin_handle = Envoy::Extensions::Common::Wasm::getOrCreateThreadLocalPlugin(
+      wasm_handle, plugin, wasm_benchmark.dispatcher());
+  auto* wasm = plugin_handle->wasmHandle()->wasm().get();
+
+  for (__attribute__((unused)) auto _ : state) {
+    auto context = std::make_shared<Envoy::Extensions::Common::Wasm::Context>(
+        wasm, plugin_handle->rootContextId(), plugin_handle);
+    context->onCreate();
+    context->onDestroy();
+  }
+}
+
+BENCHMARK(bmWasmStreamContext);
+
+// Copy of a body of range(0) bytes in 16KiB slices into VM memory, as done by get_buffer_bytes.
+// When range(1) is set, the body is linearized first, as HTTP call response bodies used to be.
+void bmWasmBufferCopyTo(benchmark::State& state) {
+  CreateWasmBenchmark wasm_benchmark;
+  auto plugin = wasm_benchmark.createPlugin("plugin", "");
+  auto wasm_handle = wasm_benchmark.createWasm(plugin);
+  auto* wasm = wasm_handle->wasm().get();
+  const uint64_t body_size = state.range(0);
+  const bool linearize = state.range(1) != 0;
+  const std::string slice(16384, 'a');
+
+  for (__attribute__((unused)) auto _ : state) {
+    state.PauseTiming();
+    Envoy::Buffer::OwnedImpl body;
+    while (body.length() < body_size) {
+      body.appendSliceForTest(slice.data(),
+                              std::min<uint64_t>(slice.size(), body_size - body.length()));
+    }
+    state.ResumeTiming();
+
+    Envoy::Extensions::Common::Wasm::Buffer buffer;
+    if (linearize) {
+      buffer.set(std::string_view(static_cast<const char*>(body.linearize(body.length())),
+                                  body.length()));
+    } else {
+      buffer.set(static_cast<const Envoy::Buffer::Instance*>(&body));
+    }
+    // The Null VM allocates from the host heap and writes the result to host addresses.
+    uint64_t pointer = 0;
+    uint64_t size = 0;
+    RELEASE_ASSERT(buffer.copyTo(wasm, 0, body_size, reinterpret_cast<uint64_t>(&pointer),
+                                 reinterpret_cast<uint64_t>(&size)) == proxy_wasm::WasmResult::Ok,
+                   "");
+    ::free(reinterpret_cast<void*>(pointer));
+  }
+}
+
+BENCHMARK(bmWasmBufferCopyTo)
+    ->Args({64 * 1024, 0})
+    ->Args({64 * 1024, 1})
+    ->Args({1024 * 1024, 0})
+    ->Args({1024 * 1024, 1});
+
 } // namespace Envoy
 
 int main(int argc, char** argv) {
@@ -0,0 +1,56 @@
+#include "test/extensions/compression/zstd/common/zstd_test_utility.h"
+
+#include <vector>
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+#include "zdict.h"
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+
+std::string jsonDocument(uint64_t seed) {
+  return absl::StrCat(R"({"id":)", seed, R"(,"name":"user-)", (seed * 7919) % 10007,
+                      R"(","email":"user-)", seed, R"(@example.com","active":)",
+                      seed % 2 == 0 ? "true" : "false",
+                      R"(,"roles":["reader","writer"],"created_at":"2021-05-)", seed % 28 + 10,
+                      "T10:", seed % 50 + 10, R"(:00Z","preferences":{"language":"en-US",)",
+                      R"("timezone":"Europe/Paris","newsletter":)",
+                      seed % 3 == 0 ? "true" : "false", "}}");
+}
+
+std::string buildDictionary(uint32_t dictionary_id) {
+  std::string content;
+  for (uint64_t seed = 0; seed < 16; ++seed) {
+    content.append(jsonDocument(seed));
+  }
+
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (uint64_t seed = 1000; seed < 2000; ++seed) {
+    const std::string sample = jsonDocument(seed);
+    samples.append(sample);
+    sample_sizes.push_back(sample.size());
+  }
+
+  ZDICT_params_t params{};
+  params.compressionLevel = 3;
+  params.dictID = dictionary_id;
+
+  std::string dictionary(content.size() + 16384, '\0');
+  const size_t size = ZDICT_finalizeDictionary(dictionary.data(), dictionary.size(),
+                                               content.data(), content.size(), samples.data(),
+                                               sample_sizes.data(), sample_sizes.size(), params);
+  RELEASE_ASSERT(!ZDICT_isError(size), ZDICT_getErrorName(size));
+  dictionary.resize(size);
+  return dictionary;
+}
+
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
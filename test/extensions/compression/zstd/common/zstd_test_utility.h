@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+
+// Returns a small JSON document, like the bodies of typical JSON APIs. The documents generated
+// for different seeds share most of their structure.
+std::string jsonDocument(uint64_t seed);
+
+// Returns a zstd dictionary with the given ID, built from samples of jsonDocument().
+std::string buildDictionary(uint32_t dictionary_id);
+
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
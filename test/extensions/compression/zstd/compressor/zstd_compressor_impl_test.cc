@@ -0,0 +1,192 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/compression/zstd/compressor/config.h"
+#include "source/extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "test/extensions/compression/zstd/common/zstd_test_utility.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+namespace {
+
+class ZstdCompressorImplTest : public testing::Test {
+protected:
+  void drainBuffer(Buffer::OwnedImpl& buffer) { buffer.drain(buffer.length()); }
+
+  void verifyWithDecompressor(Envoy::Compression::Compressor::CompressorPtr compressor,
+                              Decompressor::ZstdDDictsSharedPtr ddicts = nullptr) {
+    Buffer::OwnedImpl buffer;
+    Buffer::OwnedImpl accumulation_buffer;
+    std::string original_text{};
+    for (uint64_t i = 0; i < 10; i++) {
+      TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size * i, i);
+      original_text.append(buffer.toString());
+      ASSERT_EQ(default_input_size * i, buffer.length());
+      compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
+      accumulation_buffer.add(buffer);
+      drainBuffer(buffer);
+      ASSERT_EQ(0, buffer.length());
+    }
+
+    compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    accumulation_buffer.add(buffer);
+    drainBuffer(buffer);
+
+    Stats::IsolatedStoreImpl stats_store{};
+    Decompressor::ZstdDecompressorImpl decompressor{stats_store, "test.", std::move(ddicts), 27,
+                                                    4096};
+
+    decompressor.decompress(accumulation_buffer, buffer);
+    std::string decompressed_text{buffer.toString()};
+
+    ASSERT_EQ(original_text.length(), decompressed_text.length());
+    EXPECT_EQ(original_text, decompressed_text);
+  }
+
+  static Decompressor::ZstdDDictsSharedPtr ddictsFor(const std::string& dictionary) {
+    auto ddicts = std::make_shared<std::vector<Decompressor::ZstdDDictPtr>>();
+    ddicts->push_back(Decompressor::ZstdDecompressorImpl::createDictionary(dictionary));
+    return ddicts;
+  }
+
+  static uint64_t compressedLength(ZstdCompressorImpl& compressor, const std::string& text) {
+    Buffer::OwnedImpl buffer(text);
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer.length();
+  }
+
+  static constexpr uint32_t default_compression_level{3};
+  static constexpr uint32_t default_window_log{20};
+  static constexpr uint32_t default_input_size{796};
+};
+
+TEST_F(ZstdCompressorImplTest, CompressorDeathTest) {
+  EXPECT_DEATH(
+      { ZstdCompressorImpl compressor(100, false, 0, default_window_log, nullptr, 4096); },
+      "assert failure: compression_level <= ");
+  EXPECT_DEATH(
+      { ZstdCompressorImpl compressor(default_compression_level, false, 100, 0, nullptr, 4096); },
+      "assert failure: strategy <= ZSTD_STRATEGY_MAX");
+  EXPECT_DEATH(
+      { ZstdCompressorImpl compressor(default_compression_level, false, 0, 1, nullptr, 4096); },
+      "assert failure: window_log == 0");
+}
+
+TEST_F(ZstdCompressorImplTest, CallingFinishOnly) {
+  Buffer::OwnedImpl buffer;
+  ZstdCompressorImpl compressor(default_compression_level, false, 0, default_window_log, nullptr,
+                                4096);
+
+  TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+}
+
+TEST_F(ZstdCompressorImplTest, CallingFlushOnly) {
+  Buffer::OwnedImpl buffer;
+  ZstdCompressorImpl compressor(default_compression_level, false, 0, default_window_log, nullptr,
+                                4096);
+
+  TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+}
+
+TEST_F(ZstdCompressorImplTest, CompressWithSmallChunkSize) {
+  auto compressor = std::make_unique<ZstdCompressorImpl>(default_compression_level, true, 0,
+                                                         default_window_log, nullptr, 8);
+  verifyWithDecompressor(std::move(compressor));
+}
+
+// A dictionary built for the payloads improves the compression ratio of small payloads.
+TEST_F(ZstdCompressorImplTest, CompressWithDictionary) {
+  const std::string dictionary = buildDictionary(1);
+  const std::string document = jsonDocument(12345);
+
+  ZstdCompressorImpl plain_compressor(default_compression_level, false, 0, 0, nullptr, 4096);
+  ZstdCompressorImpl dictionary_compressor(
+      default_compression_level, false, 0, 0,
+      ZstdCompressorImpl::createDictionary(dictionary, default_compression_level, 0, 0), 4096);
+  EXPECT_LT(compressedLength(dictionary_compressor, document),
+            compressedLength(plain_compressor, document));
+
+  verifyWithDecompressor(
+      std::make_unique<ZstdCompressorImpl>(
+          default_compression_level, false, 0, default_window_log,
+          ZstdCompressorImpl::createDictionary(dictionary, default_compression_level, 0,
+                                               default_window_log),
+          4096),
+      ddictsFor(dictionary));
+}
+
+TEST_F(ZstdCompressorImplTest, InvalidDictionary) {
+  EXPECT_THROW_WITH_MESSAGE(
+      ZstdCompressorImpl::createDictionary("not a dictionary", default_compression_level, 0, 0),
+      EnvoyException, "zstd compressor: the dictionary is not a valid zstd dictionary");
+}
+
+class ConfigTest : public ZstdCompressorImplTest,
+                   public testing::WithParamInterface<std::string> {};
+
+INSTANTIATE_TEST_SUITE_P(ConfigTestSuite, ConfigTest,
+                         testing::Values("DEFAULT", "FAST", "LAZY2", "BTULTRA2"));
+
+TEST_P(ConfigTest, LoadConfig) {
+  absl::string_view strategy = GetParam();
+
+  std::string json{fmt::format(R"EOF({{
+  "compression_level": 7,
+  "enable_checksum": true,
+  "strategy": "{}",
+  "window_log": 22,
+  "chunk_size": 4096
+}})EOF",
+                               strategy)};
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  TestUtility::loadFromJson(json, zstd);
+
+  ZstdCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(zstd, context);
+  EXPECT_EQ("zstd.", factory->statsPrefix());
+  EXPECT_EQ("zstd", factory->contentEncoding());
+
+  verifyWithDecompressor(factory->createCompressor());
+}
+
+TEST_F(ZstdCompressorImplTest, LoadConfigWithDictionary) {
+  const std::string dictionary = buildDictionary(1);
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  zstd.mutable_dictionary()->set_inline_bytes(dictionary);
+
+  ZstdCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(zstd, context);
+
+  verifyWithDecompressor(factory->createCompressor(), ddictsFor(dictionary));
+}
+
+TEST_F(ZstdCompressorImplTest, LoadConfigWithInvalidDictionary) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  zstd.mutable_dictionary()->set_inline_string("not a dictionary");
+
+  ZstdCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_THROW_WITH_MESSAGE(lib_factory.createCompressorFactoryFromProto(zstd, context),
+                            EnvoyException,
+                            "zstd compressor: the dictionary is not a valid zstd dictionary");
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
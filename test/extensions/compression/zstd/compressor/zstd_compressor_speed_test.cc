@@ -0,0 +1,92 @@
+#include <functional>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/macros.h"
+#include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+
+#include "test/extensions/compression/zstd/common/zstd_test_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+using CompressorFactory = std::function<Envoy::Compression::Compressor::CompressorPtr()>;
+
+// Compares zstd to gzip with the default parameters of the gzip compressor library.
+static Envoy::Compression::Compressor::CompressorPtr createGzipCompressor() {
+  auto compressor = std::make_unique<Gzip::Compressor::ZlibCompressorImpl>(4096);
+  compressor->init(Gzip::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                   Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 28, 5);
+  return compressor;
+}
+
+static CompressorFactory zstdCompressorFactory(uint32_t compression_level, bool with_dictionary) {
+  ZstdCDictSharedPtr cdict;
+  if (with_dictionary) {
+    cdict = ZstdCompressorImpl::createDictionary(buildDictionary(1), compression_level, 0, 0);
+  }
+  return [compression_level, cdict]() {
+    return std::make_unique<ZstdCompressorImpl>(compression_level, false, 0, 0, cdict, 4096);
+  };
+}
+
+static const std::vector<std::pair<std::string, CompressorFactory>>& compressorFactories() {
+  CONSTRUCT_ON_FIRST_USE(std::vector<std::pair<std::string, CompressorFactory>>,
+                         {{"gzip", createGzipCompressor},
+                          {"zstd level 1", zstdCompressorFactory(1, false)},
+                          {"zstd level 3", zstdCompressorFactory(3, false)},
+                          {"zstd level 9", zstdCompressorFactory(9, false)},
+                          {"zstd level 3 with dictionary", zstdCompressorFactory(3, true)}});
+}
+
+// Compresses bodies with a fresh compressor each, as the compressor filter does for each response.
+// The "ratio" counter is the compressed size over the uncompressed size of the bodies.
+static void compress(benchmark::State& state, const std::vector<std::string>& bodies) {
+  const auto& factory = compressorFactories()[state.range(0)];
+  state.SetLabel(factory.first);
+
+  uint64_t uncompressed_bytes = 0;
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    for (const std::string& body : bodies) {
+      Envoy::Compression::Compressor::CompressorPtr compressor = factory.second();
+      Buffer::OwnedImpl buffer(body);
+      compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+      uncompressed_bytes += body.size();
+      compressed_bytes += buffer.length();
+    }
+  }
+  state.counters["ratio"] = static_cast<double>(compressed_bytes) / uncompressed_bytes;
+}
+
+// Small JSON API responses, where a dictionary helps most.
+static void compressSmallJsonBodies(benchmark::State& state) {
+  std::vector<std::string> bodies;
+  for (uint64_t seed = 5000; seed < 5100; ++seed) {
+    bodies.push_back(jsonDocument(seed));
+  }
+  compress(state, bodies);
+}
+BENCHMARK(compressSmallJsonBodies)->DenseRange(0, 4, 1)->Unit(benchmark::kMicrosecond);
+
+// A large JSON API response of 128KiB or so.
+static void compressLargeJsonBody(benchmark::State& state) {
+  std::string body = "[";
+  for (uint64_t seed = 5000; body.size() < 131072; ++seed) {
+    body.append(jsonDocument(seed)).append(",");
+  }
+  body.back() = ']';
+  compress(state, {body});
+}
+BENCHMARK(compressLargeJsonBody)->DenseRange(0, 4, 1)->Unit(benchmark::kMicrosecond);
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
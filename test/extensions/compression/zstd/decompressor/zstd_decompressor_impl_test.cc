@@ -0,0 +1,193 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+#include "source/extensions/compression/zstd/decompressor/config.h"
+
+#include "test/extensions/compression/zstd/common/zstd_test_utility.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+namespace {
+
+class ZstdDecompressorImplTest : public testing::Test {
+protected:
+  void drainBuffer(Buffer::OwnedImpl& buffer) { buffer.drain(buffer.length()); }
+
+  // Compresses text with a single frame, flushing it halfway so that the frame header does not
+  // record the content size.
+  static std::string compress(const std::string& text, const bool enable_checksum = false,
+                              const uint32_t window_log = default_window_log,
+                              Zstd::Compressor::ZstdCDictSharedPtr cdict = nullptr) {
+    Zstd::Compressor::ZstdCompressorImpl compressor{
+        default_compression_level, enable_checksum, 0, window_log, std::move(cdict), 4096};
+    Buffer::OwnedImpl output;
+    Buffer::OwnedImpl buffer(text.substr(0, text.size() / 2));
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    output.move(buffer);
+    buffer.add(text.substr(text.size() / 2));
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    output.move(buffer);
+    return output.toString();
+  }
+
+  static Zstd::Compressor::ZstdCDictSharedPtr cdictFor(const std::string& dictionary) {
+    return Zstd::Compressor::ZstdCompressorImpl::createDictionary(
+        dictionary, default_compression_level, 0, default_window_log);
+  }
+
+  uint64_t counterValue(const std::string& name) {
+    return stats_store_.counterFromString(name).value();
+  }
+
+  Stats::IsolatedStoreImpl stats_store_{};
+
+  static constexpr uint32_t default_compression_level{3};
+  static constexpr uint32_t default_window_log{20};
+  static constexpr uint32_t default_window_log_max{27};
+  static constexpr uint32_t default_input_size{796};
+};
+
+// Exercises compression and decompression by compressing some data, decompressing it and then
+// comparing compressor's input with decompressor's output.
+TEST_F(ZstdDecompressorImplTest, CompressAndDecompress) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  Zstd::Compressor::ZstdCompressorImpl compressor{
+      default_compression_level, true, 0, default_window_log, nullptr, 4096};
+
+  std::string original_text{};
+  for (uint64_t i = 0; i < 20; ++i) {
+    TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size * i, i);
+    original_text.append(buffer.toString());
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    accumulation_buffer.add(buffer);
+    drainBuffer(buffer);
+  }
+
+  ASSERT_EQ(0, buffer.length());
+
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+  accumulation_buffer.add(buffer);
+  drainBuffer(buffer);
+  ASSERT_EQ(0, buffer.length());
+
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", nullptr, default_window_log_max, 16};
+  decompressor.decompress(accumulation_buffer, buffer);
+  std::string decompressed_text{buffer.toString()};
+
+  ASSERT_EQ(original_text.length(), decompressed_text.length());
+  EXPECT_EQ(original_text, decompressed_text);
+  EXPECT_EQ(0, counterValue("test.zstd_generic_error"));
+}
+
+// Decompresses the frames compressed with any of the configured dictionaries, each frame
+// referencing its dictionary by ID.
+TEST_F(ZstdDecompressorImplTest, DecompressWithMultipleDictionaries) {
+  const std::string first_dictionary = buildDictionary(1);
+  const std::string second_dictionary = buildDictionary(2);
+  auto ddicts = std::make_shared<std::vector<ZstdDDictPtr>>();
+  ddicts->push_back(ZstdDecompressorImpl::createDictionary(first_dictionary));
+  ddicts->push_back(ZstdDecompressorImpl::createDictionary(second_dictionary));
+
+  const std::string first_document = jsonDocument(1);
+  const std::string second_document = jsonDocument(2);
+  Buffer::OwnedImpl input;
+  input.add(compress(first_document, false, default_window_log, cdictFor(first_dictionary)));
+  input.add(compress(second_document, false, default_window_log, cdictFor(second_dictionary)));
+
+  Buffer::OwnedImpl output;
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", ddicts, default_window_log_max, 4096};
+  decompressor.decompress(input, output);
+
+  EXPECT_EQ(first_document + second_document, output.toString());
+  EXPECT_EQ(0, counterValue("test.zstd_dictionary_error"));
+}
+
+TEST_F(ZstdDecompressorImplTest, MissingDictionary) {
+  Buffer::OwnedImpl input(
+      compress(jsonDocument(1), false, default_window_log, cdictFor(buildDictionary(1))));
+  Buffer::OwnedImpl output;
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", nullptr, default_window_log_max, 4096};
+  decompressor.decompress(input, output);
+
+  EXPECT_EQ(0, output.length());
+  EXPECT_EQ(1, counterValue("test.zstd_dictionary_error"));
+}
+
+TEST_F(ZstdDecompressorImplTest, WindowTooLarge) {
+  std::string text;
+  for (uint64_t i = 0; i < 100; ++i) {
+    text.append(jsonDocument(i));
+  }
+  Buffer::OwnedImpl input(compress(text, false, 24));
+  Buffer::OwnedImpl output;
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", nullptr, 20, 4096};
+  decompressor.decompress(input, output);
+
+  EXPECT_EQ(0, output.length());
+  EXPECT_EQ(1, counterValue("test.zstd_window_too_large_error"));
+}
+
+TEST_F(ZstdDecompressorImplTest, ChecksumWrong) {
+  std::string compressed = compress(jsonDocument(1), true);
+  // The checksum is written in the last four bytes of the frame.
+  compressed.back() ^= 0xff;
+  Buffer::OwnedImpl input(compressed);
+  Buffer::OwnedImpl output;
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", nullptr, default_window_log_max, 4096};
+  decompressor.decompress(input, output);
+
+  EXPECT_EQ(1, counterValue("test.zstd_checksum_wrong_error"));
+}
+
+TEST_F(ZstdDecompressorImplTest, CorruptedInput) {
+  Buffer::OwnedImpl input;
+  TestUtility::feedBufferWithRandomCharacters(input, 1024);
+  Buffer::OwnedImpl output;
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", nullptr, default_window_log_max, 4096};
+  decompressor.decompress(input, output);
+
+  EXPECT_EQ(0, output.length());
+  EXPECT_EQ(1, counterValue("test.zstd_generic_error"));
+}
+
+TEST_F(ZstdDecompressorImplTest, InvalidDictionary) {
+  EXPECT_THROW_WITH_MESSAGE(ZstdDecompressorImpl::createDictionary("not a dictionary"),
+                            EnvoyException,
+                            "zstd decompressor: the dictionary is not a valid zstd dictionary");
+}
+
+TEST_F(ZstdDecompressorImplTest, LoadConfig) {
+  const std::string dictionary = buildDictionary(1);
+  envoy::extensions::compression::zstd::decompressor::v3::Zstd zstd;
+  zstd.add_dictionaries()->set_inline_bytes(dictionary);
+  zstd.mutable_window_log_max()->set_value(default_window_log);
+
+  ZstdDecompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Decompressor::DecompressorFactoryPtr factory =
+      lib_factory.createDecompressorFactoryFromProto(zstd, context);
+  EXPECT_EQ("zstd.", factory->statsPrefix());
+  EXPECT_EQ("zstd", factory->contentEncoding());
+
+  const std::string document = jsonDocument(1);
+  Buffer::OwnedImpl input(compress(document, false, default_window_log, cdictFor(dictionary)));
+  Buffer::OwnedImpl output;
+  factory->createDecompressor("test.")->decompress(input, output);
+  EXPECT_EQ(document, output.toString());
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
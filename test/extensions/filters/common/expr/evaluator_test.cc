@@ -1,5 +1,6 @@
 #include "source/extensions/filters/common/expr/evaluator.h"
 
+#include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/time/time.h"
@@ -40,6 +41,41 @@ TEST(Evaluator, Print) {
   EXPECT_EQ(print(CelValue::CreateError(&status)), "CelError value");
 }
 
+// The activation of the thread is rebound to the attributes of every evaluation.
+TEST(Evaluator, Evaluate) {
+  google::api::expr::v1alpha1::Expr parsed;
+  TestUtility::loadFromYaml(R"EOF(
+  call_expr:
+    function: _==_
+    args:
+    - select_expr:
+        operand:
+          ident_expr:
+            name: request
+        field: path
+    - const_expr:
+        string_value: /foo
+  )EOF",
+                            parsed);
+  Protobuf::Arena constant_arena;
+  auto builder = createBuilder(&constant_arena);
+  auto expr = createExpression(*builder, parsed);
+
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  EXPECT_TRUE(matches(*expr, info, Http::TestRequestHeaderMapImpl{{":path", "/foo"}}));
+  EXPECT_FALSE(matches(*expr, info, Http::TestRequestHeaderMapImpl{{":path", "/bar"}}));
+  EXPECT_FALSE(matches(*expr, info, Http::TestRequestHeaderMapImpl{}));
+
+  Protobuf::Arena arena;
+  Http::TestRequestHeaderMapImpl headers{{":path", "/foo"}};
+  auto result = evaluate(*expr, arena, info, &headers, nullptr, nullptr);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ("true", print(result.value()));
+  result = evaluate(*expr, arena, info, nullptr, nullptr, nullptr);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result.value().IsError());
+}
+
 } // namespace
 } // namespace Expr
 } // namespace Common
@@ -394,6 +394,145 @@ TEST_F(LocalRateLimiterDescriptorImplTest, TokenBucketDifferentDescriptorDiffere
   EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor_));
 }
 
+class LocalRateLimiterDynamicDescriptorImplTest : public LocalRateLimiterDescriptorImplTest {
+public:
+  const std::string dynamic_descriptor_config_yaml = R"(
+  dynamic_entries:
+  - key: client_cluster
+    value: foo
+  - key: remote_address
+    value: ""
+  token_bucket:
+    max_tokens: {}
+    tokens_per_fill: 1
+    fill_interval: {}
+  )";
+
+  std::vector<RateLimit::LocalDescriptor> clientDescriptor(const std::string& address) {
+    return {{{{"client_cluster", "foo"}, {"remote_address", address}}}};
+  }
+};
+
+// Verify each value of a dynamic descriptor gets its own token bucket.
+TEST_F(LocalRateLimiterDynamicDescriptorImplTest, TokenBucketPerValue) {
+  TestUtility::loadFromYaml(fmt::format(dynamic_descriptor_config_yaml, 1, "0.05s"),
+                            *descriptors_.Add());
+  initializeWithDescriptor(std::chrono::milliseconds(50), 10, 1);
+
+  // 1 -> 0 tokens for each address
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.2")));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.2")));
+
+  // 0 -> 1 tokens for each address
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(50), nullptr));
+  fill_timer_->invokeCallback();
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.2")));
+}
+
+// Verify the fill interval of a dynamic descriptor is a multiple of the fill timer.
+TEST_F(LocalRateLimiterDynamicDescriptorImplTest, FillIntervalMultiple) {
+  TestUtility::loadFromYaml(fmt::format(dynamic_descriptor_config_yaml, 1, "0.1s"),
+                            *descriptors_.Add());
+  initializeWithDescriptor(std::chrono::milliseconds(50), 10, 1);
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+
+  // Half a descriptor fill interval.
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(50), nullptr));
+  fill_timer_->invokeCallback();
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+
+  // A full descriptor fill interval.
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(50), nullptr));
+  fill_timer_->invokeCallback();
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.1")));
+}
+
+// Verify static descriptors take precedence, and descriptors not matching the fixed entries of a
+// dynamic descriptor use the default token bucket.
+TEST_F(LocalRateLimiterDynamicDescriptorImplTest, MatchPrecedence) {
+  TestUtility::loadFromYaml(fmt::format(dynamic_descriptor_config_yaml, 1, "0.05s"),
+                            *descriptors_.Add());
+  TestUtility::loadFromYaml(R"(
+  entries:
+  - key: client_cluster
+    value: foo
+  - key: remote_address
+    value: 10.0.0.9
+  token_bucket:
+    max_tokens: 3
+    tokens_per_fill: 1
+    fill_interval: 0.05s
+  )",
+                            *descriptors_.Add());
+  initializeWithDescriptor(std::chrono::milliseconds(50), 2, 1);
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.9")));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.9")));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.9")));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.9")));
+
+  const std::vector<RateLimit::LocalDescriptor> other_cluster{
+      {{{"client_cluster", "bar"}, {"remote_address", "10.0.0.1"}}}};
+  EXPECT_TRUE(rate_limiter_->requestAllowed(other_cluster));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(other_cluster));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(other_cluster));
+}
+
+// Verify the number of buckets of a dynamic descriptor is bounded.
+TEST_F(LocalRateLimiterDynamicDescriptorImplTest, MaxDynamicDescriptors) {
+  TestUtility::loadFromYaml(fmt::format(dynamic_descriptor_config_yaml, 1, "0.05s"),
+                            *descriptors_.Add());
+  initializeTimer();
+  rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(std::chrono::milliseconds(50), 1, 1,
+                                                         dispatcher_, descriptors_, 4);
+
+  // Many more addresses than buckets each get a token in turn, as their buckets are recycled.
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor(absl::StrCat("10.0.0.", i))));
+  }
+  // The most recent address is still limited, while the bucket of the first one was recycled.
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.99")));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("10.0.0.0")));
+}
+
+TEST_F(LocalRateLimiterDynamicDescriptorImplTest, MaxTokensTooLarge) {
+  TestUtility::loadFromYaml(fmt::format(dynamic_descriptor_config_yaml, 1 << 24, "0.05s"),
+                            *descriptors_.Add());
+
+  EXPECT_THROW_WITH_MESSAGE(
+      LocalRateLimiterImpl(std::chrono::milliseconds(50), 1, 1, dispatcher_, descriptors_),
+      EnvoyException,
+      "local rate descriptor with dynamic values supports at most 16777215 tokens: "
+      "client_cluster=foo, remote_address=");
+}
+
+TEST_F(LocalRateLimiterDynamicDescriptorImplTest, EntriesAndDynamicEntries) {
+  TestUtility::loadFromYaml(R"(
+  entries:
+  - key: client_cluster
+    value: foo
+  dynamic_entries:
+  - key: remote_address
+    value: ""
+  token_bucket:
+    max_tokens: 1
+    tokens_per_fill: 1
+    fill_interval: 0.05s
+  )",
+                            *descriptors_.Add());
+
+  EXPECT_THROW_WITH_MESSAGE(
+      LocalRateLimiterImpl(std::chrono::milliseconds(50), 1, 1, dispatcher_, descriptors_),
+      EnvoyException, "local rate descriptor must have exactly one of entries and dynamic_entries");
+}
+
 } // Namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
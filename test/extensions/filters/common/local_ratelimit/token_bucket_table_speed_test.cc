@@ -0,0 +1,64 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <atomic>
+#include <memory>
+
+#include "source/extensions/filters/common/local_ratelimit/token_bucket_table.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+constexpr uint32_t Capacity = 16384;
+// The fill count is advanced by the first thread every FillEvery checks.
+constexpr uint32_t FillEvery = 1024;
+
+static std::unique_ptr<TokenBucketTable> table;
+static std::atomic<uint32_t> fill_count;
+
+// Checks the buckets of keys from concurrent threads, as the workers do for the requests of many
+// clients. Arguments:
+//   0: the number of distinct keys checked, all the threads contending on a single bucket for 1,
+//      and buckets being recycled for more than the capacity of the table.
+static void bmConsume(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    table = std::make_unique<TokenBucketTable>(Capacity, 100, 10);
+    fill_count = 0;
+  }
+
+  // The threads wait for the set up to be done before the first iteration.
+  const uint64_t keys = state.range(0);
+  uint64_t check = state.thread_index * 7919;
+  uint64_t allowed = 0;
+  for (auto _ : state) {
+    // Spread the keys over the table as the hashes of the descriptors would.
+    const uint64_t key = ((check++ % keys) + 1) * 0x9e3779b97f4a7c15;
+    allowed += table->consume(key, fill_count.load(std::memory_order_relaxed));
+    if (state.thread_index == 0 && check % FillEvery == 0) {
+      fill_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  state.counters["allowed"] =
+      benchmark::Counter(static_cast<double>(allowed), benchmark::Counter::kAvgThreads);
+
+  if (state.thread_index == 0) {
+    table.reset();
+  }
+}
+BENCHMARK(bmConsume)
+    ->Arg(1)
+    ->Arg(Capacity / 4)
+    ->Arg(Capacity * 64)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
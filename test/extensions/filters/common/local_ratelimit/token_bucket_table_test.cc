@@ -0,0 +1,121 @@
+#include <atomic>
+#include <vector>
+
+#include "source/extensions/filters/common/local_ratelimit/token_bucket_table.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+uint32_t consumeTimes(TokenBucketTable& table, uint64_t key, uint32_t fill_count, uint32_t times) {
+  uint32_t allowed = 0;
+  for (uint32_t i = 0; i < times; ++i) {
+    allowed += table.consume(key, fill_count);
+  }
+  return allowed;
+}
+
+TEST(TokenBucketTableTest, Capacity) {
+  EXPECT_EQ(4, TokenBucketTable(1, 1, 1).capacity());
+  EXPECT_EQ(1024, TokenBucketTable(1024, 1, 1).capacity());
+  EXPECT_EQ(2048, TokenBucketTable(1025, 1, 1).capacity());
+}
+
+TEST(TokenBucketTableTest, NewKeyStartsFull) {
+  TokenBucketTable table(16, 3, 1);
+  EXPECT_EQ(3, consumeTimes(table, 1, 0, 5));
+  EXPECT_EQ(3, consumeTimes(table, 2, 0, 5));
+}
+
+// Key 0 marks the empty slots, so it shares a bucket with key 1.
+TEST(TokenBucketTableTest, KeyZero) {
+  TokenBucketTable table(16, 3, 1);
+  EXPECT_EQ(3, consumeTimes(table, 0, 0, 5));
+  EXPECT_EQ(0, consumeTimes(table, 1, 0, 5));
+}
+
+TEST(TokenBucketTableTest, LazyRefill) {
+  TokenBucketTable table(16, 5, 2);
+  EXPECT_EQ(5, consumeTimes(table, 1, 0, 10));
+  EXPECT_EQ(0, consumeTimes(table, 1, 0, 1));
+  EXPECT_EQ(2, consumeTimes(table, 1, 1, 10));
+  // Several fill intervals elapsed, up to the max tokens.
+  EXPECT_EQ(4, consumeTimes(table, 1, 3, 10));
+  EXPECT_EQ(5, consumeTimes(table, 1, 100, 10));
+}
+
+// A worker may consume with a fill count older than the one the bucket was refilled at.
+TEST(TokenBucketTableTest, StaleFillCount) {
+  TokenBucketTable table(16, 2, 1);
+  EXPECT_EQ(2, consumeTimes(table, 1, 10, 2));
+  EXPECT_EQ(0, consumeTimes(table, 1, 9, 2));
+  EXPECT_EQ(1, consumeTimes(table, 1, 11, 2));
+}
+
+TEST(TokenBucketTableTest, FillCountWrapsAround) {
+  TokenBucketTable table(16, 2, 1);
+  EXPECT_EQ(2, consumeTimes(table, 1, UINT32_MAX, 2));
+  EXPECT_EQ(1, consumeTimes(table, 1, 0, 2));
+}
+
+// With a single set, inserting a fifth key recycles the least recently used bucket.
+TEST(TokenBucketTableTest, LeastRecentlyUsedEviction) {
+  TokenBucketTable table(4, 1, 1);
+  for (uint64_t key = 1; key <= 4; ++key) {
+    EXPECT_EQ(1, consumeTimes(table, key, key, 2));
+  }
+  EXPECT_EQ(1, consumeTimes(table, 5, 5, 2));
+  // Key 1 was recycled, so it starts full again, but key 4 is still limited.
+  EXPECT_EQ(1, consumeTimes(table, 1, 5, 2));
+  EXPECT_EQ(0, consumeTimes(table, 4, 4, 1));
+}
+
+// Concurrent checks of a single key never grant more tokens than the bucket holds.
+TEST(TokenBucketTableTest, ConcurrentSameKey) {
+  constexpr uint32_t Threads = 8;
+  constexpr uint32_t ChecksPerThread = 20000;
+  TokenBucketTable table(16, 50000, 1);
+  std::atomic<uint32_t> allowed{0};
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < Threads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread(
+        [&]() { allowed += consumeTimes(table, 42, 0, ChecksPerThread); }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(50000, allowed.load());
+}
+
+// Concurrent checks of many more keys than buckets keep every key within its limit.
+TEST(TokenBucketTableTest, ConcurrentChurn) {
+  constexpr uint32_t Threads = 4;
+  TokenBucketTable table(64, 1, 1);
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < Threads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&table, i]() {
+      for (uint64_t key = 0; key < 10000; ++key) {
+        table.consume(key * 2654435761 + i, 0);
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  // The table is still consistent: a new key gets a full bucket.
+  EXPECT_EQ(1, consumeTimes(table, 7, 0, 2));
+}
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -160,6 +160,55 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// Threads of coroutines that returned are reused, but not those that failed or were abandoned
+// while yielded.
+TEST_F(LuaTest, CoroutineReuse) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(fail)
+      if fail then
+        error("failed")
+      end
+      return "done"
+    end
+
+    function yieldMe()
+      coroutine.yield()
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("callMe", initializers_)));
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("yieldMe", initializers_)));
+
+  CoroutinePtr cr(state_->createCoroutine());
+  lua_State* thread = cr->luaState();
+  lua_pushboolean(thread, false);
+  cr->start(state_->getGlobalRef(0), 1, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+  cr.reset();
+  EXPECT_EQ(1U, state_->idleCoroutines());
+
+  // The returned thread runs the next coroutine, from a clean stack.
+  cr = state_->createCoroutine();
+  EXPECT_EQ(thread, cr->luaState());
+  EXPECT_EQ(cr->state(), Coroutine::State::NotStarted);
+  EXPECT_EQ(0, lua_gettop(thread));
+  EXPECT_EQ(0U, state_->idleCoroutines());
+  lua_pushboolean(thread, true);
+  EXPECT_THROW_WITH_MESSAGE(cr->start(state_->getGlobalRef(0), 1, yield_callback_), LuaException,
+                            "[string \"...\"]:4: failed");
+  cr.reset();
+  EXPECT_EQ(0U, state_->idleCoroutines());
+
+  cr = state_->createCoroutine();
+  EXPECT_NE(thread, cr->luaState());
+  EXPECT_CALL(on_yield_, ready());
+  cr->start(state_->getGlobalRef(1), 0, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Yielded);
+  cr.reset();
+  EXPECT_EQ(0U, state_->idleCoroutines());
+}
+
 class ThreadSafeTest : public testing::Test {
 public:
   ThreadSafeTest()
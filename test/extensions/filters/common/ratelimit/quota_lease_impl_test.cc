@@ -0,0 +1,315 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/service/ratelimit/v3/rls.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tracing/http_tracer_impl.h"
+#include "source/extensions/filters/common/ratelimit/quota_lease_impl.h"
+
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+namespace {
+
+class MockRequestCallbacks : public RequestCallbacks {
+public:
+  void complete(LimitStatus status, DescriptorStatusListPtr&&, Http::ResponseHeaderMapPtr&&,
+                Http::RequestHeaderMapPtr&&, const std::string&, DynamicMetadataPtr&&) override {
+    complete_(status);
+  }
+
+  MOCK_METHOD(void, complete_, (LimitStatus status));
+};
+
+// A client of the quota lease cache, with the gRPC client it calls the rate limit service with.
+struct TestClient {
+  explicit TestClient(QuotaLeaseCacheSharedPtr cache) : async_client_(new Grpc::MockAsyncClient()) {
+    auto grpc_client = std::make_unique<GrpcClientImpl>(
+        Grpc::RawAsyncClientPtr{async_client_}, absl::optional<std::chrono::milliseconds>(),
+        envoy::config::core::v3::ApiVersion::V3);
+    grpc_client_ = grpc_client.get();
+    client_ = std::make_unique<QuotaLeaseClient>(std::move(grpc_client), std::move(cache));
+  }
+
+  void expectRequest(const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                     uint32_t hits_addend) {
+    envoy::service::ratelimit::v3::RateLimitRequest request;
+    GrpcClientImpl::createRequest(request, "domain", descriptors, hits_addend);
+    EXPECT_CALL(*async_client_, sendRaw(_, _, Grpc::ProtoBufferEq(request), _, _, _))
+        .WillOnce(Return(&async_request_));
+  }
+
+  void limit(const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+    client_->limit(callbacks_, "domain", descriptors, Tracing::NullSpan::instance(),
+                   stream_info_);
+  }
+
+  void respond(envoy::service::ratelimit::v3::RateLimitResponse::Code code,
+               absl::optional<std::chrono::seconds> duration_until_reset = absl::nullopt) {
+    auto response = std::make_unique<envoy::service::ratelimit::v3::RateLimitResponse>();
+    response->set_overall_code(code);
+    if (duration_until_reset.has_value()) {
+      response->add_statuses()->mutable_duration_until_reset()->set_seconds(
+          duration_until_reset->count());
+    }
+    grpc_client_->onSuccess(std::move(response), span_);
+  }
+
+  Grpc::MockAsyncClient* async_client_;
+  Grpc::MockAsyncRequest async_request_;
+  GrpcClientImpl* grpc_client_;
+  std::unique_ptr<QuotaLeaseClient> client_;
+  MockRequestCallbacks callbacks_;
+  NiceMock<Tracing::MockSpan> span_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+class QuotaLeaseTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  void initialize(uint32_t max_leases = 100) {
+    cache_ = std::make_shared<QuotaLeaseCache>(simTime(), store_, 3, std::chrono::seconds(10),
+                                               max_leases);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "ratelimit.quota_lease." + name)->value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  QuotaLeaseCacheSharedPtr cache_;
+  const std::vector<Envoy::RateLimit::Descriptor> descriptors_{{{{"foo", "bar"}}}};
+  const std::vector<Envoy::RateLimit::Descriptor> other_descriptors_{{{{"foo", "baz"}}}};
+};
+
+TEST_F(QuotaLeaseTest, Key) {
+  EXPECT_EQ(QuotaLeaseCache::key("domain", descriptors_),
+            QuotaLeaseCache::key("domain", {{{{"foo", "bar"}}}}));
+  EXPECT_NE(QuotaLeaseCache::key("domain", descriptors_),
+            QuotaLeaseCache::key("domain", other_descriptors_));
+  EXPECT_NE(QuotaLeaseCache::key("domain", {{{{"a", "b"}, {"c", "d"}}}}),
+            QuotaLeaseCache::key("domain", {{{{"a", "b"}}}, {{{"c", "d"}}}}));
+  EXPECT_NE(QuotaLeaseCache::key("domain", {{{{"a", "b:1"}}}}),
+            QuotaLeaseCache::key("domain", {{{{"a:1", "b"}}}}));
+  EXPECT_NE(QuotaLeaseCache::key("domain", descriptors_),
+            QuotaLeaseCache::key("domain", {{{{"foo", "bar"}},
+                                             {{42, envoy::type::v3::RateLimitUnit::MINUTE}}}}));
+}
+
+// The hits of a lease are used locally, then another lease is requested.
+TEST_F(QuotaLeaseTest, LeaseServesLocally) {
+  initialize();
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK)).Times(2);
+  client.limit(descriptors_);
+  client.limit(descriptors_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_EQ(2, counter("lease_requested"));
+  EXPECT_EQ(2, counter("lease_granted"));
+  EXPECT_EQ(2, counter("local_hit"));
+}
+
+TEST_F(QuotaLeaseTest, LeaseExpires) {
+  initialize();
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+}
+
+// A lease expires when the limits of its descriptors reset.
+TEST_F(QuotaLeaseTest, LeaseExpiresOnReset) {
+  initialize();
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK, std::chrono::seconds(1));
+
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.limit(descriptors_);
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+}
+
+// When a lease is denied, the requests are checked one by one until the lease duration elapses.
+TEST_F(QuotaLeaseTest, LeaseDenied) {
+  initialize();
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  client.expectRequest(descriptors_, 0);
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  client.expectRequest(descriptors_, 0);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OverLimit));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+
+  // The next lease asks for half as many hits.
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  client.expectRequest(descriptors_, 1);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_EQ(1, counter("lease_denied"));
+}
+
+// The hits of the leases of a key are halved when a lease is denied, and doubled back up to
+// hits_per_lease when one is granted. A denied lease of a single hit is not checked again.
+TEST_F(QuotaLeaseTest, LeaseBacksOff) {
+  initialize();
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  client.expectRequest(descriptors_, 0);
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OverLimit));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  client.expectRequest(descriptors_, 1);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OverLimit));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  client.expectRequest(descriptors_, 1);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  client.expectRequest(descriptors_, 2);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.limit(descriptors_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_EQ(2, counter("lease_denied"));
+  EXPECT_EQ(3, counter("lease_granted"));
+}
+
+// While a lease is requested, the requests of other clients are checked one by one.
+TEST_F(QuotaLeaseTest, LeasePending) {
+  initialize();
+  TestClient client(cache_);
+  TestClient other_client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+
+  other_client.expectRequest(descriptors_, 0);
+  other_client.limit(descriptors_);
+  EXPECT_CALL(other_client.callbacks_, complete_(LimitStatus::OK));
+  other_client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  EXPECT_CALL(other_client.callbacks_, complete_(LimitStatus::OK));
+  other_client.limit(descriptors_);
+}
+
+// A cancelled or failed lease request lets the next request ask for a lease.
+TEST_F(QuotaLeaseTest, LeaseAbandoned) {
+  initialize();
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.async_request_, cancel());
+  client.client_->cancel();
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::Error));
+  client.grpc_client_->onFailure(Grpc::Status::Unavailable, "", client.span_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+}
+
+// Past the maximum number of leases, the requests of other descriptors are checked one by one.
+TEST_F(QuotaLeaseTest, MaxLeases) {
+  initialize(1);
+  TestClient client(cache_);
+
+  client.expectRequest(descriptors_, 3);
+  client.limit(descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  client.expectRequest(other_descriptors_, 0);
+  client.limit(other_descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+
+  // The expired lease is swept to make room for another one.
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  client.expectRequest(other_descriptors_, 3);
+  client.limit(other_descriptors_);
+  EXPECT_CALL(client.callbacks_, complete_(LimitStatus::OK));
+  client.respond(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+}
+
+} // namespace
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,165 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/common/rbac/engine_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+void addRemoteIp(envoy::config::rbac::v3::Policy& policy, uint32_t index) {
+  auto* cidr = policy.add_principals()->mutable_remote_ip();
+  cidr->set_address_prefix(absl::StrCat("10.", index / 256 % 256, ".", index % 256, ".0"));
+  cidr->mutable_prefix_len()->set_value(24);
+}
+
+// Checks a request that matches none of the policies, so that all of them are evaluated. With a
+// single policy, its remote IP principals are compiled into one LC-Trie lookup. With a policy per
+// principal, every policy is evaluated in turn.
+void bmRemoteIpPrincipals(benchmark::State& state) {
+  const uint32_t principals = state.range(0);
+  const bool single_policy = state.range(1) != 0;
+
+  envoy::config::rbac::v3::RBAC rules;
+  rules.set_action(envoy::config::rbac::v3::RBAC::ALLOW);
+  for (uint32_t i = 0; i < principals; ++i) {
+    const std::string name = single_policy ? "policy" : absl::StrCat("policy", i);
+    auto& policy = (*rules.mutable_policies())[name];
+    if (policy.permissions().empty()) {
+      policy.add_permissions()->set_any(true);
+    }
+    addRemoteIp(policy, i);
+  }
+  RoleBasedAccessControlEngineImpl engine(rules);
+
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  info.downstream_address_provider_->setRemoteAddress(
+      Network::Utility::parseInternetAddress("192.168.0.1", 456, false));
+  Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}};
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    if (engine.handleAction(connection, headers, info, nullptr)) {
+      state.SkipWithError("unexpected match");
+      break;
+    }
+  }
+}
+BENCHMARK(bmRemoteIpPrincipals)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      for (const int64_t principals : {1, 10, 100, 1000, 5000}) {
+        benchmark->Args({principals, 0});
+        benchmark->Args({principals, 1});
+      }
+    })
+    ->Unit(benchmark::kMicrosecond);
+
+// Checks a request against the exact values of a header, which are compiled into a hash set.
+void bmHeaderValuePermissions(benchmark::State& state) {
+  envoy::config::rbac::v3::RBAC rules;
+  rules.set_action(envoy::config::rbac::v3::RBAC::ALLOW);
+  auto& policy = (*rules.mutable_policies())["policy"];
+  policy.add_principals()->set_any(true);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    auto* header = policy.add_permissions()->mutable_header();
+    header->set_name("x-tenant");
+    header->set_exact_match(absl::StrCat("tenant", i));
+  }
+  RoleBasedAccessControlEngineImpl engine(rules);
+
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {"x-tenant", "none"}};
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    if (engine.handleAction(connection, headers, info, nullptr)) {
+      state.SkipWithError("unexpected match");
+      break;
+    }
+  }
+}
+BENCHMARK(bmHeaderValuePermissions)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Checks a request against a policy with a condition on a request header and the destination port.
+void bmPolicyCondition(benchmark::State& state) {
+  envoy::config::rbac::v3::RBAC rules;
+  TestUtility::loadFromYaml(R"EOF(
+  action: ALLOW
+  policies:
+    policy:
+      permissions:
+      - any: true
+      principals:
+      - any: true
+      condition:
+        call_expr:
+          function: _&&_
+          args:
+          - call_expr:
+              function: _==_
+              args:
+              - call_expr:
+                  function: _[_]
+                  args:
+                  - select_expr:
+                      operand:
+                        ident_expr:
+                          name: request
+                      field: headers
+                  - const_expr:
+                      string_value: x-tenant
+              - const_expr:
+                  string_value: tenant
+          - call_expr:
+              function: _==_
+              args:
+              - select_expr:
+                  operand:
+                    ident_expr:
+                      name: destination
+                  field: port
+              - const_expr:
+                  int64_value: 443
+  )EOF",
+                            rules);
+  RoleBasedAccessControlEngineImpl engine(rules);
+
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  info.downstream_address_provider_->setLocalAddress(
+      Network::Utility::parseInternetAddress("1.2.3.4", 443, false));
+  Http::TestRequestHeaderMapImpl headers{
+      {":method", "GET"}, {":path", "/"}, {"x-tenant", "tenant"}};
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    if (!engine.handleAction(connection, headers, info, nullptr)) {
+      state.SkipWithError("unexpected mismatch");
+      break;
+    }
+  }
+}
+BENCHMARK(bmPolicyCondition);
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -129,6 +129,90 @@ TEST(OrMatcher, Principal_Set) {
   checkMatcher(RBAC::OrMatcher(set), true, conn, headers, info);
 }
 
+TEST(OrMatcher, CompiledIPRanges) {
+  envoy::config::rbac::v3::Principal::Set set;
+  for (const std::string& prefix : {"10.0.0.0", "10.1.0.0", "10.2.0.0"}) {
+    auto* cidr = set.add_ids()->mutable_remote_ip();
+    cidr->set_address_prefix(prefix);
+    cidr->mutable_prefix_len()->set_value(16);
+  }
+  auto* cidr = set.add_ids()->mutable_remote_ip();
+  cidr->set_address_prefix("2001:db8::");
+  cidr->mutable_prefix_len()->set_value(32);
+  // A range of another type is not merged with the others.
+  cidr = set.add_ids()->mutable_direct_remote_ip();
+  cidr->set_address_prefix("10.3.0.0");
+  cidr->mutable_prefix_len()->set_value(16);
+  // An invalid range never matches.
+  cidr = set.add_ids()->mutable_remote_ip();
+  cidr->set_address_prefix("10.4.0.0");
+  cidr->mutable_prefix_len()->set_value(33);
+  const RBAC::OrMatcher matcher(set);
+
+  Envoy::Network::MockConnection conn;
+  Envoy::Http::TestRequestHeaderMapImpl headers;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  info.downstream_address_provider_->setDirectRemoteAddressForTest(
+      Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 456, false));
+  for (const std::string& address : {"10.0.0.1", "10.2.255.255", "2001:db8::1"}) {
+    info.downstream_address_provider_->setRemoteAddress(
+        Envoy::Network::Utility::parseInternetAddress(address, 456, false));
+    checkMatcher(matcher, true, conn, headers, info);
+  }
+  for (const std::string& address : {"10.3.0.1", "10.4.0.1", "11.0.0.1", "2001:db9::1"}) {
+    info.downstream_address_provider_->setRemoteAddress(
+        Envoy::Network::Utility::parseInternetAddress(address, 456, false));
+    checkMatcher(matcher, false, conn, headers, info);
+  }
+
+  info.downstream_address_provider_->setDirectRemoteAddressForTest(
+      Envoy::Network::Utility::parseInternetAddress("10.3.0.1", 456, false));
+  checkMatcher(matcher, true, conn, headers, info);
+}
+
+TEST(OrMatcher, CompiledHeaderValues) {
+  envoy::config::rbac::v3::Permission::Set set;
+  for (const std::string& value : {"a", "b", "c"}) {
+    auto* header = set.add_rules()->mutable_header();
+    header->set_name("X-Tenant");
+    header->set_exact_match(value);
+  }
+  auto* header = set.add_rules()->mutable_header();
+  header->set_name("x-other");
+  header->set_exact_match("d");
+  const RBAC::OrMatcher matcher(set);
+
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"x-tenant", "b"}});
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"x-other", "d"}});
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"x-tenant", "d"}});
+  // All the values of a header are joined before they are matched.
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"x-tenant", "a"}, {"x-tenant", "b"}});
+  checkMatcher(matcher, false);
+}
+
+TEST(OrMatcher, CompiledPaths) {
+  envoy::config::rbac::v3::Principal::Set set;
+  for (const std::string& path : {"/a", "/b"}) {
+    set.add_ids()->mutable_url_path()->mutable_path()->set_exact(path);
+  }
+  auto* ignore_case = set.add_ids()->mutable_url_path()->mutable_path();
+  ignore_case->set_exact("/C");
+  ignore_case->set_ignore_case(true);
+  const RBAC::OrMatcher matcher(set);
+
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{":path", "/a?param=val"}});
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{":path", "/c"}});
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{":path", "/B"}});
+  checkMatcher(matcher, false);
+}
+
 TEST(NotMatcher, Permission) {
   envoy::config::rbac::v3::Permission perm;
   perm.set_any(true);
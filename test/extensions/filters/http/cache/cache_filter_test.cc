@@ -23,7 +23,7 @@ protected:
   // cache callbacks.
   CacheFilterSharedPtr makeFilter(HttpCache& cache) {
     auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
-                                                context_.timeSource(), cache);
+                                                context_.timeSource(), cache, coalescer_);
     filter->setDecoderFilterCallbacks(decoder_callbacks_);
     filter->setEncoderFilterCallbacks(encoder_callbacks_);
     return filter;
@@ -128,7 +128,10 @@ protected:
                                                     {"cache-control", "public,max-age=3600"}};
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
   NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
-  Api::ApiPtr api_ = Api::createApiForTest();
+  // Null unless a test enables request coalescing.
+  RequestCoalescerSharedPtr coalescer_;
+  // The dispatcher uses the simulated time, so that request coalescing timeouts can be tested.
+  Api::ApiPtr api_ = Api::createApiForTest(time_source_);
   Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
   const Seconds delay_ = Seconds(10);
   const std::string age = std::to_string(delay_.count());
@@ -568,6 +571,136 @@ TEST_F(CacheFilterTest, GetRequestWithBodyAndTrailers) {
   }
 }
 
+TEST_F(CacheFilterTest, CoalescedCacheMiss) {
+  request_headers_.setHost("CoalescedCacheMiss");
+  coalescer_ = std::make_shared<RequestCoalescer>(std::chrono::seconds(5), "", context_.scope());
+  const std::string body = "abc";
+
+  CacheFilterSharedPtr first_filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(first_filter);
+
+  // The second request misses as well, but waits for the response to the first one instead of
+  // being sent upstream.
+  CacheFilterSharedPtr second_filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(second_filter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(1, coalescer_->stats().coalesced_requests_.value());
+
+  // Once the first response is cached, the second request is served from the cache.
+  response_headers_.setContentLength(body.size());
+  EXPECT_CALL(decoder_callbacks_,
+              encodeHeaders_(IsSupersetOfHeaders(response_headers_), /*end_stream=*/false));
+  EXPECT_CALL(
+      decoder_callbacks_,
+      encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  Buffer::OwnedImpl buffer(body);
+  EXPECT_EQ(first_filter->encodeHeaders(response_headers_, false),
+            Http::FilterHeadersStatus::Continue);
+  EXPECT_EQ(first_filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  first_filter->onDestroy();
+  second_filter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestSentUpstreamIfResponseIsUncacheable) {
+  request_headers_.setHost("CoalescedRequestSentUpstreamIfResponseIsUncacheable");
+  coalescer_ = std::make_shared<RequestCoalescer>(std::chrono::seconds(5), "", context_.scope());
+
+  CacheFilterSharedPtr first_filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(first_filter);
+
+  CacheFilterSharedPtr second_filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(second_filter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  // The first response can't be cached, so the second request is sent upstream once it looked up
+  // the cache again.
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  EXPECT_CALL(decoder_callbacks_, continueDecoding);
+  EXPECT_EQ(first_filter->encodeHeaders(response_headers_, true),
+            Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  first_filter->onDestroy();
+  second_filter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestTimeout) {
+  request_headers_.setHost("CoalescedRequestTimeout");
+  coalescer_ = std::make_shared<RequestCoalescer>(std::chrono::seconds(5), "", context_.scope());
+
+  CacheFilterSharedPtr first_filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(first_filter);
+
+  CacheFilterSharedPtr second_filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(second_filter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  // The second request is sent upstream once it has waited for too long.
+  EXPECT_CALL(decoder_callbacks_, continueDecoding);
+  time_source_.advanceTimeWait(std::chrono::seconds(5));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(1, coalescer_->stats().coalesced_request_timeouts_.value());
+
+  // The completion of the first request is ignored.
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  first_filter->onDestroy();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  second_filter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, StaleWhileRevalidate) {
+  request_headers_.setHost("StaleWhileRevalidate");
+  coalescer_ = std::make_shared<RequestCoalescer>(std::chrono::seconds(5), "", context_.scope());
+  const std::string body = "abc";
+  const std::string etag = "abc123";
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl,
+                                    "public,max-age=5,stale-while-revalidate=60");
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().Etag, etag);
+  response_headers_.setContentLength(body.size());
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    Buffer::OwnedImpl buffer(body);
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+    filter->onDestroy();
+  }
+  // The cached response is now stale, but may be served while it is revalidated.
+  waitBeforeSecondRequest();
+
+  // The first request to find the response stale validates it upstream.
+  CacheFilterSharedPtr validating_filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(validating_filter);
+  const Http::TestRequestHeaderMapImpl injected_headers = {{"if-none-match", etag}};
+  EXPECT_THAT(request_headers_, IsSupersetOfHeaders(injected_headers));
+
+  // The requests made during the validation are served the stale response.
+  request_headers_.remove(Http::CustomHeaders::get().IfNoneMatch);
+  request_headers_.remove(Http::CustomHeaders::get().IfModifiedSince);
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestHitWithBody(filter, body);
+    filter->onDestroy();
+  }
+  EXPECT_EQ(1, coalescer_->stats().stale_responses_served_while_revalidating_.value());
+  validating_filter->onDestroy();
+}
+
 // Checks the case where a cache lookup callback is posted to the dispatcher, then the CacheFilter
 // was deleted (e.g. connection dropped with the client) before the posted callback was executed. In
 // this case the CacheFilter should not be accessed after it was deleted, which is ensured by using
@@ -289,6 +289,16 @@ TEST_P(ResponseCacheControlTest, ResponseCacheControlTest) {
   EXPECT_EQ(expected_response_cache_control, ResponseCacheControl(cache_control_header));
 }
 
+TEST(ResponseCacheControlStaleWhileRevalidateTest, Parsing) {
+  EXPECT_EQ(Seconds(30),
+            ResponseCacheControl("max-age=10, stale-while-revalidate=30").stale_while_revalidate_);
+  EXPECT_EQ(Seconds(30),
+            ResponseCacheControl("stale-while-revalidate=\"30\"").stale_while_revalidate_);
+  EXPECT_EQ(absl::nullopt, ResponseCacheControl("max-age=10").stale_while_revalidate_);
+  EXPECT_EQ(absl::nullopt,
+            ResponseCacheControl("stale-while-revalidate=thirty").stale_while_revalidate_);
+}
+
 class HttpTimeTest : public testing::TestWithParam<std::string> {
 public:
   static const std::vector<std::string>& getOkTestCases() {
@@ -0,0 +1,297 @@
+#include "envoy/extensions/cache/disk_http_cache/v3alpha/config.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/disk_http_cache/disk_http_cache.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
+  // Allows 'accept' to be varied in the tests.
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  const auto& add_accept = config.mutable_allowed_vary_headers()->Add();
+  add_accept->set_exact("accept");
+  return config;
+}
+
+class DiskHttpCacheTest : public testing::Test {
+protected:
+  DiskHttpCacheTest() : vary_allow_list_(getConfig().allowed_vary_headers()) {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "max-age=3600");
+    config_.set_cache_path(TestEnvironment::temporaryDirectory());
+  }
+
+  void initialize() {
+    cache_ = std::make_unique<DiskHttpCache>(config_, Thread::threadFactoryForTest(), store_);
+  }
+
+  // Performs a cache lookup.
+  LookupContextPtr lookup(absl::string_view request_path) {
+    request_headers_.setPath(request_path);
+    LookupContextPtr context = cache_->makeLookupContext(
+        LookupRequest(request_headers_, time_system_.systemTime(), vary_allow_list_));
+    context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
+    return context;
+  }
+
+  // Inserts a value into the cache, and waits for it to be written.
+  void insert(LookupContextPtr lookup, absl::string_view response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(std::move(lookup));
+    const ResponseMetadata metadata = {time_system_.systemTime()};
+    inserter->insertHeaders(response_headers_, metadata, false);
+    inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
+    ++inserts_;
+    // The counter is incremented once the response is in the index.
+    TestUtility::waitForCounterEq(store_, "http_cache.disk.inserts", inserts_, time_system_);
+  }
+
+  void insert(absl::string_view request_path, absl::string_view response_body) {
+    insert(lookup(request_path), response_body);
+  }
+
+  Buffer::InstancePtr getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    Buffer::InstancePtr body;
+    context.getBody(AdjustedByteRange(start, end),
+                    [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+    EXPECT_NE(nullptr, body);
+    return body;
+  }
+
+  AssertionResult expectLookupSuccessWithBody(LookupContext* lookup_context,
+                                              absl::string_view body) {
+    if (lookup_result_.cache_entry_status_ != CacheEntryStatus::Ok) {
+      return AssertionFailure() << "Expected: lookup_result_.cache_entry_status == "
+                                   "CacheEntryStatus::Ok\n  Actual: "
+                                << lookup_result_.cache_entry_status_;
+    }
+    if (lookup_result_.content_length_ != body.size()) {
+      return AssertionFailure() << "Expected content_length == " << body.size()
+                                << "\n  Actual:  " << lookup_result_.content_length_;
+    }
+    const std::string actual_body =
+        body.empty() ? "" : getBody(*lookup_context, 0, body.size())->toString();
+    if (body != actual_body) {
+      return AssertionFailure() << "Expected body == " << body << "\n  Actual:  " << actual_body;
+    }
+    return AssertionSuccess();
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "http_cache.disk." + name)->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::TestUtil::TestStore store_;
+  envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig config_;
+  std::unique_ptr<DiskHttpCache> cache_;
+  uint64_t inserts_{0};
+  LookupResult lookup_result_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  Http::TestResponseHeaderMapImpl response_headers_{
+      {"date", formatter_.fromTime(time_system_.systemTime())},
+      {"cache-control", "public,max-age=3600"}};
+  VaryHeader vary_allow_list_;
+};
+
+TEST_F(DiskHttpCacheTest, PutGet) {
+  initialize();
+  LookupContextPtr name_lookup_context = lookup("Name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  insert(std::move(name_lookup_context), "Value");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Name").get(), "Value"));
+  lookup("Another Name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  insert("Name", "NewValue");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Name").get(), "NewValue"));
+  insert("Empty", "");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Empty").get(), ""));
+
+  EXPECT_EQ(4, counter("hits"));
+  EXPECT_EQ(3, counter("misses"));
+}
+
+TEST_F(DiskHttpCacheTest, RangesAreServedFromTheSegment) {
+  initialize();
+  insert("Name", "Hello, World!");
+
+  LookupContextPtr first_lookup = lookup("Name");
+  LookupContextPtr second_lookup = lookup("Name");
+  Buffer::InstancePtr first_body = getBody(*first_lookup, 7, 12);
+  Buffer::InstancePtr second_body = getBody(*second_lookup, 7, 12);
+  EXPECT_EQ("World", first_body->toString());
+  // Both buffers reference the same mapped bytes, rather than copies of them.
+  EXPECT_EQ(first_body->frontSlice().mem_, second_body->frontSlice().mem_);
+  EXPECT_EQ(static_cast<const uint8_t*>(getBody(*first_lookup, 0, 13)->frontSlice().mem_) + 7,
+            first_body->frontSlice().mem_);
+}
+
+TEST_F(DiskHttpCacheTest, VaryResponses) {
+  initialize();
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  const std::string RequestPath("some-resource");
+
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  insert(RequestPath, "accept is image/*");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "accept is image/*"));
+
+  // Should miss because we don't have this version of the response saved yet.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  LookupContextPtr second_value_vary = lookup(RequestPath);
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  insert(std::move(second_value_vary), "accept is text/html");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "accept is text/html"));
+
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "accept is image/*"));
+}
+
+TEST_F(DiskHttpCacheTest, DropsTheOldestSegment) {
+  config_.mutable_segment_size_bytes()->set_value(4096);
+  config_.mutable_max_cache_size_bytes()->set_value(2 * 4096);
+  initialize();
+
+  // Each of these bodies takes most of a segment.
+  insert("a", std::string(3000, 'a'));
+  insert("b", std::string(3000, 'b'));
+  LookupContextPtr a_lookup = lookup("a");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  insert("c", std::string(3000, 'c'));
+
+  EXPECT_EQ(3, counter("segments_created"));
+  EXPECT_EQ(1, counter("evictions"));
+  EXPECT_EQ(2, TestUtility::findGauge(store_, "http_cache.disk.segments")->value());
+  lookup("a");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("b").get(), std::string(3000, 'b')));
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("c").get(), std::string(3000, 'c')));
+
+  // The response looked up before the eviction can still be served.
+  EXPECT_EQ(std::string(3000, 'a'), getBody(*a_lookup, 0, 3000)->toString());
+}
+
+TEST_F(DiskHttpCacheTest, KeepsTheVaryFlagRecordedAgainInANewerSegment) {
+  config_.mutable_segment_size_bytes()->set_value(4096);
+  config_.mutable_max_cache_size_bytes()->set_value(2 * 4096);
+  initialize();
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  insert("resource", std::string(3000, 'i'));
+  response_headers_.remove(Http::LowerCaseString("vary"));
+  insert("other", std::string(3000, 'o'));
+  // The flag is recorded again in the second segment, before the body of the response fills a
+  // third one, which evicts the first.
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  insert("resource", std::string(3000, 't'));
+
+  EXPECT_EQ(1, counter("evictions"));
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("resource").get(), std::string(3000, 't')));
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  lookup("resource");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+TEST_F(DiskHttpCacheTest, CountsSegmentCreationFailures) {
+  const std::string cache_path = TestEnvironment::temporaryPath("disk_http_cache_removed");
+  TestEnvironment::createPath(cache_path);
+  config_.set_cache_path(cache_path);
+  config_.mutable_segment_size_bytes()->set_value(4096);
+  initialize();
+  insert("a", std::string(3000, 'a'));
+  TestEnvironment::removePath(cache_path);
+
+  // The response doesn't fit in the first segment, and no other can be created.
+  LookupContextPtr b_lookup = lookup("b");
+  InsertContextPtr inserter = cache_->makeInsertContext(std::move(b_lookup));
+  inserter->insertHeaders(response_headers_, {time_system_.systemTime()}, false);
+  inserter->insertBody(Buffer::OwnedImpl(std::string(3000, 'b')), nullptr, true);
+  TestUtility::waitForCounterEq(store_, "http_cache.disk.segment_creation_failures", 1,
+                                time_system_);
+  EXPECT_EQ(1, counter("rejected_inserts"));
+
+  lookup("b");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("a").get(), std::string(3000, 'a')));
+}
+
+TEST_F(DiskHttpCacheTest, RejectsResponsesLargerThanASegment) {
+  config_.mutable_segment_size_bytes()->set_value(4096);
+  initialize();
+
+  LookupContextPtr large_lookup = lookup("large");
+  InsertContextPtr inserter = cache_->makeInsertContext(std::move(large_lookup));
+  inserter->insertHeaders(response_headers_, {time_system_.systemTime()}, false);
+  inserter->insertBody(Buffer::OwnedImpl(std::string(5000, 'x')), nullptr, true);
+  EXPECT_EQ(1, counter("rejected_inserts"));
+
+  lookup("large");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+TEST_F(DiskHttpCacheTest, UpdateHeaders) {
+  initialize();
+  insert("Name", "Value");
+  LookupContextPtr name_lookup_context = lookup("Name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+
+  response_headers_.setCopy(Http::LowerCaseString("etag"), "\"abc\"");
+  cache_->updateHeaders(*name_lookup_context, response_headers_, {time_system_.systemTime()});
+
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Name").get(), "Value"));
+  EXPECT_EQ("\"abc\"", lookup_result_.headers_->get(Http::LowerCaseString("etag"))[0]
+                           ->value()
+                           .getStringView());
+}
+
+TEST_F(DiskHttpCacheTest, InvalidCachePath) {
+  config_.set_cache_path(TestEnvironment::temporaryPath("does/not/exist"));
+  EXPECT_THROW_WITH_REGEX(initialize(), EnvoyException, "unable to create a cache segment in");
+}
+
+TEST(Registration, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.cache.disk_http_cache.v3alpha.DiskHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::extensions::cache::disk_http_cache::v3alpha::DiskHttpCacheConfig disk_config;
+  disk_config.set_cache_path(TestEnvironment::temporaryDirectory());
+  disk_config.mutable_segment_size_bytes()->set_value(4096);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(disk_config);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context.api_, threadFactory())
+      .WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+  std::shared_ptr<HttpCache> cache = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.disk");
+  EXPECT_EQ(cache, factory->getCache(config, factory_context));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
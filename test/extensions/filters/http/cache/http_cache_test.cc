@@ -295,6 +295,52 @@ TEST_F(LookupRequestTest, PragmaNoFallback) {
   EXPECT_EQ(CacheEntryStatus::Ok, lookup_response.cache_entry_status_);
 }
 
+TEST_F(LookupRequestTest, StaleWhileRevalidate) {
+  const LookupRequest lookup_request(request_headers_, currentTime() + Seconds(20),
+                                     vary_allow_list_);
+  const Http::TestResponseHeaderMapImpl response_headers(
+      {{"date", formatter_.fromTime(currentTime())},
+       {"cache-control", "public, max-age=10, stale-while-revalidate=30"}});
+  const LookupResult lookup_response = makeLookupResult(lookup_request, response_headers);
+  // The response is stale for 10 seconds, which is within the stale-while-revalidate window.
+  EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+  EXPECT_TRUE(lookup_response.stale_while_revalidate_);
+}
+
+TEST_F(LookupRequestTest, StaleWhileRevalidateExpired) {
+  const LookupRequest lookup_request(request_headers_, currentTime() + Seconds(50),
+                                     vary_allow_list_);
+  const Http::TestResponseHeaderMapImpl response_headers(
+      {{"date", formatter_.fromTime(currentTime())},
+       {"cache-control", "public, max-age=10, stale-while-revalidate=30"}});
+  const LookupResult lookup_response = makeLookupResult(lookup_request, response_headers);
+  EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+  EXPECT_FALSE(lookup_response.stale_while_revalidate_);
+}
+
+TEST_F(LookupRequestTest, StaleWhileRevalidateWithMustRevalidate) {
+  const LookupRequest lookup_request(request_headers_, currentTime() + Seconds(20),
+                                     vary_allow_list_);
+  const Http::TestResponseHeaderMapImpl response_headers(
+      {{"date", formatter_.fromTime(currentTime())},
+       {"cache-control", "public, max-age=10, stale-while-revalidate=30, must-revalidate"}});
+  const LookupResult lookup_response = makeLookupResult(lookup_request, response_headers);
+  EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+  EXPECT_FALSE(lookup_response.stale_while_revalidate_);
+}
+
+TEST_F(LookupRequestTest, StaleWhileRevalidateWithRequestNoCache) {
+  request_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-cache");
+  const LookupRequest lookup_request(request_headers_, currentTime() + Seconds(20),
+                                     vary_allow_list_);
+  const Http::TestResponseHeaderMapImpl response_headers(
+      {{"date", formatter_.fromTime(currentTime())},
+       {"cache-control", "public, max-age=10, stale-while-revalidate=30"}});
+  const LookupResult lookup_response = makeLookupResult(lookup_request, response_headers);
+  EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+  EXPECT_FALSE(lookup_response.stale_while_revalidate_);
+}
+
 TEST_F(LookupRequestTest, SingleSatisfiableRange) {
   // add range info to headers
   request_headers_.addReference(Http::Headers::get().Range, "bytes=1-99");
@@ -0,0 +1,133 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/cache/lru_http_cache/v3alpha/config.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/lru_http_cache/lru_http_cache.h"
+#include "source/extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+constexpr uint32_t NumKeys = 1000;
+// One operation in InsertEvery is an insert, the others are lookups.
+constexpr uint32_t InsertEvery = 10;
+
+// The state shared by the threads of a benchmark, set up by its first thread.
+struct SharedState {
+  SharedState(bool lru, uint64_t body_size)
+      : now_(std::chrono::seconds(1600000000)), body_(body_size, 'x') {
+    if (lru) {
+      envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig config;
+      config.mutable_max_cache_size_bytes()->set_value(uint64_t(NumKeys) * (body_size + 1024) * 2);
+      cache_ = std::make_unique<LruHttpCache>(config, store_);
+    } else {
+      cache_ = std::make_unique<SimpleHttpCache>();
+    }
+    response_headers_.setCopy(Http::LowerCaseString("date"),
+                              DateFormatter("%a, %d %b %Y %H:%M:%S GMT").fromTime(now_));
+    response_headers_.setCopy(Http::LowerCaseString("cache-control"), "public,max-age=3600");
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  const SystemTime now_;
+  const VaryHeader vary_allow_list_{
+      Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>()};
+  const std::string body_;
+  Http::TestResponseHeaderMapImpl response_headers_;
+  std::unique_ptr<HttpCache> cache_;
+};
+
+static std::unique_ptr<SharedState> shared_state;
+
+// The state of one thread of a benchmark.
+class CacheClient {
+public:
+  CacheClient() {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+  }
+
+  void insert(uint32_t key) {
+    InsertContextPtr inserter = shared_state->cache_->makeInsertContext(makeLookupContext(key));
+    inserter->insertHeaders(shared_state->response_headers_, {shared_state->now_}, false);
+    inserter->insertBody(Buffer::OwnedImpl(shared_state->body_), nullptr, true);
+  }
+
+  // Looks up a response, and reads its whole body.
+  void lookup(uint32_t key) {
+    LookupContextPtr context = makeLookupContext(key);
+    uint64_t content_length = 0;
+    context->getHeaders([&content_length](LookupResult&& result) {
+      RELEASE_ASSERT(result.cache_entry_status_ == CacheEntryStatus::Ok, "");
+      content_length = result.content_length_;
+    });
+    context->getBody(AdjustedByteRange(0, content_length), [](Buffer::InstancePtr&& body) {
+      benchmark::DoNotOptimize(body->frontSlice().mem_);
+    });
+  }
+
+private:
+  LookupContextPtr makeLookupContext(uint32_t key) {
+    request_headers_.setPath(absl::StrCat("/resource/", key));
+    return shared_state->cache_->makeLookupContext(
+        LookupRequest(request_headers_, shared_state->now_, shared_state->vary_allow_list_));
+  }
+
+  Http::TestRequestHeaderMapImpl request_headers_;
+};
+
+// Serves cached responses from concurrent threads, while some of them are replaced. Arguments:
+//   0: whether the cache is an LruHttpCache, rather than a SimpleHttpCache.
+//   1: the size of the cached bodies.
+static void bmLookupAndInsert(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    shared_state = std::make_unique<SharedState>(state.range(0) != 0, state.range(1));
+    CacheClient client;
+    for (uint32_t key = 0; key < NumKeys; ++key) {
+      client.insert(key);
+    }
+  }
+
+  // The threads wait for the set up to be done before the first iteration.
+  CacheClient client;
+  uint32_t operation = state.thread_index * 7919;
+  for (auto _ : state) {
+    const uint32_t key = operation % NumKeys;
+    if (operation++ % InsertEvery == 0) {
+      client.insert(key);
+    } else {
+      client.lookup(key);
+    }
+  }
+
+  if (state.thread_index == 0) {
+    shared_state.reset();
+  }
+}
+BENCHMARK(bmLookupAndInsert)
+    ->Args({0, 1024})
+    ->Args({1, 1024})
+    ->Args({0, 64 * 1024})
+    ->Args({1, 64 * 1024})
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,274 @@
+#include "envoy/extensions/cache/lru_http_cache/v3alpha/config.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/lru_http_cache/lru_http_cache.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
+  // Allows 'accept' to be varied in the tests.
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  const auto& add_accept = config.mutable_allowed_vary_headers()->Add();
+  add_accept->set_exact("accept");
+  return config;
+}
+
+class LruHttpCacheTest : public testing::Test {
+protected:
+  LruHttpCacheTest() : vary_allow_list_(getConfig().allowed_vary_headers()) {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "max-age=3600");
+  }
+
+  void initialize(uint64_t max_cache_size_bytes, uint32_t shards) {
+    envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig config;
+    config.mutable_max_cache_size_bytes()->set_value(max_cache_size_bytes);
+    config.mutable_shards()->set_value(shards);
+    cache_ = std::make_unique<LruHttpCache>(config, store_);
+  }
+
+  // Performs a cache lookup.
+  LookupContextPtr lookup(absl::string_view request_path) {
+    request_headers_.setPath(request_path);
+    LookupContextPtr context = cache_->makeLookupContext(
+        LookupRequest(request_headers_, time_source_.systemTime(), vary_allow_list_));
+    context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
+    return context;
+  }
+
+  // Inserts a value into the cache, in the given chunks.
+  void insert(LookupContextPtr lookup, const std::vector<absl::string_view>& response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(std::move(lookup));
+    const ResponseMetadata metadata = {time_source_.systemTime()};
+    inserter->insertHeaders(response_headers_, metadata, false);
+    for (size_t i = 0; i < response_body.size(); ++i) {
+      const bool end_stream = i == response_body.size() - 1;
+      inserter->insertBody(
+          Buffer::OwnedImpl(response_body[i]), [](bool ready) { EXPECT_TRUE(ready); },
+          end_stream);
+    }
+  }
+
+  void insert(absl::string_view request_path, absl::string_view response_body) {
+    insert(lookup(request_path), {response_body});
+  }
+
+  std::string getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    AdjustedByteRange range(start, end);
+    std::string body;
+    context.getBody(range, [&body](Buffer::InstancePtr&& data) {
+      EXPECT_NE(data, nullptr);
+      if (data) {
+        body = data->toString();
+      }
+    });
+    return body;
+  }
+
+  AssertionResult expectLookupSuccessWithBody(LookupContext* lookup_context,
+                                              absl::string_view body) {
+    if (lookup_result_.cache_entry_status_ != CacheEntryStatus::Ok) {
+      return AssertionFailure() << "Expected: lookup_result_.cache_entry_status == "
+                                   "CacheEntryStatus::Ok\n  Actual: "
+                                << lookup_result_.cache_entry_status_;
+    }
+    if (!lookup_result_.headers_) {
+      return AssertionFailure() << "Expected nonnull lookup_result_.headers";
+    }
+    if (lookup_result_.content_length_ != body.size()) {
+      return AssertionFailure() << "Expected content_length == " << body.size()
+                                << "\n  Actual:  " << lookup_result_.content_length_;
+    }
+    const std::string actual_body = body.empty() ? "" : getBody(*lookup_context, 0, body.size());
+    if (body != actual_body) {
+      return AssertionFailure() << "Expected body == " << body << "\n  Actual:  " << actual_body;
+    }
+    return AssertionSuccess();
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "http_cache.lru." + name)->value();
+  }
+  uint64_t gauge(const std::string& name) {
+    return TestUtility::findGauge(store_, "http_cache.lru." + name)->value();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  std::unique_ptr<LruHttpCache> cache_;
+  LookupResult lookup_result_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Event::SimulatedTimeSystem time_source_;
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  Http::TestResponseHeaderMapImpl response_headers_{
+      {"date", formatter_.fromTime(time_source_.systemTime())},
+      {"cache-control", "public,max-age=3600"}};
+  VaryHeader vary_allow_list_;
+};
+
+TEST_F(LruHttpCacheTest, PutGet) {
+  initialize(1024 * 1024, 4);
+  LookupContextPtr name_lookup_context = lookup("Name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  insert(std::move(name_lookup_context), {"Value"});
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Name").get(), "Value"));
+  lookup("Another Name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  insert("Name", "NewValue");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Name").get(), "NewValue"));
+
+  EXPECT_EQ(3, counter("hits"));
+  EXPECT_EQ(2, counter("misses"));
+  EXPECT_EQ(2, counter("inserts"));
+  EXPECT_EQ(1, gauge("entries"));
+}
+
+TEST_F(LruHttpCacheTest, StreamingPutAndRanges) {
+  initialize(1024 * 1024, 4);
+  insert(lookup("request_path"), {"Hello, ", "World", "!"});
+
+  LookupContextPtr name_lookup_context = lookup("request_path");
+  EXPECT_TRUE(expectLookupSuccessWithBody(name_lookup_context.get(), "Hello, World!"));
+  EXPECT_EQ("lo, Wor", getBody(*name_lookup_context, 3, 10));
+  EXPECT_EQ("World", getBody(*name_lookup_context, 7, 12));
+  EXPECT_EQ("!", getBody(*name_lookup_context, 12, 13));
+}
+
+TEST_F(LruHttpCacheTest, EvictsLeastRecentlyUsed) {
+  initialize(1024 * 1024, 1);
+  insert("a", std::string(100, 'a'));
+  const uint64_t entry_size = gauge("cached_bytes");
+  // A single shard with room for two of the entries below.
+  initialize(2 * entry_size + entry_size / 2, 1);
+  EXPECT_EQ(0, gauge("entries"));
+
+  insert("a", std::string(100, 'a'));
+  insert("b", std::string(100, 'b'));
+  // Touch "a", so that "b" is the least recently used.
+  lookup("a");
+  insert("c", std::string(100, 'c'));
+  EXPECT_EQ(1, counter("evictions"));
+  EXPECT_EQ(2, gauge("entries"));
+  EXPECT_EQ(2 * entry_size, gauge("cached_bytes"));
+
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("a").get(), std::string(100, 'a')));
+  lookup("b");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("c").get(), std::string(100, 'c')));
+}
+
+TEST_F(LruHttpCacheTest, RejectsResponsesLargerThanAShard) {
+  initialize(1000, 2);
+  insert("small", "Value");
+  insert("large", std::string(600, 'x'));
+  EXPECT_EQ(1, counter("rejected_inserts"));
+  EXPECT_EQ(1, gauge("entries"));
+
+  lookup("large");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("small").get(), "Value"));
+}
+
+TEST_F(LruHttpCacheTest, BodyOutlivesEviction) {
+  initialize(1024 * 1024, 1);
+  insert("Name", "Value");
+  LookupContextPtr name_lookup_context = lookup("Name");
+  Buffer::InstancePtr body;
+  name_lookup_context->getBody(AdjustedByteRange(0, 5),
+                               [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+
+  // Replacing and then destroying the cache doesn't invalidate the buffer, which refers to the
+  // cached body rather than holding a copy of it.
+  insert("Name", "Other");
+  cache_.reset();
+  EXPECT_EQ("Value", body->toString());
+  EXPECT_EQ("Value", getBody(*name_lookup_context, 0, 5));
+}
+
+TEST_F(LruHttpCacheTest, UpdateHeaders) {
+  initialize(1024 * 1024, 4);
+  insert("Name", "Value");
+  LookupContextPtr name_lookup_context = lookup("Name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+
+  response_headers_.setCopy(Http::LowerCaseString("etag"), "\"abc\"");
+  cache_->updateHeaders(*name_lookup_context, response_headers_, {time_source_.systemTime()});
+
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("Name").get(), "Value"));
+  EXPECT_EQ("\"abc\"", lookup_result_.headers_->get(Http::LowerCaseString("etag"))[0]
+                           ->value()
+                           .getStringView());
+}
+
+TEST_F(LruHttpCacheTest, VaryResponses) {
+  initialize(1024 * 1024, 4);
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  const std::string RequestPath("some-resource");
+
+  // First request.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  LookupContextPtr first_value_vary = lookup(RequestPath);
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  insert(std::move(first_value_vary), {"accept is image/*"});
+  first_value_vary = lookup(RequestPath);
+  EXPECT_TRUE(expectLookupSuccessWithBody(first_value_vary.get(), "accept is image/*"));
+
+  // Second request with a different value for the varied header.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  LookupContextPtr second_value_vary = lookup(RequestPath);
+  // Should miss because we don't have this version of the response saved yet.
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  insert(std::move(second_value_vary), {"accept is text/html"});
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "accept is text/html"));
+
+  // Looks up first version again to be sure it wasn't replaced with the second one.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "accept is image/*"));
+}
+
+TEST(Registration, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.cache.lru_http_cache.v3alpha.LruHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  std::shared_ptr<HttpCache> cache = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.lru");
+
+  // Filters with the same config share the same cache, while others get their own.
+  EXPECT_EQ(cache, factory->getCache(config, factory_context));
+  envoy::extensions::cache::lru_http_cache::v3alpha::LruHttpCacheConfig lru_config;
+  lru_config.mutable_shards()->set_value(1);
+  config.mutable_typed_config()->PackFrom(lru_config);
+  std::shared_ptr<HttpCache> other_cache = factory->getCache(config, factory_context);
+  EXPECT_NE(cache, other_cache);
+
+  // A cache is released with the last filter config using it.
+  std::weak_ptr<HttpCache> weak_other_cache = other_cache;
+  other_cache.reset();
+  EXPECT_TRUE(weak_other_cache.expired());
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
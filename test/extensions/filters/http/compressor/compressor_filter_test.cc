@@ -5,6 +5,7 @@
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -17,6 +18,7 @@ namespace {
 
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 
 class TestCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
@@ -64,8 +66,14 @@ public:
     TestUtility::loadFromJson(json, compressor);
     auto compressor_factory = std::make_unique<TestCompressorFactory>("test");
     compressor_factory_ = compressor_factory.get();
-    config_ = std::make_shared<CompressorFilterConfig>(compressor, "test.", stats_, runtime_,
-                                                       std::move(compressor_factory));
+    config_ = std::make_shared<CompressorFilterConfig>(
+        compressor, "test.", stats_, runtime_, std::move(compressor_factory),
+        std::make_shared<CompressionThreadPool>(Thread::threadFactoryForTest(), 1));
+    setUpStream();
+  }
+
+  // Sets up a new filter for the current config, as for a new stream.
+  void setUpStream() {
     filter_ = std::make_unique<CompressorFilter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
@@ -401,6 +409,318 @@ TEST_F(CompressorFilterTest, RemoveAcceptEncodingHeader) {
   }
 }
 
+// The compressed body of a response with a strong entity tag is cached, and served to the
+// following responses with the same entity tag for the same resource.
+TEST_F(CompressorFilterTest, CompressedVariantCacheByEtag) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_variant_cache": {}
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  response_stats_prefix_ = "response.";
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "get"},
+                                                 {":authority", "example.com"},
+                                                 {":path", "/a"},
+                                                 {"accept-encoding", "test"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  Http::TestResponseHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  doResponseCompression(headers, false);
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_inserts").value());
+  const std::string compressed_body = data_.toString();
+
+  // No compressor is created for the response found in the cache.
+  compressor_factory_->setExpectedCompressCalls(0);
+  setUpStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  headers = {{":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ("test", headers.get_("content-encoding"));
+  EXPECT_FALSE(headers.has("etag"));
+  populateBuffer(128);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, false));
+  EXPECT_EQ(0, data_.length());
+  populateBuffer(128);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(compressed_body, data_.toString());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_hits").value());
+
+  // The entity tag of another resource doesn't match.
+  setUpStream();
+  compressor_factory_->setExpectedCompressCalls(1);
+  request_headers.setPath("/b");
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  headers = {{":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(2, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+}
+
+// A partial response shares the entity tag of the full representation, so it is neither cached
+// nor served from the cache.
+TEST_F(CompressorFilterTest, CompressedVariantCacheSkipsPartialResponses) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_variant_cache": {}
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  response_stats_prefix_ = "response.";
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "get"},
+                                                 {":authority", "example.com"},
+                                                 {":path", "/a"},
+                                                 {"accept-encoding", "test"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  Http::TestResponseHeaderMapImpl headers{{":status", "206"},
+                                          {"content-length", "256"},
+                                          {"content-range", "bytes 0-255/1024"},
+                                          {"etag", "\"abc\""}};
+  doResponseCompression(headers, false);
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_inserts").value());
+
+  // The full response is compressed, and only then cached.
+  setUpStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  headers = {{":status", "200"}, {"content-length", "1024"}, {"etag", "\"abc\""}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  populateBuffer(1024);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(expected_str_, data_.toString());
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_hits").value());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_inserts").value());
+}
+
+// The body of a response without a strong entity tag is buffered, and looked up by its digest.
+TEST_F(CompressorFilterTest, CompressedVariantCacheByBodyDigest) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_variant_cache": {}
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":method", "get"}, {":path", "/a"}, {"accept-encoding", "test"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  Http::TestResponseHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "256"}, {"etag", "W/\"abc\""}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  populateBuffer(256);
+  const std::string body = expected_str_;
+  Buffer::OwnedImpl first_chunk(body.substr(0, 100));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_->encodeData(first_chunk, false));
+  Buffer::OwnedImpl second_chunk(body.substr(100));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(second_chunk, true));
+  // The mock compressor leaves the body as is.
+  EXPECT_EQ(body, second_chunk.toString());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+
+  // The same body split differently is found in the cache.
+  compressor_factory_->setExpectedCompressCalls(0);
+  setUpStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  headers = {{":status", "200"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  first_chunk.add(body.substr(0, 200));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_->encodeData(first_chunk, false));
+  EXPECT_CALL(encoder_callbacks_, addEncodedData(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) { data_.move(data); }));
+  data_.drain(data_.length());
+  second_chunk.drain(second_chunk.length());
+  second_chunk.add(body.substr(200));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_->encodeData(second_chunk, false));
+  Http::TestResponseTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->encodeTrailers(trailers));
+  EXPECT_EQ(body, data_.toString());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.variant_cache_hits").value());
+
+  // The same body for another resource doesn't match.
+  compressor_factory_->setExpectedCompressCalls(1);
+  setUpStream();
+  request_headers.setPath("/b");
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  headers = {{":status", "200"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  Buffer::OwnedImpl whole_body(body);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(whole_body, true));
+  EXPECT_EQ(2, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+}
+
+// Responses without a strong entity tag larger than max_hashed_content_length are compressed as
+// they are received, without being cached.
+TEST_F(CompressorFilterTest, CompressedVariantCacheDoesNotBufferLargeBodies) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_variant_cache": {
+      "max_hashed_content_length": 100
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  response_stats_prefix_ = "response.";
+  doRequestNoCompression({{":method", "get"}, {"accept-encoding", "test"}});
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "256"}};
+  doResponseCompression(headers, false);
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+
+  // A body longer than its Content-Length header stops being buffered once over the limit.
+  compressor_factory_->setExpectedCompressCalls(2);
+  setUpStream();
+  doRequestNoCompression({{":method", "get"}, {"accept-encoding", "test"}});
+  headers = {{":status", "200"}, {"content-length", "50"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  Buffer::OwnedImpl chunk(std::string(50, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(chunk, false));
+  chunk.add(std::string(100, 'b'));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(chunk, false));
+  EXPECT_EQ(std::string(50, 'a') + std::string(100, 'b'), chunk.toString());
+  chunk.drain(chunk.length());
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(chunk, true));
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_inserts").value());
+}
+
+// Responses larger than max_content_length are compressed without being cached.
+TEST_F(CompressorFilterTest, CompressedVariantCacheSkipsLargeResponses) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_variant_cache": {
+      "max_content_length": 100
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  response_stats_prefix_ = "response.";
+  doRequestNoCompression({{":method", "get"}, {"accept-encoding", "test"}});
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "256"}};
+  doResponseCompression(headers, false);
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_misses").value());
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.variant_cache_inserts").value());
+}
+
+// Large response bodies are compressed by the offload thread pool, and the upstream is asked to
+// stop sending data while more than the buffer limit of the stream is waiting for it.
+TEST_F(CompressorFilterTest, OffloadedCompression) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  ON_CALL(encoder_callbacks_, dispatcher()).WillByDefault(ReturnRef(*dispatcher));
+  ON_CALL(encoder_callbacks_, encoderBufferLimit()).WillByDefault(Return(200));
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compression_offload": {
+      "min_content_length": 100
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  // The body is flushed, then finished once the trailers are received.
+  compressor_factory_->setExpectedCompressCalls(2);
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "get"}, {"accept-encoding", "test"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  Http::TestResponseHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ("test", headers.get_("content-encoding"));
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.offloaded").value());
+
+  populateBuffer(256);
+  EXPECT_CALL(encoder_callbacks_, onEncoderFilterAboveWriteBufferHighWatermark());
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(data_, false));
+  EXPECT_EQ(0, data_.length());
+
+  Buffer::OwnedImpl compressed;
+  EXPECT_CALL(encoder_callbacks_, onEncoderFilterBelowWriteBufferLowWatermark());
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        compressed.move(data);
+        dispatcher->exit();
+      }));
+  dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(expected_str_, compressed.toString());
+
+  Http::TestResponseTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_->encodeTrailers(trailers));
+  EXPECT_CALL(encoder_callbacks_, continueEncoding()).WillOnce(Invoke([&]() {
+    dispatcher->exit();
+  }));
+  dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(256, stats_.counter("test.compressor.test.test.response.total_uncompressed_bytes")
+                     .value());
+  filter_->onDestroy();
+}
+
+// Response bodies smaller than the offload threshold are compressed by the worker.
+TEST_F(CompressorFilterTest, SmallResponsesAreNotOffloaded) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compression_offload": {
+      "min_content_length": 1000
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  response_stats_prefix_ = "response.";
+  doRequestNoCompression({{":method", "get"}, {"accept-encoding", "test"}});
+  Http::TestResponseHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  compressor_factory_->setExpectedCompressCalls(2);
+  doResponseCompression(headers, true);
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.response.offloaded").value());
+}
+
 class IsAcceptEncodingAllowedTest
     : public CompressorFilterTest,
       public testing::WithParamInterface<std::tuple<std::string, bool, int, int, int, int>> {};
@@ -701,8 +1021,8 @@ protected:
                               compressor);
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
     compressor_factory1->setExpectedCompressCalls(0);
-    auto config1 = std::make_shared<CompressorFilterConfig>(compressor, "test1.", stats1_, runtime_,
-                                                            std::move(compressor_factory1));
+    auto config1 = std::make_shared<CompressorFilterConfig>(
+        compressor, "test1.", stats1_, runtime_, std::move(compressor_factory1), nullptr);
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(R"EOF(
@@ -718,8 +1038,8 @@ protected:
                               compressor);
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
     compressor_factory2->setExpectedCompressCalls(0);
-    auto config2 = std::make_shared<CompressorFilterConfig>(compressor, "test2.", stats2_, runtime_,
-                                                            std::move(compressor_factory2));
+    auto config2 = std::make_shared<CompressorFilterConfig>(
+        compressor, "test2.", stats2_, runtime_, std::move(compressor_factory2), nullptr);
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
@@ -810,7 +1130,7 @@ TEST(CompressorFilterConfigTests, MakeCompressorTest) {
   EXPECT_CALL(*compressor_factory, statsPrefix());
   EXPECT_CALL(*compressor_factory, contentEncoding());
   CompressorFilterConfig config(compressor_cfg, "test.compressor.", stats, runtime,
-                                std::move(compressor_factory));
+                                std::move(compressor_factory), nullptr);
   Envoy::Compression::Compressor::CompressorPtr compressor = config.makeCompressor();
 }
 
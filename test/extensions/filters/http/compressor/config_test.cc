@@ -2,6 +2,7 @@
 
 #include "test/extensions/filters/http/compressor/mock_compressor_library.pb.h"
 #include "test/mocks/server/factory_context.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "gtest/gtest.h"
 
@@ -12,6 +13,7 @@ namespace Compressor {
 namespace {
 
 using testing::NiceMock;
+using testing::ReturnRef;
 
 const ::test::mock_compressor_library::Unregistered _mock_compressor_library_dummy;
 
@@ -33,6 +35,56 @@ TEST(CompressorFilterFactoryTests, UnregisteredCompressorLibraryConfig) {
                             "'test.mock_compressor_library.Unregistered'");
 }
 
+// Counts the threads created through it.
+class CountingThreadFactory : public Thread::ThreadFactory {
+public:
+  Thread::ThreadPtr createThread(std::function<void()> thread_routine,
+                                 Thread::OptionsOptConstRef options) override {
+    ++threads_created_;
+    return Thread::threadFactoryForTest().createThread(std::move(thread_routine), options);
+  }
+  Thread::ThreadId currentThreadId() override {
+    return Thread::threadFactoryForTest().currentThreadId();
+  }
+
+  uint32_t threads_created_{0};
+};
+
+// The filter configs offloading compression share a thread pool, with as many threads as the
+// config asking for the most.
+TEST(CompressorFilterFactoryTests, SharedOffloadThreadPool) {
+  const std::string yaml_string = R"EOF(
+  response_direction_config:
+    compression_offload:
+      thread_count: {}
+  compressor_library:
+    name: gzip
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip
+  )EOF";
+
+  CompressorFilterFactory factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CountingThreadFactory thread_factory;
+  ON_CALL(context.server_factory_context_.api_, threadFactory())
+      .WillByDefault(ReturnRef(thread_factory));
+  envoy::extensions::filters::http::compressor::v3::Compressor proto_config;
+  TestUtility::loadFromYaml(fmt::format(yaml_string, 2), proto_config);
+  Http::FilterFactoryCb first_cb =
+      factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  EXPECT_EQ(2, thread_factory.threads_created_);
+
+  TestUtility::loadFromYaml(fmt::format(yaml_string, 1), proto_config);
+  Http::FilterFactoryCb second_cb =
+      factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  EXPECT_EQ(2, thread_factory.threads_created_);
+
+  TestUtility::loadFromYaml(fmt::format(yaml_string, 3), proto_config);
+  Http::FilterFactoryCb third_cb =
+      factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  EXPECT_EQ(3, thread_factory.threads_created_);
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace HttpFilters
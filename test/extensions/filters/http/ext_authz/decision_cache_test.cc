@@ -0,0 +1,197 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+using Filters::Common::ExtAuthz::CheckStatus;
+using Filters::Common::ExtAuthz::Response;
+
+class DecisionCacheTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  void initialize(const std::string& yaml) {
+    envoy::extensions::filters::http::ext_authz::v3::DecisionCache config;
+    TestUtility::loadFromYamlAndValidate(yaml, config);
+    cache_ = std::make_unique<DecisionCache>(config, simTime());
+  }
+
+  std::string key(const Http::TestRequestHeaderMapImpl& headers) {
+    return cache_->key(headers, Protobuf::Map<std::string, std::string>());
+  }
+
+  static Response response(CheckStatus status, absl::optional<double> ttl = absl::nullopt) {
+    Response response{};
+    response.status = status;
+    if (ttl.has_value()) {
+      (*response.dynamic_metadata.mutable_fields())["ttl"] = ValueUtil::numberValue(ttl.value());
+    }
+    return response;
+  }
+
+  DecisionCachePtr cache_;
+};
+
+TEST_F(DecisionCacheTest, KeyHeaders) {
+  initialize(R"EOF(
+  key_headers: ["authorization", "x-tenant"]
+  ttl: 10s
+  )EOF");
+
+  EXPECT_EQ(key({{"authorization", "a"}, {"x-tenant", "b"}, {"x-other", "c"}}),
+            key({{"x-tenant", "b"}, {"authorization", "a"}}));
+  EXPECT_NE(key({{"authorization", "a"}, {"x-tenant", "b"}}),
+            key({{"authorization", "a"}, {"x-tenant", "c"}}));
+  // A missing header differs from an empty one, and values are not confused with each other.
+  EXPECT_NE(key({{"authorization", "a"}}), key({{"authorization", "a"}, {"x-tenant", ""}}));
+  EXPECT_NE(key({{"authorization", "a,b"}}),
+            key({{"authorization", "a"}, {"authorization", "b"}}));
+  EXPECT_NE(key({{"authorization", "ab"}}), key({{"authorization", "a"}, {"x-tenant", "b"}}));
+}
+
+// The authority and the method of the requests are part of the key.
+TEST_F(DecisionCacheTest, KeyAuthorityAndMethod) {
+  initialize(R"EOF(
+  key_headers: ["authorization"]
+  ttl: 10s
+  )EOF");
+
+  EXPECT_EQ(key({{":authority", "a.com"}, {":method", "GET"}, {"authorization", "a"}}),
+            key({{":authority", "a.com"}, {":method", "GET"}, {"authorization", "a"}}));
+  EXPECT_NE(key({{":authority", "a.com"}, {":method", "GET"}, {"authorization", "a"}}),
+            key({{":authority", "b.com"}, {":method", "GET"}, {"authorization", "a"}}));
+  EXPECT_NE(key({{":authority", "a.com"}, {":method", "GET"}, {"authorization", "a"}}),
+            key({{":authority", "a.com"}, {":method", "POST"}, {"authorization", "a"}}));
+}
+
+// A cache key must depend on at least one header of the requests.
+TEST_F(DecisionCacheTest, KeyHeadersRequired) {
+  EXPECT_THROW(initialize(R"EOF(
+  path_segments: 2
+  ttl: 10s
+  )EOF"),
+               ProtoValidationException);
+}
+
+TEST_F(DecisionCacheTest, KeyPathSegments) {
+  initialize(R"EOF(
+  key_headers: ["authorization"]
+  path_segments: 2
+  ttl: 10s
+  )EOF");
+
+  EXPECT_EQ(key({{":path", "/api/v1/users?id=1"}}), key({{":path", "/api/v1/groups"}}));
+  EXPECT_EQ(key({{":path", "/api/v1"}}), key({{":path", "/api/v1/"}}));
+  EXPECT_NE(key({{":path", "/api/v1/users"}}), key({{":path", "/api/v2/users"}}));
+  EXPECT_NE(key({{":path", "/api"}}), key({{":path", "/api/v1"}}));
+  EXPECT_EQ(key({{":path", "/api?v1/users"}}), key({{":path", "/api"}}));
+}
+
+TEST_F(DecisionCacheTest, KeyContextExtensions) {
+  initialize(R"EOF(
+  key_headers: ["authorization"]
+  ttl: 10s
+  )EOF");
+
+  Protobuf::Map<std::string, std::string> context_extensions;
+  context_extensions["a"] = "1";
+  context_extensions["b"] = "2";
+  Protobuf::Map<std::string, std::string> other_context_extensions;
+  other_context_extensions["b"] = "2";
+  other_context_extensions["a"] = "1";
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_EQ(cache_->key(headers, context_extensions),
+            cache_->key(headers, other_context_extensions));
+  other_context_extensions["a"] = "3";
+  EXPECT_NE(cache_->key(headers, context_extensions),
+            cache_->key(headers, other_context_extensions));
+}
+
+TEST_F(DecisionCacheTest, Ttl) {
+  initialize(R"EOF(
+  key_headers: ["authorization"]
+  ttl: 10s
+  ttl_metadata_key: ttl
+  )EOF");
+
+  cache_->insert("ok", response(CheckStatus::OK));
+  cache_->insert("denied", response(CheckStatus::Denied));
+  cache_->insert("denied_with_ttl", response(CheckStatus::Denied, 2));
+  cache_->insert("ok_with_ttl", response(CheckStatus::OK, 0.5));
+  cache_->insert("ok_with_zero_ttl", response(CheckStatus::OK, 0));
+  cache_->insert("error", response(CheckStatus::Error, 10));
+  EXPECT_EQ(3U, cache_->size());
+
+  EXPECT_EQ(CheckStatus::OK, cache_->lookup("ok")->status);
+  EXPECT_EQ(CheckStatus::Denied, cache_->lookup("denied_with_ttl")->status);
+  EXPECT_NE(nullptr, cache_->lookup("ok_with_ttl"));
+  EXPECT_EQ(nullptr, cache_->lookup("denied"));
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(500));
+  EXPECT_EQ(nullptr, cache_->lookup("ok_with_ttl"));
+  simTime().advanceTimeWait(std::chrono::milliseconds(1500));
+  EXPECT_EQ(nullptr, cache_->lookup("denied_with_ttl"));
+  EXPECT_NE(nullptr, cache_->lookup("ok"));
+  simTime().advanceTimeWait(std::chrono::seconds(8));
+  EXPECT_EQ(nullptr, cache_->lookup("ok"));
+  EXPECT_EQ(0U, cache_->size());
+}
+
+TEST_F(DecisionCacheTest, DeniedTtl) {
+  initialize(R"EOF(
+  key_headers: ["authorization"]
+  ttl: 10s
+  denied_ttl: 1s
+  )EOF");
+
+  cache_->insert("denied", response(CheckStatus::Denied));
+  EXPECT_EQ(CheckStatus::Denied, cache_->lookup("denied")->status);
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache_->lookup("denied"));
+}
+
+TEST_F(DecisionCacheTest, MaxEntries) {
+  initialize(R"EOF(
+  key_headers: ["authorization"]
+  ttl: 10s
+  denied_ttl: 1s
+  max_entries: 2
+  )EOF");
+
+  cache_->insert("a", response(CheckStatus::Denied));
+  cache_->insert("b", response(CheckStatus::OK));
+  // Updating a cached decision does not evict another one.
+  cache_->insert("b", response(CheckStatus::OK));
+  EXPECT_NE(nullptr, cache_->lookup("a"));
+
+  // The expired decision is swept to make room for the new one.
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  cache_->insert("c", response(CheckStatus::OK));
+  EXPECT_EQ(2U, cache_->size());
+  EXPECT_NE(nullptr, cache_->lookup("b"));
+  EXPECT_NE(nullptr, cache_->lookup("c"));
+
+  // Without expired decisions, one of them is evicted.
+  cache_->insert("d", response(CheckStatus::OK));
+  EXPECT_EQ(2U, cache_->size());
+  EXPECT_NE(nullptr, cache_->lookup("d"));
+}
+
+} // namespace
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
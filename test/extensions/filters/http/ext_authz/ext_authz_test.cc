@@ -26,6 +26,7 @@
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -55,7 +56,7 @@ public:
       TestUtility::loadFromYaml(yaml, proto_config);
     }
     config_.reset(new FilterConfig(proto_config, stats_store_, runtime_, http_context_,
-                                   "ext_authz_prefix", bootstrap_));
+                                   "ext_authz_prefix", bootstrap_, time_system_));
     client_ = new Filters::Common::ExtAuthz::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
@@ -71,6 +72,7 @@ public:
 
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   envoy::config::bootstrap::v3::Bootstrap bootstrap_;
+  Event::SimulatedTimeSystem time_system_;
   FilterConfigSharedPtr config_;
   Filters::Common::ExtAuthz::MockClient* client_;
   std::unique_ptr<Filter> filter_;
@@ -2106,6 +2108,152 @@ TEST_F(HttpFilterTest, EmittingMetadataWhenError) {
       filter_callbacks_.clusterInfo()->statsScope().counterFromString("ext_authz.error").value());
 }
 
+// Test that a cached decision is applied to the requests with the same key without calling the
+// authorization service.
+TEST_F(HttpFilterTest, DecisionCacheHit) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: ["authorization"]
+    ttl: 10s
+  )EOF");
+
+  prepareCheck();
+  request_headers_.addCopy(Http::CustomHeaders::get().Authorization, "token");
+  EXPECT_CALL(*client_, check(_, _, _, _))
+      .WillOnce(
+          Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                     const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                     const StreamInfo::StreamInfo&) -> void { request_callbacks_ = &callbacks; }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, false));
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  response.headers_to_set = Http::HeaderVector{{Http::LowerCaseString{"x-user"}, "user"}};
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+  EXPECT_EQ(1U, config_->stats().decision_cache_miss_.value());
+
+  // Another request with the same key gets the cached decision.
+  client_ = new Filters::Common::ExtAuthz::MockClient();
+  filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+  filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  Http::TestRequestHeaderMapImpl request_headers{{"authorization", "token"}};
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ("user", request_headers.get_("x-user"));
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+
+  // The decision expires.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  client_ = new Filters::Common::ExtAuthz::MockClient();
+  filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+  filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  EXPECT_CALL(*client_, check(_, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(2U, config_->stats().decision_cache_miss_.value());
+}
+
+// Test that a denied decision is cached with its TTL, and replies to the next request with the
+// same key.
+TEST_F(HttpFilterTest, DecisionCacheDenied) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: ["authorization"]
+    ttl: 10s
+    denied_ttl: 1s
+  )EOF");
+
+  prepareCheck();
+  request_headers_.addCopy(Http::CustomHeaders::get().Authorization, "token");
+  EXPECT_CALL(*client_, check(_, _, _, _))
+      .WillOnce(
+          Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                     const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                     const StreamInfo::StreamInfo&) -> void { request_callbacks_ = &callbacks; }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, false));
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Denied;
+  response.status_code = Http::Code::Unauthorized;
+  EXPECT_CALL(filter_callbacks_, sendLocalReply(Http::Code::Unauthorized, _, _, _, _));
+  request_callbacks_->onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+
+  client_ = new Filters::Common::ExtAuthz::MockClient();
+  filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+  filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  Http::TestRequestHeaderMapImpl request_headers{{"authorization", "token"}};
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_CALL(filter_callbacks_, sendLocalReply(Http::Code::Unauthorized, _, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(2U, config_->stats().denied_.value());
+
+  // A request with another key calls the authorization service.
+  client_ = new Filters::Common::ExtAuthz::MockClient();
+  filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+  filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  Http::TestRequestHeaderMapImpl other_request_headers{{"authorization", "other_token"}};
+  EXPECT_CALL(*client_, check(_, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(other_request_headers, false));
+}
+
+// Test that errors are not cached.
+TEST_F(HttpFilterTest, DecisionCacheError) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  failure_mode_allow: true
+  decision_cache:
+    key_headers: ["authorization"]
+    ttl: 10s
+  )EOF");
+
+  prepareCheck();
+  EXPECT_CALL(*client_, check(_, _, _, _))
+      .WillOnce(
+          Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                     const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                     const StreamInfo::StreamInfo&) -> void {
+            Filters::Common::ExtAuthz::Response response{};
+            response.status = Filters::Common::ExtAuthz::CheckStatus::Error;
+            callbacks.onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+          }));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(0U, config_->decisionCache()->size());
+}
+
+// Test that the decision cache is rejected with request body buffering.
+TEST_F(HttpFilterTest, DecisionCacheWithRequestBody) {
+  EXPECT_THROW_WITH_MESSAGE(initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  with_request_body:
+    max_request_bytes: 10
+  decision_cache:
+    key_headers: ["authorization"]
+    ttl: 10s
+  )EOF"),
+                            EnvoyException,
+                            "ext_authz decision_cache is not supported with with_request_body");
+}
+
 // Test that when a connection awaiting a authorization response is canceled then the
 // authorization call is closed.
 TEST_P(HttpFilterTestParam, ResetDuringCall) {
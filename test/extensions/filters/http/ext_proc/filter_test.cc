@@ -1,3 +1,8 @@
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "envoy/service/ext_proc/v3alpha/external_processor.pb.h"
 
 #include "source/extensions/filters/http/ext_proc/ext_proc.h"
@@ -78,6 +83,13 @@ protected:
   }
 
   void doSend(ProcessingRequest&& request, Unused) {
+    if (request.has_request_body() || request.has_response_body()) {
+      if (pipelined_bodies_) {
+        // Streamed body chunks are sent before the responses to the previous ones arrive.
+        body_requests_.push_back(std::move(request));
+        return;
+      }
+    }
     ASSERT_TRUE(last_request_processed_);
     last_request_ = std::move(request);
     last_request_processed_ = false;
@@ -181,11 +193,59 @@ protected:
     stream_callbacks_->onReceiveMessage(std::move(response));
   }
 
+  // Expect the oldest streamed request_body request in flight, and send back a valid response
+  void processStreamedRequestBody(
+      absl::optional<std::function<void(const HttpBody&, ProcessingResponse&, BodyResponse&)>> cb) {
+    ASSERT_FALSE(body_requests_.empty());
+    const ProcessingRequest request = std::move(body_requests_.front());
+    body_requests_.pop_front();
+    ASSERT_TRUE(request.has_request_body());
+    auto response = std::make_unique<ProcessingResponse>();
+    auto* body_response = response->mutable_request_body();
+    if (cb) {
+      (*cb)(request.request_body(), *response, *body_response);
+    }
+    stream_callbacks_->onReceiveMessage(std::move(response));
+  }
+
+  // Expect the oldest streamed response_body request in flight, and send back a valid response
+  void processStreamedResponseBody(
+      absl::optional<std::function<void(const HttpBody&, ProcessingResponse&, BodyResponse&)>> cb) {
+    ASSERT_FALSE(body_requests_.empty());
+    const ProcessingRequest request = std::move(body_requests_.front());
+    body_requests_.pop_front();
+    ASSERT_TRUE(request.has_response_body());
+    auto response = std::make_unique<ProcessingResponse>();
+    auto* body_response = response->mutable_response_body();
+    if (cb) {
+      (*cb)(request.response_body(), *response, *body_response);
+    }
+    stream_callbacks_->onReceiveMessage(std::move(response));
+  }
+
+  // Record the body chunks that the filter injects into the filter chain after streaming them.
+  void setUpStreamedBodyInjection() {
+    EXPECT_CALL(decoder_callbacks_, injectDecodedDataToFilterChain(_, _))
+        .WillRepeatedly(Invoke([this](Buffer::Instance& data, bool end_stream) {
+          injected_request_data_.emplace_back(data.toString(), end_stream);
+          data.drain(data.length());
+        }));
+    EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, _))
+        .WillRepeatedly(Invoke([this](Buffer::Instance& data, bool end_stream) {
+          injected_response_data_.emplace_back(data.toString(), end_stream);
+          data.drain(data.length());
+        }));
+  }
+
   std::unique_ptr<MockClient> client_;
   ExternalProcessorCallbacks* stream_callbacks_ = nullptr;
   ProcessingRequest last_request_;
   bool last_request_processed_ = true;
   bool server_closed_stream_ = false;
+  bool pipelined_bodies_ = false;
+  std::deque<ProcessingRequest> body_requests_;
+  std::vector<std::pair<std::string, bool>> injected_request_data_;
+  std::vector<std::pair<std::string, bool>> injected_response_data_;
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   FilterConfigSharedPtr config_;
   std::unique_ptr<Filter> filter_;
@@ -826,9 +886,9 @@ TEST_F(HttpFilterTest, PostAndChangeBothBodiesBufferedMultiChunk) {
 }
 
 // Using a configuration with streaming set for the request and
-// response bodies, we should ignore a "buffered" body mode for now
-// because it is not implemented.
-TEST_F(HttpFilterTest, PostAndIgnoreStreamedBodiesUntilImplemented) {
+// response bodies, test the filter with a processor that changes the
+// chunks, and whose responses arrive after all the chunks were sent.
+TEST_F(HttpFilterTest, PostAndChangeStreamedBodies) {
   initialize(R"EOF(
   grpc_service:
     envoy_grpc:
@@ -841,19 +901,45 @@ TEST_F(HttpFilterTest, PostAndIgnoreStreamedBodiesUntilImplemented) {
     request_trailer_mode: "SKIP"
     response_trailer_mode: "SKIP"
   )EOF");
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
 
   // Create synthetic HTTP request
   HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
   request_headers_.addCopy(LowerCaseString("content-type"), "text/plain");
-  request_headers_.addCopy(LowerCaseString("content-length"), 100);
+  request_headers_.addCopy(LowerCaseString("content-length"), 9);
 
   EXPECT_EQ(FilterHeadersStatus::StopIteration, filter_->decodeHeaders(request_headers_, false));
   processRequestHeaders(false, absl::nullopt);
 
-  Buffer::OwnedImpl req_data;
-  TestUtility::feedBufferWithRandomCharacters(req_data, 100);
-  EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(req_data, true));
-  EXPECT_EQ(FilterTrailersStatus::Continue, filter_->decodeTrailers(request_trailers_));
+  Buffer::OwnedImpl req_data_1("foo");
+  Buffer::OwnedImpl req_data_2("bar");
+  Buffer::OwnedImpl req_data_3("baz");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_1, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_3, true));
+
+  // All the chunks are in flight, and none was passed on yet.
+  ASSERT_EQ(3, body_requests_.size());
+  EXPECT_TRUE(injected_request_data_.empty());
+
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse& resp) {
+    EXPECT_FALSE(req_body.end_of_stream());
+    EXPECT_EQ("foo", req_body.body());
+    resp.mutable_response()->mutable_body_mutation()->set_body("FOO");
+  });
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_FALSE(req_body.end_of_stream());
+    EXPECT_EQ("bar", req_body.body());
+  });
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse& resp) {
+    EXPECT_TRUE(req_body.end_of_stream());
+    EXPECT_EQ("baz", req_body.body());
+    resp.mutable_response()->mutable_body_mutation()->set_clear_body(true);
+  });
+  EXPECT_THAT(injected_request_data_,
+              testing::ElementsAre(std::make_pair("FOO", false), std::make_pair("bar", false),
+                                   std::make_pair("", true)));
 
   response_headers_.addCopy(LowerCaseString(":status"), "200");
   response_headers_.addCopy(LowerCaseString("content-type"), "text/plain");
@@ -865,14 +951,308 @@ TEST_F(HttpFilterTest, PostAndIgnoreStreamedBodiesUntilImplemented) {
 
   Buffer::OwnedImpl resp_data;
   TestUtility::feedBufferWithRandomCharacters(resp_data, 100);
-  EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(resp_data, true));
+  const std::string resp_body = resp_data.toString();
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(resp_data, true));
+  processStreamedResponseBody(
+      [&resp_body](const HttpBody& resp_body_req, ProcessingResponse&, BodyResponse&) {
+        EXPECT_TRUE(resp_body_req.end_of_stream());
+        EXPECT_EQ(resp_body, resp_body_req.body());
+      });
+  EXPECT_THAT(injected_response_data_, testing::ElementsAre(std::make_pair(resp_body, true)));
 
   EXPECT_EQ(FilterTrailersStatus::Continue, filter_->encodeTrailers(response_trailers_));
   filter_->onDestroy();
 
   EXPECT_EQ(1, config_->stats().streams_started_.value());
+  EXPECT_EQ(6, config_->stats().stream_msgs_sent_.value());
+  EXPECT_EQ(6, config_->stats().stream_msgs_received_.value());
+  EXPECT_EQ(1, config_->stats().streams_closed_.value());
+}
+
+// Using a configuration with streaming set for the request body, test
+// the filter when part of the body arrives before the response to the
+// request headers.
+TEST_F(HttpFilterTest, PostAndStreamRequestBodyComesFast) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_body_mode: "STREAMED"
+    response_header_mode: "SKIP"
+  )EOF");
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::StopIteration, filter_->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl req_data_1("Hello");
+  Buffer::OwnedImpl req_data_2(", World!");
+  Buffer::OwnedImpl buffered_data;
+  setUpDecodingBuffering(buffered_data);
+
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterAboveWriteBufferHighWatermark());
+  EXPECT_EQ(FilterDataStatus::StopIterationAndWatermark, filter_->decodeData(req_data_1, false));
+  buffered_data.add(req_data_1);
+
+  // The data buffered so far is streamed once the headers are continued.
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterBelowWriteBufferLowWatermark());
+  processRequestHeaders(false, absl::nullopt);
+  EXPECT_EQ(0, buffered_data.length());
+  ASSERT_EQ(1, body_requests_.size());
+
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, true));
+  ASSERT_EQ(2, body_requests_.size());
+
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_FALSE(req_body.end_of_stream());
+    EXPECT_EQ("Hello", req_body.body());
+  });
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_TRUE(req_body.end_of_stream());
+    EXPECT_EQ(", World!", req_body.body());
+  });
+  EXPECT_THAT(injected_request_data_, testing::ElementsAre(std::make_pair("Hello", false),
+                                                           std::make_pair(", World!", true)));
+
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers_, true));
+  filter_->onDestroy();
+
+  EXPECT_EQ(3, config_->stats().stream_msgs_sent_.value());
+  EXPECT_EQ(3, config_->stats().stream_msgs_received_.value());
+}
+
+// Using a configuration that limits the streamed chunks in flight, test
+// that the body data received meanwhile is coalesced into the next chunk,
+// and that the filter watermarks while too much of it is held.
+TEST_F(HttpFilterTest, StreamedBodyMaxChunksInFlight) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+    response_header_mode: "SKIP"
+  max_streamed_chunks_in_flight: 2
+  )EOF");
+  EXPECT_EQ(2, config_->maxStreamedChunksInFlight());
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
+  EXPECT_CALL(decoder_callbacks_, decoderBufferLimit()).WillRepeatedly(Return(10));
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl req_data_1("aaaa");
+  Buffer::OwnedImpl req_data_2("bbbb");
+  Buffer::OwnedImpl req_data_3("cccc");
+  Buffer::OwnedImpl req_data_4("dddd");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_1, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, false));
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterAboveWriteBufferHighWatermark());
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_3, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_4, true));
+  ASSERT_EQ(2, body_requests_.size());
+
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_EQ("aaaa", req_body.body());
+  });
+  // The held data follows as a single chunk.
+  ASSERT_EQ(2, body_requests_.size());
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_EQ("bbbb", req_body.body());
+  });
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterBelowWriteBufferLowWatermark());
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_TRUE(req_body.end_of_stream());
+    EXPECT_EQ("ccccdddd", req_body.body());
+  });
+  EXPECT_THAT(injected_request_data_,
+              testing::ElementsAre(std::make_pair("aaaa", false), std::make_pair("bbbb", false),
+                                   std::make_pair("ccccdddd", true)));
+  filter_->onDestroy();
+
+  EXPECT_EQ(3, config_->stats().stream_msgs_sent_.value());
+  EXPECT_EQ(3, config_->stats().stream_msgs_received_.value());
+}
+
+// Using a configuration with a minimum streamed chunk size, test that small
+// body chunks are coalesced before they are sent.
+TEST_F(HttpFilterTest, StreamedBodyCoalesceSmallChunks) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+    response_header_mode: "SKIP"
+  streamed_chunk_min_bytes: 10
+  )EOF");
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl req_data_1("abcd");
+  Buffer::OwnedImpl req_data_2("efgh");
+  Buffer::OwnedImpl req_data_3("ijkl");
+  Buffer::OwnedImpl req_data_4("mn");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_1, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, false));
+  EXPECT_TRUE(body_requests_.empty());
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_3, false));
+  ASSERT_EQ(1, body_requests_.size());
+  // The end of the body is sent even if it is small.
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_4, true));
+  ASSERT_EQ(2, body_requests_.size());
+
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_FALSE(req_body.end_of_stream());
+    EXPECT_EQ("abcdefghijkl", req_body.body());
+  });
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_TRUE(req_body.end_of_stream());
+    EXPECT_EQ("mn", req_body.body());
+  });
+  EXPECT_THAT(injected_request_data_, testing::ElementsAre(std::make_pair("abcdefghijkl", false),
+                                                           std::make_pair("mn", true)));
+  filter_->onDestroy();
+}
+
+// Using a configuration with a minimum streamed chunk size above the buffer
+// limit, test that the data is sent once half of the limit is held, rather
+// than stalling behind the watermark.
+TEST_F(HttpFilterTest, StreamedBodyCoalesceAboveBufferLimit) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+    response_header_mode: "SKIP"
+  streamed_chunk_min_bytes: 100
+  )EOF");
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
+  EXPECT_CALL(decoder_callbacks_, decoderBufferLimit()).WillRepeatedly(Return(10));
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterAboveWriteBufferHighWatermark()).Times(0);
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl req_data_1("abc");
+  Buffer::OwnedImpl req_data_2("def");
+  Buffer::OwnedImpl req_data_3("gh");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_1, false));
+  EXPECT_TRUE(body_requests_.empty());
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, false));
+  ASSERT_EQ(1, body_requests_.size());
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_3, true));
+  ASSERT_EQ(2, body_requests_.size());
+
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_FALSE(req_body.end_of_stream());
+    EXPECT_EQ("abcdef", req_body.body());
+  });
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_TRUE(req_body.end_of_stream());
+    EXPECT_EQ("gh", req_body.body());
+  });
+  EXPECT_THAT(injected_request_data_, testing::ElementsAre(std::make_pair("abcdef", false),
+                                                           std::make_pair("gh", true)));
+  filter_->onDestroy();
+}
+
+// Using a configuration with streaming set for the request body and trailers
+// sent, test that the trailers are held until the last chunk is processed.
+TEST_F(HttpFilterTest, StreamedBodyWithTrailers) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+    request_trailer_mode: "SEND"
+    response_header_mode: "SKIP"
+  streamed_chunk_min_bytes: 100
+  )EOF");
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl req_data("foo");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data, false));
+  EXPECT_TRUE(body_requests_.empty());
+
+  // The trailers end the body, so the data held for coalescing is sent.
+  request_trailers_.addCopy(LowerCaseString("x-trailer"), "yes");
+  EXPECT_EQ(FilterTrailersStatus::StopIteration, filter_->decodeTrailers(request_trailers_));
+  ASSERT_EQ(1, body_requests_.size());
+
+  processStreamedRequestBody([](const HttpBody& req_body, ProcessingResponse&, BodyResponse&) {
+    EXPECT_FALSE(req_body.end_of_stream());
+    EXPECT_EQ("foo", req_body.body());
+  });
+  EXPECT_THAT(injected_request_data_, testing::ElementsAre(std::make_pair("foo", false)));
+
+  ASSERT_FALSE(last_request_processed_);
+  ASSERT_TRUE(last_request_.has_request_trailers());
+  auto response = std::make_unique<ProcessingResponse>();
+  response->mutable_request_trailers();
+  last_request_processed_ = true;
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  stream_callbacks_->onReceiveMessage(std::move(response));
+  filter_->onDestroy();
+
   EXPECT_EQ(2, config_->stats().stream_msgs_sent_.value());
   EXPECT_EQ(2, config_->stats().stream_msgs_received_.value());
+}
+
+// Using a configuration with streaming set for the request body, test that
+// the chunks in flight are passed on unmodified and in order when the
+// stream to the processor is closed.
+TEST_F(HttpFilterTest, StreamedBodyAndClose) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+    response_header_mode: "SKIP"
+  max_streamed_chunks_in_flight: 1
+  )EOF");
+  pipelined_bodies_ = true;
+  setUpStreamedBodyInjection();
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl req_data_1("foo");
+  Buffer::OwnedImpl req_data_2("bar");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_1, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, false));
+  ASSERT_EQ(1, body_requests_.size());
+
+  server_closed_stream_ = true;
+  stream_callbacks_->onGrpcClose();
+  EXPECT_THAT(injected_request_data_,
+              testing::ElementsAre(std::make_pair("foo", false), std::make_pair("bar", false)));
+
+  // The rest of the body is not streamed any more.
+  Buffer::OwnedImpl req_data_3("baz");
+  EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(req_data_3, true));
+  filter_->onDestroy();
+
+  EXPECT_EQ(1, config_->stats().stream_msgs_sent_.value());
   EXPECT_EQ(1, config_->stats().streams_closed_.value());
 }
 
@@ -0,0 +1,149 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/extensions/filters/http/ext_proc/v3alpha/ext_proc.pb.h"
+#include "envoy/service/ext_proc/v3alpha/external_processor.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/ext_proc/ext_proc.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+namespace {
+
+using envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode;
+using envoy::service::ext_proc::v3alpha::ProcessingRequest;
+using envoy::service::ext_proc::v3alpha::ProcessingResponse;
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+constexpr uint32_t ChunkCount = 64;
+constexpr uint32_t ChunkSize = 1024;
+// The number of ticks it takes the processor to reply to a message, while one body chunk arrives
+// per tick.
+constexpr uint32_t ProcessorLatency = 4;
+
+// A processor that replies to every body message ProcessorLatency ticks after it was sent,
+// without modifying the body.
+class FakeProcessor : public ExternalProcessorClient {
+public:
+  class Stream : public ExternalProcessorStream {
+  public:
+    explicit Stream(FakeProcessor& processor) : processor_(processor) {}
+
+    void send(ProcessingRequest&& request, bool) override {
+      processor_.requests_.emplace_back(processor_.now_, std::move(request));
+    }
+    bool close() override { return true; }
+
+  private:
+    FakeProcessor& processor_;
+  };
+
+  ExternalProcessorStreamPtr start(ExternalProcessorCallbacks& callbacks) override {
+    callbacks_ = &callbacks;
+    return std::make_unique<Stream>(*this);
+  }
+
+  void tick() {
+    ++now_;
+    while (!requests_.empty() && requests_.front().first + ProcessorLatency <= now_) {
+      const bool request_body = requests_.front().second.has_request_body();
+      requests_.pop_front();
+      auto response = std::make_unique<ProcessingResponse>();
+      if (request_body) {
+        response->mutable_request_body();
+      } else {
+        response->mutable_response_body();
+      }
+      callbacks_->onReceiveMessage(std::move(response));
+    }
+  }
+
+private:
+  ExternalProcessorCallbacks* callbacks_{};
+  uint64_t now_{};
+  std::deque<std::pair<uint64_t, ProcessingRequest>> requests_;
+};
+
+// Streams a request body through the filter to the fake processor, with the maximum number of
+// chunks in flight and the minimum chunk size in the arguments. The ticks it takes to pass the
+// whole body on measure the latency added by the processor, and the time of an iteration the
+// overhead of the filter.
+void bmStreamedRequestBody(benchmark::State& state) {
+  envoy::extensions::filters::http::ext_proc::v3alpha::ExternalProcessor proto_config;
+  auto* processing_mode = proto_config.mutable_processing_mode();
+  processing_mode->set_request_header_mode(ProcessingMode::SKIP);
+  processing_mode->set_response_header_mode(ProcessingMode::SKIP);
+  processing_mode->set_request_body_mode(ProcessingMode::STREAMED);
+  proto_config.mutable_max_streamed_chunks_in_flight()->set_value(state.range(0));
+  proto_config.set_streamed_chunk_min_bytes(state.range(1));
+  Stats::IsolatedStoreImpl stats_store;
+  auto config = std::make_shared<FilterConfig>(proto_config, std::chrono::milliseconds(200),
+                                               stats_store, "");
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+  uint64_t injected_bytes = 0;
+  ON_CALL(decoder_callbacks, injectDecodedDataToFilterChain(_, _))
+      .WillByDefault(Invoke([&injected_bytes](Buffer::Instance& data, bool) {
+        injected_bytes += data.length();
+        data.drain(data.length());
+      }));
+
+  Http::TestRequestHeaderMapImpl headers{
+      {":method", "POST"}, {":path", "/"}, {":authority", "host"}};
+  const std::string chunk(ChunkSize, 'a');
+  uint64_t ticks = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto client = std::make_unique<FakeProcessor>();
+    FakeProcessor& processor = *client;
+    Filter filter(config, std::move(client));
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+    filter.decodeHeaders(headers, false);
+
+    injected_bytes = 0;
+    for (uint32_t tick = 0; injected_bytes < ChunkCount * ChunkSize; ++tick) {
+      if (tick < ChunkCount) {
+        Buffer::OwnedImpl data(chunk);
+        filter.decodeData(data, tick + 1 == ChunkCount);
+      }
+      processor.tick();
+      ++ticks;
+    }
+    filter.onDestroy();
+  }
+
+  state.counters["ticks_per_body"] =
+      benchmark::Counter(ticks, benchmark::Counter::kAvgIterations);
+  state.counters["messages_per_body"] = benchmark::Counter(
+      config->stats().stream_msgs_sent_.value(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(bmStreamedRequestBody)
+    ->Args({1, 0})
+    ->Args({8, 0})
+    ->Args({64, 0})
+    ->Args({1, 8 * ChunkSize})
+    ->Args({8, 8 * ChunkSize});
+
+} // namespace
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,132 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/grpc_json_transcoder/v3/transcoder.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/grpc_json_transcoder/json_transcoder_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+// The size of the body chunks read from the downstream connection.
+constexpr uint64_t ChunkSize = 16 * 1024;
+
+class TranscoderBenchmark {
+public:
+  TranscoderBenchmark() : api_(Api::createApiForTest()) {
+    envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder proto_config;
+    proto_config.set_proto_descriptor(
+        TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"));
+    proto_config.add_services("bookstore.Bookstore");
+    config_ = std::make_unique<JsonTranscoderConfig>(proto_config, *api_);
+
+    ON_CALL(decoder_callbacks_, decoderBufferLimit())
+        .WillByDefault(Return(std::numeric_limits<uint32_t>::max()));
+    ON_CALL(decoder_callbacks_, addDecodedData(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) {
+          upstream_bytes_ += data.length();
+          data.drain(data.length());
+        }));
+  }
+
+  // Runs a request through a new filter in chunks of ChunkSize, and returns the number of bytes
+  // forwarded upstream before its last chunk arrived.
+  uint64_t transcode(Http::TestRequestHeaderMapImpl headers, const std::string& body) {
+    JsonTranscoderFilter filter(*config_);
+    filter.setDecoderFilterCallbacks(decoder_callbacks_);
+    filter.decodeHeaders(headers, false);
+
+    upstream_bytes_ = 0;
+    uint64_t bytes_before_end = 0;
+    for (uint64_t offset = 0; offset < body.size(); offset += ChunkSize) {
+      const bool end_stream = offset + ChunkSize >= body.size();
+      if (end_stream) {
+        bytes_before_end = upstream_bytes_;
+      }
+      Buffer::OwnedImpl data(absl::string_view(body).substr(offset, ChunkSize));
+      filter.decodeData(data, end_stream);
+      upstream_bytes_ += data.length();
+    }
+    return bytes_before_end;
+  }
+
+private:
+  Api::ApiPtr api_;
+  std::unique_ptr<JsonTranscoderConfig> config_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  uint64_t upstream_bytes_{};
+};
+
+void payloadSizes(benchmark::internal::Benchmark* b) {
+  for (int64_t size : {1 << 10, 64 << 10, 1 << 20, 50 << 20}) {
+    b->Arg(size);
+  }
+}
+
+// A unary JSON request of the size in the argument. The message is only complete, and sent
+// upstream, once the whole body has been parsed.
+void bmJsonRequest(benchmark::State& state) {
+  TranscoderBenchmark transcoder;
+  const uint64_t size = state.range(0);
+  const std::string body = absl::StrCat(R"({"theme":")", std::string(size, 'a'), R"("})");
+  uint64_t bytes_before_end = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    bytes_before_end += transcoder.transcode(
+        {{":method", "POST"}, {":path", "/shelf"}, {"content-type", "application/json"}}, body);
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+  state.counters["bytes_before_end"] =
+      benchmark::Counter(bytes_before_end, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(bmJsonRequest)->Apply(payloadSizes)->Unit(benchmark::kMicrosecond);
+
+// A unary HttpBody request of the size in the argument, streamed upstream as it arrives when its
+// content-length is known, and buffered otherwise.
+void bmHttpBodyRequest(benchmark::State& state, bool content_length) {
+  TranscoderBenchmark transcoder;
+  const uint64_t size = state.range(0);
+  const std::string body(size, 'a');
+  Http::TestRequestHeaderMapImpl headers{
+      {":method", "POST"}, {":path", "/postBody?arg=hi"}, {"content-type", "text/plain"}};
+  if (content_length) {
+    headers.setContentLength(size);
+  }
+  uint64_t bytes_before_end = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    bytes_before_end += transcoder.transcode(headers, body);
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+  state.counters["bytes_before_end"] =
+      benchmark::Counter(bytes_before_end, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_CAPTURE(bmHttpBodyRequest, buffered, false)
+    ->Apply(payloadSizes)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(bmHttpBodyRequest, streamed, true)
+    ->Apply(payloadSizes)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,66 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "source/common/tracing/http_tracer_impl.h"
+#include "source/extensions/filters/http/jwt_authn/authenticator.h"
+#include "source/extensions/filters/http/jwt_authn/filter_config.h"
+
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using ::google::jwt_verify::Status;
+using ::testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+// Verifies the same token with a local JWKS, with the Jwt cache enabled in the argument. Without
+// the cache, every request pays for the signature verification.
+void bmVerifyGoodToken(benchmark::State& state) {
+  envoy::extensions::filters::http::jwt_authn::v3::JwtAuthentication proto_config;
+  TestUtility::loadFromYaml(ExampleConfig, proto_config);
+  auto& provider = (*proto_config.mutable_providers())[std::string(ProviderName)];
+  provider.mutable_local_jwks()->set_inline_string(PublicKey);
+  if (state.range(0) != 0) {
+    provider.mutable_jwt_cache_config();
+  }
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  auto filter_config = std::make_unique<FilterConfigImpl>(proto_config, "", context);
+  auto authenticator = Authenticator::create(
+      nullptr, std::string(ProviderName), false, false, filter_config->getJwksCache(),
+      filter_config->cm(), [](Upstream::ClusterManager&) { return nullptr; },
+      filter_config->timeSource());
+  ExtractorConstPtr extractor = Extractor::create(provider);
+
+  const std::string authorization = "Bearer " + std::string(GoodToken);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Http::TestRequestHeaderMapImpl headers{{"Authorization", authorization}};
+    bool verified = false;
+    authenticator->verify(headers, Tracing::NullSpan::instance(), extractor->extract(headers),
+                          nullptr,
+                          [&verified](const Status& status) { verified = status == Status::Ok; });
+    if (!verified) {
+      state.SkipWithError("JWT verification failed");
+      break;
+    }
+  }
+}
+BENCHMARK(bmVerifyGoodToken)->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
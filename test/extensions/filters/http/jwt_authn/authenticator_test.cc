@@ -112,6 +112,68 @@ TEST_F(AuthenticatorTest, TestOkJWTandCache) {
   EXPECT_EQ(0U, filter_config_->stats().jwks_fetch_failed_.value());
 }
 
+// This test verifies a Jwt found in the Jwt cache is not verified again, but its payload is still
+// forwarded.
+TEST_F(AuthenticatorTest, TestJwtCache) {
+  (*proto_config_.mutable_providers())[std::string(ProviderName)].mutable_jwt_cache_config();
+  createAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }));
+
+  for (int i = 0; i < 10; i++) {
+    Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+
+    expectVerifyStatus(Status::Ok, headers);
+
+    EXPECT_EQ(headers.get_("sec-istio-auth-userinfo"), ExpectedPayloadValue);
+    EXPECT_FALSE(headers.has(Http::CustomHeaders::get().Authorization));
+  }
+
+  EXPECT_EQ(9U, filter_config_->stats().jwt_cache_hit_.value());
+  EXPECT_EQ(1U, filter_config_->stats().jwt_cache_miss_.value());
+
+  // A Jwt with a claim that is not allowed is still rejected when it is not cached.
+  Http::TestRequestHeaderMapImpl headers{
+      {"Authorization", "Bearer " + std::string(InvalidAudToken)}};
+  expectVerifyStatus(Status::JwtAudienceNotAllowed, headers);
+  EXPECT_EQ(2U, filter_config_->stats().jwt_cache_miss_.value());
+}
+
+// This test verifies a cached Jwt is verified again once the Jwks it was verified with expires,
+// and is rejected if its key was rotated out of the new Jwks.
+TEST_F(AuthenticatorTest, TestJwtCacheWithRotatedJwks) {
+  auto& provider = (*proto_config_.mutable_providers())[std::string(ProviderName)];
+  provider.mutable_jwt_cache_config();
+  provider.mutable_remote_jwks()->mutable_cache_duration()->set_seconds(1);
+  createAuthenticator();
+  ::google::jwt_verify::JwksPtr rotated_jwks = Jwks::createFrom(ES256PublicKey, Jwks::JWKS);
+  EXPECT_TRUE(rotated_jwks->getStatus() == Status::Ok);
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }))
+      .WillOnce(Invoke([&rotated_jwks](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                                       JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(rotated_jwks));
+      }));
+
+  for (int i = 0; i < 2; i++) {
+    Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+    expectVerifyStatus(Status::Ok, headers);
+  }
+  EXPECT_EQ(1U, filter_config_->stats().jwt_cache_hit_.value());
+
+  mock_factory_ctx_.time_system_.advanceTimeWait(std::chrono::seconds(2));
+  Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+  expectVerifyStatus(Status::JwksKidAlgMismatch, headers);
+  EXPECT_EQ(1U, filter_config_->stats().jwt_cache_hit_.value());
+  EXPECT_EQ(2U, filter_config_->stats().jwks_fetch_success_.value());
+}
+
 TEST_F(AuthenticatorTest, TestCompletePaddingInJwtPayload) {
   (*proto_config_.mutable_providers())[std::string(ProviderName)].set_pad_forward_payload_header(
       true);
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
+
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using ::google::jwt_verify::Jwt;
+using ::google::jwt_verify::Status;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+class JwtCacheTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  JwtCacheTest() {
+    // One second before the exp of the tokens.
+    simTime().setSystemTime(std::chrono::system_clock::from_time_t(2001001000));
+  }
+
+  void initialize(uint32_t jwt_cache_size) {
+    envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig config;
+    config.set_jwt_cache_size(jwt_cache_size);
+    cache_ = std::make_unique<JwtCache>(config, simTime());
+  }
+
+  static JwtConstSharedPtr parse(const std::string& token) {
+    auto jwt = std::make_shared<Jwt>();
+    EXPECT_EQ(Status::Ok, jwt->parseFromString(token));
+    return jwt;
+  }
+
+  void insert(const std::string& token, uint64_t jwks_generation = 1) {
+    cache_->insert(token, parse(token), jwks_generation);
+  }
+
+  JwtConstSharedPtr lookup(const std::string& token, uint64_t jwks_generation = 1) {
+    return cache_->lookup(token, jwks_generation);
+  }
+
+  JwtCachePtr cache_;
+};
+
+TEST_F(JwtCacheTest, Lookup) {
+  initialize(0);
+
+  EXPECT_EQ(nullptr, lookup(GoodToken));
+  insert(GoodToken);
+  const JwtConstSharedPtr jwt = lookup(GoodToken);
+  ASSERT_NE(nullptr, jwt);
+  EXPECT_EQ("https://example.com", jwt->iss_);
+  EXPECT_EQ(nullptr, lookup(OtherGoodToken));
+}
+
+// A Jwt is only found with the generation of the Jwks which verified it.
+TEST_F(JwtCacheTest, JwksGeneration) {
+  initialize(0);
+
+  insert(GoodToken, 1);
+  EXPECT_EQ(nullptr, lookup(GoodToken, 2));
+  EXPECT_NE(nullptr, lookup(GoodToken, 1));
+  insert(GoodToken, 2);
+  EXPECT_EQ(1U, cache_->size());
+  EXPECT_EQ(nullptr, lookup(GoodToken, 1));
+  EXPECT_NE(nullptr, lookup(GoodToken, 2));
+}
+
+TEST_F(JwtCacheTest, Expired) {
+  initialize(0);
+
+  insert(GoodToken);
+  EXPECT_NE(nullptr, lookup(GoodToken));
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, lookup(GoodToken));
+  EXPECT_EQ(0U, cache_->size());
+}
+
+TEST_F(JwtCacheTest, NonExpiringNotCached) {
+  initialize(0);
+
+  insert(NonExpiringToken);
+  EXPECT_EQ(nullptr, lookup(NonExpiringToken));
+  EXPECT_EQ(0U, cache_->size());
+}
+
+TEST_F(JwtCacheTest, EvictLeastRecentlyUsed) {
+  initialize(2);
+
+  insert(GoodToken);
+  insert(OtherGoodToken);
+  // Updating a cached Jwt does not evict another one.
+  insert(OtherGoodToken);
+  EXPECT_EQ(2U, cache_->size());
+  EXPECT_NE(nullptr, lookup(GoodToken));
+
+  insert(NonExistKidToken);
+  EXPECT_EQ(2U, cache_->size());
+  EXPECT_EQ(nullptr, lookup(OtherGoodToken));
+  EXPECT_NE(nullptr, lookup(GoodToken));
+  EXPECT_NE(nullptr, lookup(NonExistKidToken));
+}
+
+TEST_F(JwtCacheTest, Clear) {
+  initialize(0);
+
+  insert(GoodToken);
+  insert(OtherGoodToken);
+  cache_->clear();
+  EXPECT_EQ(0U, cache_->size());
+  EXPECT_EQ(nullptr, lookup(GoodToken));
+}
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 
+#include "absl/strings/str_replace.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -414,6 +415,16 @@ TEST_F(DescriptorFilterTest, RouteDescriptorWithStageConfig) {
   EXPECT_EQ(1U, findCounter("test.http_local_rate_limit.ok"));
 }
 
+TEST_F(DescriptorFilterTest, DynamicDescriptorPerConnection) {
+  const std::string yaml = absl::StrReplaceAll(
+      fmt::format(descriptor_config_yaml, "1", "1", "0"),
+      {{"- entries:\n   - key: foo2\n     value: bar2",
+        "- dynamic_entries:\n   - key: foo2\n     value: \"\""}});
+  EXPECT_THROW_WITH_MESSAGE(setUpTest(yaml), EnvoyException,
+                            "local rate limit descriptors with empty values are not supported "
+                            "with local_rate_limit_per_downstream_connection");
+}
+
 } // namespace LocalRateLimitFilter
 } // namespace HttpFilters
 } // namespace Extensions
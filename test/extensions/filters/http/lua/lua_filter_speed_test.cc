@@ -0,0 +1,85 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/lua/v3/lua.pb.h"
+
+#include "source/extensions/filters/http/lua/lua_filter.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Lua {
+namespace {
+
+using testing::NiceMock;
+
+const std::string HeadersScript{R"EOF(
+  function envoy_on_request(request_handle)
+    local headers = request_handle:headers()
+    headers:add("x-lua-request", "1")
+    headers:replace("x-forwarded-proto", "https")
+    headers:remove("x-internal-debug")
+    if headers:get(":path") == "/admin" then
+      headers:add("x-admin", "true")
+    end
+  end
+
+  function envoy_on_response(response_handle)
+    response_handle:headers():add("x-lua-response", "1")
+  end
+)EOF"};
+
+// Runs the request and response headers of a request through a new filter per iteration, with
+// the GC pause in the argument (0 keeps the runtime default). The memory used by the Lua state
+// at the end shows what the GC tuning trades for the time of an iteration.
+void bmHeadersScript(benchmark::State& state) {
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.set_inline_code(HeadersScript);
+  if (state.range(0) > 0) {
+    proto_config.mutable_garbage_collection()->mutable_pause()->set_value(state.range(0));
+  }
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  NiceMock<Api::MockApi> api;
+  auto config = std::make_shared<FilterConfig>(proto_config, tls, cluster_manager, api);
+  Event::SimulatedTimeSystem time_system;
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"},
+                                                   {":path", "/api"},
+                                                   {":authority", "host"},
+                                                   {"x-forwarded-proto", "http"},
+                                                   {"x-internal-debug", "1"}};
+    Http::TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    Filter filter(config, time_system);
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+    filter.decodeHeaders(request_headers, true);
+    filter.encodeHeaders(response_headers, true);
+    filter.onDestroy();
+  }
+
+  state.counters["lua_bytes_used"] =
+      config->perLuaCodeSetup(GLOBAL_SCRIPT_NAME)->runtimeBytesUsed();
+}
+BENCHMARK(bmHeadersScript)->Arg(0)->Arg(100)->Arg(400);
+
+} // namespace
+} // namespace Lua
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -2173,6 +2173,25 @@ TEST_F(LuaHttpFilterTest, SignatureVerify) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 }
 
+// Requests keep running on a state with a tuned GC, reusing the threads of finished coroutines.
+TEST_F(LuaHttpFilterTest, GarbageCollectionConfig) {
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.set_inline_code(HEADER_ONLY_SCRIPT);
+  proto_config.mutable_garbage_collection()->mutable_pause()->set_value(150);
+  proto_config.mutable_garbage_collection()->mutable_step_multiplier()->set_value(400);
+  envoy::extensions::filters::http::lua::v3::LuaPerRoute per_route_proto_config;
+  setupConfig(proto_config, per_route_proto_config);
+  setupFilter();
+
+  for (int i = 0; i < 3; i++) {
+    Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+    EXPECT_CALL(*filter_, scriptLog(spdlog::level::trace, StrEq("/")));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    filter_->onDestroy();
+    setupFilter();
+  }
+}
+
 // Test whether the route configuration can properly disable the Lua filter.
 TEST_F(LuaHttpFilterTest, LuaFilterDisabled) {
   envoy::extensions::filters::http::lua::v3::Lua proto_config;
@@ -51,6 +51,10 @@ public:
       proto_config_.set_failure_mode_deny(failure_mode_deny_);
       proto_config_.set_enable_x_ratelimit_headers(enable_x_ratelimit_headers_);
       proto_config_.set_disable_x_envoy_ratelimited_header(disable_x_envoy_ratelimited_header_);
+      if (hits_per_lease_ > 0) {
+        proto_config_.mutable_quota_lease()->set_hits_per_lease(hits_per_lease_);
+        proto_config_.mutable_quota_lease()->mutable_lease_duration()->set_seconds(3600);
+      }
       setGrpcService(*proto_config_.mutable_rate_limit_service()->mutable_grpc_service(),
                      "ratelimit", fake_upstreams_.back()->localAddress());
       proto_config_.mutable_rate_limit_service()->set_transport_api_version(apiVersion());
@@ -101,6 +105,7 @@ public:
 
     envoy::service::ratelimit::v3::RateLimitRequest expected_request_msg;
     expected_request_msg.set_domain("some_domain");
+    expected_request_msg.set_hits_addend(hits_per_lease_);
     auto* entry = expected_request_msg.add_descriptors()->add_entries();
     entry->set_key("destination_cluster");
     entry->set_value("cluster_0");
@@ -198,6 +203,7 @@ public:
   envoy::extensions::filters::http::ratelimit::v3::RateLimit::XRateLimitHeadersRFCVersion
       enable_x_ratelimit_headers_ = envoy::extensions::filters::http::ratelimit::v3::RateLimit::OFF;
   bool disable_x_envoy_ratelimited_header_ = false;
+  uint32_t hits_per_lease_ = 0;
   envoy::extensions::filters::http::ratelimit::v3::RateLimit proto_config_{};
   const std::string base_filter_config_ = R"EOF(
     domain: some_domain
@@ -229,6 +235,12 @@ public:
   }
 };
 
+// Test verifies that the decisions are served from the quota leases.
+class RatelimitQuotaLeaseIntegrationTest : public RatelimitIntegrationTest {
+public:
+  RatelimitQuotaLeaseIntegrationTest() { hits_per_lease_ = 3; }
+};
+
 INSTANTIATE_TEST_SUITE_P(IpVersionsClientType, RatelimitIntegrationTest,
                          VERSIONED_GRPC_CLIENT_INTEGRATION_PARAMS,
                          Grpc::VersionedGrpcClientIntegrationParamTest::protocolTestParamsToString);
@@ -242,6 +254,9 @@ INSTANTIATE_TEST_SUITE_P(IpVersionsClientType,
                          RatelimitFilterEnvoyRatelimitedHeaderDisabledIntegrationTest,
                          VERSIONED_GRPC_CLIENT_INTEGRATION_PARAMS,
                          Grpc::VersionedGrpcClientIntegrationParamTest::protocolTestParamsToString);
+INSTANTIATE_TEST_SUITE_P(IpVersionsClientType, RatelimitQuotaLeaseIntegrationTest,
+                         VERSIONED_GRPC_CLIENT_INTEGRATION_PARAMS,
+                         Grpc::VersionedGrpcClientIntegrationParamTest::protocolTestParamsToString);
 
 TEST_P(RatelimitIntegrationTest, Ok) {
   XDS_DEPRECATED_FEATURE_TEST_SKIP;
@@ -499,5 +514,29 @@ TEST_P(RatelimitFilterEnvoyRatelimitedHeaderDisabledIntegrationTest,
   EXPECT_EQ(nullptr, test_server_->counter("cluster.cluster_0.ratelimit.error"));
 }
 
+TEST_P(RatelimitQuotaLeaseIntegrationTest, LeaseServesLocally) {
+  XDS_DEPRECATED_FEATURE_TEST_SKIP;
+  initiateClientConnection();
+  waitForRatelimitRequest();
+  sendRateLimitResponse(envoy::service::ratelimit::v3::RateLimitResponse::OK, {},
+                        Http::TestResponseHeaderMapImpl{}, Http::TestRequestHeaderMapImpl{});
+  waitForSuccessfulUpstreamResponse();
+
+  // The other hits of the lease are used without calling the rate limit service.
+  Http::TestRequestHeaderMapImpl headers{
+      {":method", "GET"}, {":path", "/test/long/url"}, {":scheme", "http"}, {":authority", "host"}};
+  for (int i = 0; i < 2; ++i) {
+    auto response = codec_client_->makeHeaderOnlyRequest(headers);
+    ASSERT_TRUE(fake_upstream_connection_->waitForNewStream(*dispatcher_, upstream_request_));
+    ASSERT_TRUE(upstream_request_->waitForEndStream(*dispatcher_));
+    upstream_request_->encodeHeaders(Http::TestResponseHeaderMapImpl{{":status", "200"}}, true);
+    ASSERT_TRUE(response->waitForEndStream());
+    EXPECT_EQ("200", response->headers().getStatusValue());
+  }
+  cleanup();
+
+  EXPECT_EQ(3, test_server_->counter("cluster.cluster_0.ratelimit.ok")->value());
+}
+
 } // namespace
 } // namespace Envoy
@@ -364,6 +364,157 @@ TEST_P(WasmFilterConfigTest, YamlLoadFromRemoteWasmFailOnUncachedThenSucceed) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+TEST_P(WasmFilterConfigTest, YamlLoadFromRemoteWasmCodeCacheDirectory) {
+#if defined(__aarch64__)
+  // TODO(PiotrSikora): There are no Emscripten releases for arm64.
+  if (GetParam() != "null") {
+    return;
+  }
+#endif
+  const std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/test_cpp.wasm"));
+  const std::string sha256 = Hex::encode(
+      Envoy::Common::Crypto::UtilitySingleton::get().getSha256Digest(Buffer::OwnedImpl(code)));
+  const std::string code_cache_directory = TestEnvironment::temporaryPath("wasm_code_cache");
+  TestEnvironment::removePath(code_cache_directory);
+  TestEnvironment::createPath(code_cache_directory);
+  const std::string yaml = TestEnvironment::substitute(absl::StrCat(R"EOF(
+  config:
+    vm_config:
+      nack_on_code_cache_miss: true
+      code_cache_directory: )EOF",
+                                                                    code_cache_directory, R"EOF(
+      runtime: "envoy.wasm.runtime.)EOF",
+                                                                    GetParam(), R"EOF("
+      code:
+        remote:
+          http_uri:
+            uri: https://example.com/data
+            cluster: cluster_1
+            timeout: 5s
+          sha256: )EOF",
+                                                                    sha256));
+  envoy::extensions::filters::http::wasm::v3::Wasm proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  WasmFilterConfig factory;
+  NiceMock<Http::MockAsyncClient> client;
+  NiceMock<Http::MockAsyncClientRequest> request(&client);
+
+  // The code is only fetched once.
+  cluster_manager_.initializeThreadLocalClusters({"cluster_1"});
+  EXPECT_CALL(cluster_manager_.thread_local_cluster_, httpAsyncClient())
+      .WillOnce(ReturnRef(cluster_manager_.thread_local_cluster_.async_client_));
+  EXPECT_CALL(cluster_manager_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            Http::ResponseMessagePtr response(
+                new Http::ResponseMessageImpl(Http::ResponseHeaderMapPtr{
+                    new Http::TestResponseHeaderMapImpl{{":status", "200"}}}));
+            response->body().add(code);
+            callbacks.onSuccess(request, std::move(response));
+            return &request;
+          }));
+
+  EXPECT_THROW_WITH_MESSAGE(factory.createFilterFactoryFromProto(proto_config, "stats", context_),
+                            WasmException, "Unable to create Wasm HTTP filter ");
+  EXPECT_EQ(code, TestEnvironment::readFileToStringForTest(
+                      absl::StrCat(code_cache_directory, "/", sha256, ".wasm")));
+
+  EXPECT_CALL(init_watcher_, ready());
+  context_.initManager().initialize(init_watcher_);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+
+  // After a restart, the code is loaded from the code cache directory without a NACK.
+  Envoy::Extensions::Common::Wasm::clearCodeCacheForTesting();
+  Init::ManagerImpl init_manager2{"init_manager2"};
+  Init::ExpectableWatcherImpl init_watcher2;
+
+  EXPECT_CALL(context_, initManager()).WillRepeatedly(ReturnRef(init_manager2));
+
+  auto cb = factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+
+  EXPECT_CALL(init_watcher2, ready());
+  init_manager2.initialize(init_watcher2);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  EXPECT_CALL(filter_callback, addAccessLogHandler(_));
+
+  cb(filter_callback);
+  dispatcher_.clearDeferredDeleteList();
+  TestEnvironment::removePath(code_cache_directory);
+}
+
+TEST_P(WasmFilterConfigTest, YamlLoadFromRemoteWasmReplacesCorruptCodeCacheFile) {
+#if defined(__aarch64__)
+  // TODO(PiotrSikora): There are no Emscripten releases for arm64.
+  if (GetParam() != "null") {
+    return;
+  }
+#endif
+  const std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/test_cpp.wasm"));
+  const std::string sha256 = Hex::encode(
+      Envoy::Common::Crypto::UtilitySingleton::get().getSha256Digest(Buffer::OwnedImpl(code)));
+  const std::string code_cache_directory = TestEnvironment::temporaryPath("wasm_code_cache");
+  TestEnvironment::removePath(code_cache_directory);
+  TestEnvironment::createPath(code_cache_directory);
+  TestEnvironment::writeStringToFileForTest(
+      absl::StrCat(code_cache_directory, "/", sha256, ".wasm"), code.substr(0, code.size() / 2),
+      true);
+  const std::string yaml = TestEnvironment::substitute(absl::StrCat(R"EOF(
+  config:
+    vm_config:
+      nack_on_code_cache_miss: true
+      code_cache_directory: )EOF",
+                                                                    code_cache_directory, R"EOF(
+      runtime: "envoy.wasm.runtime.)EOF",
+                                                                    GetParam(), R"EOF("
+      code:
+        remote:
+          http_uri:
+            uri: https://example.com/data
+            cluster: cluster_1
+            timeout: 5s
+          sha256: )EOF",
+                                                                    sha256));
+  envoy::extensions::filters::http::wasm::v3::Wasm proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  WasmFilterConfig factory;
+  NiceMock<Http::MockAsyncClient> client;
+  NiceMock<Http::MockAsyncClientRequest> request(&client);
+
+  // The truncated file does not match the sha256, so the code is fetched.
+  cluster_manager_.initializeThreadLocalClusters({"cluster_1"});
+  EXPECT_CALL(cluster_manager_.thread_local_cluster_, httpAsyncClient())
+      .WillOnce(ReturnRef(cluster_manager_.thread_local_cluster_.async_client_));
+  EXPECT_CALL(cluster_manager_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            Http::ResponseMessagePtr response(
+                new Http::ResponseMessageImpl(Http::ResponseHeaderMapPtr{
+                    new Http::TestResponseHeaderMapImpl{{":status", "200"}}}));
+            response->body().add(code);
+            callbacks.onSuccess(request, std::move(response));
+            return &request;
+          }));
+
+  EXPECT_THROW_WITH_MESSAGE(factory.createFilterFactoryFromProto(proto_config, "stats", context_),
+                            WasmException, "Unable to create Wasm HTTP filter ");
+  // The corrupt file is replaced with the fetched code.
+  EXPECT_EQ(code, TestEnvironment::readFileToStringForTest(
+                      absl::StrCat(code_cache_directory, "/", sha256, ".wasm")));
+
+  EXPECT_CALL(init_watcher_, ready());
+  context_.initManager().initialize(init_watcher_);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+  dispatcher_.clearDeferredDeleteList();
+  TestEnvironment::removePath(code_cache_directory);
+}
+
 TEST_P(WasmFilterConfigTest, YamlLoadFromRemoteWasmFailCachedThenSucceed) {
 #if defined(__aarch64__)
   // TODO(PiotrSikora): There are no Emscripten releases for arm64.
@@ -10,6 +10,7 @@
 #include "source/common/common/random_generator.h"
 #include "source/common/http/conn_manager_utility.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/tracing/tail_sampling_impl.h"
 #include "source/extensions/filters/network/http_connection_manager/config.h"
 #include "source/extensions/request_id/uuid/config.h"
 
@@ -322,6 +323,44 @@ http_filters:
   EXPECT_THAT(config.tracer(), Eq(http_tracer_));
 }
 
+TEST_F(HttpConnectionManagerConfigTest, TracingTailSampling) {
+  const std::string yaml_string = R"EOF(
+codec_type: http1
+server_name: foo
+stat_prefix: router
+route_config:
+  virtual_hosts:
+  - name: service
+    domains:
+    - "*"
+    routes:
+    - match:
+        prefix: "/"
+      route:
+        cluster: cluster
+tracing:
+  tail_sampling:
+    min_duration: 1s
+    min_status_code: 500
+    keep_errors: true
+http_filters:
+- name: envoy.filters.http.router
+  )EOF";
+
+  EXPECT_CALL(http_tracer_manager_, getOrCreateHttpTracer(nullptr)).WillOnce(Return(http_tracer_));
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  // The HttpTracer obtained from the HttpTracerManager is wrapped by the tail sampler.
+  EXPECT_NE(nullptr, dynamic_cast<Tracing::TailSamplingHttpTracer*>(config.tracer().get()));
+  EXPECT_EQ(0, context_.scope_.gauge("http.router.tracing.tail_sampling.spans_buffered",
+                                     Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+}
+
 TEST_F(HttpConnectionManagerConfigTest, TracingIsEnabledAndThereIsTracingConfigInBootstrap) {
   const std::string yaml_string = R"EOF(
 codec_type: http1
@@ -0,0 +1,122 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace Common {
+namespace Statsd {
+
+// Forces the writer to send one datagram per system call.
+class NoMmsgOsSysCalls : public Api::OsSysCallsImpl {
+public:
+  bool supportsMmsg() const override { return false; }
+};
+
+class UdpStatsdSpeedTest {
+public:
+  UdpStatsdSpeedTest(uint32_t num_metrics)
+      : server_(Network::Address::IpVersion::v4), snapshot_(std::make_unique<Snapshot>()) {
+    // Half counters and half gauges, with the same names as a cluster would have.
+    for (uint32_t i = 0; i < num_metrics / 2; ++i) {
+      Stats::Counter& counter =
+          store_.counterFromString(absl::StrCat("cluster.service_", i, ".upstream_rq_total"));
+      counter.inc();
+      snapshot_->counters_.push_back({1, counter});
+      Stats::Gauge& gauge = store_.gaugeFromString(
+          absl::StrCat("cluster.service_", i, ".upstream_cx_active"),
+          Stats::Gauge::ImportMode::Accumulate);
+      gauge.set(i);
+      snapshot_->gauges_.push_back(gauge);
+    }
+  }
+
+  std::unique_ptr<UdpStatsdSink> makeSink(uint64_t max_bytes_per_datagram) {
+    absl::optional<uint64_t> buffer_size;
+    if (max_bytes_per_datagram > 0) {
+      buffer_size = max_bytes_per_datagram;
+    }
+    return std::make_unique<UdpStatsdSink>(tls_, server_.localAddress(), false,
+                                           getDefaultPrefix(), buffer_size);
+  }
+
+  Stats::MetricSnapshot& snapshot() { return *snapshot_; }
+
+  ~UdpStatsdSpeedTest() { tls_.shutdownThread(); }
+
+private:
+  using Snapshot = NiceMock<Stats::MockMetricSnapshot>;
+
+  Stats::TestUtil::TestStore store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  // Receives nothing: datagrams beyond its socket buffer are dropped by the kernel, as they would
+  // be by a slow statsd server.
+  Network::Test::UdpSyncPeer server_;
+  std::unique_ptr<Snapshot> snapshot_;
+};
+
+// Flushes a snapshot of metrics over UDP. Arguments:
+//   0: the maximum size of each datagram, 0 meaning one metric per datagram.
+//   1: whether datagrams are sent with sendmmsg(), rather than one system call each.
+//   2: whether the sink is created for each flush, so that every name is rendered each time,
+//      rather than once for the benchmark.
+static void bmFlush(benchmark::State& state) {
+  const uint32_t num_metrics = skipExpensiveBenchmarks() ? 2000 : 200000;
+  const uint64_t max_bytes_per_datagram = state.range(0);
+  const bool use_mmsg = state.range(1) != 0;
+  const bool cold = state.range(2) != 0;
+
+  UdpStatsdSpeedTest context(num_metrics);
+  NoMmsgOsSysCalls no_mmsg_os_sys_calls;
+  std::unique_ptr<TestThreadsafeSingletonInjector<Api::OsSysCallsImpl>> os_calls;
+  if (!use_mmsg) {
+    os_calls = std::make_unique<TestThreadsafeSingletonInjector<Api::OsSysCallsImpl>>(
+        &no_mmsg_os_sys_calls);
+  }
+
+  std::unique_ptr<UdpStatsdSink> sink = context.makeSink(max_bytes_per_datagram);
+  for (auto _ : state) {
+    if (cold) {
+      state.PauseTiming();
+      sink = context.makeSink(max_bytes_per_datagram);
+      state.ResumeTiming();
+    }
+    sink->flush(context.snapshot());
+  }
+  state.counters["metrics_per_flush"] = num_metrics;
+}
+static void flushArguments(benchmark::internal::Benchmark* b) {
+  for (int64_t max_bytes_per_datagram : {0, 1432}) {
+    for (int64_t use_mmsg : {0, 1}) {
+      for (int64_t cold : {0, 1}) {
+        b->Args({max_bytes_per_datagram, use_mmsg, cold});
+      }
+    }
+  }
+}
+BENCHMARK(bmFlush)->Apply(flushArguments)->Unit(benchmark::kMillisecond);
+
+} // namespace Statsd
+} // namespace Common
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
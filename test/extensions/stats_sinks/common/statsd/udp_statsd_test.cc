@@ -10,17 +10,24 @@
 #include "source/extensions/stat_sinks/common/statsd/statsd.h"
 #include "source/extensions/stat_sinks/common/statsd/tag_formats.h"
 
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -33,6 +40,8 @@ class MockWriter : public UdpStatsdSink::Writer {
 public:
   MOCK_METHOD(void, write, (const std::string& message));
   MOCK_METHOD(void, writeBuffer, (Buffer::Instance & buffer));
+  MOCK_METHOD(void, beginBatch, ());
+  MOCK_METHOD(void, endBatch, ());
 
   void delegateBufferFake() {
     ON_CALL(*this, writeBuffer).WillByDefault([this](Buffer::Instance& buffer) {
@@ -161,6 +170,115 @@ TEST_P(UdpStatsdSinkWithTagsTest, InitWithIpAddress) {
   tls_.shutdownThread();
 }
 
+// Flushing more datagrams than fit in a single sendmmsg() call delivers all of them.
+TEST_P(UdpStatsdSinkTest, BatchedWritesOverSeveralSyscalls) {
+  Stats::TestUtil::TestStore store;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  Network::Test::UdpSyncPeer server(GetParam());
+  UdpStatsdSink sink(tls_, server.localAddress(), false);
+
+  const uint32_t num_counters = 150;
+  for (uint32_t i = 0; i < num_counters; ++i) {
+    Stats::Counter& counter = store.counterFromString(absl::StrCat("counter", i));
+    counter.inc();
+    snapshot.counters_.push_back({1, counter});
+  }
+
+  sink.flush(snapshot);
+  for (uint32_t i = 0; i < num_counters; ++i) {
+    Network::UdpRecvData data;
+    server.recv(data);
+    EXPECT_EQ(absl::StrCat("envoy.counter", i, ":1|c"), data.buffer_->toString());
+  }
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkTest, PartialAndFailedSendmmsg) {
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  UdpStatsdSink sink(tls_, Network::Utility::parseInternetAddressAndPort("127.0.0.1:8125"), false);
+
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (uint32_t i = 0; i < 3; ++i) {
+    counters.push_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = absl::StrCat("counter", i);
+    counters.back()->used_ = true;
+    snapshot.counters_.push_back({1, *counters.back()});
+  }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  ON_CALL(os_sys_calls, supportsMmsg()).WillByDefault(Return(true));
+  {
+    InSequence s;
+    // The first call only sends one datagram, so the second one resumes from the second.
+    EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 3, 0))
+        .WillOnce(Invoke([](os_fd_t, struct mmsghdr* msgvec, unsigned int, int) {
+          EXPECT_EQ("envoy.counter0:1|c",
+                    absl::string_view(static_cast<char*>(msgvec[0].msg_hdr.msg_iov->iov_base),
+                                      msgvec[0].msg_hdr.msg_iov->iov_len));
+          return Api::SysCallIntResult{1, 0};
+        }));
+    EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, 0))
+        .WillOnce(Invoke([](os_fd_t, struct mmsghdr* msgvec, unsigned int, int) {
+          EXPECT_EQ("envoy.counter1:1|c",
+                    absl::string_view(static_cast<char*>(msgvec[0].msg_hdr.msg_iov->iov_base),
+                                      msgvec[0].msg_hdr.msg_iov->iov_len));
+          return Api::SysCallIntResult{2, 0};
+        }));
+    // A failure drops the rest of the batch, rather than retrying it.
+    EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 3, 0))
+        .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}));
+  }
+  sink.flush(snapshot);
+  sink.flush(snapshot);
+
+  tls_.shutdownThread();
+}
+
+// The name and tags of metrics owned by a store are rendered once, and released once the metrics
+// are no longer flushed.
+TEST(UdpStatsdSinkTest, RenderedMetricsCache) {
+  Stats::TestUtil::TestStore store;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  Stats::Counter& counter = store.counter("test_counter");
+  Stats::Gauge& gauge = store.gauge("test_gauge", Stats::Gauge::ImportMode::Accumulate);
+  counter.inc();
+  gauge.set(3);
+  snapshot.counters_.push_back({1, counter});
+  snapshot.gauges_.push_back(gauge);
+  const uint32_t counter_use_count = counter.use_count();
+
+  EXPECT_CALL(*writer_ptr, beginBatch());
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter:1|c"));
+  EXPECT_CALL(*writer_ptr, write("envoy.test_gauge:3|g"));
+  EXPECT_CALL(*writer_ptr, endBatch());
+  sink.flush(snapshot);
+  EXPECT_EQ(2, sink.renderedMetricsForTest());
+  EXPECT_EQ(counter_use_count + 1, counter.use_count());
+
+  gauge.set(4);
+  snapshot.counters_[0].delta_ = 2;
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter:2|c"));
+  EXPECT_CALL(*writer_ptr, write("envoy.test_gauge:4|g"));
+  sink.flush(snapshot);
+  EXPECT_EQ(2, sink.renderedMetricsForTest());
+
+  snapshot.counters_.clear();
+  EXPECT_CALL(*writer_ptr, write("envoy.test_gauge:4|g"));
+  sink.flush(snapshot);
+  EXPECT_EQ(1, sink.renderedMetricsForTest());
+  EXPECT_EQ(counter_use_count, counter.use_count());
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, CheckActualStats) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -171,6 +171,23 @@ TEST_F(MetricsServiceSinkTest, CheckStatsCount) {
   sink.flush(snapshot_);
 }
 
+TEST_F(MetricsServiceSinkTest, FlushOptions) {
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      default_sink(streamer_, false, false);
+  EXPECT_FALSE(default_sink.flushOptions().changed_metrics_only_);
+  EXPECT_EQ(0, default_sink.flushOptions().max_metrics_per_flush_);
+
+  Stats::SinkFlushOptions flush_options;
+  flush_options.changed_metrics_only_ = true;
+  flush_options.max_metrics_per_flush_ = 100;
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      sink(streamer_, false, false, flush_options);
+  EXPECT_TRUE(sink.flushOptions().changed_metrics_only_);
+  EXPECT_EQ(100, sink.flushOptions().max_metrics_per_flush_);
+}
+
 // Test that verifies counters are correctly reported as current value when configured to do so.
 TEST_F(MetricsServiceSinkTest, ReportCountersValues) {
   MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
@@ -0,0 +1,141 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/trace/v3/zipkin.pb.h"
+
+#include "source/common/common/random_generator.h"
+#include "source/common/network/utility.h"
+#include "source/extensions/tracers/zipkin/span_buffer.h"
+#include "source/extensions/tracers/zipkin/tracer.h"
+
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+
+// Buffers the reported spans, as ReporterImpl does, clearing the buffer when full rather than
+// flushing it so that only span creation is measured.
+class BufferingReporter : public Reporter {
+public:
+  BufferingReporter(envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion version,
+                    uint64_t size)
+      : span_buffer_(version, true, size), size_(size) {}
+
+  void reportSpan(Span&& span) override {
+    span_buffer_.addSpan(std::move(span));
+    if (span_buffer_.pendingSpans() == size_) {
+      span_buffer_.clear();
+    }
+  }
+
+private:
+  SpanBuffer span_buffer_;
+  const uint64_t size_;
+};
+
+class ZipkinSpeedTest {
+public:
+  ZipkinSpeedTest()
+      : tracer_("service1", Network::Utility::parseInternetAddress("1.2.3.4", 8080, false),
+                random_generator_, false, true, time_system_) {
+    tracer_.setReporter(std::make_unique<BufferingReporter>(
+        envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, 1000));
+  }
+
+  // Starts, tags and finishes a span, with as many tags as HttpTracerUtility::finalizeSpan() sets.
+  void traceRequest() {
+    SpanPtr span = tracer_.startSpan(config_, "www.example.com", time_system_.systemTime());
+    span->setSampled(true);
+    span->setTag("component", "proxy");
+    span->setTag("node_id", "node-1");
+    span->setTag("zone", "zone-a");
+    span->setTag("guid:x-request-id", "b6f5a2f6-5a4c-4b8a-9d3e-1c0c2f8a6e7d");
+    span->setTag("http.url", "https://www.example.com/api/v1/users/12345");
+    span->setTag("http.method", "GET");
+    span->setTag("downstream_cluster", "-");
+    span->setTag("user_agent", "curl/7.64.1");
+    span->setTag("http.protocol", "HTTP/1.1");
+    span->setTag("request_size", "0");
+    span->setTag("upstream_cluster", "backend");
+    span->setTag("http.status_code", "200");
+    span->setTag("response_size", "1024");
+    span->setTag("response_flags", "-");
+    span->finish();
+  }
+
+  // Builds a span as a finished request would have it.
+  Span makeSpan(uint64_t id) {
+    Span span(time_system_);
+    span.setId(id);
+    span.setTraceId(id);
+    span.setParentId(id + 1);
+    span.setName("www.example.com");
+    span.setDuration(2000);
+    Endpoint endpoint("service1", Network::Utility::parseInternetAddress("1.2.3.4", 8080, false));
+    span.addAnnotation(Annotation(1584324295476870, "sr", endpoint));
+    span.addAnnotation(Annotation(1584324295478870, "ss", endpoint));
+    for (uint32_t i = 0; i < 14; ++i) {
+      span.setTag(absl::StrCat("tag_", i), absl::StrCat("a value for tag ", i));
+    }
+    return span;
+  }
+
+private:
+  Event::SimulatedTimeSystem time_system_;
+  Random::RandomGeneratorImpl random_generator_;
+  NiceMock<Tracing::MockConfig> config_;
+  Tracer tracer_;
+};
+
+// Creates spans and hands them over to the reporter's buffer.
+static void bmSpanCreation(benchmark::State& state) {
+  ZipkinSpeedTest context;
+  for (auto _ : state) {
+    context.traceRequest();
+  }
+}
+BENCHMARK(bmSpanCreation);
+
+// Serializes a buffer of spans. Arguments:
+//   0: the collector endpoint version, HTTP_JSON or HTTP_PROTO.
+//   1: the number of buffered spans.
+static void bmSerialize(benchmark::State& state) {
+  const auto version =
+      static_cast<envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion>(
+          state.range(0));
+  const uint64_t num_spans = state.range(1);
+
+  ZipkinSpeedTest context;
+  SpanBuffer span_buffer(version, true, num_spans);
+  for (uint64_t i = 0; i < num_spans; ++i) {
+    span_buffer.addSpan(context.makeSpan(i));
+  }
+
+  size_t bytes = 0;
+  for (auto _ : state) {
+    bytes += span_buffer.serialize().size();
+  }
+  state.SetBytesProcessed(bytes);
+}
+static void serializeArguments(benchmark::internal::Benchmark* b) {
+  for (int64_t version : {envoy::config::trace::v3::ZipkinConfig::HTTP_JSON,
+                          envoy::config::trace::v3::ZipkinConfig::HTTP_PROTO}) {
+    for (int64_t num_spans : {5, 100, 1000}) {
+      b->Args({version, num_spans});
+    }
+  }
+}
+BENCHMARK(bmSerialize)->Apply(serializeArguments)->Unit(benchmark::kMicrosecond);
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
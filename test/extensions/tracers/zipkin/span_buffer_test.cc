@@ -418,6 +418,36 @@ TEST(ZipkinSpanBufferTest, SerializeSpan) {
             serializedMessageToJson<zipkin::proto3::ListOfSpans>(buffer6.serialize()));
 }
 
+TEST(ZipkinSpanBufferTest, SerializeEscapedStringsAndRepeatedTags) {
+  SpanBuffer buffer(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, true, 2);
+  Span span = createSpan({"cs"}, IpType::V4);
+  span.setName("say \"hi\"\n\\");
+  // Replaces the tag set by createSpan().
+  span.setTag("response_size", "0");
+  span.setTag("control", std::string("\x01", 1));
+  buffer.addSpan(std::move(span));
+
+  const std::string serialized = buffer.serialize();
+  EXPECT_THAT(serialized, HasSubstr(R"("name":"say \"hi\"\n\\")"));
+  EXPECT_THAT(serialized, HasSubstr(R"("control":"\u0001")"));
+  EXPECT_THAT(wrapAsObject("[{"
+                           R"("traceId":"0000000000000001",)"
+                           R"("id":"0000000000000001",)"
+                           R"("name":"say \"hi\"\n\\",)"
+                           R"("kind":"CLIENT",)"
+                           R"("timestamp":ANNOTATION_TEST_TIMESTAMP,)"
+                           R"("duration":DEFAULT_TEST_DURATION,)"
+                           R"("localEndpoint":{)"
+                           R"("serviceName":"service1",)"
+                           R"("ipv4":"1.2.3.4",)"
+                           R"("port":8080},)"
+                           R"("tags":{)"
+                           R"("response_size":"0",)"
+                           R"("control":"\u0001"})"
+                           "}]"),
+              JsonStringEq(wrapAsObject(serialized)));
+}
+
 TEST(ZipkinSpanBufferTest, TestSerializeTimestampInTheFuture) {
   ProtobufWkt::Struct objectWithScientificNotation;
   auto* objectWithScientificNotationFields = objectWithScientificNotation.mutable_fields();
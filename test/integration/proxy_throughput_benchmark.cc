@@ -0,0 +1,243 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "source/common/memory/stats.h"
+#include "source/exe/process_wide.h"
+
+#include "test/benchmark/main.h"
+#include "test/integration/autonomous_upstream.h"
+#include "test/integration/http_integration.h"
+#include "test/test_common/environment.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace {
+
+// Sets up the process wide state and the runfiles, which the test runner provides to integration
+// tests, once for all the benchmarks.
+void initializeProcess() {
+  static ProcessWide* process_wide = new ProcessWide();
+  static bazel::tools::cpp::runfiles::Runfiles* runfiles = []() {
+    std::string error;
+    auto* runfiles =
+        bazel::tools::cpp::runfiles::Runfiles::Create("proxy_throughput_benchmark", &error);
+    TestEnvironment::setRunfiles(runfiles);
+    return runfiles;
+  }();
+  UNREFERENCED_PARAMETER(process_wide);
+  UNREFERENCED_PARAMETER(runfiles);
+}
+
+// The integration helpers report failures to gtest, which does not run here, so stop the
+// benchmark instead.
+void checkResult(const testing::AssertionResult& result) {
+  RELEASE_ASSERT(result, result.message());
+}
+
+std::chrono::microseconds processCpuTime() {
+  struct rusage usage;
+  RELEASE_ASSERT(getrusage(RUSAGE_SELF, &usage) == 0, "");
+  return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+// Records the latency of the requests of a benchmark, and the CPU time and memory used by the
+// whole process while they run. The process runs the client, the Envoy server and the fake
+// upstream, so the CPU time and memory per request are those of the full round trip.
+class RequestStats {
+public:
+  RequestStats()
+      : start_cpu_time_(processCpuTime()),
+        start_allocated_bytes_(Memory::Stats::totalCurrentlyAllocated()) {}
+
+  void addLatency(std::chrono::steady_clock::duration latency) {
+    latencies_.push_back(std::chrono::duration<double, std::micro>(latency).count());
+  }
+
+  void report(benchmark::State& state) {
+    const double requests = latencies_.size();
+    state.counters["requests_per_second"] =
+        benchmark::Counter(requests, benchmark::Counter::kIsRate);
+    state.counters["cpu_us_per_request"] =
+        benchmark::Counter((processCpuTime() - start_cpu_time_).count() / requests);
+    // Allocation counts are not exposed by the allocator, so this reports the growth of the
+    // memory in use, which includes what the fake upstream keeps for the whole connection.
+    const double allocated_bytes = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["allocated_bytes_per_request"] =
+        benchmark::Counter((allocated_bytes - start_allocated_bytes_) / requests);
+    if (latencies_.empty()) {
+      return;
+    }
+    std::sort(latencies_.begin(), latencies_.end());
+    state.counters["latency_p50_us"] = percentile(0.5);
+    state.counters["latency_p90_us"] = percentile(0.9);
+    state.counters["latency_p99_us"] = percentile(0.99);
+  }
+
+private:
+  double percentile(double fraction) const {
+    const size_t index = static_cast<size_t>(latencies_.size() * fraction);
+    return latencies_[std::min(index, latencies_.size() - 1)];
+  }
+
+  const std::chrono::microseconds start_cpu_time_;
+  const uint64_t start_allocated_bytes_;
+  std::vector<double> latencies_;
+};
+
+Network::Address::IpVersion ipVersion() {
+  return TestEnvironment::getIpVersionsForTest().front();
+}
+
+// An Envoy server proxying a client connection of the downstream protocol to an autonomous fake
+// upstream, which responds to each request with the number of bytes it asks for.
+class HttpProxy : public HttpIntegrationTest {
+public:
+  HttpProxy(Http::CodecType downstream_protocol, Http::CodecType upstream_protocol)
+      : HttpIntegrationTest(
+            downstream_protocol, ipVersion(),
+            ConfigHelper::httpProxyConfig(downstream_protocol == Http::CodecType::HTTP3)) {
+    autonomous_upstream_ = true;
+    setUpstreamProtocol(upstream_protocol);
+    initialize();
+    codec_client_ = makeHttpConnection(lookupPort("http"));
+  }
+
+  // Sends batches of range(1) concurrent requests for responses of range(0) bytes, and waits for
+  // all the responses of a batch before sending the next one.
+  void run(benchmark::State& state) {
+    const Http::TestRequestHeaderMapImpl request_headers{
+        {":method", "GET"},
+        {":path", "/"},
+        {":scheme", "http"},
+        {":authority", "host"},
+        {AutonomousStream::RESPONSE_SIZE_BYTES, absl::StrCat(state.range(0))},
+        {AutonomousStream::NO_TRAILERS, "true"}};
+    std::vector<IntegrationStreamDecoderPtr> responses(state.range(1));
+    RequestStats stats;
+    for (auto _ : state) { // NOLINT: Silences warning about dead store
+      const auto start = std::chrono::steady_clock::now();
+      for (IntegrationStreamDecoderPtr& response : responses) {
+        response = codec_client_->makeHeaderOnlyRequest(request_headers);
+      }
+      // Responses are waited for in order, so a response which completes before the ones sent
+      // ahead of it is recorded when they complete.
+      for (IntegrationStreamDecoderPtr& response : responses) {
+        checkResult(response->waitForEndStream());
+        stats.addLatency(std::chrono::steady_clock::now() - start);
+        RELEASE_ASSERT(response->headers().getStatusValue() == "200", "");
+      }
+    }
+    stats.report(state);
+  }
+};
+
+void httpRequests(benchmark::State& state, Http::CodecType downstream_protocol,
+                  Http::CodecType upstream_protocol) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1024) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  initializeProcess();
+  HttpProxy proxy(downstream_protocol, upstream_protocol);
+  proxy.run(state);
+}
+
+// Sends HTTP/1 requests through Envoy to an HTTP/1 upstream.
+void bmHttp1Requests(benchmark::State& state) {
+  httpRequests(state, Http::CodecType::HTTP1, Http::CodecType::HTTP1);
+}
+BENCHMARK(bmHttp1Requests)
+    ->Args({0, 1})
+    ->Args({16384, 1})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// Sends HTTP/2 requests through Envoy to an HTTP/2 upstream.
+void bmHttp2Requests(benchmark::State& state) {
+  httpRequests(state, Http::CodecType::HTTP2, Http::CodecType::HTTP2);
+}
+BENCHMARK(bmHttp2Requests)
+    ->Args({0, 1})
+    ->Args({0, 10})
+    ->Args({16384, 10})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+#ifdef ENVOY_ENABLE_QUIC
+// Sends HTTP/3 requests through Envoy to an HTTP/2 upstream.
+void bmHttp3Requests(benchmark::State& state) {
+  httpRequests(state, Http::CodecType::HTTP3, Http::CodecType::HTTP2);
+}
+BENCHMARK(bmHttp3Requests)
+    ->Args({0, 1})
+    ->Args({0, 10})
+    ->Args({16384, 10})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+#endif
+
+// An Envoy server proxying a client TCP connection to a fake upstream, which echoes the data it
+// receives.
+class TcpProxy : public BaseIntegrationTest {
+public:
+  TcpProxy() : BaseIntegrationTest(ipVersion(), ConfigHelper::tcpProxyConfig()) {
+    config_helper_.renameListener("tcp_proxy");
+    initialize();
+    tcp_client_ = makeTcpConnection(lookupPort("tcp_proxy"));
+    checkResult(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection_));
+  }
+
+  ~TcpProxy() override {
+    tcp_client_->close();
+    checkResult(fake_upstream_connection_->waitForDisconnect());
+  }
+
+  // Sends range(0) bytes at a time, and waits for them to be echoed before sending more.
+  void run(benchmark::State& state) {
+    const std::string payload(state.range(0), 'a');
+    uint64_t upstream_bytes = 0;
+    RequestStats stats;
+    for (auto _ : state) { // NOLINT: Silences warning about dead store
+      const auto start = std::chrono::steady_clock::now();
+      checkResult(tcp_client_->write(payload));
+      // The fake upstream accumulates all the data received on the connection.
+      upstream_bytes += payload.size();
+      checkResult(fake_upstream_connection_->waitForData(upstream_bytes));
+      checkResult(fake_upstream_connection_->write(payload));
+      checkResult(tcp_client_->waitForData(payload.size()));
+      tcp_client_->clearData();
+      stats.addLatency(std::chrono::steady_clock::now() - start);
+    }
+    stats.report(state);
+  }
+
+private:
+  IntegrationTcpClientPtr tcp_client_;
+  FakeRawConnectionPtr fake_upstream_connection_;
+};
+
+// Echoes data through the TCP proxy.
+void bmTcpProxyEcho(benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1024) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  initializeProcess();
+  TcpProxy proxy;
+  proxy.run(state);
+}
+BENCHMARK(bmTcpProxyEcho)->Arg(64)->Arg(16384)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Envoy
@@ -150,6 +150,8 @@ public:
     return wrapped_scope_->findTextReadout(name);
   }
 
+  StatName prefix() const override { return wrapped_scope_->prefix(); }
+
   const SymbolTable& constSymbolTable() const override {
     return wrapped_scope_->constSymbolTable();
   }
@@ -339,6 +341,7 @@ public:
     Thread::LockGuard lock(lock_);
     return store_.findTextReadout(name);
   }
+  StatName prefix() const override { return store_.prefix(); }
   const SymbolTable& constSymbolTable() const override { return store_.constSymbolTable(); }
   SymbolTable& symbolTable() override { return store_.symbolTable(); }
 
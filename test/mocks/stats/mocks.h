@@ -169,6 +169,7 @@ public:
   MOCK_METHOD(void, setParentValue, (uint64_t parent_value));
   MOCK_METHOD(void, sub, (uint64_t amount));
   MOCK_METHOD(void, mergeImportMode, (ImportMode));
+  MOCK_METHOD(bool, latchChanged, ());
   MOCK_METHOD(bool, used, (), (const));
   MOCK_METHOD(uint64_t, value, (), (const));
   MOCK_METHOD(absl::optional<bool>, cachedShouldImport, (), (const));
@@ -277,6 +278,9 @@ public:
 
   MOCK_METHOD(void, flush, (MetricSnapshot & snapshot));
   MOCK_METHOD(void, onHistogramComplete, (const Histogram& histogram, uint64_t value));
+  SinkFlushOptions flushOptions() const override { return flush_options_; }
+
+  SinkFlushOptions flush_options_;
 };
 
 class MockStore : public TestUtil::TestStore {
@@ -100,6 +100,86 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store, time_system);
 }
 
+TEST(ServerInstanceUtil, FlushChangedMetricsOnly) {
+  Stats::TestUtil::TestStore store;
+  Event::SimulatedTimeSystem time_system;
+  Stats::Counter& changed_counter = store.counter("changed_counter");
+  store.counter("idle_counter");
+  Stats::Gauge& changed_gauge = store.gauge("changed_gauge", Stats::Gauge::ImportMode::Accumulate);
+  Stats::Gauge& idle_gauge = store.gauge("idle_gauge", Stats::Gauge::ImportMode::Accumulate);
+  store.textReadout("text").set("is important");
+
+  std::list<Stats::SinkPtr> sinks;
+  auto* sink = new StrictMock<Stats::MockSink>();
+  sink->flush_options_.changed_metrics_only_ = true;
+  sinks.emplace_back(sink);
+
+  changed_counter.inc();
+  changed_gauge.set(5);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "changed_counter");
+    EXPECT_EQ(snapshot.counters()[0].delta_, 1);
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "changed_gauge");
+    ASSERT_EQ(snapshot.textReadouts().size(), 1);
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+
+  // Nothing changed since the previous flush. Setting a gauge to its current value is not a change.
+  changed_gauge.set(5);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+
+  // A sink wanting every metric gets them all, while the other one still only gets the changes.
+  auto* full_sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(full_sink);
+  idle_gauge.inc();
+  idle_gauge.dec();
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "idle_gauge");
+  }));
+  EXPECT_CALL(*full_sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+}
+
+TEST(ServerInstanceUtil, FlushInChunks) {
+  Stats::TestUtil::TestStore store;
+  Event::SimulatedTimeSystem time_system;
+  for (int i = 0; i < 5; ++i) {
+    store.counter(absl::StrCat("counter", i)).inc();
+  }
+  store.gauge("gauge", Stats::Gauge::ImportMode::Accumulate).set(1);
+
+  std::list<Stats::SinkPtr> sinks;
+  auto* sink = new StrictMock<Stats::MockSink>();
+  sink->flush_options_.max_metrics_per_flush_ = 4;
+  sinks.emplace_back(sink);
+
+  std::vector<size_t> chunk_sizes;
+  EXPECT_CALL(*sink, flush(_)).Times(2).WillRepeatedly(Invoke([&](Stats::MetricSnapshot& snapshot) {
+    chunk_sizes.push_back(snapshot.counters().size() + snapshot.gauges().size());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+  EXPECT_EQ(chunk_sizes, std::vector<size_t>({4, 2}));
+
+  // An empty snapshot is still flushed once.
+  sink->flush_options_.changed_metrics_only_ = true;
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {